@@ -291,6 +291,45 @@ void update_read_req_coverage(read_req_t* req,
 }
 
 
+/* Get the logio context for the given client of our application on this
+ * node, attaching to the client's log on first use */
+logio_context* client_get_peer_logio(unifyfs_client* client,
+                                     int peer_client_id)
+{
+    if (peer_client_id == client->state.client_id) {
+        return client->state.logio_ctx;
+    }
+
+    if ((peer_client_id < 0) ||
+        (peer_client_id >= UNIFYFS_SERVER_MAX_APP_CLIENTS)) {
+        LOGERR("invalid peer client id %d", peer_client_id);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&(client->sync));
+    logio_context* logio_ctx = client->logio_ctx_ptrs[peer_client_id];
+    if (NULL == logio_ctx) {
+        size_t shmem_size = 0;
+        if (client->state.logio_ctx->shmem != NULL) {
+            shmem_size = client->state.logio_ctx->shmem->size;
+        }
+        char* spill_dir = NULL;
+        if (client->state.logio_ctx->spill_sz > 0) {
+            spill_dir = client->cfg.logio_spill_dir;
+        }
+        unifyfs_logio_init(client->state.app_id,
+                           peer_client_id,
+                           shmem_size,
+                           client->state.logio_ctx->spill_sz,
+                           spill_dir,
+                           &client->logio_ctx_ptrs[peer_client_id]);
+        logio_ctx = client->logio_ctx_ptrs[peer_client_id];
+    }
+    pthread_mutex_unlock(&(client->sync));
+
+    return logio_ctx;
+}
+
 /* This uses information in the extent map for a file on the client to
  * complete any read requests.  It only complets a request if it contains
  * all of the data.  Otherwise the request is copied to the list of
@@ -420,28 +459,8 @@ void service_local_reqs(
             off_t log_offset = ext_log_pos + ext_byte_offset;
             size_t nread = 0;
             /* we need to use the logio_ctx from correct client */
-            logio_context* logio_ctx = NULL;
-            if (next->client_id == client->state.client_id) {
-                logio_ctx = client->state.logio_ctx;
-            } else if (client->logio_ctx_ptrs[next->client_id] != NULL) {
-                logio_ctx = client->logio_ctx_ptrs[next->client_id];
-            } else {
-                size_t shmem_size = 0;
-                if (client->state.logio_ctx->shmem != NULL) {
-                    shmem_size = client->state.logio_ctx->shmem->size;
-                }
-                char* spill_dir = NULL;
-                if (client->state.logio_ctx->spill_sz > 0) {
-                    spill_dir = client->cfg.logio_spill_dir;
-                }
-                unifyfs_logio_init(client->state.app_id,
-                                   next->client_id,
-                                   shmem_size,
-                                   client->state.logio_ctx->spill_sz,
-                                   spill_dir,
-                                   &client->logio_ctx_ptrs[next->client_id]);
-                logio_ctx = client->logio_ctx_ptrs[next->client_id];
-            }
+            logio_context* logio_ctx =
+                client_get_peer_logio(client, next->client_id);
             if (NULL != logio_ctx) {
                 int rc = unifyfs_logio_read(logio_ctx, log_offset,
                                             cover_length, req_ptr, &nread);
@@ -108,6 +108,11 @@ void update_read_req_coverage(read_req_t* req,
                               size_t extent_byte_offset,
                               size_t extent_length);
 
+/* Get the logio context for the given client of our application on this
+ * node, attaching to the client's log on first use */
+logio_context* client_get_peer_logio(unifyfs_client* client,
+                                     int peer_client_id);
+
 /* process a set of client read requests */
 int process_gfid_reads(unifyfs_client* client,
                        read_req_t* in_reqs,
@@ -126,6 +126,27 @@ UNIFYFS_DEF(__open_2, int,
 UNIFYFS_DEF(lio_listio, int,
             (int m, struct aiocb* const cblist[], int n, struct sigevent* sep),
             (m, cblist, n, sep))
+UNIFYFS_DEF(aio_read, int,
+            (struct aiocb* cbp),
+            (cbp))
+UNIFYFS_DEF(aio_write, int,
+            (struct aiocb* cbp),
+            (cbp))
+UNIFYFS_DEF(aio_fsync, int,
+            (int op, struct aiocb* cbp),
+            (op, cbp))
+UNIFYFS_DEF(aio_error, int,
+            (const struct aiocb* cbp),
+            (cbp))
+UNIFYFS_DEF(aio_return, ssize_t,
+            (struct aiocb* cbp),
+            (cbp))
+UNIFYFS_DEF(aio_suspend, int,
+            (const struct aiocb* const list[], int n, const struct timespec* t),
+            (list, n, t))
+UNIFYFS_DEF(aio_cancel, int,
+            (int fd, struct aiocb* cbp),
+            (fd, cbp))
 #endif
 
 UNIFYFS_DEF(lseek, off_t,
@@ -157,12 +178,24 @@ UNIFYFS_DEF(pread, ssize_t,
 UNIFYFS_DEF(pread64, ssize_t,
             (int fd, void* buf, size_t count, off64_t off),
             (fd, buf, count, off))
+UNIFYFS_DEF(preadv, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off),
+            (fd, iov, iovcnt, off))
+#ifdef HAVE_PREADV2
+UNIFYFS_DEF(preadv2, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off,
+             int flags),
+            (fd, iov, iovcnt, off, flags))
+#endif
 UNIFYFS_DEF(pwrite, ssize_t,
             (int fd, const void* buf, size_t count, off_t off),
             (fd, buf, count, off))
 UNIFYFS_DEF(pwrite64, ssize_t,
             (int fd, const void* buf, size_t count, off64_t off),
             (fd, buf, count, off))
+UNIFYFS_DEF(pwritev, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off),
+            (fd, iov, iovcnt, off))
 UNIFYFS_DEF(close, int,
             (int fd),
             (fd))
@@ -403,6 +436,13 @@ struct gotcha_binding_t unifyfs_wrappers[] = {
     { "__open_2", UNIFYFS_WRAP(__open_2), &wrappee_handle___open_2 },
 #ifdef HAVE_LIO_LISTIO
     { "lio_listio", UNIFYFS_WRAP(lio_listio), &wrappee_handle_lio_listio },
+    { "aio_read", UNIFYFS_WRAP(aio_read), &wrappee_handle_aio_read },
+    { "aio_write", UNIFYFS_WRAP(aio_write), &wrappee_handle_aio_write },
+    { "aio_fsync", UNIFYFS_WRAP(aio_fsync), &wrappee_handle_aio_fsync },
+    { "aio_error", UNIFYFS_WRAP(aio_error), &wrappee_handle_aio_error },
+    { "aio_return", UNIFYFS_WRAP(aio_return), &wrappee_handle_aio_return },
+    { "aio_suspend", UNIFYFS_WRAP(aio_suspend), &wrappee_handle_aio_suspend },
+    { "aio_cancel", UNIFYFS_WRAP(aio_cancel), &wrappee_handle_aio_cancel },
 #endif
     { "lseek", UNIFYFS_WRAP(lseek), &wrappee_handle_lseek },
     { "lseek64", UNIFYFS_WRAP(lseek64), &wrappee_handle_lseek64 },
@@ -413,8 +453,13 @@ struct gotcha_binding_t unifyfs_wrappers[] = {
     { "writev", UNIFYFS_WRAP(writev), &wrappee_handle_writev },
     { "pread", UNIFYFS_WRAP(pread), &wrappee_handle_pread },
     { "pread64", UNIFYFS_WRAP(pread64), &wrappee_handle_pread64 },
+    { "preadv", UNIFYFS_WRAP(preadv), &wrappee_handle_preadv },
+#ifdef HAVE_PREADV2
+    { "preadv2", UNIFYFS_WRAP(preadv2), &wrappee_handle_preadv2 },
+#endif
     { "pwrite", UNIFYFS_WRAP(pwrite), &wrappee_handle_pwrite },
     { "pwrite64", UNIFYFS_WRAP(pwrite64), &wrappee_handle_pwrite64 },
+    { "pwritev", UNIFYFS_WRAP(pwritev), &wrappee_handle_pwritev },
     { "fchdir", UNIFYFS_WRAP(fchdir), &wrappee_handle_fchdir },
     { "ftruncate", UNIFYFS_WRAP(ftruncate), &wrappee_handle_ftruncate },
     { "fsync", UNIFYFS_WRAP(fsync), &wrappee_handle_fsync },
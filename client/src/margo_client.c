@@ -58,6 +58,7 @@ static void register_client_rpcs(client_rpc_context_t* ctx)
     CLIENT_REGISTER_RPC(mread);
     CLIENT_REGISTER_RPC(node_local_extents_get);
     CLIENT_REGISTER_RPC(get_gfids);
+    CLIENT_REGISTER_RPC(server_stats);
 
 #undef CLIENT_REGISTER_RPC
 
@@ -74,6 +75,7 @@ static void register_client_rpcs(client_rpc_context_t* ctx)
 
     CLIENT_REGISTER_RPC_HANDLER(heartbeat);
     CLIENT_REGISTER_RPC_HANDLER(mread_req_data);
+    CLIENT_REGISTER_RPC_HANDLER(mread_req_local);
     CLIENT_REGISTER_RPC_HANDLER(mread_req_complete);
     CLIENT_REGISTER_RPC_HANDLER(transfer_complete);
     CLIENT_REGISTER_RPC_HANDLER(unlink_callback);
@@ -451,6 +453,9 @@ int invoke_client_metaset_rpc(unifyfs_client* client,
            in.attr.gfid, in.attr.filename);
     double timeout = client_rpc_context->timeout;
     int rc = forward_to_server(handle, &in, timeout);
+
+    /* the server may have changed the file attributes */
+    unifyfs_attr_cache_invalidate(client, f_meta->gfid);
     if (rc != UNIFYFS_SUCCESS) {
         LOGERR("forward of metaset rpc to server failed");
         margo_destroy(handle);
@@ -660,6 +665,9 @@ int invoke_client_truncate_rpc(unifyfs_client* client,
     LOGDBG("invoking the truncate rpc function in client");
     double timeout = client_rpc_context->timeout;
     int rc = forward_to_server(handle, &in, timeout);
+
+    /* the server may have changed the file attributes */
+    unifyfs_attr_cache_invalidate(client, gfid);
     if (rc != UNIFYFS_SUCCESS) {
         LOGERR("forward of truncate rpc to server failed");
         margo_destroy(handle);
@@ -707,6 +715,9 @@ int invoke_client_unlink_rpc(unifyfs_client* client,
     LOGDBG("invoking the unlink rpc function in client");
     double timeout = client_rpc_context->timeout;
     int rc = forward_to_server(handle, &in, timeout);
+
+    /* the server may have changed the file attributes */
+    unifyfs_attr_cache_invalidate(client, gfid);
     if (rc != UNIFYFS_SUCCESS) {
         LOGERR("forward of unlink rpc to server failed");
         margo_destroy(handle);
@@ -754,6 +765,9 @@ int invoke_client_laminate_rpc(unifyfs_client* client,
     LOGDBG("invoking the laminate rpc function in client");
     double timeout = client_rpc_context->timeout;
     int rc = forward_to_server(handle, &in, timeout);
+
+    /* the server may have changed the file attributes */
+    unifyfs_attr_cache_invalidate(client, gfid);
     if (rc != UNIFYFS_SUCCESS) {
         LOGERR("forward of laminate rpc to server failed");
         margo_destroy(handle);
@@ -801,6 +815,9 @@ int invoke_client_sync_rpc(unifyfs_client* client,
     LOGINFO("invoking the sync rpc function in client");
     double timeout = client_rpc_context->timeout;
     int rc = forward_to_server(handle, &in, timeout);
+
+    /* the server may have changed the file attributes */
+    unifyfs_attr_cache_invalidate(client, gfid);
     if (rc != UNIFYFS_SUCCESS) {
         LOGERR("forward of sync rpc to server failed");
         margo_destroy(handle);
@@ -1138,6 +1155,93 @@ static void unifyfs_mread_req_data_rpc(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_mread_req_data_rpc)
 
+/* for client read request identified by mread_id and request index, copy
+ * data from the log of a peer client on the same node to request's user
+ * buffer at given byte offset from start of request */
+static void unifyfs_mread_req_local_rpc(hg_handle_t handle)
+{
+    int ret = UNIFYFS_SUCCESS;
+
+    /* get input params */
+    unifyfs_mread_req_local_in_t in;
+    hg_return_t hret = margo_get_input(handle, &in);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_get_input() failed");
+        ret = UNIFYFS_ERROR_MARGO;
+    } else {
+        /* lookup client mread request */
+        unifyfs_client* client;
+        int client_app   = (int) in.app_id;
+        int client_id    = (int) in.client_id;
+        int client_mread = (int) in.mread_id;
+        client = unifyfs_find_client(client_app, client_id, NULL);
+        client_mread_status* mread = client_get_mread_status(client,
+                                                             client_mread);
+        if (NULL == mread) {
+            /* unknown client request */
+            ret = EINVAL;
+        } else {
+            int read_index = (int) in.read_index;
+            size_t data_size = (size_t) in.length;
+            size_t data_offset = (size_t) in.read_offset;
+            int log_client = (int) in.log_client_id;
+            off_t log_offset = (off_t) in.log_offset;
+
+            if (data_size != 0) {
+                /* set up pointer to user buffer at read req offset */
+                ABT_mutex_lock(mread->sync);
+                assert(read_index < mread->n_reads);
+                read_req_t* rdreq = mread->reqs + read_index;
+                char* user_buf = rdreq->buf + data_offset;
+                size_t data_space = rdreq->length - data_offset;
+                ABT_mutex_unlock(mread->sync);
+
+                logio_context* logio_ctx =
+                    client_get_peer_logio(client, log_client);
+                if (data_size > data_space) {
+                    LOGERR("data size exceeds available user buffer space");
+                    ret = EINVAL;
+                } else if (NULL == logio_ctx) {
+                    LOGERR("failed to attach log for client %d", log_client);
+                    ret = UNIFYFS_FAILURE;
+                } else {
+                    /* copy data directly from peer log into user buffer */
+                    size_t nread = 0;
+                    ret = unifyfs_logio_read(logio_ctx, log_offset, data_size,
+                                             user_buf, &nread);
+                    if (ret == UNIFYFS_SUCCESS) {
+                        ABT_mutex_lock(mread->sync);
+                        update_read_req_coverage(rdreq, data_offset, nread);
+                        ABT_mutex_unlock(mread->sync);
+                        LOGINFO("updated coverage for mread[%d] request %d",
+                                client_mread, read_index);
+                    } else {
+                        LOGERR("peer log read failed for client=%d "
+                               "offset=%zu size=%zu", log_client,
+                               (size_t) log_offset, data_size);
+                    }
+                }
+            }
+        }
+        margo_free_input(handle, &in);
+    }
+
+    /* set rpc result status */
+    unifyfs_mread_req_local_out_t out;
+    out.ret = ret;
+
+    /* return to caller */
+    LOGDBG("responding");
+    hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* free margo resources */
+    margo_destroy(handle);
+}
+DEFINE_MARGO_RPC_HANDLER(unifyfs_mread_req_local_rpc)
+
 /* for client read request identified by mread_id and request index,
  * update request completion state according to input params */
 static void unifyfs_mread_req_complete_rpc(hg_handle_t handle)
@@ -1267,6 +1371,7 @@ static void unifyfs_unlink_callback_rpc(hg_handle_t handle)
             ret = EINVAL;
         } else {
             int gfid = (int) in.gfid;
+            unifyfs_attr_cache_invalidate(client, gfid);
             int fid = unifyfs_fid_from_gfid(client, gfid);
             if (-1 != fid) {
                 unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client,
@@ -1411,3 +1516,95 @@ exit:  // normally, we use "out", but that's also the name of a variable
     margo_destroy(handle);
     return ret;
 }
+
+/* invokes the server_stats rpc function */
+int invoke_client_server_stats_rpc(unifyfs_client* client,
+                                   int reset,
+                                   char** report)
+{
+    /* check that we have initialized margo */
+    if (NULL == client_rpc_context) {
+        return UNIFYFS_FAILURE;
+    }
+
+    /* the initial buffer holds a full report, but retry once with
+     * a larger buffer in case the report has grown. The server does not
+     * reset statistics when the report is truncated, so the retry asks
+     * for the reset again. */
+    int ret = UNIFYFS_ERROR_MARGO;
+    hg_size_t buf_size = UNIFYFS_CLIENT_STATS_BUFSIZE;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        char* buf = calloc(1, buf_size);
+        if (NULL == buf) {
+            return ENOMEM;
+        }
+
+        /* fill in input struct */
+        unifyfs_server_stats_in_t in;
+        hg_return_t hret = margo_bulk_create(client_rpc_context->mid,
+                                             1, (void**)&buf, &buf_size,
+                                             HG_BULK_WRITE_ONLY,
+                                             &in.bulk_report);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_bulk_create() failed - %s",
+                   HG_Error_to_string(hret));
+            free(buf);
+            return UNIFYFS_ERROR_MARGO;
+        }
+        in.app_id    = (int32_t) client->state.app_id;
+        in.client_id = (int32_t) client->state.client_id;
+        in.reset     = (int32_t) reset;
+        in.bulk_size = buf_size;
+
+        /* get handle to rpc function */
+        hg_handle_t handle =
+            create_handle(client_rpc_context->rpcs.server_stats_id);
+
+        /* call rpc function */
+        LOGDBG("invoking the server_stats rpc function in client");
+        double timeout = client_rpc_context->timeout;
+        ret = forward_to_server(handle, &in, timeout);
+        if (ret != UNIFYFS_SUCCESS) {
+            LOGERR("forward of server_stats rpc to server failed");
+            margo_bulk_free(in.bulk_report);
+            margo_destroy(handle);
+            free(buf);
+            return ret;
+        }
+
+        /* decode response */
+        hg_size_t report_size = 0;
+        unifyfs_server_stats_out_t out;
+        hret = margo_get_output(handle, &out);
+        if (hret == HG_SUCCESS) {
+            LOGDBG("Got response ret=%" PRIi32, out.ret);
+            ret = (int) out.ret;
+            report_size = out.report_size;
+            margo_free_output(handle, &out);
+        } else {
+            LOGERR("margo_get_output() failed - %s",
+                   HG_Error_to_string(hret));
+            ret = UNIFYFS_ERROR_MARGO;
+        }
+        margo_bulk_free(in.bulk_report);
+        margo_destroy(handle);
+
+        if ((ret == UNIFYFS_SUCCESS) && (report_size > buf_size) &&
+            (0 == attempt)) {
+            /* report was truncated, try again with a big enough buffer.
+             * A second truncated report is returned as is */
+            free(buf);
+            buf_size = report_size;
+            continue;
+        }
+
+        if (ret == UNIFYFS_SUCCESS) {
+            buf[buf_size - 1] = '\0';
+            *report = buf;
+        } else {
+            free(buf);
+        }
+        return ret;
+    }
+    return ret;
+}
@@ -39,10 +39,12 @@ typedef struct ClientRpcIds {
     hg_id_t mread_id;
     hg_id_t node_local_extents_get_id;
     hg_id_t get_gfids_id;
+    hg_id_t server_stats_id;
 
     /* server-to-client */
     hg_id_t heartbeat_id;
     hg_id_t mread_req_data_id;
+    hg_id_t mread_req_local_id;
     hg_id_t mread_req_complete_id;
     hg_id_t transfer_complete_id;
     hg_id_t unlink_callback_id;
@@ -116,5 +118,9 @@ int invoke_client_get_gfids_rpc(unifyfs_client* client,
                                 int* num_gfids,
                                 int** gfid_list);
 
+int invoke_client_server_stats_rpc(unifyfs_client* client,
+                                   int reset,
+                                   char** report);
+
 
 #endif // MARGO_CLIENT_H
@@ -16,6 +16,7 @@
 #include "unifyfs_fid.h"
 #include "unifyfs_wrap.h"
 #include "unifyfs-sysio.h"
+#include "unifyfs-aio.h"
 
 #ifdef USE_SPATH
 #include <spath.h>
@@ -557,6 +558,9 @@ int posix_client_fini(void)
         return UNIFYFS_FAILURE;
     }
 
+    /* complete any outstanding asynchronous I/O */
+    unifyfs_aio_fini();
+
     unifyfs_handle fshdl = (unifyfs_handle) posix_client;
     rc = unifyfs_finalize(fshdl);
     if (UNIFYFS_SUCCESS != rc) {
@@ -0,0 +1,685 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <signal.h>
+
+#include "unifyfs-aio.h"
+#include "unifyfs-sysio.h"
+#include "posix_client.h"
+#include "client_read.h"
+#include "unifyfs_fid.h"
+
+/* when waiting on a set of aiocbs that includes requests serviced by
+ * the system AIO library, we can't be signaled when those complete,
+ * so poll for them at this interval (nanoseconds) */
+#define AIO_SUSPEND_POLL_NSEC (1000000L)
+
+/* a queued or executing request */
+typedef struct aio_request {
+    struct aiocb* cbp;       /* user control block */
+    unifyfs_aio_op_e op;     /* requested operation */
+    int fd;                  /* application file descriptor */
+    int ufd;                 /* UnifyFS fd, or -1 if not a UnifyFS file */
+    int fid;                 /* local file id, or -1 */
+    int gfid;                /* global file id, or -1 */
+    unifyfs_aio_list* list;  /* owning lio_listio() list, or NULL */
+    struct aio_request* next;
+    struct aio_request* prev;
+} aio_request;
+
+struct unifyfs_aio_list {
+    /* number of incomplete requests, plus one held by the submitter
+     * until unifyfs_aio_list_finish() */
+    unsigned int pending;
+    unsigned int n_error; /* number of requests that failed */
+    int notify;           /* whether to deliver sevp on completion */
+    struct sigevent sevp;
+};
+
+/* notification to deliver once the engine lock is released */
+typedef struct {
+    int notify;
+    struct sigevent sevp;
+    unifyfs_aio_list* free_list; /* list to free after notification */
+} aio_notification;
+
+/* protects all engine state below */
+static pthread_mutex_t aio_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* signaled when requests are queued or the engine is shutting down */
+static pthread_cond_t aio_queue_cond = PTHREAD_COND_INITIALIZER;
+
+/* signaled when requests complete */
+static pthread_cond_t aio_done_cond = PTHREAD_COND_INITIALIZER;
+
+static aio_request* aio_queue;  /* requests waiting for the thread */
+static aio_request* aio_active; /* requests being executed by the thread */
+
+static pthread_t aio_thread;
+static int aio_thread_running; // = 0
+static int aio_thread_exit;    // = 0
+
+/* the error code field is written last on completion, with release
+ * ordering, so that a reader that sees a final status also sees the
+ * return value. Reads do not take the engine lock, which keeps
+ * aio_error() and aio_return() safe to call from signal handlers. */
+static inline int aio_load_status(const struct aiocb* cbp)
+{
+    return __atomic_load_n(&(AIOCB_ERROR_CODE(cbp)), __ATOMIC_ACQUIRE);
+}
+
+static inline void aio_store_status(struct aiocb* cbp, int err, ssize_t ret)
+{
+    AIOCB_RETURN_VAL(cbp) = ret;
+    __atomic_store_n(&(AIOCB_ERROR_CODE(cbp)), err, __ATOMIC_RELEASE);
+}
+
+/* passes SIGEV_THREAD notification arguments to the new thread */
+typedef struct {
+    void (*fn)(union sigval);
+    union sigval value;
+} aio_thread_notify_args;
+
+static void* aio_notify_thread(void* arg)
+{
+    aio_thread_notify_args* args = (aio_thread_notify_args*) arg;
+    args->fn(args->value);
+    free(args);
+    return NULL;
+}
+
+/* deliver the notification requested by the sigevent */
+static void aio_notify(struct sigevent* sevp)
+{
+    switch (sevp->sigev_notify) {
+    case SIGEV_SIGNAL: {
+        int rc = sigqueue(getpid(), sevp->sigev_signo, sevp->sigev_value);
+        if (rc != 0) {
+            LOGERR("sigqueue(signo=%d) failed - %s",
+                   sevp->sigev_signo, strerror(errno));
+        }
+        break;
+    }
+    case SIGEV_THREAD: {
+        if (NULL == sevp->sigev_notify_function) {
+            break;
+        }
+        aio_thread_notify_args* args = malloc(sizeof(*args));
+        if (NULL == args) {
+            LOGERR("failed to allocate notification arguments");
+            break;
+        }
+        args->fn = sevp->sigev_notify_function;
+        args->value = sevp->sigev_value;
+
+        pthread_t tid;
+        int rc = pthread_create(&tid,
+            (pthread_attr_t*) sevp->sigev_notify_attributes,
+            aio_notify_thread, args);
+        if (rc != 0) {
+            LOGERR("failed to create notification thread - %s",
+                   strerror(rc));
+            free(args);
+        } else {
+            pthread_detach(tid);
+        }
+        break;
+    }
+    default: // SIGEV_NONE
+        break;
+    }
+}
+
+static void aio_deliver(aio_notification* note)
+{
+    if (note->notify) {
+        aio_notify(&(note->sevp));
+    }
+    if (NULL != note->free_list) {
+        free(note->free_list);
+    }
+}
+
+/* drop one pending reference on the list, called with engine lock held.
+ * Fills note if the list is now complete and needs a notification. */
+static void aio_list_release_locked(unifyfs_aio_list* list,
+                                    aio_notification* note)
+{
+    list->pending--;
+    if (list->pending > 0) {
+        return;
+    }
+
+    if (list->notify) {
+        note->notify = 1;
+        note->sevp = list->sevp;
+    }
+    note->free_list = list;
+}
+
+/* record the completion of a request, called with engine lock held.
+ * The request must already be removed from its queue. */
+static void aio_complete_locked(aio_request* req, int err, ssize_t ret,
+                                aio_notification* note)
+{
+    memset(note, 0, sizeof(*note));
+
+    struct aiocb* cbp = req->cbp;
+    aio_store_status(cbp, err, ret);
+
+    if (NULL != req->list) {
+        if (err != 0) {
+            req->list->n_error++;
+        }
+        aio_list_release_locked(req->list, note);
+    } else if (cbp->aio_sigevent.sigev_notify != SIGEV_NONE) {
+        note->notify = 1;
+        note->sevp = cbp->aio_sigevent;
+    }
+
+    pthread_cond_broadcast(&aio_done_cond);
+    free(req);
+}
+
+/* mark an executed request complete and deliver its notification */
+static void aio_complete(aio_request* req, int err, ssize_t ret)
+{
+    aio_notification note;
+    pthread_mutex_lock(&aio_mutex);
+    DL_DELETE(aio_active, req);
+    aio_complete_locked(req, err, ret, &note);
+    pthread_mutex_unlock(&aio_mutex);
+    aio_deliver(&note);
+}
+
+/* execute a single request other than a read of a UnifyFS file */
+static void aio_execute(aio_request* req)
+{
+    struct aiocb* cbp = req->cbp;
+    ssize_t ret = 0;
+    int err = 0;
+
+    switch (req->op) {
+    case UNIFYFS_AIO_READ:
+        /* zero-length reads of UnifyFS files also come here */
+        ret = UNIFYFS_WRAP(pread)(req->fd, (void*)cbp->aio_buf,
+                                  cbp->aio_nbytes, cbp->aio_offset);
+        break;
+    case UNIFYFS_AIO_WRITE:
+        if (req->ufd >= 0) {
+            /* with O_APPEND, writes always go to the end of the file */
+            off_t pos = cbp->aio_offset;
+            unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(req->ufd);
+            if ((NULL != filedesc) && filedesc->append) {
+                pos = unifyfs_fid_logical_size(posix_client, req->fid);
+            }
+            size_t nwritten;
+            int rc = unifyfs_fd_write(req->ufd, pos,
+                                      (const void*)cbp->aio_buf,
+                                      cbp->aio_nbytes, &nwritten);
+            if (rc != UNIFYFS_SUCCESS) {
+                errno = unifyfs_rc_errno(rc);
+                ret = -1;
+            } else {
+                ret = (ssize_t) nwritten;
+            }
+        } else {
+            ret = UNIFYFS_WRAP(pwrite)(req->fd, (const void*)cbp->aio_buf,
+                                       cbp->aio_nbytes, cbp->aio_offset);
+        }
+        break;
+    case UNIFYFS_AIO_FSYNC:
+        ret = UNIFYFS_WRAP(fsync)(req->fd);
+        break;
+    case UNIFYFS_AIO_FDATASYNC:
+        if (req->ufd >= 0) {
+            /* fdatasync() isn't supported on UnifyFS files,
+             * but a full fsync() satisfies the request */
+            ret = UNIFYFS_WRAP(fsync)(req->fd);
+        } else {
+            ret = UNIFYFS_WRAP(fdatasync)(req->fd);
+        }
+        break;
+    default:
+        errno = EINVAL;
+        ret = -1;
+        break;
+    }
+
+    if (ret < 0) {
+        err = errno;
+    }
+    aio_complete(req, err, ret);
+}
+
+/* issue the accumulated reads of UnifyFS files as one batch and
+ * complete each request */
+static void aio_execute_reads(read_req_t* reqs, aio_request** rd_reqs,
+                              size_t count)
+{
+    if (0 == count) {
+        return;
+    }
+
+    int rc = process_gfid_reads(posix_client, reqs, count);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to process %zu asynchronous reads - %s",
+               count, unifyfs_rc_enum_description(rc));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        int err = reqs[i].errcode;
+        if (rc != UNIFYFS_SUCCESS) {
+            aio_complete(rd_reqs[i], unifyfs_rc_errno(rc), -1);
+        } else if ((UNIFYFS_SUCCESS == err) || (ENODATA == err)) {
+            /* short reads and reads past the end of file succeed */
+            aio_complete(rd_reqs[i], 0, (ssize_t)(reqs[i].nread));
+        } else {
+            aio_complete(rd_reqs[i], unifyfs_rc_errno(err), -1);
+        }
+    }
+}
+
+/* execute a batch of requests in submission order. Reads of UnifyFS
+ * files are accumulated and issued together, the batch is flushed
+ * before any other operation to preserve ordering */
+static void aio_execute_batch(aio_request** batch, size_t count)
+{
+    read_req_t* reqs = calloc(count, sizeof(read_req_t));
+    aio_request** rd_reqs = calloc(count, sizeof(aio_request*));
+    if ((NULL == reqs) || (NULL == rd_reqs)) {
+        LOGERR("failed to allocate read requests, completing with ENOMEM");
+        for (size_t i = 0; i < count; i++) {
+            aio_complete(batch[i], ENOMEM, -1);
+        }
+        free(reqs);
+        free(rd_reqs);
+        return;
+    }
+
+    size_t n_reads = 0;
+    int synced_fid = -1;
+    for (size_t i = 0; i < count; i++) {
+        aio_request* req = batch[i];
+        if ((UNIFYFS_AIO_READ == req->op) && (req->fid >= 0) &&
+            (req->cbp->aio_nbytes > 0)) {
+            /* sync data for file before reading, once per file */
+            if (req->fid != synced_fid) {
+                /* TODO: handle error if sync fails? */
+                unifyfs_fid_sync_extents(posix_client, req->fid);
+                synced_fid = req->fid;
+            }
+
+            struct aiocb* cbp = req->cbp;
+            read_req_t* rreq = &(reqs[n_reads]);
+            rreq->gfid    = req->gfid;
+            rreq->offset  = (size_t)(cbp->aio_offset);
+            rreq->length  = cbp->aio_nbytes;
+            rreq->nread   = 0;
+            rreq->errcode = 0;
+            rreq->buf     = (char*)(cbp->aio_buf);
+            rreq->aiocbp  = cbp;
+            rreq->cover_begin_offset = (size_t)-1;
+            rreq->cover_end_offset   = (size_t)-1;
+            rd_reqs[n_reads] = req;
+            n_reads++;
+            continue;
+        }
+
+        if (UNIFYFS_AIO_READ != req->op) {
+            aio_execute_reads(reqs, rd_reqs, n_reads);
+            memset(reqs, 0, n_reads * sizeof(read_req_t));
+            n_reads = 0;
+            synced_fid = -1;
+        }
+        aio_execute(req);
+    }
+    aio_execute_reads(reqs, rd_reqs, n_reads);
+
+    free(reqs);
+    free(rd_reqs);
+}
+
+/* background progress thread, services queued requests until told to
+ * exit and the queue is empty */
+static void* aio_progress_thread(void* arg)
+{
+    aio_request** batch = NULL;
+    size_t batch_cap = 0;
+
+    pthread_mutex_lock(&aio_mutex);
+    while (1) {
+        while ((NULL == aio_queue) && !aio_thread_exit) {
+            pthread_cond_wait(&aio_queue_cond, &aio_mutex);
+        }
+        if (NULL == aio_queue) {
+            break;
+        }
+
+        /* take everything that's queued */
+        aio_active = aio_queue;
+        aio_queue = NULL;
+
+        size_t count = 0;
+        aio_request* req;
+        DL_FOREACH(aio_active, req) {
+            count++;
+        }
+        if (count > batch_cap) {
+            aio_request** tmp = realloc(batch, count * sizeof(*batch));
+            if (NULL == tmp) {
+                /* put the requests back and retry later */
+                LOGERR("failed to allocate request batch");
+                aio_queue = aio_active;
+                aio_active = NULL;
+                pthread_mutex_unlock(&aio_mutex);
+                usleep(1000);
+                pthread_mutex_lock(&aio_mutex);
+                continue;
+            }
+            batch = tmp;
+            batch_cap = count;
+        }
+        count = 0;
+        DL_FOREACH(aio_active, req) {
+            batch[count++] = req;
+        }
+        pthread_mutex_unlock(&aio_mutex);
+
+        LOGDBG("executing %zu asynchronous requests", count);
+        aio_execute_batch(batch, count);
+
+        pthread_mutex_lock(&aio_mutex);
+    }
+    pthread_mutex_unlock(&aio_mutex);
+
+    free(batch);
+    return NULL;
+}
+
+int unifyfs_aio_submit(struct aiocb* cbp,
+                       unifyfs_aio_op_e op,
+                       unifyfs_aio_list* list)
+{
+    if (NULL == cbp) {
+        return EINVAL;
+    }
+
+    aio_request* req = calloc(1, sizeof(aio_request));
+    if (NULL == req) {
+        return EAGAIN;
+    }
+    req->cbp  = cbp;
+    req->op   = op;
+    req->fd   = cbp->aio_fildes;
+    req->ufd  = -1;
+    req->fid  = -1;
+    req->gfid = -1;
+    req->list = list;
+
+    /* resolve UnifyFS files now, so later reuse of the descriptor
+     * doesn't change what the request refers to */
+    int fd = cbp->aio_fildes;
+    if (unifyfs_intercept_fd(&fd)) {
+        int fid = unifyfs_get_fid_from_fd(fd);
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if ((fid < 0) || (NULL == filedesc)) {
+            free(req);
+            return EBADF;
+        }
+        if (((UNIFYFS_AIO_READ == op) && !filedesc->read) ||
+            ((UNIFYFS_AIO_WRITE == op) && !filedesc->write)) {
+            free(req);
+            return EBADF;
+        }
+        req->ufd  = fd;
+        req->fid  = fid;
+        req->gfid = unifyfs_gfid_from_fid(posix_client, fid);
+    }
+
+    if (((UNIFYFS_AIO_READ == op) || (UNIFYFS_AIO_WRITE == op)) &&
+        (cbp->aio_offset < 0)) {
+        free(req);
+        return EINVAL;
+    }
+
+    pthread_mutex_lock(&aio_mutex);
+    if (!aio_thread_running) {
+        aio_thread_exit = 0;
+        int rc = pthread_create(&aio_thread, NULL, aio_progress_thread, NULL);
+        if (rc != 0) {
+            pthread_mutex_unlock(&aio_mutex);
+            LOGERR("failed to create AIO progress thread - %s",
+                   strerror(rc));
+            free(req);
+            return EAGAIN;
+        }
+        aio_thread_running = 1;
+    }
+
+    aio_store_status(cbp, EINPROGRESS, 0);
+    if (NULL != list) {
+        list->pending++;
+    }
+    DL_APPEND(aio_queue, req);
+    pthread_cond_signal(&aio_queue_cond);
+    pthread_mutex_unlock(&aio_mutex);
+
+    return UNIFYFS_SUCCESS;
+}
+
+unifyfs_aio_list* unifyfs_aio_list_create(const struct sigevent* sevp)
+{
+    unifyfs_aio_list* list = calloc(1, sizeof(unifyfs_aio_list));
+    if (NULL == list) {
+        return NULL;
+    }
+
+    /* hold a reference until all requests have been submitted */
+    list->pending = 1;
+    if ((NULL != sevp) && (sevp->sigev_notify != SIGEV_NONE)) {
+        list->notify = 1;
+        list->sevp = *sevp;
+    }
+    return list;
+}
+
+int unifyfs_aio_list_finish(unifyfs_aio_list* list, int wait)
+{
+    int ret = UNIFYFS_SUCCESS;
+    aio_notification note;
+    memset(&note, 0, sizeof(note));
+
+    pthread_mutex_lock(&aio_mutex);
+    if (wait) {
+        while (list->pending > 1) {
+            pthread_cond_wait(&aio_done_cond, &aio_mutex);
+        }
+        if (list->n_error > 0) {
+            ret = EIO;
+        }
+        note.free_list = list;
+    } else {
+        aio_list_release_locked(list, &note);
+    }
+    pthread_mutex_unlock(&aio_mutex);
+
+    aio_deliver(&note);
+    return ret;
+}
+
+int unifyfs_aio_error(const struct aiocb* cbp)
+{
+    return aio_load_status(cbp);
+}
+
+ssize_t unifyfs_aio_return(struct aiocb* cbp)
+{
+    int err = aio_load_status(cbp);
+    if (EINPROGRESS == err) {
+        errno = EINVAL;
+        return -1;
+    }
+    ssize_t ret = AIOCB_RETURN_VAL(cbp);
+    if (err != 0) {
+        errno = err;
+    }
+    return ret;
+}
+
+int unifyfs_aio_suspend(const struct aiocb* const list[],
+                        int nent,
+                        const struct timespec* timeout)
+{
+    /* compute absolute deadline from relative timeout */
+    struct timespec deadline;
+    if (NULL != timeout) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec  += timeout->tv_sec;
+        deadline.tv_nsec += timeout->tv_nsec;
+        while (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    int ret = UNIFYFS_SUCCESS;
+    pthread_mutex_lock(&aio_mutex);
+    while (1) {
+        /* done if any request has completed, note whether we need
+         * to poll for requests not serviced by the engine */
+        int done = 0;
+        int foreign = 0;
+        for (int i = 0; i < nent; i++) {
+            const struct aiocb* cbp = list[i];
+            if (NULL == cbp) {
+                continue;
+            }
+            if (aio_load_status(cbp) != EINPROGRESS) {
+                done = 1;
+                break;
+            }
+            int fd = cbp->aio_fildes;
+            if (!unifyfs_intercept_fd(&fd)) {
+                foreign = 1;
+            }
+        }
+        if (done) {
+            break;
+        }
+
+        struct timespec wake;
+        int timed = 0;
+        if (NULL != timeout) {
+            wake = deadline;
+            timed = 1;
+        }
+        if (foreign) {
+            struct timespec poll;
+            clock_gettime(CLOCK_REALTIME, &poll);
+            poll.tv_nsec += AIO_SUSPEND_POLL_NSEC;
+            if (poll.tv_nsec >= 1000000000L) {
+                poll.tv_sec++;
+                poll.tv_nsec -= 1000000000L;
+            }
+            if (!timed || (poll.tv_sec < wake.tv_sec) ||
+                ((poll.tv_sec == wake.tv_sec) &&
+                 (poll.tv_nsec < wake.tv_nsec))) {
+                wake = poll;
+            }
+            timed = 1;
+        }
+
+        if (timed) {
+            int rc = pthread_cond_timedwait(&aio_done_cond, &aio_mutex,
+                                            &wake);
+            if ((ETIMEDOUT == rc) && (NULL != timeout)) {
+                struct timespec now;
+                clock_gettime(CLOCK_REALTIME, &now);
+                if ((now.tv_sec > deadline.tv_sec) ||
+                    ((now.tv_sec == deadline.tv_sec) &&
+                     (now.tv_nsec >= deadline.tv_nsec))) {
+                    ret = EAGAIN;
+                    break;
+                }
+            }
+        } else {
+            pthread_cond_wait(&aio_done_cond, &aio_mutex);
+        }
+    }
+    pthread_mutex_unlock(&aio_mutex);
+
+    return ret;
+}
+
+int unifyfs_aio_cancel(int fd, struct aiocb* cbp)
+{
+    int ret = AIO_ALLDONE;
+    aio_request* canceled = NULL;
+    aio_request* req;
+    aio_request* tmp;
+
+    pthread_mutex_lock(&aio_mutex);
+
+    /* requests already taken by the progress thread can't be canceled */
+    DL_FOREACH(aio_active, req) {
+        if ((req->fd == fd) && ((NULL == cbp) || (req->cbp == cbp))) {
+            ret = AIO_NOTCANCELED;
+            break;
+        }
+    }
+
+    DL_FOREACH_SAFE(aio_queue, req, tmp) {
+        if ((req->fd == fd) && ((NULL == cbp) || (req->cbp == cbp))) {
+            DL_DELETE(aio_queue, req);
+            DL_APPEND(canceled, req);
+            if (AIO_ALLDONE == ret) {
+                ret = AIO_CANCELED;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&aio_mutex);
+
+    /* complete canceled requests, notifying as for other completions */
+    DL_FOREACH_SAFE(canceled, req, tmp) {
+        aio_notification note;
+        DL_DELETE(canceled, req);
+        pthread_mutex_lock(&aio_mutex);
+        aio_complete_locked(req, ECANCELED, -1, &note);
+        pthread_mutex_unlock(&aio_mutex);
+        aio_deliver(&note);
+    }
+
+    return ret;
+}
+
+void unifyfs_aio_fini(void)
+{
+    pthread_mutex_lock(&aio_mutex);
+    if (!aio_thread_running) {
+        pthread_mutex_unlock(&aio_mutex);
+        return;
+    }
+    aio_thread_exit = 1;
+    pthread_cond_signal(&aio_queue_cond);
+    pthread_mutex_unlock(&aio_mutex);
+
+    /* the thread drains the queue before exiting */
+    pthread_join(aio_thread, NULL);
+
+    pthread_mutex_lock(&aio_mutex);
+    aio_thread_running = 0;
+    pthread_mutex_unlock(&aio_mutex);
+}
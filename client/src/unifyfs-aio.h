@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef UNIFYFS_AIO_H
+#define UNIFYFS_AIO_H
+
+#include "unifyfs-internal.h"
+
+/*
+ * Asynchronous I/O engine for the POSIX client.
+ *
+ * Requests submitted through aio_read(), aio_write(), aio_fsync(), and
+ * lio_listio() are queued and serviced by a background progress thread.
+ * The thread takes all queued requests at once, so consecutive reads
+ * of UnifyFS files are issued as a single batch of read requests to the
+ * server. On completion, the status and return value are recorded in the
+ * user's aiocb and the requested sigevent notification is delivered.
+ */
+
+/* operations serviced by the engine */
+typedef enum {
+    UNIFYFS_AIO_READ = 0,
+    UNIFYFS_AIO_WRITE,
+    UNIFYFS_AIO_FSYNC,
+    UNIFYFS_AIO_FDATASYNC
+} unifyfs_aio_op_e;
+
+/* a set of requests submitted by a single lio_listio() call */
+typedef struct unifyfs_aio_list unifyfs_aio_list;
+
+/* Queue the aiocb for asynchronous execution of the given operation.
+ * If list is not NULL, the request is tracked as a member of that list,
+ * and the sigevent in the aiocb is ignored.
+ * Returns UNIFYFS_SUCCESS or an errno value if the request was not
+ * queued. */
+int unifyfs_aio_submit(struct aiocb* cbp,
+                       unifyfs_aio_op_e op,
+                       unifyfs_aio_list* list);
+
+/* Create a list to track the requests of one lio_listio() call. If sevp
+ * is not NULL, its notification is delivered once all requests of the
+ * list have completed. */
+unifyfs_aio_list* unifyfs_aio_list_create(const struct sigevent* sevp);
+
+/* Mark the end of submissions to the list. If wait is set, block until
+ * all requests of the list have completed. The list must not be used
+ * by the caller after this returns.
+ * Returns UNIFYFS_SUCCESS, or EIO if wait is set and any request of
+ * the list failed. */
+int unifyfs_aio_list_finish(unifyfs_aio_list* list, int wait);
+
+/* Return the error status of the request (EINPROGRESS if still
+ * queued or executing) */
+int unifyfs_aio_error(const struct aiocb* cbp);
+
+/* Return the final return value of a completed request */
+ssize_t unifyfs_aio_return(struct aiocb* cbp);
+
+/* Wait until at least one of the requests in the list has completed or
+ * the timeout (relative, may be NULL) has expired. NULL entries in the
+ * list are ignored. Returns UNIFYFS_SUCCESS or EAGAIN on timeout. */
+int unifyfs_aio_suspend(const struct aiocb* const list[],
+                        int nent,
+                        const struct timespec* timeout);
+
+/* Cancel queued requests for the given file descriptor, or only the
+ * given aiocb if cbp is not NULL. Returns AIO_CANCELED, AIO_NOTCANCELED,
+ * or AIO_ALLDONE. */
+int unifyfs_aio_cancel(int fd, struct aiocb* cbp);
+
+/* Complete all outstanding requests and stop the progress thread */
+void unifyfs_aio_fini(void);
+
+#endif /* UNIFYFS_AIO_H */
@@ -45,6 +45,7 @@
 #include "margo_client.h"
 #include "posix_client.h"
 #include "client_read.h"
+#include "unifyfs-aio.h"
 #include "unifyfs_fid.h"
 
 /* ---------------------------------------
@@ -601,11 +602,11 @@ int UNIFYFS_WRAP(rename)(const char* oldpath, const char* newpath)
         }
 
         /* finally overwrite the old name with the new name */
-        pthread_mutex_lock(&(posix_client->sync));
-        LOGDBG("Changing %s to %s",
-               (char*)posix_client->unifyfs_filelist[fid].filename, new_upath);
-        strcpy((void*)posix_client->unifyfs_filelist[fid].filename, new_upath);
-        pthread_mutex_unlock(&(posix_client->sync));
+        int rc = unifyfs_fid_rename(posix_client, fid, new_upath);
+        if (rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(rc);
+            return -1;
+        }
 
         /* success */
         errno = 0;
@@ -1171,6 +1172,38 @@ int UNIFYFS_WRAP(fstatfs)(int fd, struct statfs* fsbuf)
  * Returns success or error code.
  */
 int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
+{
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len  = count;
+    return unifyfs_fd_readv(fd, pos, &iov, 1, nread);
+}
+
+/* sum the buffer lengths of an I/O vector, returns EINVAL if the vector
+ * is invalid or the total overflows */
+static int iov_total_length(const struct iovec* iov, int iovcnt,
+                            size_t* total)
+{
+    *total = 0;
+    if ((iovcnt < 0) || (iovcnt > IOV_MAX) ||
+        ((iovcnt > 0) && (NULL == iov))) {
+        return EINVAL;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len > (SSIZE_MAX - *total)) {
+            return EINVAL;
+        }
+        *total += iov[i].iov_len;
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/*
+ * Read into the buffers of an I/O vector from file starting at offset
+ * 'pos'. All buffers are read with a single batch of read requests.
+ */
+int unifyfs_fd_readv(int fd, off_t pos, const struct iovec* iov, int iovcnt,
+                     size_t* nread)
 {
     /* assume we'll fail, set bytes read to 0 as a clue */
     *nread = 0;
@@ -1193,6 +1226,12 @@ int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
         return EBADF;
     }
 
+    size_t count;
+    int ret = iov_total_length(iov, iovcnt, &count);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
     /* TODO: is it safe to assume that off_t is bigger than size_t? */
     /* check that we don't overflow the file length */
     if (unifyfs_would_overflow_offt(pos, (off_t) count)) {
@@ -1209,33 +1248,55 @@ int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
     /* sync data for file before reading, if needed */
     unifyfs_fid_sync_extents(posix_client, fid);
 
-    /* fill in read request */
-    read_req_t req;
-    req.gfid    = unifyfs_gfid_from_fid(posix_client, fid);
-    req.offset  = (size_t) pos;
-    req.length  = count;
-    req.nread   = 0;
-    req.errcode = 0;
-    req.buf     = buf;
-    req.aiocbp  = NULL;
-    req.cover_begin_offset = (size_t)-1;
-    req.cover_end_offset   = (size_t)-1;
-
-    /* execute read operation */
-    int ret = process_gfid_reads(posix_client, &req, 1);
-    if (ret != UNIFYFS_SUCCESS) {
-        /* failed to issue read operation */
-        return ret;
-    } else if ((req.errcode != UNIFYFS_SUCCESS) &&
-               (req.errcode != ENODATA)) {
-        /* read executed, but failed */
-        return req.errcode;
+    /* fill in a read request for each non-empty buffer */
+    read_req_t* reqs = (read_req_t*) calloc(iovcnt, sizeof(read_req_t));
+    if (NULL == reqs) {
+        return ENOMEM;
     }
+    int gfid = unifyfs_gfid_from_fid(posix_client, fid);
+    int num_reqs = 0;
+    size_t offset = (size_t) pos;
+    for (int i = 0; i < iovcnt; i++) {
+        if (0 == iov[i].iov_len) {
+            continue;
+        }
+        read_req_t* req = &reqs[num_reqs++];
+        req->gfid    = gfid;
+        req->offset  = offset;
+        req->length  = iov[i].iov_len;
+        req->nread   = 0;
+        req->errcode = 0;
+        req->buf     = (char*) iov[i].iov_base;
+        req->aiocbp  = NULL;
+        req->cover_begin_offset = (size_t)-1;
+        req->cover_end_offset   = (size_t)-1;
+        offset += iov[i].iov_len;
+    }
+
+    /* execute read operations */
+    ret = process_gfid_reads(posix_client, reqs, num_reqs);
+    if (ret == UNIFYFS_SUCCESS) {
+        /* bytes read are those up to the first short read */
+        for (int i = 0; i < num_reqs; i++) {
+            read_req_t* req = &reqs[i];
+            if ((req->errcode != UNIFYFS_SUCCESS) &&
+                (req->errcode != ENODATA)) {
+                /* read executed, but failed */
+                ret = req->errcode;
+                break;
+            }
+            *nread += req->nread;
+            if (req->nread < req->length) {
+                break;
+            }
+        }
+    }
+    free(reqs);
 
-    /* success, get number of bytes read from read request field */
-    *nread = req.nread;
-
-    return UNIFYFS_SUCCESS;
+    if (ret != UNIFYFS_SUCCESS) {
+        *nread = 0;
+    }
+    return ret;
 }
 
 /*
@@ -1246,6 +1307,19 @@ int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
  */
 int unifyfs_fd_write(int fd, off_t pos, const void* buf, size_t count,
                      size_t* nwritten)
+{
+    struct iovec iov;
+    iov.iov_base = (void*) buf;
+    iov.iov_len  = count;
+    return unifyfs_fd_writev(fd, pos, &iov, 1, nwritten);
+}
+
+/*
+ * Write the buffers of an I/O vector into file starting at offset 'pos',
+ * as a single write.
+ */
+int unifyfs_fd_writev(int fd, off_t pos, const struct iovec* iov,
+                      int iovcnt, size_t* nwritten)
 {
     /* assume we'll fail, set bytes written to 0 as a clue */
     *nwritten = 0;
@@ -1267,6 +1341,12 @@ int unifyfs_fd_write(int fd, off_t pos, const void* buf, size_t count,
         return EBADF;
     }
 
+    size_t count;
+    int ret = iov_total_length(iov, iovcnt, &count);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
     /* TODO: is it safe to assume that off_t is bigger than size_t? */
     /* check that our write won't overflow the length */
     if (unifyfs_would_overflow_offt(pos, (off_t) count)) {
@@ -1275,8 +1355,8 @@ int unifyfs_fd_write(int fd, off_t pos, const void* buf, size_t count,
     }
 
     /* finally write specified data to file */
-    int write_rc = unifyfs_fid_write(posix_client, fid, pos,
-                                     buf, count, nwritten);
+    int write_rc = unifyfs_fid_writev(posix_client, fid, pos,
+                                      iov, iovcnt, nwritten);
     return write_rc;
 }
 
@@ -1736,36 +1816,58 @@ int UNIFYFS_WRAP(posix_fadvise)(int fd, off_t offset, off_t len, int advice)
             return errno;
         }
 
+        if ((offset < 0) || (len < 0)) {
+            /* this function returns the errno itself, not -1 */
+            errno = EINVAL;
+            return errno;
+        }
+
         /* process advice from caller */
+        int rc = UNIFYFS_SUCCESS;
         switch (advice) {
         case POSIX_FADV_NORMAL:
-        case POSIX_FADV_SEQUENTIAL:
-        /* can use this hint for a better compression strategy */
         case POSIX_FADV_RANDOM:
         case POSIX_FADV_NOREUSE:
+            break;
+        case POSIX_FADV_SEQUENTIAL:
+            /* read ahead the parts of the file in local write logs */
+            rc = unifyfs_fid_advise(posix_client, fid, offset, len,
+                                    LOGIO_ADVICE_SEQUENTIAL);
+            break;
         case POSIX_FADV_WILLNEED:
-        /* with the spill-over case, we can use this hint to
-         * to better manage the in-memory parts of a file. On
-         * getting this advice, move the chunks that are on the
-         * spill-over device to the in-memory portion
-         */
+            /* with the spill-over case, we can use this hint to
+             * to better manage the in-memory parts of a file. On
+             * getting this advice, move the chunks that are on the
+             * spill-over device to the in-memory portion */
+            rc = unifyfs_fid_migrate(posix_client, fid, offset, len, 1);
+            if (rc == ENOSPC) {
+                /* shmem is full, leave the data in the spill-over file */
+                rc = UNIFYFS_SUCCESS;
+            }
+            unifyfs_fid_advise(posix_client, fid, offset, len,
+                               LOGIO_ADVICE_WILLNEED);
+            break;
         case POSIX_FADV_DONTNEED:
             /* similar to the previous case, but move contents from memory
-             * to the spill-over device instead.
-             */
-
-            /* ERROR: fn not yet supported */
-            fprintf(stderr, "Function not yet supported @ %s:%d\n",
-                    __FILE__, __LINE__);
-            errno = ENOTSUP;
-            return errno;
+             * to the spill-over device instead */
+            rc = unifyfs_fid_migrate(posix_client, fid, offset, len, 0);
+            if (rc == ENOSPC) {
+                rc = UNIFYFS_SUCCESS;
+            }
+            unifyfs_fid_advise(posix_client, fid, offset, len,
+                               LOGIO_ADVICE_DONTNEED);
+            break;
         default:
             /* this function returns the errno itself, not -1 */
             errno = EINVAL;
             return errno;
         }
 
-        /* just a hint so return success even if we don't do anything */
+        /* just a hint, so log any error but return success */
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("posix_fadvise(advice=%d) failed for fid=%d - %s",
+                   advice, fid, unifyfs_rc_enum_description(rc));
+        }
         return 0;
     } else {
         MAP_OR_FAIL(posix_fadvise);
@@ -1868,179 +1970,392 @@ ssize_t UNIFYFS_WRAP(write)(int fd, const void* buf, size_t count)
 
 ssize_t UNIFYFS_WRAP(readv)(int fd, const struct iovec* iov, int iovcnt)
 {
-    ssize_t ret;
-
     /* check whether we should intercept this file descriptor */
-    int origfd = fd;
     if (unifyfs_intercept_fd(&fd)) {
-        ssize_t rret;
-        int i;
-        ret = 0;
-        for (i = 0; i < iovcnt; i++) {
-            rret = UNIFYFS_WRAP(read)(origfd, (void*)iov[i].iov_base,
-                iov[i].iov_len);
-            if (-1 == rret) {
-                return -1;
-            } else if (0 == rret) {
-                return ret;
-            } else {
-                ret += rret;
-            }
+        /* get pointer to file descriptor structure */
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if (filedesc == NULL) {
+            /* ERROR: invalid file descriptor */
+            errno = EBADF;
+            return (ssize_t)(-1);
+        }
+
+        /* execute read */
+        size_t bytes;
+        int read_rc = unifyfs_fd_readv(fd, filedesc->pos, iov, iovcnt,
+                                       &bytes);
+        if (read_rc != UNIFYFS_SUCCESS) {
+            /* read operation failed */
+            errno = unifyfs_rc_errno(read_rc);
+            return (ssize_t)(-1);
         }
+
+        /* success, update position */
+        filedesc->pos += (off_t) bytes;
+
+        /* return number of bytes read */
         errno = 0;
-        return ret;
+        return (ssize_t) bytes;
     } else {
         MAP_OR_FAIL(readv);
-        ret = UNIFYFS_REAL(readv)(fd, iov, iovcnt);
+        ssize_t ret = UNIFYFS_REAL(readv)(fd, iov, iovcnt);
         return ret;
     }
 }
 
 ssize_t UNIFYFS_WRAP(writev)(int fd, const struct iovec* iov, int iovcnt)
 {
-    ssize_t ret;
+    /* check whether we should intercept this file descriptor */
+    if (unifyfs_intercept_fd(&fd)) {
+        /* get pointer to file descriptor structure */
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if (filedesc == NULL) {
+            /* ERROR: invalid file descriptor */
+            errno = EBADF;
+            return (ssize_t)(-1);
+        }
+
+        /* compute starting position to write within file,
+         * assume at current position on file descriptor */
+        off_t pos = filedesc->pos;
+        if (filedesc->append) {
+            /* With O_APPEND we always write to the end */
+            int fid = unifyfs_get_fid_from_fd(fd);
+            pos = unifyfs_fid_logical_size(posix_client, fid);
+        }
+
+        /* write data to file */
+        size_t bytes;
+        int write_rc = unifyfs_fd_writev(fd, pos, iov, iovcnt, &bytes);
+        if (write_rc != UNIFYFS_SUCCESS) {
+            /* write failed */
+            errno = unifyfs_rc_errno(write_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* update file position */
+        filedesc->pos = pos + bytes;
+
+        /* return number of bytes written */
+        errno = 0;
+        return (ssize_t) bytes;
+    } else {
+        MAP_OR_FAIL(writev);
+        ssize_t ret = UNIFYFS_REAL(writev)(fd, iov, iovcnt);
+        return ret;
+    }
+}
+
+ssize_t UNIFYFS_WRAP(preadv)(int fd, const struct iovec* iov, int iovcnt,
+                             off_t offset)
+{
+    /* equivalent to readv(), except that it shall read from a given
+     * position in the file without changing the file pointer */
 
     /* check whether we should intercept this file descriptor */
-    int origfd = fd;
     if (unifyfs_intercept_fd(&fd)) {
-        ssize_t wret;
-        int i;
-        ret = 0;
-        for (i = 0; i < iovcnt; i++) {
-            wret = UNIFYFS_WRAP(write)(origfd, (const void*)iov[i].iov_base,
-                iov[i].iov_len);
-            if (-1 == wret) {
-                return -1;
-            } else {
-                ret += wret;
-                if ((size_t)wret != iov[i].iov_len) {
-                    return ret;
-                }
-            }
+        if (offset < 0) {
+            errno = EINVAL;
+            return (ssize_t)(-1);
+        }
+
+        /* execute read */
+        size_t bytes;
+        int read_rc = unifyfs_fd_readv(fd, offset, iov, iovcnt, &bytes);
+        if (read_rc != UNIFYFS_SUCCESS) {
+            /* read operation failed */
+            errno = unifyfs_rc_errno(read_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* return number of bytes read */
+        errno = 0;
+        return (ssize_t) bytes;
+    } else {
+        MAP_OR_FAIL(preadv);
+        ssize_t ret = UNIFYFS_REAL(preadv)(fd, iov, iovcnt, offset);
+        return ret;
+    }
+}
+
+ssize_t UNIFYFS_WRAP(pwritev)(int fd, const struct iovec* iov, int iovcnt,
+                              off_t offset)
+{
+    /* equivalent to writev(), except that it writes into a given
+     * position without changing the file pointer */
+
+    /* check whether we should intercept this file descriptor */
+    if (unifyfs_intercept_fd(&fd)) {
+        if (offset < 0) {
+            errno = EINVAL;
+            return (ssize_t)(-1);
         }
+
+        /* write data to file */
+        size_t bytes;
+        int write_rc = unifyfs_fd_writev(fd, offset, iov, iovcnt, &bytes);
+        if (write_rc != UNIFYFS_SUCCESS) {
+            /* write failed */
+            errno = unifyfs_rc_errno(write_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* return number of bytes written */
         errno = 0;
+        return (ssize_t) bytes;
+    } else {
+        MAP_OR_FAIL(pwritev);
+        ssize_t ret = UNIFYFS_REAL(pwritev)(fd, iov, iovcnt, offset);
         return ret;
+    }
+}
+
+#ifdef HAVE_PREADV2
+ssize_t UNIFYFS_WRAP(preadv2)(int fd, const struct iovec* iov, int iovcnt,
+                              off_t offset, int flags)
+{
+    /* check whether we should intercept this file descriptor */
+    int origfd = fd;
+    if (unifyfs_intercept_fd(&fd)) {
+        /* the RWF_* flags are only hints for reads, so we ignore them */
+        LOGDBG("preadv2 flags=0x%x", flags);
+
+        /* an offset of -1 means to read at the current file position */
+        if (-1 == offset) {
+            return UNIFYFS_WRAP(readv)(origfd, iov, iovcnt);
+        }
+        return UNIFYFS_WRAP(preadv)(origfd, iov, iovcnt, offset);
     } else {
-        MAP_OR_FAIL(writev);
-        ret = UNIFYFS_REAL(writev)(fd, iov, iovcnt);
+        MAP_OR_FAIL(preadv2);
+        ssize_t ret = UNIFYFS_REAL(preadv2)(fd, iov, iovcnt, offset, flags);
         return ret;
     }
 }
+#endif
 
 #ifdef HAVE_LIO_LISTIO
+/* Asynchronous I/O on UnifyFS files is serviced by the client AIO engine
+ * (see unifyfs-aio.c), which executes requests on a background thread and
+ * updates the aiocb status on completion. Requests for other files are
+ * passed to the system AIO library. */
+
+/* returns 1 if the aiocb refers to a UnifyFS file */
+static int aio_intercept_cb(const struct aiocb* cbp)
+{
+    int fd = cbp->aio_fildes;
+    return unifyfs_intercept_fd(&fd);
+}
+
+int UNIFYFS_WRAP(aio_read)(struct aiocb* cbp)
+{
+    if (aio_intercept_cb(cbp)) {
+        int rc = unifyfs_aio_submit(cbp, UNIFYFS_AIO_READ, NULL);
+        if (rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(rc);
+            return -1;
+        }
+        errno = 0;
+        return 0;
+    } else {
+        MAP_OR_FAIL(aio_read);
+        int ret = UNIFYFS_REAL(aio_read)(cbp);
+        return ret;
+    }
+}
+
+int UNIFYFS_WRAP(aio_write)(struct aiocb* cbp)
+{
+    if (aio_intercept_cb(cbp)) {
+        int rc = unifyfs_aio_submit(cbp, UNIFYFS_AIO_WRITE, NULL);
+        if (rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(rc);
+            return -1;
+        }
+        errno = 0;
+        return 0;
+    } else {
+        MAP_OR_FAIL(aio_write);
+        int ret = UNIFYFS_REAL(aio_write)(cbp);
+        return ret;
+    }
+}
+
+int UNIFYFS_WRAP(aio_fsync)(int op, struct aiocb* cbp)
+{
+    if (aio_intercept_cb(cbp)) {
+        unifyfs_aio_op_e aio_op;
+        if (O_SYNC == op) {
+            aio_op = UNIFYFS_AIO_FSYNC;
+        } else if (O_DSYNC == op) {
+            aio_op = UNIFYFS_AIO_FDATASYNC;
+        } else {
+            errno = EINVAL;
+            return -1;
+        }
+        int rc = unifyfs_aio_submit(cbp, aio_op, NULL);
+        if (rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(rc);
+            return -1;
+        }
+        errno = 0;
+        return 0;
+    } else {
+        MAP_OR_FAIL(aio_fsync);
+        int ret = UNIFYFS_REAL(aio_fsync)(op, cbp);
+        return ret;
+    }
+}
+
+int UNIFYFS_WRAP(aio_error)(const struct aiocb* cbp)
+{
+    if (aio_intercept_cb(cbp)) {
+        return unifyfs_aio_error(cbp);
+    } else {
+        MAP_OR_FAIL(aio_error);
+        int ret = UNIFYFS_REAL(aio_error)(cbp);
+        return ret;
+    }
+}
+
+ssize_t UNIFYFS_WRAP(aio_return)(struct aiocb* cbp)
+{
+    if (aio_intercept_cb(cbp)) {
+        return unifyfs_aio_return(cbp);
+    } else {
+        MAP_OR_FAIL(aio_return);
+        ssize_t ret = UNIFYFS_REAL(aio_return)(cbp);
+        return ret;
+    }
+}
+
+int UNIFYFS_WRAP(aio_suspend)(const struct aiocb* const list[], int nent,
+                              const struct timespec* timeout)
+{
+    /* the engine waits on lists with any UnifyFS requests, polling for
+     * requests it doesn't service */
+    int i;
+    int intercept = 0;
+    for (i = 0; i < nent; i++) {
+        if ((NULL != list[i]) && aio_intercept_cb(list[i])) {
+            intercept = 1;
+            break;
+        }
+    }
+
+    if (intercept) {
+        int rc = unifyfs_aio_suspend(list, nent, timeout);
+        if (rc != UNIFYFS_SUCCESS) {
+            errno = rc;
+            return -1;
+        }
+        errno = 0;
+        return 0;
+    } else {
+        MAP_OR_FAIL(aio_suspend);
+        int ret = UNIFYFS_REAL(aio_suspend)(list, nent, timeout);
+        return ret;
+    }
+}
+
+int UNIFYFS_WRAP(aio_cancel)(int fd, struct aiocb* cbp)
+{
+    if ((NULL != cbp) && (cbp->aio_fildes != fd)) {
+        errno = EBADF;
+        return -1;
+    }
+
+    int origfd = fd;
+    if (unifyfs_intercept_fd(&fd)) {
+        return unifyfs_aio_cancel(origfd, cbp);
+    } else {
+        /* lio_listio() may have given the engine requests for
+         * this file, so try canceling those first */
+        int ret = unifyfs_aio_cancel(fd, cbp);
+        if (AIO_ALLDONE != ret) {
+            return ret;
+        }
+        MAP_OR_FAIL(aio_cancel);
+        ret = UNIFYFS_REAL(aio_cancel)(fd, cbp);
+        return ret;
+    }
+}
+
 int UNIFYFS_WRAP(lio_listio)(int mode, struct aiocb* const aiocb_list[],
                              int nitems, struct sigevent* sevp)
 {
-    /* TODO - support for LIO_NOWAIT mode */
-
-    read_req_t* reqs = calloc(nitems, sizeof(read_req_t));
-    if (NULL == reqs) {
-        errno = ENOMEM; // EAGAIN?
+    if (((mode != LIO_WAIT) && (mode != LIO_NOWAIT)) || (nitems < 0)) {
+        errno = EINVAL;
         return -1;
     }
 
-    int ret = 0;
-    int reqcnt = 0;
-    int i, fd, fid, ndx, rc;
-    struct aiocb* cbp;
+    /* pass lists without any UnifyFS requests to the system library */
+    int i;
+    int intercept = 0;
+    for (i = 0; i < nitems; i++) {
+        struct aiocb* cbp = aiocb_list[i];
+        if ((NULL != cbp) && (cbp->aio_lio_opcode != LIO_NOP) &&
+            aio_intercept_cb(cbp)) {
+            intercept = 1;
+            break;
+        }
+    }
+    if (!intercept) {
+        MAP_OR_FAIL(lio_listio);
+        int ret = UNIFYFS_REAL(lio_listio)(mode, aiocb_list, nitems, sevp);
+        return ret;
+    }
+
+    /* the engine services every request of the list, including any
+     * for other files, so that it can track completion of the list */
+    unifyfs_aio_list* list =
+        unifyfs_aio_list_create((LIO_NOWAIT == mode) ? sevp : NULL);
+    if (NULL == list) {
+        errno = EAGAIN;
+        return -1;
+    }
 
+    int submit_failed = 0;
     for (i = 0; i < nitems; i++) {
-        cbp = aiocb_list[i];
-        fd = cbp->aio_fildes;
+        struct aiocb* cbp = aiocb_list[i];
+        if (NULL == cbp) {
+            continue;
+        }
 
         /* LOGDBG("aiocb(fd=%d, op=%d, count=%zu, offset=%zu, buf=%p)",
          *      cbp->aio_fildes, cbp->aio_lio_opcode, cbp->aio_nbytes,
          *      cbp->aio_offset, cbp->aio_buf); */
 
+        unifyfs_aio_op_e op;
         switch (cbp->aio_lio_opcode) {
-        case LIO_WRITE: {
-            ssize_t wret;
-            wret = UNIFYFS_WRAP(pwrite)(fd, (const void*)cbp->aio_buf,
-                                        cbp->aio_nbytes, cbp->aio_offset);
-            if (-1 == wret) {
-                AIOCB_ERROR_CODE(cbp) = errno;
-            } else {
-                AIOCB_ERROR_CODE(cbp) = 0;
-                AIOCB_RETURN_VAL(cbp) = wret;
-            }
+        case LIO_READ:
+            op = UNIFYFS_AIO_READ;
             break;
-        }
-        case LIO_READ: {
-            if (unifyfs_intercept_fd(&fd)) {
-                /* get local file id for this request */
-                fid = unifyfs_get_fid_from_fd(fd);
-                if (fid < 0) {
-                    AIOCB_ERROR_CODE(cbp) = EINVAL;
-                } else {
-                    /* TODO: handle error if sync fails? */
-                    /* sync data for file before reading, if needed */
-                    unifyfs_fid_sync_extents(posix_client, fid);
-
-                    /* define read request for this file */
-                    reqs[reqcnt].gfid    = unifyfs_gfid_from_fid(posix_client,
-                                                                 fid);
-                    reqs[reqcnt].offset  = (size_t)(cbp->aio_offset);
-                    reqs[reqcnt].length  = cbp->aio_nbytes;
-                    reqs[reqcnt].nread   = 0;
-                    reqs[reqcnt].errcode = 0;
-                    reqs[reqcnt].buf     = (char*)(cbp->aio_buf);
-                    reqs[reqcnt].aiocbp  = cbp;
-                    reqs[reqcnt].cover_begin_offset = (size_t)-1;
-                    reqs[reqcnt].cover_end_offset   = (size_t)-1;
-                    reqcnt++;
-                }
-            } else {
-                ssize_t rret;
-                rret = UNIFYFS_WRAP(pread)(fd, (void*)cbp->aio_buf,
-                                           cbp->aio_nbytes, cbp->aio_offset);
-                if (-1 == rret) {
-                    AIOCB_ERROR_CODE(cbp) = errno;
-                } else {
-                    AIOCB_ERROR_CODE(cbp) = 0;
-                    AIOCB_RETURN_VAL(cbp) = rret;
-                }
-            }
+        case LIO_WRITE:
+            op = UNIFYFS_AIO_WRITE;
             break;
-        }
         default: // LIO_NOP
-            LOGDBG("lio_vec[%d] - unexpected LIO op %d",
-                   i, cbp->aio_lio_opcode);
-            break;
+            continue;
         }
-    }
 
-    if (reqcnt) {
-        rc = process_gfid_reads(posix_client, reqs, reqcnt);
+        int rc = unifyfs_aio_submit(cbp, op, list);
         if (rc != UNIFYFS_SUCCESS) {
-            /* error reading data */
-            ret = rc;
-        }
-
-        /* update aiocb fields to record error status and return value */
-        for (i = 0; i < reqcnt; i++) {
-            for (ndx = 0; ndx < nitems; ndx++) {
-                cbp = aiocb_list[ndx];
-                if (cbp == reqs[i].aiocbp) {
-                    AIOCB_ERROR_CODE(cbp) =
-                        unifyfs_rc_errno((unifyfs_rc)(reqs[i].errcode));
-                    if (0 == reqs[i].errcode) {
-                        AIOCB_RETURN_VAL(cbp) = reqs[i].length;
-                    }
-                    break; // continue outer loop
-                }
-            }
+            LOGDBG("lio_vec[%d] - failed to queue request - %s",
+                   i, strerror(unifyfs_rc_errno(rc)));
+            AIOCB_RETURN_VAL(cbp) = -1;
+            AIOCB_ERROR_CODE(cbp) = unifyfs_rc_errno(rc);
+            submit_failed = 1;
         }
     }
 
-    free(reqs);
-
-    if (ret) {
-        errno = unifyfs_rc_errno(ret);
-        ret = -1;
-    } else {
-        errno = 0;
+    /* with LIO_WAIT, this returns once all requests have completed */
+    int rc = unifyfs_aio_list_finish(list, (LIO_WAIT == mode));
+    if (submit_failed || (rc != UNIFYFS_SUCCESS)) {
+        errno = EIO;
+        return -1;
     }
-    return ret;
+
+    errno = 0;
+    return 0;
 }
 #endif
 
@@ -2327,21 +2642,199 @@ int UNIFYFS_WRAP(flock)(int fd, int operation)
     }
 }
 
-/* TODO: handle different flags */
+/* Regions returned by mmap() for UnifyFS files. These are tracked so that
+ * msync() and munmap() can recognize them. The leading pages of a region
+ * may be mapped directly from a client write log, the log chunks holding
+ * that data are pinned until those pages are unmapped. */
+typedef struct posix_mapping {
+    void* addr;                 /* start address of mapped region */
+    size_t length;              /* length of mapped region */
+    int gfid;                   /* global file id of mapped file */
+    logio_context* logio;       /* log of directly mapped data, or NULL */
+    off_t log_offset;           /* log offset of directly mapped data */
+    size_t direct_len;          /* bytes at addr mapped from the log */
+    struct posix_mapping* next;
+} posix_mapping;
+
+static posix_mapping* posix_mappings; /* list of active mappings */
+static pthread_mutex_t posix_mapping_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int posix_track_mapping(void* addr, size_t length, int gfid,
+                               logio_context* logio, off_t log_offset,
+                               size_t direct_len)
+{
+    posix_mapping* map = (posix_mapping*) malloc(sizeof(posix_mapping));
+    if (NULL == map) {
+        return ENOMEM;
+    }
+    map->addr = addr;
+    map->length = length;
+    map->gfid = gfid;
+    map->logio = logio;
+    map->log_offset = log_offset;
+    map->direct_len = direct_len;
+
+    pthread_mutex_lock(&posix_mapping_mutex);
+    map->next = posix_mappings;
+    posix_mappings = map;
+    pthread_mutex_unlock(&posix_mapping_mutex);
+    return UNIFYFS_SUCCESS;
+}
+
+/* track the part [start, end) of a mapping that remains after the rest
+ * was unmapped, pinning the log data it still maps directly
+ * (note: caller must hold posix_mapping_mutex) */
+static void posix_keep_mapping_part(posix_mapping* map,
+                                    char* start,
+                                    char* end)
+{
+    posix_mapping* part = (posix_mapping*) malloc(sizeof(posix_mapping));
+    if (NULL == part) {
+        LOGERR("failed to track remaining part of mapping");
+        return;
+    }
+    *part = *map;
+    part->addr = start;
+    part->length = (size_t)(end - start);
+    part->logio = NULL;
+    part->log_offset = 0;
+    part->direct_len = 0;
+
+    char* direct_end = (char*)map->addr + map->direct_len;
+    if ((NULL != map->logio) && (start < direct_end)) {
+        char* part_direct_end = (end < direct_end) ? end : direct_end;
+        size_t skip = (size_t)(start - (char*)map->addr);
+        part->log_offset = map->log_offset + (off_t)skip;
+        part->direct_len = (size_t)(part_direct_end - start);
+        if (unifyfs_logio_pin(map->logio, part->log_offset,
+                              part->direct_len) == UNIFYFS_SUCCESS) {
+            part->logio = map->logio;
+        } else {
+            part->direct_len = 0;
+        }
+    }
+
+    part->next = posix_mappings;
+    posix_mappings = part;
+}
+
+/* stop tracking the given region. Mappings that only partly overlap the
+ * region are trimmed or split, so the parts still mapped stay tracked */
+static void posix_untrack_mappings(void* addr, size_t length)
+{
+    char* start = (char*) addr;
+    char* end = start + length;
+
+    pthread_mutex_lock(&posix_mapping_mutex);
+    posix_mapping** prev = &posix_mappings;
+    posix_mapping* map = posix_mappings;
+    posix_mapping* overlaps = NULL;
+    while (NULL != map) {
+        char* map_start = (char*) map->addr;
+        char* map_end = map_start + map->length;
+        if ((map_start < end) && (start < map_end)) {
+            /* move overlapping mapping to a separate list */
+            *prev = map->next;
+            map->next = overlaps;
+            overlaps = map;
+        } else {
+            prev = &(map->next);
+        }
+        map = *prev;
+    }
+
+    while (NULL != overlaps) {
+        map = overlaps;
+        overlaps = map->next;
+
+        char* map_start = (char*) map->addr;
+        char* map_end = map_start + map->length;
+        if (map_start < start) {
+            posix_keep_mapping_part(map, map_start, start);
+        }
+        if (end < map_end) {
+            posix_keep_mapping_part(map, end, map_end);
+        }
+        if (NULL != map->logio) {
+            unifyfs_logio_unpin(map->logio, map->log_offset,
+                                map->direct_len);
+        }
+        free(map);
+    }
+    pthread_mutex_unlock(&posix_mapping_mutex);
+}
+
+/* returns 1 if the given region lies within a tracked mapping */
+static int posix_is_mapped(void* addr, size_t length)
+{
+    char* start = (char*) addr;
+    char* end = start + length;
+    int found = 0;
+
+    pthread_mutex_lock(&posix_mapping_mutex);
+    posix_mapping* map;
+    for (map = posix_mappings; NULL != map; map = map->next) {
+        char* map_start = (char*) map->addr;
+        char* map_end = map_start + map->length;
+        if ((start >= map_start) && (end <= map_end)) {
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&posix_mapping_mutex);
+    return found;
+}
+
+/* When a single local extent holds all the requested file data, map the
+ * data at addr straight from the write log of the client (ourself or a
+ * peer on this node) that wrote it. The log chunks are pinned, so the
+ * data stays in place even if the file is unlinked while mapped. */
+static int mmap_local_extent(int fid, off_t offset, size_t length, int prot,
+                             void* addr, logio_context** logio,
+                             off_t* log_offset)
+{
+    if (!posix_client->use_local_extents &&
+        !posix_client->use_node_local_extents) {
+        return ENOTSUP;
+    }
+
+    unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(posix_client, fid);
+    if (NULL == meta) {
+        return EINVAL;
+    }
+
+    int rc = ENOTSUP;
+    size_t start = (size_t) offset;
+    size_t end = start + length - 1;
+    struct seg_tree* extents = &meta->extents;
+    seg_tree_rdlock(extents);
+    struct seg_tree_node* node = seg_tree_find_nolock(extents, start, start);
+    if ((NULL != node) && (node->start <= start) && (node->end >= end)) {
+        off_t log_off = (off_t)(node->ptr + (start - node->start));
+        logio_context* logio_ctx =
+            client_get_peer_logio(posix_client, node->client_id);
+        if (NULL != logio_ctx) {
+            void* map = addr;
+            rc = unifyfs_logio_map(logio_ctx, log_off, length, prot, &map);
+            if (rc == UNIFYFS_SUCCESS) {
+                *logio = logio_ctx;
+                *log_offset = log_off;
+            }
+        }
+    }
+    seg_tree_unlock(extents);
+    return rc;
+}
+
+/* Laminated files may be mapped for reading (or as private copies). Whole
+ * pages of file data are mapped directly from a client write log when
+ * possible, everything else (including a partial last page) is read into
+ * anonymous memory at map time. */
 void* UNIFYFS_WRAP(mmap)(void* addr, size_t length, int prot, int flags,
                          int fd, off_t offset)
 {
     /* check whether we should intercept this file descriptor */
     if (unifyfs_intercept_fd(&fd)) {
-        /* for now, tell user that we can't support mmap,
-         * we'll need to track assigned memory region so that
-         * we can identify our files on msync and munmap */
-        fprintf(stderr, "Function not yet supported @ %s:%d\n",
-                __FILE__, __LINE__);
-        errno = ENODEV;
-        return MAP_FAILED;
-
-#if 0 // TODO - mmap support
         /* get the file id for this file descriptor */
         int fid = unifyfs_get_fid_from_fd(fd);
         if (fid < 0) {
@@ -2349,48 +2842,109 @@ void* UNIFYFS_WRAP(mmap)(void* addr, size_t length, int prot, int flags,
             return MAP_FAILED;
         }
 
-        /* TODO: handle addr properly based on flags */
+        /* file must be open for reading */
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if ((NULL == filedesc) || !filedesc->read) {
+            errno = EACCES;
+            return MAP_FAILED;
+        }
 
-        /* allocate memory required to mmap the data if addr is NULL;
-         * using posix_memalign instead of malloc to align mmap'ed area
-         * to page size */
-        if (!addr) {
-            int ret = posix_memalign(&addr, sysconf(_SC_PAGE_SIZE), length);
-            if (ret) {
-                /* posix_memalign does not set errno */
-                if (ret == EINVAL) {
-                    errno = EINVAL;
-                    return MAP_FAILED;
-                }
+        /* only laminated files have contents that can't change underneath
+         * the mapping, and changes can't be written back through it */
+        if (!unifyfs_fid_is_laminated(posix_client, fid)) {
+            LOGDBG("mmap() of non-laminated file not supported");
+            errno = ENODEV;
+            return MAP_FAILED;
+        }
+        if ((flags & MAP_SHARED) && (prot & PROT_WRITE)) {
+            errno = EACCES;
+            return MAP_FAILED;
+        }
 
-                if (ret == ENOMEM) {
-                    errno = ENOMEM;
-                    return MAP_FAILED;
-                }
-            }
+        size_t page_size = (size_t) sysconf(_SC_PAGE_SIZE);
+        if ((0 == length) || (offset < 0) || (offset % page_size)) {
+            errno = EINVAL;
+            return MAP_FAILED;
         }
 
-        /* TODO: do we need to extend file if offset+length goes past current end? */
+        int gfid = unifyfs_gfid_from_fid(posix_client, fid);
+        off_t file_size = unifyfs_fid_global_size(posix_client, fid);
+
+        /* reserve the region with anonymous memory, so bytes past the end
+         * of the file read as zeros */
+        MAP_OR_FAIL(mmap);
+        int map_flags = MAP_PRIVATE | MAP_ANONYMOUS | (flags & MAP_FIXED);
+        void* map = UNIFYFS_REAL(mmap)(addr, length, (PROT_READ | PROT_WRITE),
+                                       map_flags, -1, 0);
+        if (MAP_FAILED == map) {
+            return MAP_FAILED;
+        }
 
-        /* check that we don't copy past the end of the file */
-        off_t last_byte = offset + length;
-        off_t file_size = unifyfs_fid_size(fid);
-        if (last_byte > file_size) {
-            /* trying to copy past the end of the file, so
-             * adjust the total amount to be copied */
-            length = (size_t)(file_size - offset);
+        /* try to map the whole pages of file data in place. a partial
+         * last page is always copied, since the rest of that page in the
+         * log holds unrelated data */
+        size_t direct_len = 0;
+        logio_context* logio = NULL;
+        off_t log_offset = 0;
+        if (!(prot & PROT_WRITE) && (offset < file_size)) {
+            size_t avail = (size_t)(file_size - offset);
+            direct_len = (avail < length) ? avail : length;
+            direct_len -= (direct_len % page_size);
+            if ((direct_len > 0) &&
+                (mmap_local_extent(fid, offset, direct_len, prot, map,
+                                   &logio, &log_offset) != UNIFYFS_SUCCESS)) {
+                direct_len = 0;
+            }
         }
 
-        /* read data from file */
-        int rc = unifyfs_fid_read(fid, offset, addr, length);
+        /* copy the remaining file data into anonymous memory */
+        int rc = UNIFYFS_SUCCESS;
+        off_t copy_offset = offset + (off_t)direct_len;
+        if (copy_offset < file_size) {
+            size_t count = length - direct_len;
+            if ((offset + (off_t)length) > file_size) {
+                count = (size_t)(file_size - copy_offset);
+            }
+
+            read_req_t req;
+            req.gfid    = gfid;
+            req.offset  = copy_offset;
+            req.length  = count;
+            req.nread   = 0;
+            req.errcode = 0;
+            req.buf     = (char*)map + direct_len;
+            req.aiocbp  = NULL;
+            req.cover_begin_offset = (size_t)-1;
+            req.cover_end_offset   = (size_t)-1;
+
+            rc = process_gfid_reads(posix_client, &req, 1);
+            if (rc == UNIFYFS_SUCCESS) {
+                rc = req.errcode;
+            }
+        }
+        if ((rc == UNIFYFS_SUCCESS) && (direct_len < length) &&
+            (prot != (PROT_READ | PROT_WRITE))) {
+            if (mprotect((char*)map + direct_len, length - direct_len,
+                         prot) != 0) {
+                rc = errno;
+            }
+        }
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = posix_track_mapping(map, length, gfid,
+                                     logio, log_offset, direct_len);
+        }
         if (rc != UNIFYFS_SUCCESS) {
-            /* TODO: need to free memory in this case? */
-            errno = ENOMEM;
+            LOGERR("failed to fill mapping of gfid=%d (off=%zu, len=%zu)",
+                   gfid, (size_t)offset, length);
+            MAP_OR_FAIL(munmap);
+            UNIFYFS_REAL(munmap)(map, length);
+            if (NULL != logio) {
+                unifyfs_logio_unpin(logio, log_offset, direct_len);
+            }
+            errno = unifyfs_rc_errno(rc);
             return MAP_FAILED;
         }
-
-        return addr;
-#endif
+        return map;
     } else {
         MAP_OR_FAIL(mmap);
         void* ret = UNIFYFS_REAL(mmap)(addr, length, prot, flags, fd, offset);
@@ -2400,25 +2954,28 @@ void* UNIFYFS_WRAP(mmap)(void* addr, size_t length, int prot, int flags,
 
 int UNIFYFS_WRAP(munmap)(void* addr, size_t length)
 {
-#if 0 // TODO - mmap support
-    fprintf(stderr, "Function not yet supported @ %s:%d\n", __FILE__, __LINE__);
-    errno = EINVAL;
-    return -1;
-#endif
     MAP_OR_FAIL(munmap);
     int ret = UNIFYFS_REAL(munmap)(addr, length);
+    if (0 == ret) {
+        /* forget any UnifyFS mappings within the region, once their
+         * pages are gone it is safe to unpin the log data */
+        posix_untrack_mappings(addr, length);
+    }
     return ret;
 }
 
 int UNIFYFS_WRAP(msync)(void* addr, size_t length, int flags)
 {
-#if 0 // TODO - mmap support
-    /* TODO: need to keep track of all the mmaps that are linked to
-     * a given file before this function can be implemented */
-    fprintf(stderr, "Function not yet supported @ %s:%d\n", __FILE__, __LINE__);
-    errno = EINVAL;
-    return -1;
-#endif
+    if (posix_is_mapped(addr, length)) {
+        /* mapped UnifyFS files are laminated, so there are never any
+         * changes to write back */
+        if ((flags & MS_SYNC) && (flags & MS_ASYNC)) {
+            errno = EINVAL;
+            return -1;
+        }
+        return 0;
+    }
+
     MAP_OR_FAIL(msync);
     int ret = UNIFYFS_REAL(msync)(addr, length, flags);
     return ret;
@@ -99,6 +99,14 @@ UNIFYFS_DECL(fdatasync, int, (int fd));
 UNIFYFS_DECL(ftruncate, int, (int fd, off_t length));
 UNIFYFS_DECL(lio_listio, int, (int mode, struct aiocb* const aiocb_list[],
                                int nitems, struct sigevent* sevp));
+UNIFYFS_DECL(aio_read, int, (struct aiocb* cbp));
+UNIFYFS_DECL(aio_write, int, (struct aiocb* cbp));
+UNIFYFS_DECL(aio_fsync, int, (int op, struct aiocb* cbp));
+UNIFYFS_DECL(aio_error, int, (const struct aiocb* cbp));
+UNIFYFS_DECL(aio_return, ssize_t, (struct aiocb* cbp));
+UNIFYFS_DECL(aio_suspend, int, (const struct aiocb* const list[], int nent,
+                                const struct timespec* timeout));
+UNIFYFS_DECL(aio_cancel, int, (int fd, struct aiocb* cbp));
 UNIFYFS_DECL(lseek, off_t, (int fd, off_t offset, int whence));
 UNIFYFS_DECL(lseek64, off64_t, (int fd, off64_t offset, int whence));
 UNIFYFS_DECL(mmap, void*, (void* addr, size_t length, int prot, int flags,
@@ -108,12 +116,20 @@ UNIFYFS_DECL(mmap64, void*, (void* addr, size_t length, int prot, int flags,
 UNIFYFS_DECL(msync, int, (void* addr, size_t length, int flags));
 UNIFYFS_DECL(munmap, int, (void* addr, size_t length));
 UNIFYFS_DECL(pread, ssize_t, (int fd, void* buf, size_t count, off_t offset));
+UNIFYFS_DECL(preadv, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                               off_t offset));
+#ifdef HAVE_PREADV2
+UNIFYFS_DECL(preadv2, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                                off_t offset, int flags));
+#endif
 UNIFYFS_DECL(pread64, ssize_t, (int fd, void* buf, size_t count,
                                 off64_t offset));
 UNIFYFS_DECL(pwrite, ssize_t, (int fd, const void* buf, size_t count,
                                off_t offset));
 UNIFYFS_DECL(pwrite64, ssize_t, (int fd, const void* buf, size_t count,
                                  off64_t offset));
+UNIFYFS_DECL(pwritev, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                                off_t offset));
 UNIFYFS_DECL(read, ssize_t, (int fd, void* buf, size_t count));
 UNIFYFS_DECL(readv, ssize_t, (int fd, const struct iovec* iov, int iovcnt));
 UNIFYFS_DECL(write, ssize_t, (int fd, const void* buf, size_t count));
@@ -146,6 +162,20 @@ int unifyfs_fd_read(
     size_t* nread /* number of bytes read */
 );
 
+/*
+ * Read into the buffers of an I/O vector from file starting at offset
+ * 'pos', using one batch of read requests for all buffers. Returns
+ * UNIFYFS_SUCCESS and sets number of bytes actually read on success.
+ * Otherwise returns error code on error.
+ */
+int unifyfs_fd_readv(
+    int fd,                  /* file descriptor to read from */
+    off_t pos,               /* offset within file to read from */
+    const struct iovec* iov, /* buffers to hold data */
+    int iovcnt,              /* number of buffers */
+    size_t* nread            /* number of bytes read */
+);
+
 /*
  * Write 'count' bytes from 'buf' into file starting at offset 'pos'.
  * Returns UNIFYFS_SUCCESS and sets number of bytes actually written in bytes
@@ -159,4 +189,17 @@ int unifyfs_fd_write(
     size_t* nwritten /* number of bytes written */
 );
 
+/*
+ * Write the buffers of an I/O vector into file starting at offset 'pos',
+ * as a single write. Returns UNIFYFS_SUCCESS and sets number of bytes
+ * actually written on success. Otherwise returns error code on error.
+ */
+int unifyfs_fd_writev(
+    int fd,                  /* file descriptor to write to */
+    off_t pos,               /* offset within file to write to */
+    const struct iovec* iov, /* buffers holding data to write */
+    int iovcnt,              /* number of buffers */
+    size_t* nwritten         /* number of bytes written */
+);
+
 #endif /* UNIFYFS_SYSIO_H */
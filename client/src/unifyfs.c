@@ -57,6 +57,14 @@
 /* list of local clients */
 static arraylist_t* client_list; /* = NULL */
 
+/* cached global file attributes */
+typedef struct unifyfs_attr_cache_entry {
+    int gfid;                  /* key */
+    unifyfs_file_attr_t attr;  /* attributes (owns attr.filename) */
+    struct timespec expire;    /* lease expiration, unused if laminated */
+    UT_hash_handle hh;
+} unifyfs_attr_cache_entry;
+
 
 /* lock access to shared data structures in superblock */
 int unifyfs_stack_lock(unifyfs_client* client)
@@ -130,6 +138,165 @@ int unifyfs_set_global_file_meta(unifyfs_client* client,
     return ret;
 }
 
+/* remove entry from the attribute cache and free it,
+ * assumes caller holds the attr_cache_sync lock */
+static void attr_cache_remove(unifyfs_client* client,
+                              unifyfs_attr_cache_entry* entry)
+{
+    HASH_DEL(client->attr_cache, entry);
+    client->attr_cache_count--;
+    if (NULL != entry->attr.filename) {
+        free(entry->attr.filename);
+    }
+    free(entry);
+}
+
+/* returns 1 if the cached attributes are still valid */
+static int attr_cache_valid(unifyfs_attr_cache_entry* entry)
+{
+    if (entry->attr.is_laminated) {
+        /* laminated attributes never change */
+        return 1;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec < entry->expire.tv_sec) ||
+           ((now.tv_sec == entry->expire.tv_sec) &&
+            (now.tv_nsec < entry->expire.tv_nsec));
+}
+
+/* returns the current attribute cache sequence number, which is
+ * sampled before fetching attributes that may later be inserted */
+static unsigned long attr_cache_seq(unifyfs_client* client)
+{
+    unsigned long seq;
+    pthread_mutex_lock(&(client->attr_cache_sync));
+    seq = client->attr_cache_seq;
+    pthread_mutex_unlock(&(client->attr_cache_sync));
+    return seq;
+}
+
+/* copy attributes into the cache, replacing any existing entry. The
+ * attributes are dropped if any entry was invalidated since seq was
+ * sampled, as they may have been fetched before the invalidation */
+static void attr_cache_insert(unifyfs_client* client,
+                              int gfid,
+                              const unifyfs_file_attr_t* attr,
+                              unsigned long seq)
+{
+    if (!attr->is_laminated && (client->attr_lease_msecs <= 0)) {
+        /* only laminated files are cached */
+        return;
+    }
+
+    unifyfs_attr_cache_entry* entry = malloc(sizeof(*entry));
+    if (NULL == entry) {
+        return;
+    }
+    entry->gfid = gfid;
+    entry->attr = *attr;
+    if (NULL != attr->filename) {
+        entry->attr.filename = strdup(attr->filename);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &(entry->expire));
+    long msecs = client->attr_lease_msecs;
+    entry->expire.tv_sec  += msecs / 1000;
+    entry->expire.tv_nsec += (msecs % 1000) * 1000000L;
+    if (entry->expire.tv_nsec >= 1000000000L) {
+        entry->expire.tv_sec++;
+        entry->expire.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&(client->attr_cache_sync));
+    {
+        if (seq != client->attr_cache_seq) {
+            LOGDBG("dropping stale attributes for gfid=%d", gfid);
+            pthread_mutex_unlock(&(client->attr_cache_sync));
+            if (NULL != entry->attr.filename) {
+                free(entry->attr.filename);
+            }
+            free(entry);
+            return;
+        }
+
+        unifyfs_attr_cache_entry* old = NULL;
+        HASH_FIND_INT(client->attr_cache, &gfid, old);
+        if (NULL != old) {
+            attr_cache_remove(client, old);
+        } else if (client->attr_cache_count >= UNIFYFS_CLIENT_ATTR_CACHE_MAX) {
+            /* evict the oldest entry, which is at the head of the
+             * insertion-ordered hash list */
+            attr_cache_remove(client, client->attr_cache);
+        }
+        HASH_ADD_INT(client->attr_cache, gfid, entry);
+        client->attr_cache_count++;
+    }
+    pthread_mutex_unlock(&(client->attr_cache_sync));
+}
+
+/* look for valid cached attributes, returns 1 and fills attr if found */
+static int attr_cache_lookup(unifyfs_client* client,
+                             int gfid,
+                             unifyfs_file_attr_t* attr)
+{
+    int found = 0;
+    pthread_mutex_lock(&(client->attr_cache_sync));
+    {
+        unifyfs_attr_cache_entry* entry = NULL;
+        HASH_FIND_INT(client->attr_cache, &gfid, entry);
+        if (NULL != entry) {
+            if (attr_cache_valid(entry)) {
+                *attr = entry->attr;
+                if (NULL != entry->attr.filename) {
+                    attr->filename = strdup(entry->attr.filename);
+                }
+                found = 1;
+            } else {
+                /* lease expired */
+                attr_cache_remove(client, entry);
+            }
+        }
+    }
+    pthread_mutex_unlock(&(client->attr_cache_sync));
+    return found;
+}
+
+void unifyfs_attr_cache_invalidate(unifyfs_client* client,
+                                   int gfid)
+{
+    if ((NULL == client) || !client->use_attr_cache) {
+        return;
+    }
+
+    pthread_mutex_lock(&(client->attr_cache_sync));
+    {
+        /* reject inserts of attributes fetched before now */
+        client->attr_cache_seq++;
+
+        unifyfs_attr_cache_entry* entry = NULL;
+        HASH_FIND_INT(client->attr_cache, &gfid, entry);
+        if (NULL != entry) {
+            LOGDBG("invalidating cached attributes for gfid=%d", gfid);
+            attr_cache_remove(client, entry);
+        }
+    }
+    pthread_mutex_unlock(&(client->attr_cache_sync));
+}
+
+/* free all cached attributes */
+static void attr_cache_fini(unifyfs_client* client)
+{
+    pthread_mutex_lock(&(client->attr_cache_sync));
+    {
+        unifyfs_attr_cache_entry* entry;
+        unifyfs_attr_cache_entry* tmp;
+        HASH_ITER(hh, client->attr_cache, entry, tmp) {
+            attr_cache_remove(client, entry);
+        }
+    }
+    pthread_mutex_unlock(&(client->attr_cache_sync));
+}
+
 int unifyfs_get_global_file_meta(unifyfs_client* client,
                                  int gfid,
                                  unifyfs_file_attr_t* gfattr)
@@ -139,12 +306,27 @@ int unifyfs_get_global_file_meta(unifyfs_client* client,
         return UNIFYFS_FAILURE;
     }
 
+    /* avoid the server round trip if we have valid cached attributes */
+    if (client->use_attr_cache &&
+        attr_cache_lookup(client, gfid, gfattr)) {
+        LOGDBG("using cached attributes for gfid=%d", gfid);
+        return UNIFYFS_SUCCESS;
+    }
+
+    unsigned long seq = 0;
+    if (client->use_attr_cache) {
+        seq = attr_cache_seq(client);
+    }
+
     /* attempt to lookup file attributes in key/value store */
     unifyfs_file_attr_t fmeta;
     int ret = invoke_client_metaget_rpc(client, gfid, &fmeta);
     if (ret == UNIFYFS_SUCCESS) {
         /* found it, copy attributes to output struct */
         *gfattr = fmeta;
+        if (client->use_attr_cache) {
+            attr_cache_insert(client, gfid, &fmeta, seq);
+        }
     }
     return ret;
 }
@@ -402,6 +584,12 @@ int unifyfs_client_init(unifyfs_client* client)
             return rc;
         }
 
+        /* build the gfid and path indexes of active file ids */
+        rc = unifyfs_fid_index_init(client);
+        if (rc != UNIFYFS_SUCCESS) {
+            return rc;
+        }
+
         /* initialize log-based I/O context */
         rc = unifyfs_logio_init_client(client->state.app_id,
                                        client->state.client_id,
@@ -434,6 +622,12 @@ int unifyfs_client_init(unifyfs_client* client)
         pthread_mutexattr_settype(&mux_recursive, PTHREAD_MUTEX_RECURSIVE);
         pthread_mutex_init(&(client->sync), &mux_recursive);
 
+        /* start with an empty attribute cache */
+        client->attr_cache = NULL;
+        client->attr_cache_count = 0;
+        client->attr_cache_seq = 0;
+        pthread_mutex_init(&(client->attr_cache_sync), NULL);
+
         /* remember that we've now initialized the library */
         client->state.initialized = 1;
     }
@@ -478,9 +672,14 @@ int unifyfs_client_fini(unifyfs_client* client)
         arraylist_free(client->active_transfers);
     }
 
+    unifyfs_fid_index_fini(client);
+
     pthread_mutex_unlock(&(client->sync));
     pthread_mutex_destroy(&(client->sync));
 
+    attr_cache_fini(client);
+    pthread_mutex_destroy(&(client->attr_cache_sync));
+
     /* close spillover files */
     if (NULL != client->state.logio_ctx) {
         unifyfs_logio_close(client->state.logio_ctx, 0);
@@ -529,18 +728,26 @@ int unifyfs_sync_files(unifyfs_client* client)
 {
     int ret = UNIFYFS_SUCCESS;
 
-    /* sync every active file */
+    int* fids = calloc((size_t)client->max_files, sizeof(int));
+    if (NULL == fids) {
+        return ENOMEM;
+    }
+
+    /* sync every active file, batching their extents into as few
+     * sync rpcs as possible */
     pthread_mutex_lock(&(client->sync));
+    int num_fids = 0;
     for (int i = 0; i < client->max_files; i++) {
         if (client->unifyfs_filelist[i].in_use) {
-            /* got an active file, so sync this file id */
-            int rc = unifyfs_fid_sync_extents(client, i);
-            if (UNIFYFS_SUCCESS != rc) {
-                ret = rc;
-            }
+            fids[num_fids++] = i;
         }
     }
+    if (num_fids > 0) {
+        ret = unifyfs_fid_sync_extents_batch(client, num_fids, fids);
+    }
     pthread_mutex_unlock(&(client->sync));
 
+    free(fids);
+
     return ret;
 }
@@ -93,6 +93,15 @@ unifyfs_rc unifyfs_initialize(const char* mountpoint,
         }
     }
 
+    /* queue non-error log messages for a background writer thread */
+    cfgval = client_cfg->log_async;
+    if (cfgval != NULL) {
+        rc = configurator_bool_val(cfgval, &b);
+        if (rc == 0) {
+            unifyfs_set_log_async((int)b);
+        }
+    }
+
     /* set log level from config */
     cfgval = client_cfg->log_verbosity;
     if (cfgval != NULL) {
@@ -206,6 +215,27 @@ unifyfs_rc unifyfs_initialize(const char* mountpoint,
         }
     }
 
+    /* Determine whether we cache global file attributes. Attributes of
+     * laminated files are cached until the server reports the file has
+     * been unlinked. Those of non-laminated files are only cached when
+     * a lease is configured, which relaxes sync/barrier visibility. */
+    client->use_attr_cache = true;
+    cfgval = client_cfg->client_attr_cache;
+    if (cfgval != NULL) {
+        rc = configurator_bool_val(cfgval, &b);
+        if (rc == 0) {
+            client->use_attr_cache = (bool)b;
+        }
+    }
+    client->attr_lease_msecs = UNIFYFS_CLIENT_ATTR_LEASE_MSECS;
+    cfgval = client_cfg->client_attr_lease_msecs;
+    if (cfgval != NULL) {
+        rc = configurator_int_val(cfgval, &l);
+        if (rc == 0) {
+            client->attr_lease_msecs = l;
+        }
+    }
+
     /* Timeout to wait on rpc calls to server, in milliseconds */
     double timeout_msecs = UNIFYFS_MARGO_CLIENT_SERVER_TIMEOUT_MSEC;
     cfgval = client_cfg->margo_client_timeout;
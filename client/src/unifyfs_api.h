@@ -403,6 +403,14 @@ unifyfs_rc unifyfs_get_server_file_meta(unifyfs_handle fshdl,
                                         unifyfs_gfid gfid,
                                         unifyfs_server_file_meta* fmeta);
 
+/* Get a text report of the local server's rpc statistics: per-rpc counts
+ * and histograms of queue and handler latency. If reset is non-zero, the
+ * server's statistics are cleared after they are reported.
+ * The caller is responsible for freeing the report. */
+unifyfs_rc unifyfs_get_server_stats(unifyfs_handle fshdl,
+                                    int reset,
+                                    char** report);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
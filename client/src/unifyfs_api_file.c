@@ -320,3 +320,17 @@ unifyfs_rc unifyfs_get_server_file_meta(unifyfs_handle fshdl,
     }
     return ret;
 }
+
+/* Get a text report of the local server's rpc statistics */
+unifyfs_rc unifyfs_get_server_stats(unifyfs_handle fshdl,
+                                    int reset,
+                                    char** report)
+{
+    if ((UNIFYFS_INVALID_HANDLE == fshdl) || (NULL == report)) {
+        return EINVAL;
+    }
+    unifyfs_client* client = fshdl;
+
+    *report = NULL;
+    return invoke_client_server_stats_rpc(client, reset, report);
+}
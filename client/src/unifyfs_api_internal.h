@@ -81,6 +81,14 @@ typedef struct unifyfs_client {
 
     size_t unlink_usecs;             /* micrcosecs to sleep after unlink */
 
+    /* cache of global file attributes, keyed by gfid (see unifyfs.c) */
+    bool use_attr_cache;             /* cache global file attributes */
+    long attr_lease_msecs;           /* lease for non-laminated files */
+    struct unifyfs_attr_cache_entry* attr_cache;
+    size_t attr_cache_count;
+    unsigned long attr_cache_seq;    /* bumped on every invalidation */
+    pthread_mutex_t attr_cache_sync; /* protects attr_cache */
+
     /* tracks current working directory within namespace */
     char* cwd;
 
@@ -100,6 +108,12 @@ typedef struct unifyfs_client {
     unifyfs_filename_t* unifyfs_filelist;
     unifyfs_filemeta_t* unifyfs_filemetas;
 
+    /* hashed indexes from gfid and path to active fid (see unifyfs_fid.c),
+     * protected by the sync mutex */
+    int* fid_gfid_index;
+    int* fid_path_index;
+    size_t fid_index_size; /* slots per index (a power of two) */
+
     /* Other clients log-io context */
     logio_context* logio_ctx_ptrs[UNIFYFS_SERVER_MAX_APP_CLIENTS];
 
@@ -124,11 +138,15 @@ int unifyfs_set_global_file_meta(unifyfs_client* client,
                                  unifyfs_file_attr_op_e op,
                                  unifyfs_file_attr_t* gfattr);
 
-/* get global file metadata */
+/* get global file metadata, from the attribute cache if valid */
 int unifyfs_get_global_file_meta(unifyfs_client* client,
                                  int gfid,
                                  unifyfs_file_attr_t* gfattr);
 
+/* drop any cached global file metadata for the gfid */
+void unifyfs_attr_cache_invalidate(unifyfs_client* client,
+                                   int gfid);
+
 /* sync all writes for client files with the server */
 int unifyfs_sync_files(unifyfs_client* client);
 
@@ -16,8 +16,146 @@
 #include <unistd.h>
 
 #include "unifyfs_fid.h"
+#include "client_read.h"
 #include "margo_client.h"
 
+/* ---------------------------------------
+ * fid gfid/path indexes
+ * --------------------------------------- */
+
+/* Each index is an open-addressing hash table with linear probing that
+ * maps a key (gfid or path) to the fid of an active file, and holds -1
+ * in empty slots. Removal shifts later entries of the probe sequence
+ * back, so there are no tombstones and lookups stop at the first empty
+ * slot. The tables are sized to at least twice max_files to keep the
+ * probe sequences short. Callers must hold client->sync. */
+
+#define FID_INDEX_EMPTY (-1)
+
+static inline size_t gfid_index_hash(int gfid)
+{
+    /* Fibonacci hashing to spread out nearby gfids */
+    uint64_t h = (uint64_t)(uint32_t)gfid * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h >> 32);
+}
+
+static inline size_t path_index_hash(const char* path)
+{
+    /* FNV-1a */
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char* c = (const unsigned char*)path; *c; c++) {
+        h ^= (uint64_t)*c;
+        h *= 0x100000001b3ULL;
+    }
+    return (size_t)(h ^ (h >> 32));
+}
+
+static inline size_t fid_index_home(unifyfs_client* client,
+                                    int* index,
+                                    int fid)
+{
+    size_t h;
+    if (index == client->fid_gfid_index) {
+        h = gfid_index_hash(client->unifyfs_filemetas[fid].attrs.gfid);
+    } else {
+        h = path_index_hash(client->unifyfs_filelist[fid].filename);
+    }
+    return h & (client->fid_index_size - 1);
+}
+
+static void fid_index_insert(unifyfs_client* client,
+                             int* index,
+                             int fid)
+{
+    if (NULL == index) {
+        return;
+    }
+    size_t mask = client->fid_index_size - 1;
+    size_t slot = fid_index_home(client, index, fid);
+    while (index[slot] != FID_INDEX_EMPTY) {
+        if (index[slot] == fid) {
+            return; /* already indexed */
+        }
+        slot = (slot + 1) & mask;
+    }
+    index[slot] = fid;
+}
+
+static void fid_index_remove(unifyfs_client* client,
+                             int* index,
+                             int fid)
+{
+    if (NULL == index) {
+        return;
+    }
+    size_t mask = client->fid_index_size - 1;
+    size_t slot = fid_index_home(client, index, fid);
+    while (index[slot] != fid) {
+        if (index[slot] == FID_INDEX_EMPTY) {
+            return; /* not indexed */
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    /* shift back later entries whose home is at or before the hole */
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask;
+    while (index[next] != FID_INDEX_EMPTY) {
+        size_t home = fid_index_home(client, index, index[next]);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index[hole] = index[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index[hole] = FID_INDEX_EMPTY;
+}
+
+int unifyfs_fid_index_init(unifyfs_client* client)
+{
+    size_t sz = 16;
+    while (sz < (2 * (size_t)client->max_files)) {
+        sz <<= 1;
+    }
+
+    client->fid_gfid_index = (int*) malloc(sz * sizeof(int));
+    client->fid_path_index = (int*) malloc(sz * sizeof(int));
+    if ((NULL == client->fid_gfid_index) ||
+        (NULL == client->fid_path_index)) {
+        LOGERR("failed to allocate fid indexes");
+        unifyfs_fid_index_fini(client);
+        return ENOMEM;
+    }
+    client->fid_index_size = sz;
+    for (size_t i = 0; i < sz; i++) {
+        client->fid_gfid_index[i] = FID_INDEX_EMPTY;
+        client->fid_path_index[i] = FID_INDEX_EMPTY;
+    }
+
+    /* index any files that are already active */
+    for (int fid = 0; fid < client->max_files; fid++) {
+        if (client->unifyfs_filelist[fid].in_use) {
+            fid_index_insert(client, client->fid_gfid_index, fid);
+            fid_index_insert(client, client->fid_path_index, fid);
+        }
+    }
+
+    return UNIFYFS_SUCCESS;
+}
+
+void unifyfs_fid_index_fini(unifyfs_client* client)
+{
+    if (NULL != client->fid_gfid_index) {
+        free(client->fid_gfid_index);
+        client->fid_gfid_index = NULL;
+    }
+    if (NULL != client->fid_path_index) {
+        free(client->fid_path_index);
+        client->fid_path_index = NULL;
+    }
+    client->fid_index_size = 0;
+}
+
 /* ---------------------------------------
  * fid stack management
  * --------------------------------------- */
@@ -146,7 +284,16 @@ int unifyfs_fid_update_file_meta(unifyfs_client* client,
     /* lookup local metadata for file */
     unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
     if (meta != NULL) {
+        pthread_mutex_lock(&(client->sync));
+        int reindex = (meta->attrs.gfid != gfattr->gfid);
+        if (reindex) {
+            fid_index_remove(client, client->fid_gfid_index, fid);
+        }
         meta->attrs = *gfattr;
+        if (reindex) {
+            fid_index_insert(client, client->fid_gfid_index, fid);
+        }
+        pthread_mutex_unlock(&(client->sync));
         return UNIFYFS_SUCCESS;
     }
 
@@ -223,8 +370,6 @@ int unifyfs_fid_create_file(unifyfs_client* client,
     LOGDBG("Filename %s got unifyfs fid %d",
            client->unifyfs_filelist[fid].filename, fid);
 
-    pthread_mutex_unlock(&(client->sync));
-
     /* get metadata for this file id */
     unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
     assert(meta != NULL);
@@ -232,6 +377,13 @@ int unifyfs_fid_create_file(unifyfs_client* client,
     /* initialize file attributes */
     unifyfs_file_attr_set_invalid(&(meta->attrs));
     meta->attrs.gfid = unifyfs_generate_gfid(path);
+
+    /* add file to the gfid and path indexes */
+    fid_index_insert(client, client->fid_gfid_index, fid);
+    fid_index_insert(client, client->fid_path_index, fid);
+
+    pthread_mutex_unlock(&(client->sync));
+
     meta->attrs.size = 0;
     meta->attrs.mode = UNIFYFS_STAT_DEFAULT_FILE_MODE;
     meta->attrs.is_laminated = 0;
@@ -337,6 +489,33 @@ int unifyfs_fid_create_directory(unifyfs_client* client,
     return UNIFYFS_SUCCESS;
 }
 
+/* change the path of the file with given file id */
+int unifyfs_fid_rename(unifyfs_client* client,
+                       int fid,
+                       const char* new_path)
+{
+    /* check that pathname is within bounds */
+    size_t pathlen = strlen(new_path) + 1;
+    if (pathlen > UNIFYFS_MAX_FILENAME) {
+        return ENAMETOOLONG;
+    }
+
+    pthread_mutex_lock(&(client->sync));
+    if (!client->unifyfs_filelist[fid].in_use) {
+        pthread_mutex_unlock(&(client->sync));
+        return EINVAL;
+    }
+    LOGDBG("Changing %s to %s",
+           (char*)client->unifyfs_filelist[fid].filename, new_path);
+    fid_index_remove(client, client->fid_path_index, fid);
+    strlcpy((void*)&client->unifyfs_filelist[fid].filename, new_path,
+            UNIFYFS_MAX_FILENAME);
+    fid_index_insert(client, client->fid_path_index, fid);
+    pthread_mutex_unlock(&(client->sync));
+
+    return UNIFYFS_SUCCESS;
+}
+
 /* delete a file id, free its local storage resources and return
  * the file id to free stack */
 int unifyfs_fid_delete(unifyfs_client* client,
@@ -344,6 +523,10 @@ int unifyfs_fid_delete(unifyfs_client* client,
 {
     pthread_mutex_lock(&(client->sync));
 
+    /* remove file from the gfid and path indexes */
+    fid_index_remove(client, client->fid_gfid_index, fid);
+    fid_index_remove(client, client->fid_path_index, fid);
+
     /* set this file id as not in use */
     client->unifyfs_filelist[fid].in_use = 0;
     client->unifyfs_filelist[fid].filename[0] = 0;
@@ -770,19 +953,26 @@ int unifyfs_gfid_from_fid(unifyfs_client* client,
     }
 }
 
-/* scan list of files and return fid corresponding to target gfid,
+/* lookup fid corresponding to target gfid in the gfid index,
  * returns -1 if not found */
 int unifyfs_fid_from_gfid(unifyfs_client* client,
                           int gfid)
 {
     pthread_mutex_lock(&(client->sync));
-    for (int i = 0; i < client->max_files; i++) {
-        if (client->unifyfs_filelist[i].in_use &&
-            client->unifyfs_filemetas[i].attrs.gfid == gfid) {
-            /* found a file id that's in use and it matches
-             * the target fid, this is the one */
-            pthread_mutex_unlock(&(client->sync));
-            return i;
+    int* index = client->fid_gfid_index;
+    if (NULL != index) {
+        size_t mask = client->fid_index_size - 1;
+        size_t slot = gfid_index_hash(gfid) & mask;
+        int i;
+        while ((i = index[slot]) != FID_INDEX_EMPTY) {
+            if (client->unifyfs_filelist[i].in_use &&
+                client->unifyfs_filemetas[i].attrs.gfid == gfid) {
+                /* found a file id that's in use and it matches
+                 * the target fid, this is the one */
+                pthread_mutex_unlock(&(client->sync));
+                return i;
+            }
+            slot = (slot + 1) & mask;
         }
     }
     pthread_mutex_unlock(&(client->sync));
@@ -807,18 +997,24 @@ const char* unifyfs_path_from_fid(unifyfs_client* client,
 int unifyfs_fid_from_path(unifyfs_client* client,
                           const char* path)
 {
-    /* scan through active entries in filelist array looking
-     * for a match of path */
+    /* probe the path index for an active entry matching path */
     pthread_mutex_lock(&(client->sync));
-    for (int i = 0; i < client->max_files; i++) {
-        if (client->unifyfs_filelist[i].in_use) {
-            const char* filename = client->unifyfs_filelist[i].filename;
-            if (0 == strcmp(filename, path)) {
-                LOGDBG("File found: unifyfs_filelist[%d].filename = %s",
-                       i, (char*)filename);
-                pthread_mutex_unlock(&(client->sync));
-                return i;
+    int* index = client->fid_path_index;
+    if (NULL != index) {
+        size_t mask = client->fid_index_size - 1;
+        size_t slot = path_index_hash(path) & mask;
+        int i;
+        while ((i = index[slot]) != FID_INDEX_EMPTY) {
+            if (client->unifyfs_filelist[i].in_use) {
+                const char* filename = client->unifyfs_filelist[i].filename;
+                if (0 == strcmp(filename, path)) {
+                    LOGDBG("File found: unifyfs_filelist[%d].filename = %s",
+                           i, (char*)filename);
+                    pthread_mutex_unlock(&(client->sync));
+                    return i;
+                }
             }
+            slot = (slot + 1) & mask;
         }
     }
     pthread_mutex_unlock(&(client->sync));
@@ -1006,37 +1202,34 @@ static int add_write_meta_to_index(unifyfs_client* client,
 }
 
 /*
- * Remove all entries in the current index and re-write it using the write
- * metadata stored in the target file's extents_sync segment tree. This only
- * re-writes the metadata in the index. All the actual data is still kept
- * in the write log and will be referenced correctly by the new metadata.
- *
- * After this function is done, 'state.write_index' will have been totally
- * re-written. The writes in the index will be flattened, non-overlapping,
- * and sequential. The extents_sync segment tree will be cleared.
+ * Append the write metadata stored in the target file's extents_sync
+ * segment tree to the current index. This only writes the metadata in the
+ * index. All the actual data is still kept in the write log and will be
+ * referenced correctly by the new metadata.
  *
- * This function is called when we sync our extents with the server.
+ * The appended writes will be flattened, non-overlapping, and sequential.
+ * The extents_sync segment tree will be cleared.
  *
- * Returns maximum write log offset for synced extents.
+ * Returns maximum write log offset for appended extents.
  */
-static off_t rewrite_index_from_seg_tree(unifyfs_client* client,
-                                         unifyfs_filemeta_t* meta)
+static off_t append_index_from_seg_tree(unifyfs_client* client,
+                                        unifyfs_filemeta_t* meta)
 {
     /* get pointer to index buffer */
     unifyfs_index_t* indexes = client->state.write_index.index_entries;
 
-    /* Erase the index before we re-write it */
-    clear_index(client);
-
-    /* count up number of entries we wrote to buffer */
-    unsigned long idx = 0;
+    /* start after the entries already in the buffer */
+    unsigned long idx = *(client->state.write_index.ptr_num_entries);
 
     /* record maximum write log offset */
     off_t max_log_offset = 0;
 
     int gfid = meta->attrs.gfid;
 
-    seg_tree_rdlock(&meta->extents_sync);
+    /* Hold the write lock until the tree is cleared, so that extents
+     * cannot be moved in the log (see unifyfs_fid_migrate()) after we
+     * have copied their log offsets */
+    seg_tree_wrlock(&meta->extents_sync);
     /* For each write in this file's seg_tree ... */
     struct seg_tree_node* node = NULL;
     while ((node = seg_tree_iter(&meta->extents_sync, node))) {
@@ -1049,9 +1242,9 @@ static off_t rewrite_index_from_seg_tree(unifyfs_client* client,
             max_log_offset = (off_t) node->end;
         }
     }
-    seg_tree_unlock(&meta->extents_sync);
     /* All done processing this files writes.  Clear its seg_tree */
-    seg_tree_clear(&meta->extents_sync);
+    seg_tree_clear_nolock(&meta->extents_sync);
+    seg_tree_unlock(&meta->extents_sync);
 
     /* record total number of entries in index buffer */
     *(client->state.write_index.ptr_num_entries) = idx;
@@ -1059,6 +1252,26 @@ static off_t rewrite_index_from_seg_tree(unifyfs_client* client,
     return max_log_offset;
 }
 
+/*
+ * Remove all entries in the current index and re-write it using the write
+ * metadata stored in the target file's extents_sync segment tree.
+ *
+ * After this function is done, 'state.write_index' will have been totally
+ * re-written.
+ *
+ * This function is called when we sync our extents with the server.
+ *
+ * Returns maximum write log offset for synced extents.
+ */
+static off_t rewrite_index_from_seg_tree(unifyfs_client* client,
+                                         unifyfs_filemeta_t* meta)
+{
+    /* Erase the index before we re-write it */
+    clear_index(client);
+
+    return append_index_from_seg_tree(client, meta);
+}
+
 /* Sync extent data for file to storage */
 int unifyfs_fid_sync_data(unifyfs_client* client,
                           int fid)
@@ -1139,14 +1352,360 @@ int unifyfs_fid_sync_extents(unifyfs_client* client,
 }
 
 
-/* Write data to file using log-based I/O.
+/* Send the extents in the index to the server. When the index holds
+ * extents for more than one file, the sync rpc is given INVALID_GFID so
+ * the server processes the extents of each file in the index. */
+static int flush_index(unifyfs_client* client,
+                       int num_files,
+                       int gfid)
+{
+    int ret = UNIFYFS_SUCCESS;
+    if (*(client->state.write_index.ptr_num_entries) > 0) {
+        int sync_gfid = (num_files == 1) ? gfid : INVALID_GFID;
+        ret = invoke_client_sync_rpc(client, sync_gfid);
+        if (UNIFYFS_SUCCESS != ret) {
+            LOGERR("failed to flush write index to server for %d files",
+                   num_files);
+        }
+    }
+    clear_index(client);
+    return ret;
+}
+
+/* Sync extent metadata for a set of files to server */
+int unifyfs_fid_sync_extents_batch(unifyfs_client* client,
+                                   int num_fids,
+                                   const int* fids)
+{
+    /* assume we'll succeed */
+    int ret = UNIFYFS_SUCCESS;
+    int rc;
+
+    size_t max_entries = client->max_write_index_entries;
+    int num_files = 0; /* number of files with extents in the index */
+    int last_gfid = INVALID_GFID;
+
+    clear_index(client);
+    for (int i = 0; i < num_fids; i++) {
+        int fid = fids[i];
+        unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+        if ((NULL == meta) || (meta->fid != fid) ||
+            !meta->needs_writes_sync) {
+            continue;
+        }
+
+        /* flush the index first if this file's extents won't fit */
+        size_t count = (size_t) seg_tree_count(&meta->extents_sync);
+        size_t used = *(client->state.write_index.ptr_num_entries);
+        if ((used > 0) && ((used + count) > max_entries)) {
+            rc = flush_index(client, num_files, last_gfid);
+            if (UNIFYFS_SUCCESS != rc) {
+                ret = rc;
+            }
+            num_files = 0;
+        }
+
+        /* write contents from segment tree to index buffer */
+        append_index_from_seg_tree(client, meta);
+        if (*(client->state.write_index.ptr_num_entries) > used) {
+            num_files++;
+            last_gfid = meta->attrs.gfid;
+        }
+
+        /* this file's extents will be sync'd with the next flush */
+        meta->needs_writes_sync = 0;
+    }
+
+    rc = flush_index(client, num_files, last_gfid);
+    if (UNIFYFS_SUCCESS != rc) {
+        ret = rc;
+    }
+
+    return ret;
+}
+
+/* extent of file data in a write log */
+typedef struct {
+    unsigned long start;   /* starting file offset */
+    unsigned long end;     /* ending file offset */
+    unsigned long ptr;     /* log offset of data */
+    unsigned long new_ptr; /* log offset of moved data */
+} fid_log_extent;
+
+static int compare_ulong(const void* a, const void* b)
+{
+    unsigned long ua = *(const unsigned long*)a;
+    unsigned long ub = *(const unsigned long*)b;
+    if (ua < ub) {
+        return -1;
+    } else if (ua > ub) {
+        return 1;
+    }
+    return 0;
+}
+
+/* Move unsynced write data of the file within [offset, offset+length)
+ * to the shmem (to_shmem != 0) or spill storage of our write log.
+ * A length of zero means to the end of the file. Synced data stays where
+ * it is, since the server has recorded its log location. */
+int unifyfs_fid_migrate(unifyfs_client* client,
+                        int fid,
+                        off_t offset,
+                        off_t length,
+                        int to_shmem)
+{
+    unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+    if ((NULL == meta) || (meta->fid != fid)) {
+        LOGERR("missing filemeta for fid=%d", fid);
+        return EINVAL;
+    }
+    if (meta->storage != FILE_STORAGE_LOGIO) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    unsigned long range_start = (unsigned long) offset;
+    unsigned long range_end = ULONG_MAX;
+    if (length > 0) {
+        range_end = range_start + (unsigned long)length - 1;
+    }
+
+    struct seg_tree* extents = &meta->extents_sync;
+    seg_tree_rdlock(extents);
+    unsigned long n_extents = extents->count;
+    if (0 == n_extents) {
+        seg_tree_unlock(extents);
+        return UNIFYFS_SUCCESS;
+    }
+
+    fid_log_extent* move = calloc(n_extents, sizeof(fid_log_extent));
+    unsigned long* deltas = calloc(n_extents, sizeof(unsigned long));
+    if ((NULL == move) || (NULL == deltas)) {
+        seg_tree_unlock(extents);
+        free(move);
+        free(deltas);
+        return ENOMEM;
+    }
+
+    /* Writes larger than half a log chunk are given whole chunks, which
+     * are released on the first free of any of their data. The pieces of
+     * such a write left by later overwrites must therefore move together,
+     * so we also pick up the unsynced extents that have the same file to
+     * log offset difference as an extent within the range. */
+    size_t n_deltas = 0;
+    struct seg_tree_node* node;
+    node = seg_tree_find_nolock(extents, range_start, range_end);
+    while ((NULL != node) && (node->start <= range_end)) {
+        deltas[n_deltas++] = node->start - node->ptr;
+        node = seg_tree_iter(extents, node);
+    }
+    qsort(deltas, n_deltas, sizeof(unsigned long), compare_ulong);
+
+    size_t n_move = 0;
+    node = NULL;
+    while ((n_deltas > 0) && (node = seg_tree_iter(extents, node))) {
+        unsigned long delta = node->start - node->ptr;
+        if (NULL != bsearch(&delta, deltas, n_deltas,
+                            sizeof(unsigned long), compare_ulong)) {
+            move[n_move].start = node->start;
+            move[n_move].end   = node->end;
+            move[n_move].ptr   = node->ptr;
+            n_move++;
+        }
+    }
+    seg_tree_unlock(extents);
+    free(deltas);
+
+    /* copy all the data first, so that nothing is released unless every
+     * extent could be moved */
+    int ret = UNIFYFS_SUCCESS;
+    logio_context* logio_ctx = client->state.logio_ctx;
+    size_t i;
+    for (i = 0; i < n_move; i++) {
+        size_t nbytes = (size_t)(move[i].end - move[i].start + 1);
+        off_t new_ptr;
+        ret = unifyfs_logio_migrate(logio_ctx, (off_t)move[i].ptr, nbytes,
+                                    to_shmem, &new_ptr);
+        if (ret != UNIFYFS_SUCCESS) {
+            break;
+        }
+        move[i].new_ptr = (unsigned long) new_ptr;
+    }
+
+    if (ret != UNIFYFS_SUCCESS) {
+        /* roll back the copies we made */
+        size_t j;
+        for (j = 0; j < i; j++) {
+            if (move[j].new_ptr != move[j].ptr) {
+                size_t nbytes = (size_t)(move[j].end - move[j].start + 1);
+                unifyfs_logio_free(logio_ctx, (off_t)move[j].new_ptr, nbytes);
+            }
+        }
+        free(move);
+        return ret;
+    }
+
+    /* The tree lock was dropped while copying. A write in the meantime
+     * makes the copy stale, and a sync hands the old log locations to
+     * the server, so only move the extents if none of them changed. All
+     * are checked before any is moved, since the pieces of a large write
+     * must move together. */
+    int client_id = client->state.client_id;
+    int unchanged = 1;
+    seg_tree_wrlock(extents);
+    if (client->use_local_extents) {
+        seg_tree_wrlock(&meta->extents);
+    }
+    for (i = 0; i < n_move; i++) {
+        if (move[i].new_ptr == move[i].ptr) {
+            continue;
+        }
+        node = seg_tree_find_nolock(extents, move[i].start, move[i].end);
+        if ((NULL == node) ||
+            (node->start != move[i].start) ||
+            (node->end != move[i].end) ||
+            (node->ptr != move[i].ptr)) {
+            unchanged = 0;
+            break;
+        }
+    }
+    for (i = 0; unchanged && (i < n_move); i++) {
+        /* point the extent at its new location */
+        if (move[i].new_ptr == move[i].ptr) {
+            continue;
+        }
+        seg_tree_add_nolock(extents, move[i].start, move[i].end,
+                            move[i].new_ptr, client_id);
+        if (client->use_local_extents) {
+            seg_tree_add_nolock(&meta->extents, move[i].start, move[i].end,
+                                move[i].new_ptr, client_id);
+        }
+    }
+    if (client->use_local_extents) {
+        seg_tree_unlock(&meta->extents);
+    }
+    seg_tree_unlock(extents);
+
+    if (!unchanged) {
+        /* drop the copies and leave the data where it is */
+        for (i = 0; i < n_move; i++) {
+            if (move[i].new_ptr != move[i].ptr) {
+                size_t nbytes = (size_t)(move[i].end - move[i].start + 1);
+                unifyfs_logio_free(logio_ctx, (off_t)move[i].new_ptr, nbytes);
+            }
+        }
+        LOGDBG("extents of fid=%d changed during migration, not moved", fid);
+        free(move);
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* release the old locations */
+    for (i = 0; i < n_move; i++) {
+        if (move[i].new_ptr != move[i].ptr) {
+            size_t nbytes = (size_t)(move[i].end - move[i].start + 1);
+            int rc = unifyfs_logio_free(logio_ctx, (off_t)move[i].ptr,
+                                        nbytes);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to free moved logio data at log_offset=%zu",
+                       (size_t)move[i].ptr);
+            }
+        }
+    }
+    LOGDBG("moved %zu extents of fid=%d to %s", n_move, fid,
+           (to_shmem ? "shmem" : "spill"));
+
+    free(move);
+    return UNIFYFS_SUCCESS;
+}
+
+/* pass advice for the parts of the extents in the tree that fall within
+ * [range_start, range_end] on to the log holding the data */
+static int fid_advise_extents(unifyfs_client* client,
+                              struct seg_tree* extents,
+                              unsigned long range_start,
+                              unsigned long range_end,
+                              logio_advice_e advice)
+{
+    int ret = UNIFYFS_SUCCESS;
+    seg_tree_rdlock(extents);
+    struct seg_tree_node* node;
+    node = seg_tree_find_nolock(extents, range_start, range_end);
+    while ((NULL != node) && (node->start <= range_end)) {
+        unsigned long start = node->start;
+        if (start < range_start) {
+            start = range_start;
+        }
+        unsigned long end = node->end;
+        if (end > range_end) {
+            end = range_end;
+        }
+        off_t log_offset = (off_t)(node->ptr + (start - node->start));
+        size_t nbytes = (size_t)(end - start + 1);
+
+        logio_context* logio_ctx =
+            client_get_peer_logio(client, node->client_id);
+        if (NULL != logio_ctx) {
+            int rc = unifyfs_logio_advise(logio_ctx, log_offset, nbytes,
+                                          advice);
+            if (rc != UNIFYFS_SUCCESS) {
+                ret = rc;
+            }
+        }
+        node = seg_tree_iter(extents, node);
+    }
+    seg_tree_unlock(extents);
+    return ret;
+}
+
+/* Pass expected access to the file data within [offset, offset+length)
+ * that is held in local write logs on to the operating system.
+ * A length of zero means to the end of the file. */
+int unifyfs_fid_advise(unifyfs_client* client,
+                       int fid,
+                       off_t offset,
+                       off_t length,
+                       logio_advice_e advice)
+{
+    unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(client, fid);
+    if ((NULL == meta) || (meta->fid != fid)) {
+        LOGERR("missing filemeta for fid=%d", fid);
+        return EINVAL;
+    }
+    if (meta->storage != FILE_STORAGE_LOGIO) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    unsigned long range_start = (unsigned long) offset;
+    unsigned long range_end = ULONG_MAX;
+    if (length > 0) {
+        range_end = range_start + (unsigned long)length - 1;
+    }
+
+    /* our unsynced writes */
+    int ret = fid_advise_extents(client, &meta->extents_sync,
+                                 range_start, range_end, advice);
+
+    /* local extents known to be in our log or a peer's log on this node */
+    if (client->use_local_extents || client->use_node_local_extents) {
+        int rc = fid_advise_extents(client, &meta->extents,
+                                    range_start, range_end, advice);
+        if (rc != UNIFYFS_SUCCESS) {
+            ret = rc;
+        }
+    }
+    return ret;
+}
+
+
+/* Write data of an I/O vector to file using log-based I/O. The vector
+ * is written to a single log allocation, and recorded as one extent.
  * Return UNIFYFS_SUCCESS, or error code */
 static int fid_logio_write(
     unifyfs_client* client,
     unifyfs_filemeta_t* meta, /* meta data for file */
     off_t pos,                /* file position to start writing at */
-    const void* buf,          /* user buffer holding data */
-    size_t count,             /* number of bytes to write */
+    const struct iovec* iov,  /* user buffers holding data */
+    int iovcnt,               /* number of user buffers */
+    size_t count,             /* total number of bytes to write */
     size_t* nwritten)         /* returns number of bytes written */
 {
     /* assume we'll fail to write anything */
@@ -1168,13 +1727,27 @@ static int fid_logio_write(
         return rc;
     }
 
-    /* do the write */
-    rc = unifyfs_logio_write(client->state.logio_ctx, log_off, count,
-                             buf, nwritten);
-    if (rc != UNIFYFS_SUCCESS) {
-        LOGERR("fid=%d gfid=%d logio_write(off=%zu, cnt=%zu) failed",
-               fid, gfid, log_off, count);
-        return rc;
+    /* do the write, copying each buffer to the next part of the log
+     * allocation */
+    for (int i = 0; i < iovcnt; i++) {
+        size_t len = iov[i].iov_len;
+        if (0 == len) {
+            continue;
+        }
+        size_t nbytes = 0;
+        rc = unifyfs_logio_write(client->state.logio_ctx,
+                                 log_off + (off_t)(*nwritten), len,
+                                 (const char*) iov[i].iov_base, &nbytes);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("fid=%d gfid=%d logio_write(off=%zu, cnt=%zu) failed",
+                   fid, gfid, (size_t)log_off + *nwritten, len);
+            *nwritten = 0;
+            return rc;
+        }
+        *nwritten += nbytes;
+        if (nbytes < len) {
+            break;
+        }
     }
 
     if (*nwritten < count) {
@@ -1202,12 +1775,35 @@ int unifyfs_fid_write(
     const void* buf,  /* buffer to be written */
     size_t count,     /* number of bytes to write */
     size_t* nwritten) /* returns number of bytes written */
+{
+    struct iovec iov;
+    iov.iov_base = (void*) buf;
+    iov.iov_len  = count;
+    return unifyfs_fid_writev(client, fid, pos, &iov, 1, nwritten);
+}
+
+/* Write the buffers of an I/O vector into file starting at offset pos.
+ *
+ * Returns UNIFYFS_SUCCESS, or an error code
+ */
+int unifyfs_fid_writev(
+    unifyfs_client* client,
+    int fid,                 /* local file id to write to */
+    off_t pos,               /* starting position in file */
+    const struct iovec* iov, /* buffers to be written */
+    int iovcnt,              /* number of buffers */
+    size_t* nwritten)        /* returns number of bytes written */
 {
     int rc;
 
     /* assume we won't write anything */
     *nwritten = 0;
 
+    size_t count = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        count += iov[i].iov_len;
+    }
+
     /* short-circuit a 0-byte write */
     if (count == 0) {
         return UNIFYFS_SUCCESS;
@@ -1225,7 +1821,8 @@ int unifyfs_fid_write(
     /* determine storage type to write file data */
     if (meta->storage == FILE_STORAGE_LOGIO) {
         /* file stored in logged i/o */
-        rc = fid_logio_write(client, meta, pos, buf, count, nwritten);
+        rc = fid_logio_write(client, meta, pos, iov, iovcnt, count,
+                             nwritten);
         if (rc == UNIFYFS_SUCCESS) {
             /* write succeeded, remember that we have new data
              * that needs to be synced with the server */
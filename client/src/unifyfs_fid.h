@@ -20,6 +20,13 @@
 
 /* ---  file id (fid) management --- */
 
+/* Allocate the gfid and path indexes of active fids, and add
+ * any fids already in use (e.g., from a reattached superblock) */
+int unifyfs_fid_index_init(unifyfs_client* client);
+
+/* Free the gfid and path indexes of active fids */
+void unifyfs_fid_index_fini(unifyfs_client* client);
+
 /* Allocate a fid slot for a new entry.
  * Return the fid or -1 on error */
 int unifyfs_fid_alloc(unifyfs_client* client);
@@ -61,6 +68,11 @@ int unifyfs_fid_update_file_meta(unifyfs_client* client,
                                  int fid,
                                  unifyfs_file_attr_t* gfattr);
 
+/* Change the path of the file with given file id */
+int unifyfs_fid_rename(unifyfs_client* client,
+                       int fid,
+                       const char* new_path);
+
 /* Unlink file and then delete its associated state */
 int unifyfs_fid_unlink(unifyfs_client* client,
                        int fid);
@@ -146,6 +158,17 @@ int unifyfs_fid_write(
     size_t* nwritten /* returns number of bytes written */
 );
 
+/* Write the buffers of an I/O vector into file starting at offset pos,
+ * using a single log allocation */
+int unifyfs_fid_writev(
+    unifyfs_client* client,
+    int fid,                 /* local file id to write to */
+    off_t pos,               /* starting offset within file */
+    const struct iovec* iov, /* buffers of data to be written */
+    int iovcnt,              /* number of buffers */
+    size_t* nwritten         /* returns number of bytes written */
+);
+
 /* Truncate file to given length. Removes or truncates file extents
  * in metadata that are past the given length. */
 int unifyfs_fid_truncate(unifyfs_client* client,
@@ -160,6 +183,30 @@ int unifyfs_fid_sync_data(unifyfs_client* client,
 int unifyfs_fid_sync_extents(unifyfs_client* client,
                              int fid);
 
+/* Sync extent metadata for a set of files to server, packing the extents
+ * of as many files as fit in the write index into each sync rpc */
+int unifyfs_fid_sync_extents_batch(unifyfs_client* client,
+                                   int num_fids,
+                                   const int* fids);
+
+/* Move unsynced file data within [offset, offset+length) to the shmem
+ * (to_shmem != 0) or spill storage of the client write log. A length of
+ * zero means to the end of the file. */
+int unifyfs_fid_migrate(unifyfs_client* client,
+                        int fid,
+                        off_t offset,
+                        off_t length,
+                        int to_shmem);
+
+/* Pass expected access to file data within [offset, offset+length) held
+ * in node-local write logs on to the operating system. A length of zero
+ * means to the end of the file. */
+int unifyfs_fid_advise(unifyfs_client* client,
+                       int fid,
+                       off_t offset,
+                       off_t length,
+                       logio_advice_e advice);
+
 /* Given a file name, allocate a gfid entry on the server for the file.
  * Returns UNIFYFS_SUCCESS if successful. */
 int unifyfs_gfid_create(
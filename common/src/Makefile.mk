@@ -10,6 +10,8 @@ UNIFYFS_COMMON_BASE_SRCS = \
   %reldir%/compare_fn.c \
   %reldir%/ini.h \
   %reldir%/ini.c \
+  %reldir%/node_pool.h \
+  %reldir%/node_pool.c \
   %reldir%/rm_enumerator.h \
   %reldir%/rm_enumerator.c \
   %reldir%/seg_tree.h \
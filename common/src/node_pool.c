@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "node_pool.h"
+
+/* number of objects in the first slab, and the limit of slab growth */
+#define NODE_POOL_MIN_SLAB_OBJS 16
+#define NODE_POOL_MAX_SLAB_OBJS 1024
+
+/* objects are aligned to the largest alignment of the header fields */
+#define NODE_POOL_ALIGN (sizeof(struct slab_header))
+
+/* header at the start of each slab, followed by its objects */
+struct slab_header {
+    struct slab_header* next;
+    size_t n_objs;
+};
+
+/* released objects are linked through their first word */
+struct free_obj {
+    struct free_obj* next;
+};
+
+static inline char* slab_objects(struct slab_header* slab)
+{
+    return (char*)(slab + 1);
+}
+
+/* make the objects of the given slab available for allocation */
+static void use_slab(struct node_pool* pool, struct slab_header* slab)
+{
+    pool->next  = slab_objects(slab);
+    pool->limit = pool->next + (slab->n_objs * pool->obj_size);
+}
+
+void node_pool_init(struct node_pool* pool, size_t obj_size)
+{
+    memset(pool, 0, sizeof(*pool));
+
+    if (obj_size < sizeof(struct free_obj)) {
+        obj_size = sizeof(struct free_obj);
+    }
+    pool->obj_size = (obj_size + NODE_POOL_ALIGN - 1) &
+                     ~(NODE_POOL_ALIGN - 1);
+}
+
+void* node_pool_alloc(struct node_pool* pool)
+{
+    void* obj;
+
+    if (NULL != pool->free_list) {
+        /* reuse the most recently released object */
+        struct free_obj* fobj = pool->free_list;
+        pool->free_list = fobj->next;
+        obj = fobj;
+    } else {
+        if ((size_t)(pool->limit - pool->next) < pool->obj_size) {
+            /* newest slab is used up, allocate one twice its size */
+            size_t n_objs = NODE_POOL_MIN_SLAB_OBJS;
+            if (pool->slab_objs >= NODE_POOL_MIN_SLAB_OBJS) {
+                n_objs = pool->slab_objs * 2;
+                if (n_objs > NODE_POOL_MAX_SLAB_OBJS) {
+                    n_objs = NODE_POOL_MAX_SLAB_OBJS;
+                }
+            }
+            struct slab_header* slab =
+                malloc(sizeof(*slab) + (n_objs * pool->obj_size));
+            if (NULL == slab) {
+                return NULL;
+            }
+            slab->n_objs = n_objs;
+            slab->next = pool->slabs;
+            pool->slabs = slab;
+            pool->slab_objs = n_objs;
+            use_slab(pool, slab);
+        }
+        obj = pool->next;
+        pool->next += pool->obj_size;
+    }
+
+    memset(obj, 0, pool->obj_size);
+    return obj;
+}
+
+void node_pool_free(struct node_pool* pool, void* obj)
+{
+    if (NULL != obj) {
+        struct free_obj* fobj = obj;
+        fobj->next = pool->free_list;
+        pool->free_list = fobj;
+    }
+}
+
+void node_pool_clear(struct node_pool* pool)
+{
+    struct slab_header* newest = pool->slabs;
+    if (NULL == newest) {
+        return;
+    }
+
+    /* free all but the newest slab */
+    struct slab_header* slab = newest->next;
+    while (NULL != slab) {
+        struct slab_header* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    newest->next = NULL;
+
+    pool->free_list = NULL;
+    use_slab(pool, newest);
+}
+
+void node_pool_release(struct node_pool* pool)
+{
+    struct slab_header* slab = pool->slabs;
+    while (NULL != slab) {
+        struct slab_header* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    pool->slabs     = NULL;
+    pool->free_list = NULL;
+    pool->next      = NULL;
+    pool->limit     = NULL;
+    pool->slab_objs = 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <stddef.h>
+
+/*
+ * A pool of fixed-size objects (e.g., tree nodes) carved out of larger
+ * slabs. Released objects are kept on a free list for reuse, and
+ * node_pool_clear() releases every object at once without visiting them.
+ * Slabs start small and double in size as the pool grows, so pools of
+ * small trees stay small.
+ *
+ * The pool does no locking. The owner must serialize all calls, which
+ * the trees do by only using their pool while holding the write lock.
+ */
+struct node_pool {
+    size_t obj_size;   /* size of each object, rounded up for alignment */
+    size_t slab_objs;  /* number of objects in the newest slab */
+    void* slabs;       /* list of allocated slabs, newest first */
+    void* free_list;   /* list of released objects */
+    char* next;        /* next never-used object in the newest slab */
+    char* limit;       /* end of the newest slab */
+};
+
+/* Initialize an empty pool of objects of the given size */
+void node_pool_init(struct node_pool* pool, size_t obj_size);
+
+/* Return a zeroed object from the pool, or NULL if out of memory */
+void* node_pool_alloc(struct node_pool* pool);
+
+/* Return an object to the pool for reuse */
+void node_pool_free(struct node_pool* pool, void* obj);
+
+/*
+ * Release all objects of the pool. The newest (largest) slab is kept
+ * for reuse, so repeatedly filling and clearing a pool does not go
+ * back to the system allocator.
+ */
+void node_pool_clear(struct node_pool* pool);
+
+/* Release all objects and all memory held by the pool. The pool
+ * remains initialized and may be used again. */
+void node_pool_release(struct node_pool* pool);
+
+#endif /* NODE_POOL_H */
@@ -59,6 +59,7 @@ int seg_tree_init(struct seg_tree* seg_tree)
     memset(seg_tree, 0, sizeof(*seg_tree));
     ABT_rwlock_create(&(seg_tree->rwlock));
     RB_INIT(&seg_tree->head);
+    node_pool_init(&seg_tree->pool, sizeof(struct seg_tree_node));
 
     return 0;
 }
@@ -69,19 +70,24 @@ int seg_tree_init(struct seg_tree* seg_tree)
 void seg_tree_destroy(struct seg_tree* seg_tree)
 {
     seg_tree_clear(seg_tree);
+    node_pool_release(&seg_tree->pool);
     ABT_rwlock_free(&(seg_tree->rwlock));
 }
 
-/* Allocate a node for the range tree.  Free node with free() when finished */
+/*
+ * Allocate a node for the range tree from the tree's node pool.  Release
+ * the node with seg_tree_node_free().  Caller must hold the write lock.
+ */
 static struct seg_tree_node*
-seg_tree_node_alloc(unsigned long start,
+seg_tree_node_alloc(struct seg_tree* seg_tree,
+                    unsigned long start,
                     unsigned long end,
                     unsigned long ptr,
                     int client_id)
 {
     /* allocate a new node structure */
     struct seg_tree_node* node;
-    node = calloc(1, sizeof(*node));
+    node = node_pool_alloc(&seg_tree->pool);
     if (!node) {
         return NULL;
     }
@@ -95,6 +101,13 @@ seg_tree_node_alloc(unsigned long start,
     return node;
 }
 
+/* Return a node to the tree's node pool.  Caller must hold the write lock. */
+static void
+seg_tree_node_free(struct seg_tree* seg_tree, struct seg_tree_node* node)
+{
+    node_pool_free(&seg_tree->pool, node);
+}
+
 /*
  * Given two start/end ranges, return a new range from start1/end1 that
  * does not overlap start2/end2.  The non-overlapping range is stored
@@ -149,9 +162,10 @@ static int get_non_overlapping_range(
 }
 
 /*
- * Add an entry to the range tree.  Returns 0 on success, nonzero otherwise.
+ * Add an entry to the range tree.  Assumes you've already write-locked
+ * the tree.  Returns 0 on success, nonzero otherwise.
  */
-int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
+int seg_tree_add_nolock(struct seg_tree* seg_tree, unsigned long start,
     unsigned long end, unsigned long ptr, int client_id)
 {
     /* Assume we'll succeed */
@@ -168,15 +182,26 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
     unsigned long ptr_end;
     int ret;
 
+    /*
+     * Fast path for sequential writes: if the new range starts right after
+     * the last range in the tree and its data directly follows that range
+     * in the log, nothing can overlap it, so just extend the last range.
+     */
+    target = seg_tree->last;
+    if ((target != NULL) &&
+        ((target->end + 1) == start) &&
+        ((target->ptr + (target->end - target->start + 1)) == ptr)) {
+        target->end = end;
+        seg_tree->max = MAX(seg_tree->max, end);
+        return 0;
+    }
+
     /* Create our range */
-    node = seg_tree_node_alloc(start, end, ptr, client_id);
+    node = seg_tree_node_alloc(seg_tree, start, end, ptr, client_id);
     if (!node) {
         return ENOMEM;
     }
 
-    /* Lock the tree so we can modify it */
-    seg_tree_wrlock(seg_tree);
-
     /*
      * Try to insert our range into the RB tree.  If it overlaps with any other
      * range, then it is not inserted, and the overlapping range node is
@@ -200,7 +225,7 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
              * non-overlapping range.  Delete the existing range.
              */
             RB_REMOVE(inttree, &seg_tree->head, overlap);
-            free(overlap);
+            seg_tree_node_free(seg_tree, overlap);
             seg_tree->count--;
         } else {
             /*
@@ -210,10 +235,10 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
              * inserted without issue.  The remaining section will be processed
              * on the next pass of this while() loop.
              */
-            resized = seg_tree_node_alloc(new_start, new_end,
+            resized = seg_tree_node_alloc(seg_tree, new_start, new_end,
                 overlap->ptr + (new_start - overlap->start), client_id);
             if (!resized) {
-                free(node);
+                seg_tree_node_free(seg_tree, node);
                 rc = ENOMEM;
                 goto release_add;
             }
@@ -231,13 +256,14 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
                  * part.  Add it in.
                  */
                 remaining = seg_tree_node_alloc(
+                    seg_tree,
                     resized->end + 1,
                     overlap->end,
                     overlap->ptr + (resized->end + 1 - overlap->start),
                     client_id);
                 if (!remaining) {
-                    free(node);
-                    free(resized);
+                    seg_tree_node_free(seg_tree, node);
+                    seg_tree_node_free(seg_tree, resized);
                     rc = ENOMEM;
                     goto release_add;
                 }
@@ -245,7 +271,7 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
             /* Remove our old range */
             RB_REMOVE(inttree, &seg_tree->head, overlap);
-            free(overlap);
+            seg_tree_node_free(seg_tree, overlap);
             seg_tree->count--;
 
             /* Insert the non-overlapping part of the new range */
@@ -294,7 +320,7 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
             /* Delete new extent from the tree and free it. */
             RB_REMOVE(inttree, &seg_tree->head, target);
-            free(target);
+            seg_tree_node_free(seg_tree, target);
             seg_tree->count--;
 
             /*
@@ -323,18 +349,35 @@ int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
 
             /* Delete next extent from the tree and free it. */
             RB_REMOVE(inttree, &seg_tree->head, next);
-            free(next);
+            seg_tree_node_free(seg_tree, next);
             seg_tree->count--;
         }
     }
 
 release_add:
 
-    seg_tree_unlock(seg_tree);
+    /*
+     * Remember the last range for the sequential write fast path.  This is
+     * also needed on failure, as overlapped ranges may have been freed.
+     */
+    seg_tree->last = RB_MAX(inttree, &seg_tree->head);
 
     return rc;
 }
 
+/*
+ * Add an entry to the range tree.  Returns 0 on success, nonzero otherwise.
+ */
+int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
+    unsigned long end, unsigned long ptr, int client_id)
+{
+    /* Lock the tree so we can modify it */
+    seg_tree_wrlock(seg_tree);
+    int rc = seg_tree_add_nolock(seg_tree, start, end, ptr, client_id);
+    seg_tree_unlock(seg_tree);
+    return rc;
+}
+
 /*
  * Remove or truncate one or more entries from the range tree
  * if they overlap [start, end].
@@ -359,7 +402,7 @@ int seg_tree_remove(
                  * remove whole extent */
                 LOGDBG("removing node [%lu, %lu]", node->start, node->end);
                 RB_REMOVE(inttree, &seg_tree->head, node);
-                free(node);
+                seg_tree_node_free(seg_tree, node);
                 seg_tree->count--;
             } else {
                 /* start <= node_s <= end < node_e
@@ -408,6 +451,7 @@ int seg_tree_remove(
         /* keep looking for nodes that overlap target region */
         node = seg_tree_find_nolock(seg_tree, start, end);
     }
+    seg_tree->last = RB_MAX(inttree, &seg_tree->head);
     seg_tree_unlock(seg_tree);
 
     return 0;
@@ -425,18 +469,18 @@ struct seg_tree_node* seg_tree_find_nolock(
     unsigned long start,
     unsigned long end)
 {
-    /* Create a range of just our starting byte offset */
-    struct seg_tree_node* node = seg_tree_node_alloc(start, start, 0, 0);
-    if (!node) {
-        return NULL;
-    }
+    /* Create a range of just our starting byte offset.  This is only
+     * used as a search key, so it lives on the stack rather than in the
+     * node pool, which may not be used under a read lock. */
+    struct seg_tree_node key;
+    memset(&key, 0, sizeof(key));
+    key.start = start;
+    key.end = start;
 
     /* Search tree for either a range that overlaps with
      * the target range (starting byte), or otherwise the
      * node for the next biggest starting byte. */
-    struct seg_tree_node* next = RB_NFIND(inttree, &seg_tree->head, node);
-
-    free(node);
+    struct seg_tree_node* next = RB_NFIND(inttree, &seg_tree->head, &key);
 
     /* We may have found a node that doesn't include our starting
      * byte offset, but it would be the range with the lowest
@@ -561,37 +605,28 @@ seg_tree_unlock(struct seg_tree* seg_tree)
 
 /*
  * Remove all nodes in seg_tree, but keep it initialized so you can
- * seg_tree_add() to it.
+ * seg_tree_add() to it.  Assumes you've already write-locked the tree.
  */
-void seg_tree_clear(struct seg_tree* seg_tree)
+void seg_tree_clear_nolock(struct seg_tree* seg_tree)
 {
-    struct seg_tree_node* node = NULL;
-    struct seg_tree_node* oldnode = NULL;
-
-    seg_tree_wrlock(seg_tree);
-
-    if (RB_EMPTY(&seg_tree->head)) {
-        /* seg_tree is empty, nothing to do */
-        seg_tree_unlock(seg_tree);
-        return;
-    }
-
-    /* Remove and free each node in the tree */
-    while ((node = seg_tree_iter(seg_tree, node))) {
-        if (oldnode) {
-            RB_REMOVE(inttree, &seg_tree->head, oldnode);
-            free(oldnode);
-        }
-        oldnode = node;
-    }
-    if (oldnode) {
-        RB_REMOVE(inttree, &seg_tree->head, oldnode);
-        free(oldnode);
-    }
+    /* All nodes come from the tree's pool, so rather than removing
+     * them one at a time, empty the tree and release the pool at once */
+    RB_INIT(&seg_tree->head);
+    node_pool_clear(&seg_tree->pool);
+    seg_tree->last = NULL;
 
     seg_tree->count = 0;
     seg_tree->max = 0;
+}
 
+/*
+ * Remove all nodes in seg_tree, but keep it initialized so you can
+ * seg_tree_add() to it.
+ */
+void seg_tree_clear(struct seg_tree* seg_tree)
+{
+    seg_tree_wrlock(seg_tree);
+    seg_tree_clear_nolock(seg_tree);
     seg_tree_unlock(seg_tree);
 }
 
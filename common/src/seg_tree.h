@@ -16,6 +16,7 @@
 #define __SEG_TREE_H__
 
 #include <abt.h>
+#include "node_pool.h"
 #include "tree.h"
 
 struct seg_tree_node {
@@ -31,6 +32,8 @@ struct seg_tree {
     ABT_rwlock rwlock;
     unsigned long count;     /* number of segments stored in tree */
     unsigned long max;       /* maximum logical offset value in the tree */
+    struct seg_tree_node* last; /* node with the highest offsets, or NULL */
+    struct node_pool pool;   /* node storage, used under the write lock */
 };
 
 /* Returns 0 on success, positive non-zero error code otherwise */
@@ -42,6 +45,12 @@ int seg_tree_init(struct seg_tree* seg_tree);
  */
 void seg_tree_clear(struct seg_tree* seg_tree);
 
+/*
+ * Remove all nodes in seg_tree, but keep it initialized so you can
+ * seg_tree_add() to it.  Assumes you've already write-locked the tree.
+ */
+void seg_tree_clear_nolock(struct seg_tree* seg_tree);
+
 /*
  * Remove and free all nodes in the seg_tree.
  */
@@ -53,6 +62,13 @@ void seg_tree_destroy(struct seg_tree* seg_tree);
 int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
     unsigned long end, unsigned long ptr, int client);
 
+/*
+ * Add an entry to the range tree.  Assumes you've already write-locked
+ * the tree.  Returns 0 on success, nonzero otherwise.
+ */
+int seg_tree_add_nolock(struct seg_tree* seg_tree, unsigned long start,
+    unsigned long end, unsigned long ptr, int client);
+
 /*
  * Remove or truncate one or more entries from the range tree
  * if they overlap [start, end].
@@ -17,89 +17,181 @@
 
 #include <assert.h>
 #include <stdbool.h> // bool
-#include <stdint.h>  // uint8_t
+#include <stdint.h>  // uint64_t
 #include <stdio.h>
 #include <stdlib.h>  // NULL
 #include <string.h>  // memset()
 
 
-/* Bit-twiddling convenience macros */
-#define SLOT_BYTE(slot) ((slot) >> 3)
-#define SLOT_BIT(slot) ((slot) & 0x7)
-#define BYTE_BIT_TO_SLOT(byte, bit) (((byte) * 8) + (bit))
-#define BYTE_VAL_BIT(byte_val, bit) ((byte_val) & (uint8_t)(1 << (bit)))
+/* The slot usage bitmap is managed as an array of 64-bit words, where
+ * slot N is tracked by bit (N % 64) of word (N / 64). On little-endian
+ * systems this is the same layout as a byte array where slot N is bit
+ * (N % 8) of byte (N / 8).
+ *
+ * Following the usage bitmap is a summary bitmap with one bit per usage
+ * word, which is set when all slots tracked by that word are in use. The
+ * summary lets searches skip over runs of 4096 fully-used slots using a
+ * single word comparison. */
+#define SLOTS_PER_WORD 64
+#define SLOT_WORD(slot) ((slot) >> 6)
+#define SLOT_BIT(slot) ((slot) & 0x3F)
+#define WORD_BIT_TO_SLOT(word, bit) (((word) * SLOTS_PER_WORD) + (bit))
+#define WORD_ALL_USED UINT64_MAX
+
+/* Return mask with bits [bit, bit+nbits) set, where nbits is in [1,64] */
+static inline
+uint64_t bit_range_mask(int bit, size_t nbits)
+{
+    uint64_t mask = (nbits >= SLOTS_PER_WORD) ?
+                    WORD_ALL_USED : (((uint64_t)1 << nbits) - 1);
+    return mask << bit;
+}
 
-/* Set given byte-bit in use map */
+/* Return number of words necessary to track given number of bits */
 static inline
-void set_usemap_byte_bit(uint8_t* usemap, size_t byte, int bit)
+size_t bits_to_words(size_t nbits)
 {
-    uint8_t byte_val = usemap[byte];
-    byte_val |= (uint8_t)(1 << bit);
-    usemap[byte] = byte_val;
+    return (nbits + (SLOTS_PER_WORD - 1)) / SLOTS_PER_WORD;
 }
 
-/* Clear given byte-bit in use map */
+/* Return bytes necessary to hold use map and summary map for given number
+ * of slots */
 static inline
-void clear_usemap_byte_bit(uint8_t* usemap, size_t byte, int bit)
+size_t slot_map_bytes(size_t total_slots)
 {
-    uint8_t byte_val = usemap[byte];
-    uint8_t byte_mask = (uint8_t)0xFF - (uint8_t)(1 << bit);
-    byte_val &= byte_mask;
-    usemap[byte] = byte_val;
+    size_t use_words = bits_to_words(total_slots);
+    size_t summary_words = bits_to_words(use_words);
+    return (use_words + summary_words) * sizeof(uint64_t);
 }
 
-/* Check use map for slot used */
+/* Slot usage bitmap immediately follows the structure in memory */
 static inline
-int check_slot(uint8_t* usemap, size_t slot)
+uint64_t* get_use_map(slot_map* smap)
 {
-    size_t byte = SLOT_BYTE(slot);
-    int bit = SLOT_BIT(slot);
-    uint8_t byte_val = usemap[byte];
-    if (BYTE_VAL_BIT(byte_val, bit)) {
-        return 1;
+    uint64_t* usemap = (uint64_t*)((char*)smap + sizeof(slot_map));
+    return usemap;
+}
+
+/* Summary bitmap immediately follows the slot usage bitmap */
+static inline
+uint64_t* get_summary_map(slot_map* smap)
+{
+    uint64_t* usemap = get_use_map(smap);
+    return usemap + bits_to_words(smap->total_slots);
+}
+
+/* Return the given use map word, with bits for any slots past the end of
+ * the slot map treated as used */
+static inline
+uint64_t get_use_word(slot_map* smap, uint64_t* usemap, size_t word)
+{
+    uint64_t word_val = usemap[word];
+    size_t tail_bits = SLOT_BIT(smap->total_slots);
+    if (tail_bits && (word == SLOT_WORD(smap->total_slots))) {
+        word_val |= ~(bit_range_mask(0, tail_bits));
     }
-    return 0;
+    return word_val;
 }
 
-/* Update use map to use slot */
+/* Update summary map bit for given use map word */
 static inline
-void use_slot(uint8_t* usemap, size_t slot)
+void update_summary(slot_map* smap, uint64_t* usemap, size_t word)
 {
-    size_t byte = SLOT_BYTE(slot);
-    int bit = SLOT_BIT(slot);
-    set_usemap_byte_bit(usemap, byte, bit);
+    uint64_t* summary = get_summary_map(smap);
+    uint64_t bit = (uint64_t)1 << SLOT_BIT(word);
+    if (get_use_word(smap, usemap, word) == WORD_ALL_USED) {
+        summary[SLOT_WORD(word)] |= bit;
+    } else {
+        summary[SLOT_WORD(word)] &= ~bit;
+    }
 }
 
-/* Update use map to release slot */
+/* Check use map for slot used */
 static inline
-void release_slot(uint8_t* usemap, size_t slot)
+int check_slot(uint64_t* usemap, size_t slot)
 {
-    size_t byte = SLOT_BYTE(slot);
-    int bit = SLOT_BIT(slot);
-    clear_usemap_byte_bit(usemap, byte, bit);
+    uint64_t word_val = usemap[SLOT_WORD(slot)];
+    if (word_val & ((uint64_t)1 << SLOT_BIT(slot))) {
+        return 1;
+    }
+    return 0;
 }
 
-/* Return bytes necessary to hold use map for given number of slots */
+/* Set (use != 0) or clear (use == 0) the given range of slots in the
+ * use map, and update the summary map for the modified words */
 static inline
-size_t slot_map_bytes(size_t total_slots)
+void update_slot_range(slot_map* smap,
+                       size_t start_slot,
+                       size_t num_slots,
+                       int use)
 {
-    size_t map_bytes = SLOT_BYTE(total_slots);
-    if (SLOT_BIT(total_slots)) {
-        map_bytes++;
+    uint64_t* usemap = get_use_map(smap);
+    size_t slot = start_slot;
+    size_t remaining = num_slots;
+    while (remaining) {
+        size_t word = SLOT_WORD(slot);
+        int bit = SLOT_BIT(slot);
+        size_t nbits = SLOTS_PER_WORD - bit;
+        if (nbits > remaining) {
+            nbits = remaining;
+        }
+        uint64_t mask = bit_range_mask(bit, nbits);
+        if (use) {
+            usemap[word] |= mask;
+        } else {
+            usemap[word] &= ~mask;
+        }
+        update_summary(smap, usemap, word);
+        slot += nbits;
+        remaining -= nbits;
     }
-    return map_bytes;
 }
 
-/* Slot usage bitmap immediately follows the structure in memory.
- * The usage bitmap can be thought of as an uint8_t array, where
- * each uint8_t represents 8 slots.
- *   uint8_t use_bitmap[total_slots/8]
- */
+/* Return index of first used slot at or after given slot, or -1 if none */
 static inline
-uint8_t* get_use_map(slot_map* smap)
+ssize_t find_next_used_slot(slot_map* smap, size_t slot)
 {
-    uint8_t* usemap = (uint8_t*)((char*)smap + sizeof(slot_map));
-    return usemap;
+    uint64_t* usemap = get_use_map(smap);
+    size_t n_words = bits_to_words(smap->total_slots);
+    size_t word = SLOT_WORD(slot);
+    if (slot >= smap->total_slots) {
+        return (ssize_t)-1;
+    }
+    uint64_t word_val = usemap[word] & (WORD_ALL_USED << SLOT_BIT(slot));
+    while (1) {
+        if (word_val) {
+            return (ssize_t)WORD_BIT_TO_SLOT(word, __builtin_ctzll(word_val));
+        }
+        if (++word == n_words) {
+            break;
+        }
+        word_val = usemap[word];
+    }
+    return (ssize_t)-1;
+}
+
+/* Return index of last used slot at or before given slot, or -1 if none */
+static inline
+ssize_t find_prev_used_slot(slot_map* smap, ssize_t slot)
+{
+    uint64_t* usemap = get_use_map(smap);
+    if (slot < 0) {
+        return (ssize_t)-1;
+    }
+    size_t word = SLOT_WORD((size_t)slot);
+    uint64_t word_val = usemap[word] &
+                        bit_range_mask(0, SLOT_BIT((size_t)slot) + 1);
+    while (1) {
+        if (word_val) {
+            int bit = (SLOTS_PER_WORD - 1) - __builtin_clzll(word_val);
+            return (ssize_t)WORD_BIT_TO_SLOT(word, bit);
+        }
+        if (word == 0) {
+            break;
+        }
+        word_val = usemap[--word];
+    }
+    return (ssize_t)-1;
 }
 
 /* Return number of free slots */
@@ -128,6 +220,12 @@ slot_map* slotmap_init(size_t num_slots,
         return NULL;
     }
 
+    /* the use map is accessed as 64-bit words */
+    assert(((uintptr_t)region_addr % sizeof(uint64_t)) == 0);
+
+    if (region_sz < sizeof(slot_map)) {
+        return NULL;
+    }
     size_t avail_use_bytes = region_sz - sizeof(slot_map);
     size_t needed_use_bytes = slot_map_bytes(num_slots);
     if (needed_use_bytes > avail_use_bytes) {
@@ -142,6 +240,19 @@ slot_map* slotmap_init(size_t num_slots,
     return smap;
 }
 
+/**
+ * Return the minimum memory region size needed by slotmap_init() to
+ * track the given number of slots.
+ *
+ * @param num_slots number of slots to track
+ *
+ * @return region size in bytes
+ */
+size_t slotmap_region_size(size_t num_slots)
+{
+    return sizeof(slot_map) + slot_map_bytes(num_slots);
+}
+
 /**
  * Clear the given slot_map. Marks all slots free.
  *
@@ -160,44 +271,31 @@ int slotmap_clear(slot_map* smap)
     smap->first_used_slot = -1;
     smap->last_used_slot = -1;
 
-    /* zero-out use map */
-    uint8_t* usemap = get_use_map(smap);
+    /* zero-out use map and summary map */
+    uint64_t* usemap = get_use_map(smap);
     memset((void*)usemap, 0, slot_map_bytes(smap->total_slots));
 
     return UNIFYFS_SUCCESS;
 }
 
+/* Find runs of num_slots (< 64) free slots that lie entirely within the
+ * given use map word. Returns a mask where bit N is set iff the slots for
+ * bits [N, N+num_slots) are all free. */
 static inline
-size_t find_consecutive_zero_bits(uint8_t byte_val,
-                                  size_t num_bits,
-                                  int* start_bit)
+uint64_t find_free_runs_in_word(uint64_t word_val,
+                                size_t num_slots)
 {
-    size_t max_free = 0;
-    int free_start = 0;
-    for (int bit = 0; bit < 8; bit++) {
-        /* starting at current bit, count consecutive zero bits */
-        int run_start = bit;
-        size_t run_max = 0;
-        while (!BYTE_VAL_BIT(byte_val, bit)) {
-            run_max++;
-            bit++;
-            if (bit == 8) {
-                break;
-            }
-        }
-        if (run_max > max_free) {
-            max_free = run_max;
-            free_start = run_start;
+    uint64_t runs = ~word_val;
+    size_t len = 1;
+    while (runs && (len < num_slots)) {
+        size_t shift = len;
+        if (shift > (num_slots - len)) {
+            shift = num_slots - len;
         }
+        runs &= (runs >> shift);
+        len += shift;
     }
-    if (NULL != start_bit) {
-        if (max_free >= num_bits) {
-            *start_bit = free_start;
-        } else {
-            *start_bit = -1; /* did not find enough bits */
-        }
-    }
-    return max_free;
+    return runs;
 }
 
 /**
@@ -221,83 +319,79 @@ ssize_t slotmap_reserve(slot_map* smap,
         return (ssize_t)-1;
     }
 
-    /* need this many usemap bytes for requested slots */
-    size_t slot_bytes = slot_map_bytes(num_slots);
-
     /* these will be set if we find a spot for the reservation */
-    size_t start_slot;
+    size_t start_slot = 0;
     int found_start = 0;
 
-    /* search for contiguous free slots */
-    size_t search_start = 0;
-    if ((smap->last_used_slot != -1) && (slot_bytes > 1)) {
-        /* skip past likely-used slots */
-        search_start = SLOT_BYTE(smap->last_used_slot);
-    }
-    uint8_t* usemap = get_use_map(smap);
-    size_t map_bytes = slot_map_bytes(smap->total_slots);
-    for (size_t byte_ndx = search_start; byte_ndx < map_bytes; byte_ndx++) {
-        uint8_t byte_val = usemap[byte_ndx];
-        if (byte_val == UINT8_MAX) {
-            /* current byte is completely occupied */
-            continue;
-        } else if ((slot_bytes > 1) &&
-                   ((byte_ndx + slot_bytes) <= map_bytes)) {
-            /* look for slot_bytes consecutive zero bytes */
-            size_t run_start = byte_ndx;
-            size_t run_count = 0;
-            while (0 == usemap[byte_ndx]) {
-                run_count++;
-                byte_ndx++;
-                if (run_count == slot_bytes) {
-                    /* success */
-                    start_slot = BYTE_BIT_TO_SLOT(run_start, 0);
-                    found_start = 1;
-                    break;
-                }
+    /* current run of free slots that spans use map words */
+    size_t run_start = 0;
+    size_t run_len = 0;
+
+    uint64_t* usemap = get_use_map(smap);
+    uint64_t* summary = get_summary_map(smap);
+    size_t n_words = bits_to_words(smap->total_slots);
+    size_t word = 0;
+    while (word < n_words) {
+        if (SLOT_BIT(word) == 0) {
+            /* at the start of a summary word, skip all the use words it
+             * tracks if they are all fully used */
+            uint64_t summary_val = summary[SLOT_WORD(word)];
+            if (summary_val == WORD_ALL_USED) {
+                run_len = 0;
+                word += SLOTS_PER_WORD;
+                continue;
+            }
+        }
+
+        uint64_t word_val = get_use_word(smap, usemap, word);
+        if (word_val == WORD_ALL_USED) {
+            /* current word is completely occupied */
+            run_len = 0;
+        } else if (word_val == 0) {
+            /* current word is completely free, extend the run */
+            if (0 == run_len) {
+                run_start = WORD_BIT_TO_SLOT(word, 0);
             }
+            run_len += SLOTS_PER_WORD;
         } else {
-            /* need at most 8 bits, spanning at most two bytes */
-            int bit_in_byte;
-            size_t free_bits = find_consecutive_zero_bits(byte_val, num_slots,
-                                                          &bit_in_byte);
-            if (free_bits >= num_slots) {
-                /* success, can reserve all slots in this byte of use map */
-                assert(bit_in_byte != -1);
-                start_slot = BYTE_BIT_TO_SLOT(byte_ndx, bit_in_byte);
+            /* free slots at the start of the word extend the current run */
+            size_t head_free = (size_t) __builtin_ctzll(word_val);
+            if (run_len && ((run_len + head_free) >= num_slots)) {
+                start_slot = run_start;
                 found_start = 1;
-            } else if ((byte_ndx + 1) < map_bytes) {
-                /* check if free bits are at the end of the byte */
-                find_consecutive_zero_bits(byte_val, free_bits, &bit_in_byte);
-                assert(bit_in_byte != -1);
-                if (bit_in_byte == (8 - free_bits)) {
-                    /* free bits are at tail end of byte,
-                     * check next byte for remaining needed slots */
-                    int bit_in_byte2;
-                    size_t have_bits = free_bits;
-                    size_t need_bits = num_slots - have_bits;
-                    byte_val = usemap[byte_ndx + 1];
-                    free_bits = find_consecutive_zero_bits(byte_val, need_bits,
-                                                           &bit_in_byte2);
-                    if ((free_bits >= need_bits) && (bit_in_byte2 == 0)) {
-                        /* success, has enough free bits at start of byte */
-                        start_slot = BYTE_BIT_TO_SLOT(byte_ndx, bit_in_byte);
-                        found_start = 1;
-                    }
+                break;
+            }
+
+            /* look for a run of free slots within the word */
+            if (num_slots < SLOTS_PER_WORD) {
+                uint64_t runs = find_free_runs_in_word(word_val, num_slots);
+                if (runs) {
+                    int bit = __builtin_ctzll(runs);
+                    start_slot = WORD_BIT_TO_SLOT(word, bit);
+                    found_start = 1;
+                    break;
                 }
             }
+
+            /* free slots at the end of the word start a new run */
+            size_t tail_free = (size_t) __builtin_clzll(word_val);
+            run_len = tail_free;
+            run_start = WORD_BIT_TO_SLOT(word, SLOTS_PER_WORD - tail_free);
         }
-        if (found_start) {
+
+        if (run_len >= num_slots) {
+            start_slot = run_start;
+            found_start = 1;
             break;
         }
+        word++;
     }
 
     if (found_start) {
         /* success, reserve bits in consecutive slots */
         size_t end_slot = start_slot + num_slots - 1;
-        for (size_t i = start_slot; i <= end_slot; i++) {
-            use_slot(usemap, i);
-        }
+        assert(end_slot < smap->total_slots);
+        update_slot_range(smap, start_slot, num_slots, 1);
         if ((smap->first_used_slot == -1) ||
             (start_slot < smap->first_used_slot)) {
             smap->first_used_slot = start_slot;
@@ -331,7 +425,12 @@ int slotmap_release(slot_map* smap,
         return EINVAL;
     }
 
-    uint8_t* usemap = get_use_map(smap);
+    if ((num_slots == 0) ||
+        ((start_index + num_slots) > smap->total_slots)) {
+        return EINVAL;
+    }
+
+    uint64_t* usemap = get_use_map(smap);
 
     /* make sure first bit at start slot index is actually set */
     if (!check_slot(usemap, start_index)) {
@@ -340,9 +439,7 @@ int slotmap_release(slot_map* smap,
 
     /* release the slots */
     size_t end_slot = start_index + num_slots - 1;
-    for (size_t i = start_index; i <= end_slot; i++) {
-        release_slot(usemap, i);
-    }
+    update_slot_range(smap, start_index, num_slots, 0);
     smap->used_slots -= num_slots;
 
     if (smap->used_slots == 0) {
@@ -353,25 +450,13 @@ int slotmap_release(slot_map* smap,
 
     /* find new first-used slot if necessary */
     if (start_index == smap->first_used_slot) {
-        ssize_t first_slot = end_slot + 1;
-        while ((first_slot < smap->total_slots) &&
-               (!check_slot(usemap, (size_t)first_slot))) {
-            first_slot++;
-        }
-        if (first_slot == smap->total_slots) {
-            first_slot = -1;
-        }
-        smap->last_used_slot = first_slot;
+        smap->first_used_slot = find_next_used_slot(smap, end_slot + 1);
     }
 
     /* find new last-used slot if necessary */
     if (end_slot == smap->last_used_slot) {
-        ssize_t last_slot = start_index - 1;
-        while ((last_slot >= 0) &&
-               (!check_slot(usemap, (size_t)last_slot))) {
-            last_slot--;
-        }
-        smap->last_used_slot = last_slot;
+        smap->last_used_slot = find_prev_used_slot(smap,
+                                                   (ssize_t)start_index - 1);
     }
 
     return UNIFYFS_SUCCESS;
@@ -388,7 +473,7 @@ void slotmap_print(slot_map* smap)
         return;
     }
 
-    uint8_t* usemap = get_use_map(smap);
+    uint64_t* usemap = get_use_map(smap);
 
     /* the '#' at the beginning of the lines is for compatibility with TAP */
     fprintf(stderr, "# Slot Map:\n");
@@ -29,10 +29,11 @@ typedef struct slot_map {
     ssize_t last_used_slot;
 } slot_map;
 
-/* The slot usage bitmap immediately follows the structure in memory.
- * The usage bitmap can be thought of as an uint8_t array, where
- * each uint8_t represents 8 slots.
- *   uint8_t use_bitmap[total_slots/8]
+/* The slot usage bitmap immediately follows the structure in memory,
+ * followed by a summary bitmap that tracks fully-used bitmap words.
+ * Both are uint64_t arrays, so the structure must be 8-byte aligned.
+ *   uint64_t use_bitmap[ceil(total_slots/64)]
+ *   uint64_t summary_bitmap[ceil(total_slots/4096)]
  */
 
 /**
@@ -50,6 +51,16 @@ slot_map* slotmap_init(size_t num_slots,
                        void* region_addr,
                        size_t region_sz);
 
+/**
+ * Return the minimum memory region size needed by slotmap_init() to
+ * track the given number of slots.
+ *
+ * @param num_slots number of slots to track
+ *
+ * @return region size in bytes
+ */
+size_t slotmap_region_size(size_t num_slots);
+
 /**
  * Clear the given slot_map. Marks all slots free.
  *
@@ -47,7 +47,8 @@ typedef enum {
     UNIFYFS_CLIENT_RPC_TRUNCATE,
     UNIFYFS_CLIENT_RPC_UNLINK,
     UNIFYFS_CLIENT_RPC_UNMOUNT,
-    UNIFYFS_CLIENT_RPC_NODE_LOCAL_EXTENTS_GET
+    UNIFYFS_CLIENT_RPC_NODE_LOCAL_EXTENTS_GET,
+    UNIFYFS_CLIENT_RPC_TYPE_COUNT /* must be last */
 } client_rpc_e;
 
 typedef enum {
@@ -63,6 +64,7 @@ typedef struct {
     void* input;
     void* bulk_buf;
     size_t bulk_sz;
+    uint64_t submit_time; /* when queued (nsec), for server rpc stats */
 } client_rpc_req_t;
 
 /* unifyfs_attach_rpc (client => server)
@@ -267,6 +269,29 @@ MERCURY_GEN_PROC(unifyfs_mread_req_data_in_t,
 MERCURY_GEN_PROC(unifyfs_mread_req_data_out_t, ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(unifyfs_mread_req_data_rpc)
 
+/* unifyfs_mread_req_local_rpc (server => client)
+ *
+ * Data location response for a single read request located at the
+ * specified read_index in the array of requests associated with the given
+ * mread_id, used when the data resides in the log of another client of the
+ * same application on this node. Rather than transferring the data, the
+ * server provides the log location so that the client can copy the data
+ * directly from the peer's log into the request buffer.
+ *
+ * read_offset is the offset to be added to the start offset of the request,
+ * and (log_client_id, log_offset, length) identify the data in the log. */
+MERCURY_GEN_PROC(unifyfs_mread_req_local_in_t,
+                 ((int32_t)(app_id))
+                 ((int32_t)(client_id))
+                 ((int32_t)(mread_id))
+                 ((int32_t)(read_index))
+                 ((hg_size_t)(read_offset))
+                 ((int32_t)(log_client_id))
+                 ((hg_size_t)(log_offset))
+                 ((hg_size_t)(length)))
+MERCURY_GEN_PROC(unifyfs_mread_req_local_out_t, ((int32_t)(ret)))
+DECLARE_MARGO_RPC_HANDLER(unifyfs_mread_req_local_rpc)
+
 /* unifyfs_mread_req_complete_rpc (server => client)
  *
  * Request completion response for a single read request located at the
@@ -333,6 +358,22 @@ MERCURY_GEN_PROC(unifyfs_get_gfids_out_t,
                 )
 DECLARE_MARGO_RPC_HANDLER(unifyfs_get_gfids_rpc)
 
+/* unifyfs_server_stats_rpc (client => server)
+ *
+ * returns a text report of the server's rpc statistics, pushed into the
+ * client's bulk buffer. report_size is the full report length (including
+ * the terminating nul), which may exceed the buffer size */
+MERCURY_GEN_PROC(unifyfs_server_stats_in_t,
+                 ((int32_t)(app_id))
+                 ((int32_t)(client_id))
+                 ((int32_t)(reset))
+                 ((hg_size_t)(bulk_size))
+                 ((hg_bulk_t)(bulk_report)))
+MERCURY_GEN_PROC(unifyfs_server_stats_out_t,
+                 ((int32_t)(ret))
+                 ((hg_size_t)(report_size)))
+DECLARE_MARGO_RPC_HANDLER(unifyfs_server_stats_rpc)
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -68,6 +68,8 @@
     UNIFYFS_CFG_CLI(unifyfs, configfile, STRING, /etc/unifyfs.conf, "path to configuration file", configurator_file_check, 'f', "specify full path to config file") \
     UNIFYFS_CFG_CLI(unifyfs, daemonize, BOOL, off, "enable server daemonization", NULL, 'D', "on|off") \
     UNIFYFS_CFG_CLI(unifyfs, mountpoint, STRING, /unifyfs, "mountpoint directory", NULL, 'm', "specify full path to desired mountpoint") \
+    UNIFYFS_CFG(client, attr_cache, BOOL, on, "cache global file attributes in the client", NULL) \
+    UNIFYFS_CFG(client, attr_lease_msecs, INT, UNIFYFS_CLIENT_ATTR_LEASE_MSECS, "milliseconds cached attributes of non-laminated files remain valid (0 = not cached)", NULL) \
     UNIFYFS_CFG(client, cwd, STRING, NULLSTRING, "current working directory", NULL) \
     UNIFYFS_CFG(client, excl_private, BOOL, on, "create node-local private files when given O_EXCL", NULL) \
     UNIFYFS_CFG(client, fsync_persist, BOOL, on, "persist written data to storage on fsync()", NULL) \
@@ -79,6 +81,7 @@
     UNIFYFS_CFG(client, unlink_usecs, INT, 0, "number of microsecs to sleep after initiating unlink rpc", NULL) \
     UNIFYFS_CFG(client, write_index_size, INT, UNIFYFS_CLIENT_WRITE_INDEX_SIZE, "write metadata index buffer size", NULL) \
     UNIFYFS_CFG(client, write_sync, BOOL, off, "sync every write to server", NULL) \
+    UNIFYFS_CFG(log, async, BOOL, on, "write warning, info, and debug messages from a background thread", NULL) \
     UNIFYFS_CFG_CLI(log, verbosity, INT, 0, "log verbosity level", NULL, 'v', "specify logging verbosity level") \
     UNIFYFS_CFG_CLI(log, file, STRING, unifyfsd.log, "log file name", NULL, 'l', "specify log file name") \
     UNIFYFS_CFG_CLI(log, dir, STRING, LOGDIR, "log file directory", configurator_directory_check, 'L', "specify full path to directory to contain log file") \
@@ -93,12 +96,18 @@
     UNIFYFS_CFG(margo, server_pool_size, INT, UNIFYFS_MARGO_POOL_SZ, "size of server's ULT pool for server-server RPCs", NULL) \
     UNIFYFS_CFG(margo, server_timeout, INT, UNIFYFS_MARGO_SERVER_SERVER_TIMEOUT_MSEC, "timeout in milliseconds for server-server RPCs", NULL) \
     UNIFYFS_CFG(margo, tcp, BOOL, on, "use TCP for server-to-server margo RPCs", NULL) \
+    UNIFYFS_CFG(meta, range_owners, BOOL, off, "distribute shared file extent metadata across servers by file offset range", NULL) \
     UNIFYFS_CFG(meta, range_size, INT, UNIFYFS_META_DEFAULT_SLICE_SZ, "metadata range size", NULL) \
     UNIFYFS_CFG_CLI(runstate, dir, STRING, RUNDIR, "runstate file directory", configurator_directory_check, 'R', "specify full path to directory to contain server-local state") \
+    UNIFYFS_CFG(server, direct_local_reads, BOOL, off, "let clients copy node-local read data directly from peer client logs", NULL) \
     UNIFYFS_CFG_CLI(server, hostfile, STRING, NULLSTRING, "server hostfile name", NULL, 'H', "specify full path to server hostfile") \
     UNIFYFS_CFG_CLI(server, init_timeout, INT, UNIFYFS_DEFAULT_INIT_TIMEOUT, "timeout of waiting for server initialization", NULL, 't', "timeout in seconds to wait for servers to be ready for clients") \
     UNIFYFS_CFG(server, local_extents, BOOL, off, "use server-cached extents to service local reads without consulting file owner", NULL) \
     UNIFYFS_CFG(server, max_app_clients, INT, UNIFYFS_SERVER_MAX_APP_CLIENTS, "maximum number of clients per application", NULL) \
+    UNIFYFS_CFG(server, reqmgr_threads, INT, UNIFYFS_SERVER_REQMGR_THREADS, "number of request manager threads servicing clients", NULL) \
+    UNIFYFS_CFG(server, transfer_buffer_size, INT, UNIFYFS_SERVER_TRANSFER_BUF_SIZE, "size of each buffer used to stage transfer data", NULL) \
+    UNIFYFS_CFG(server, transfer_direct_io, BOOL, off, "use O_DIRECT for aligned transfer writes to destination files", NULL) \
+    UNIFYFS_CFG(server, transfer_writers, INT, UNIFYFS_SERVER_TRANSFER_WRITERS, "number of concurrent writer threads per file transfer", NULL) \
     UNIFYFS_CFG_CLI(sharedfs, dir, STRING, NULLSTRING, "shared file system directory", configurator_directory_check, 'S', "specify full path to directory to contain server shared files") \
 
 #ifdef __cplusplus
@@ -53,6 +53,9 @@
 #define UNIFYFS_CLIENT_MAX_READ_COUNT 1000     /* max # active read requests */
 #define UNIFYFS_CLIENT_READ_TIMEOUT_SECONDS 60
 #define UNIFYFS_CLIENT_MAX_ACTIVE_REQUESTS 256 /* max concurrent client reqs */
+#define UNIFYFS_CLIENT_ATTR_LEASE_MSECS 0      /* non-laminated attr lease */
+#define UNIFYFS_CLIENT_ATTR_CACHE_MAX 65536    /* max cached file attrs */
+#define UNIFYFS_CLIENT_STATS_BUFSIZE (64 * KIB) /* server stats report buffer */
 
 // Log-based I/O Default Values
 #define UNIFYFS_LOGIO_CHUNK_SIZE (4 * MIB)
@@ -70,9 +73,13 @@
 // Server
 #define UNIFYFS_SERVER_MAX_BULK_TX_SIZE (8 * MIB) /* to-server transmit size */
 #define UNIFYFS_SERVER_MAX_DATA_TX_SIZE (4 * MIB) /* to-client transmit size */
+#define UNIFYFS_SERVER_READ_SEGMENT_SIZE (4 * MIB) /* chunk-read resp segment */
 #define UNIFYFS_SERVER_MAX_NUM_APPS 64   /* max # apps/mountpoints supported */
 #define UNIFYFS_SERVER_MAX_APP_CLIENTS 256  /* max # clients per application */
 #define UNIFYFS_SERVER_MAX_READS 2048   /* max # server read reqs per reqmgr */
+#define UNIFYFS_SERVER_REQMGR_THREADS 4 /* default # request manager threads */
+#define UNIFYFS_SERVER_TRANSFER_BUF_SIZE (16 * MIB) /* transfer buffer size */
+#define UNIFYFS_SERVER_TRANSFER_WRITERS 4 /* default # transfer writers */
 
 // Utilities
 #define UNIFYFS_DEFAULT_INIT_TIMEOUT 120    /* server init timeout (seconds) */
@@ -31,6 +31,10 @@
 #include "unifyfs_log.h"
 
 #include <assert.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/syscall.h>
@@ -42,6 +46,9 @@ unifyfs_log_level_t unifyfs_log_level = LOG_ERR;
 /* enable verbose logging on error */
 int unifyfs_log_on_error; // = 0
 
+/* queue non-error messages for the log writer thread */
+int unifyfs_log_async = 1;
+
 /* pointer to log file stream */
 FILE* unifyfs_log_stream; // = NULL
 
@@ -88,16 +95,86 @@ int unifyfs_log_open(const char* file)
 
 static const char* null_func = "?func?";
 
-/* print a message to the log with given time and source context */
-void unifyfs_log_print(time_t now,
-                       const char* srcfile,
-                       int lineno,
-                       const char* function,
-                       char* msg)
+/*
+ * Asynchronous logging
+ *
+ * Each thread that logs gets its own single-producer ring of fixed-size
+ * message records. The message is formatted directly into the next free
+ * record, which is then published by advancing the ring head. Nothing is
+ * locked and no system call is made on the logging thread. Timestamp
+ * formatting and writes to the log stream are left to a background
+ * writer thread, which merges the rings in timestamp order. Consumers of
+ * the rings (the writer thread, and threads writing synchronously) are
+ * serialized by print_mutex, which also protects the log stream.
+ *
+ * Rings are never freed. When a thread exits, its ring is released for
+ * reuse by a new thread once the writer has emptied it.
+ */
+
+#define LOG_RING_SLOTS 512 /* must be a power of two */
+#define LOG_RECORD_SIZE 1024
+#define LOG_WRITER_INTERVAL_NSEC 10000000L /* 10 ms */
+
+typedef struct {
+    struct timespec ts;
+    const char* file;
+    const char* func;
+    int lineno;
+    char msg[LOG_RECORD_SIZE - sizeof(struct timespec)
+             - (2 * sizeof(char*)) - sizeof(int)];
+} log_record;
+
+typedef struct log_ring {
+    /* producer-owned */
+    uint64_t head __attribute__((aligned(64)));
+
+    /* consumer-owned, updated with print_mutex held */
+    uint64_t tail __attribute__((aligned(64)));
+
+    int owned;    /* in use by a live thread */
+    pid_t tid;    /* thread that owns the ring */
+    struct log_ring* next;
+    log_record records[LOG_RING_SLOTS];
+} log_ring;
+
+/* list of all rings, only ever pushed onto */
+static log_ring* log_rings; // = NULL
+
+/* ring of the calling thread */
+static __thread log_ring* my_ring; // = NULL
+
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ring_key;
+
+/* serializes ring consumers and writes to the log stream */
+static pthread_mutex_t print_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* writer thread state */
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writer_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t writer_thread;
+static int writer_running; // = 0
+static int writer_exit; // = 0
+
+/* cached formatted timestamp, protected by print_mutex */
+static time_t last_ts_sec = (time_t)-1;
+static char last_ts_str[64];
+
+/* write one message, assumes print_mutex is held */
+static void log_write(time_t now,
+                      long tid,
+                      const char* srcfile,
+                      int lineno,
+                      const char* function,
+                      const char* msg)
 {
-    char timestamp[64] = {0};
-    struct tm* log_ltime = localtime(&now);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", log_ltime);
+    if (now != last_ts_sec) {
+        struct tm log_ltime;
+        localtime_r(&now, &log_ltime);
+        strftime(last_ts_str, sizeof(last_ts_str), "%Y-%m-%dT%H:%M:%S",
+                 &log_ltime);
+        last_ts_sec = now;
+    }
 
     char* file = (char*)srcfile;
     char* func = (char*)function;
@@ -107,15 +184,281 @@ void unifyfs_log_print(time_t now,
     if (NULL == func) {
         func = (char*) null_func;
     }
+    if (NULL == unifyfs_log_stream) {
+        unifyfs_log_stream = stderr;
+    }
     fprintf(unifyfs_log_stream, "%s tid=%ld @ %s() [%s:%d] %s\n",
-            timestamp, (long)unifyfs_gettid(), func, file, lineno, msg);
+            last_ts_str, tid, func, file, lineno, msg);
+}
+
+static int ts_before(const struct timespec* a, const struct timespec* b)
+{
+    return (a->tv_sec < b->tv_sec) ||
+           ((a->tv_sec == b->tv_sec) && (a->tv_nsec < b->tv_nsec));
+}
+
+/* write queued messages from all rings in timestamp order, returns
+ * number written. Assumes print_mutex is held. */
+static size_t log_drain(void)
+{
+    size_t n_rings = 0;
+    log_ring* ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+    for (; NULL != ring; ring = ring->next) {
+        n_rings++;
+    }
+
+    /* bound the work so a busy producer can't keep us here forever */
+    size_t max_written = n_rings * LOG_RING_SLOTS;
+    size_t n_written = 0;
+    while (n_written < max_written) {
+        log_ring* first = NULL;
+        log_record* first_rec = NULL;
+        ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+        for (; NULL != ring; ring = ring->next) {
+            uint64_t head = __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE);
+            if (ring->tail != head) {
+                log_record* rec =
+                    ring->records + (ring->tail & (LOG_RING_SLOTS - 1));
+                if ((NULL == first) || ts_before(&(rec->ts),
+                                                 &(first_rec->ts))) {
+                    first = ring;
+                    first_rec = rec;
+                }
+            }
+        }
+        if (NULL == first) {
+            break;
+        }
+
+        log_write(first_rec->ts.tv_sec, (long)first->tid,
+                  first_rec->file, first_rec->lineno, first_rec->func,
+                  first_rec->msg);
+        __atomic_store_n(&(first->tail), first->tail + 1, __ATOMIC_RELEASE);
+        n_written++;
+    }
+    return n_written;
+}
+
+void unifyfs_log_flush(void)
+{
+    pthread_mutex_lock(&print_mutex);
+    if (log_drain() && (NULL != unifyfs_log_stream)) {
+        fflush(unifyfs_log_stream);
+    }
+    pthread_mutex_unlock(&print_mutex);
+}
+
+static void* log_writer_main(void* arg)
+{
+    (void) arg;
+
+    pthread_mutex_lock(&writer_mutex);
+    while (!writer_exit) {
+        pthread_mutex_unlock(&writer_mutex);
+
+        unifyfs_log_flush();
+
+        /* sleep until woken by a filling ring or the interval expires */
+        struct timespec wake;
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_nsec += LOG_WRITER_INTERVAL_NSEC;
+        if (wake.tv_nsec >= 1000000000L) {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&writer_mutex);
+        if (!writer_exit) {
+            pthread_cond_timedwait(&writer_cond, &writer_mutex, &wake);
+        }
+    }
+    pthread_mutex_unlock(&writer_mutex);
+
+    unifyfs_log_flush();
+    return NULL;
+}
+
+static void log_writer_stop(void)
+{
+    pthread_mutex_lock(&writer_mutex);
+    int running = writer_running;
+    if (running) {
+        writer_exit = 1;
+        pthread_cond_signal(&writer_cond);
+    }
+    pthread_mutex_unlock(&writer_mutex);
+
+    if (running) {
+        pthread_join(writer_thread, NULL);
+        pthread_mutex_lock(&writer_mutex);
+        writer_running = 0;
+        writer_exit = 0;
+        pthread_mutex_unlock(&writer_mutex);
+    }
+}
+
+/* the writer thread does not survive fork, and the child must not
+ * inherit a locked print_mutex */
+static void log_atfork_prepare(void)
+{
+    pthread_mutex_lock(&print_mutex);
+}
+
+static void log_atfork_parent(void)
+{
+    pthread_mutex_unlock(&print_mutex);
+}
+
+static void log_atfork_child(void)
+{
+    pthread_mutex_init(&print_mutex, NULL);
+    pthread_mutex_init(&writer_mutex, NULL);
+    pthread_cond_init(&writer_cond, NULL);
+    writer_running = 0;
+    writer_exit = 0;
+}
+
+/* release the exiting thread's ring for reuse */
+static void log_ring_release(void* arg)
+{
+    log_ring* ring = (log_ring*) arg;
+    __atomic_store_n(&(ring->owned), 0, __ATOMIC_RELEASE);
+}
+
+static void log_init_once(void)
+{
+    pthread_key_create(&ring_key, log_ring_release);
+    pthread_atfork(log_atfork_prepare, log_atfork_parent, log_atfork_child);
+    atexit(log_writer_stop);
+}
+
+/* start the writer thread if needed, returns 1 if it is running */
+static int log_writer_start(void)
+{
+    pthread_once(&ring_key_once, log_init_once);
+
+    pthread_mutex_lock(&writer_mutex);
+    if (!writer_running) {
+        writer_exit = 0;
+        if (0 == pthread_create(&writer_thread, NULL, log_writer_main, NULL)) {
+            writer_running = 1;
+        }
+    }
+    int running = writer_running;
+    pthread_mutex_unlock(&writer_mutex);
+    return running;
+}
+
+/* get a ring for the calling thread, reusing a released one if possible */
+static log_ring* log_ring_acquire(void)
+{
+    log_ring* ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+    for (; NULL != ring; ring = ring->next) {
+        int unowned = 0;
+        uint64_t tail = __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE);
+        if ((tail == __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE))
+            && __atomic_compare_exchange_n(&(ring->owned), &unowned, 1, 0,
+                                           __ATOMIC_ACQ_REL,
+                                           __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (NULL == ring) {
+        ring = calloc(1, sizeof(*ring));
+        if (NULL == ring) {
+            return NULL;
+        }
+        ring->owned = 1;
+        ring->next = __atomic_load_n(&log_rings, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&log_rings, &(ring->next), ring,
+                                            0, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED)) {
+            /* ring->next was updated with the current list head */
+        }
+    }
+
+    ring->tid = unifyfs_gettid();
+    pthread_setspecific(ring_key, ring);
+    return ring;
+}
+
+void unifyfs_log_enqueue(const char* srcfile,
+                         int lineno,
+                         const char* function,
+                         const char* fmt, ...)
+{
+    va_list args;
+
+    /* (re)start the writer thread if needed, e.g. after log close */
+    log_ring* ring = NULL;
+    if (__atomic_load_n(&writer_running, __ATOMIC_RELAXED) ||
+        log_writer_start()) {
+        ring = my_ring;
+        if (NULL == ring) {
+            ring = log_ring_acquire();
+            my_ring = ring;
+        }
+    }
+
+    if (NULL != ring) {
+        uint64_t head = ring->head;
+        uint64_t tail = __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE);
+        if ((head - tail) < LOG_RING_SLOTS) {
+            log_record* rec = ring->records + (head & (LOG_RING_SLOTS - 1));
+            va_start(args, fmt);
+            int len = vsnprintf(rec->msg, sizeof(rec->msg), fmt, args);
+            va_end(args);
+            if ((len >= 0) && ((size_t)len < sizeof(rec->msg))) {
+                clock_gettime(CLOCK_REALTIME, &(rec->ts));
+                rec->file   = srcfile;
+                rec->func   = function;
+                rec->lineno = lineno;
+                __atomic_store_n(&(ring->head), head + 1, __ATOMIC_RELEASE);
+
+                /* wake the writer early if the ring is half full */
+                if ((head + 1 - tail) == (LOG_RING_SLOTS / 2)) {
+                    pthread_cond_signal(&writer_cond);
+                }
+                return;
+            }
+        }
+    }
+
+    /* the ring is full, or the message is too long for a record,
+     * so write it synchronously */
+    char msg[4096];
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    unifyfs_log_print(time(NULL), srcfile, lineno, function, msg);
+}
+
+/* print a message to the log with given time and source context */
+void unifyfs_log_print(time_t now,
+                       const char* srcfile,
+                       int lineno,
+                       const char* function,
+                       char* msg)
+{
+    pthread_mutex_lock(&print_mutex);
+
+    /* write queued messages first to keep the log in order */
+    log_drain();
+
+    log_write(now, (long)unifyfs_gettid(), srcfile, lineno, function, msg);
     fflush(unifyfs_log_stream);
+
+    pthread_mutex_unlock(&print_mutex);
 }
 
 /* close our log file stream.
  * returns UNIFYFS_SUCCESS on success */
 int unifyfs_log_close(void)
 {
+    /* write out any queued messages */
+    log_writer_stop();
+    unifyfs_log_flush();
+
     /* if stream is open, and its not stderr, close it */
     if (NULL != unifyfs_log_stream) {
         if (unifyfs_log_stream != stderr) {
@@ -143,6 +486,15 @@ void unifyfs_set_log_on_error(void)
     unifyfs_log_on_error = 1;
 }
 
+/* enable or disable queueing of messages for the log writer thread */
+void unifyfs_set_log_async(int enable)
+{
+    if (!enable) {
+        unifyfs_log_flush();
+    }
+    unifyfs_log_async = enable;
+}
+
 pid_t unifyfs_gettid(void)
 {
 #if defined(gettid)
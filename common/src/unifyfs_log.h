@@ -51,17 +51,29 @@ typedef enum {
 
 extern unifyfs_log_level_t unifyfs_log_level;
 extern int unifyfs_log_on_error;
+extern int unifyfs_log_async;
 extern FILE* unifyfs_log_stream;
 
 pid_t unifyfs_gettid(void);
 
-/* print one message to debug file stream */
+/* print one message to debug file stream, after any queued messages */
 void unifyfs_log_print(time_t now,
                        const char* srcfile,
                        int lineno,
                        const char* function,
                        char* msg);
 
+/* format message into the calling thread's log queue, to be written
+ * to the debug file stream by the background log writer thread */
+void unifyfs_log_enqueue(const char* srcfile,
+                         int lineno,
+                         const char* function,
+                         const char* fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+/* write all queued messages to the debug file stream */
+void unifyfs_log_flush(void);
+
 /* open specified file as debug file stream,
  * returns UNIFYFS_SUCCESS on success */
 int unifyfs_log_open(const char* file);
@@ -76,17 +88,30 @@ void unifyfs_set_log_level(unifyfs_log_level_t lvl);
 /* enable verbose logging upon error */
 void unifyfs_set_log_on_error(void);
 
+/* enable (1) or disable (0) queueing of warning, info, and debug messages
+ * for the background log writer thread */
+void unifyfs_set_log_async(int enable);
+
+/* Messages of warning level and above are queued when async logging is
+ * enabled, errors are always written synchronously (after the queued
+ * messages) so they are not lost if the process dies */
 #define LOG(level, ...) \
     do { \
         if (level <= unifyfs_log_level) { \
             if (NULL == unifyfs_log_stream) { \
                 unifyfs_log_stream = stderr; \
             } \
-            const char* srcfile = __FILE__; \
-            time_t log_time = time(NULL); \
-            char msg[4096] = {0}; \
-            scnprintf(msg, sizeof(msg), __VA_ARGS__); \
-            unifyfs_log_print(log_time, srcfile, __LINE__, __func__, msg); \
+            if ((level > LOG_ERR) && unifyfs_log_async) { \
+                unifyfs_log_enqueue(__FILE__, __LINE__, __func__, \
+                                    __VA_ARGS__); \
+            } else { \
+                const char* srcfile = __FILE__; \
+                time_t log_time = time(NULL); \
+                char msg[4096]; \
+                scnprintf(msg, sizeof(msg), __VA_ARGS__); \
+                unifyfs_log_print(log_time, srcfile, __LINE__, __func__, \
+                                  msg); \
+            } \
         } \
     } while (0)
 
@@ -18,6 +18,8 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <sched.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -32,6 +34,10 @@
 #define LOGIO_SHMEM_FMTSTR "logio_mem.%d.%d"
 #define LOGIO_SPILL_FMTSTR "%s/logio_spill.%d.%d"
 
+/* size of bounce buffer used to copy data when migrating between
+ * shmem and spill storage */
+#define LOGIO_MIGRATE_BUF_SIZE (1024 * 1024)
+
 
 /* log-based I/O header - first page of shmem region or spill file */
 typedef struct log_header {
@@ -40,26 +46,82 @@ typedef struct log_header {
     size_t reserved_sz;        /* reserved data bytes */
     size_t chunk_sz;           /* data chunk size */
     off_t  data_offset;        /* file/memory offset where data chunks start */
+    size_t live_offset;        /* header offset of chunk live byte counts */
+    size_t pin_offset;         /* header offset of chunk pin counts */
+
+    ssize_t open_chunk;        /* chunk used to pack small allocations,
+                                * or -1 if none is open */
+    size_t open_used;          /* bytes carved from the open chunk */
 
-    volatile int updating;     /* flag to prevent client/server update races */
+    int updating;              /* lock word to prevent client/server update
+                                * races, only accessed using atomic ops */
 } log_header;
 /* chunk slot_map immediately follows header and occupies rest of the page */
 // slot_map chunk_map;         /* chunk slot_map that tracks reservations */
+/* per-chunk live byte and pin counts occupy the end of the header pages */
+// chunk_live_t chunk_live[];  /* live bytes of packed chunks */
+// chunk_pin_t chunk_pins[];   /* active direct mappings of chunks */
+
+/* count of bytes still allocated from a packed chunk. chunks reserved
+ * by whole-chunk allocations are marked with LOGIO_CHUNK_WHOLE */
+typedef uint32_t chunk_live_t;
+#define LOGIO_CHUNK_WHOLE ((chunk_live_t)UINT32_MAX)
+
+/* count of direct memory mappings of a chunk. a chunk is not released
+ * while it is pinned, even if all its data has been freed */
+typedef uint32_t chunk_pin_t;
+
+/* number of busy-wait iterations before yielding the processor while
+ * waiting for the log header lock */
+#define LOG_HEADER_LOCK_SPINS 128
 
+/* hint to the processor that we are in a spin-wait loop */
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__powerpc64__)
+    __asm__ __volatile__("or 27,27,27" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/* The log header lock word lives in memory shared between the client
+ * process (all its threads) and the server, so we use a test-and-test-and-set
+ * spinlock built on atomic compare-and-swap. Waiters spin on a plain load
+ * (to avoid bouncing the cache line) and yield after a short spin, since
+ * the critical sections are only a slot map update. */
 static inline void LOCK_LOG_HEADER(log_header* hdr)
 {
     assert(NULL != hdr);
-    while (hdr->updating) {
-        usleep(10);
+    int* lock = &(hdr->updating);
+    while (1) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(lock, &expected, 1, 0,
+                                        __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+            return;
+        }
+        int spins = 0;
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+            if (++spins < LOG_HEADER_LOCK_SPINS) {
+                cpu_relax();
+            } else {
+                sched_yield();
+                spins = 0;
+            }
+        }
     }
-    hdr->updating = 1;
 }
 
 static inline void UNLOCK_LOG_HEADER(log_header* hdr)
 {
     assert(NULL != hdr);
-    assert(hdr->updating);
-    hdr->updating = 0;
+    assert(__atomic_load_n(&(hdr->updating), __ATOMIC_RELAXED));
+    __atomic_store_n(&(hdr->updating), 0, __ATOMIC_RELEASE);
 }
 
 static inline
@@ -69,6 +131,20 @@ slot_map* log_header_to_chunkmap(log_header* hdr)
     return (slot_map*)(hdrp + sizeof(log_header));
 }
 
+static inline
+chunk_live_t* log_header_to_livemap(log_header* hdr)
+{
+    char* hdrp = (char*) hdr;
+    return (chunk_live_t*)(hdrp + hdr->live_offset);
+}
+
+static inline
+chunk_pin_t* log_header_to_pinmap(log_header* hdr)
+{
+    char* hdrp = (char*) hdr;
+    return (chunk_pin_t*)(hdrp + hdr->pin_offset);
+}
+
 /* convenience method to return system page size */
 size_t get_page_size(void)
 {
@@ -273,32 +349,28 @@ int unifyfs_logio_init(const int app_id,
 }
 
 
-/* initialize the log header page for given log region and size
- * (note: intended for client use only) */
-static int init_log_header(char* log_region,
-                           size_t region_size,
-                           size_t chunk_size)
+/* determine the header layout for a log region of the given size. The
+ * header holds the log_header struct, followed by the chunk slot_map, and
+ * the chunk live byte and pin counts at its end. It occupies whole pages,
+ * and the data chunks use the rest of the region.
+ * Returns UNIFYFS_SUCCESS, or UNIFYFS_FAILURE if the region is too small */
+static int get_log_header_layout(size_t region_size,
+                                 size_t chunk_size,
+                                 size_t* hdr_size_out,
+                                 size_t* n_chunks_out,
+                                 size_t* live_size_out)
 {
     size_t pgsz = get_page_size();
 
-    /* TODO: need to think about how to support client re-attach */
-
-    /* log header structure resides at start of log region */
-    log_header* hdr = (log_header*) log_region;
-
-    /* zero all log header fields */
-    memset(log_region, 0, sizeof(log_header));
-    hdr->chunk_sz = chunk_size;
-
-    /* chunk slot map immediately follows header */
-    char* slotmap = log_region + sizeof(log_header);
+    if (0 == chunk_size) {
+        LOGERR("invalid logio chunk size 0");
+        return UNIFYFS_FAILURE;
+    }
 
-    /* determine number of pages necessary to hold chunkmap */
+    /* determine number of pages necessary to hold the header */
     size_t hdr_pages = 1;
-    size_t hdr_size = 0;
-    size_t data_size = 0;
     while (1) {
-        hdr_size = (hdr_pages * pgsz);
+        size_t hdr_size = (hdr_pages * pgsz);
         if (hdr_size >= region_size) {
             LOGERR("Failed chunk slotmap init (region_sz=%zu, chunk_sz=%zu)",
                    region_size, chunk_size);
@@ -309,22 +381,73 @@ static int init_log_header(char* log_region,
         size_t data_space = region_size - hdr_size;
         size_t n_chunks = data_space / chunk_size;
 
-        /* try to init chunk slotmap */
-        size_t slotmap_size = hdr_size - sizeof(log_header);
-        slot_map* chunkmap = slotmap_init(n_chunks, slotmap, slotmap_size);
-        if (NULL == chunkmap) {
-            LOGDBG("chunk slotmap init failed (sz=%zu, #chunks=%zu)",
-                   slotmap_size, n_chunks);
+        /* chunk live byte and pin counts are placed at the end of the
+         * header */
+        size_t live_size = n_chunks *
+                           (sizeof(chunk_live_t) + sizeof(chunk_pin_t));
+        if (live_size % sizeof(uint64_t)) {
+            /* keep the slotmap use words within 64-bit aligned space */
+            live_size += sizeof(uint64_t) - (live_size % sizeof(uint64_t));
+        }
+
+        size_t needed = sizeof(log_header) +
+                        slotmap_region_size(n_chunks) +
+                        live_size;
+        if (needed > hdr_size) {
             hdr_pages++;
             continue;
         }
 
-        /* the data_size is an exact multiple of chunk_size, which may be
-         * slightly less than the data_space */
-        data_size = n_chunks * chunk_size;
-        break;
+        *hdr_size_out = hdr_size;
+        *n_chunks_out = n_chunks;
+        *live_size_out = live_size;
+        return UNIFYFS_SUCCESS;
+    }
+}
+
+/* initialize the log header pages for given log region and size
+ * (note: intended for client use only) */
+static int init_log_header(char* log_region,
+                           size_t region_size,
+                           size_t chunk_size)
+{
+    size_t hdr_size;
+    size_t n_chunks;
+    size_t live_size;
+
+    /* TODO: need to think about how to support client re-attach */
+
+    int rc = get_log_header_layout(region_size, chunk_size,
+                                   &hdr_size, &n_chunks, &live_size);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
+
+    /* log header structure resides at start of log region */
+    log_header* hdr = (log_header*) log_region;
+
+    /* zero all log header fields */
+    memset(log_region, 0, sizeof(log_header));
+    hdr->chunk_sz = chunk_size;
+    hdr->open_chunk = -1;
+
+    /* chunk slot map immediately follows header */
+    char* slotmap = log_region + sizeof(log_header);
+    size_t slotmap_size = hdr_size - sizeof(log_header) - live_size;
+    slot_map* chunkmap = slotmap_init(n_chunks, slotmap, slotmap_size);
+    if (NULL == chunkmap) {
+        LOGERR("chunk slotmap init failed (sz=%zu, #chunks=%zu)",
+               slotmap_size, n_chunks);
+        return UNIFYFS_FAILURE;
     }
 
+    /* the data_size is an exact multiple of chunk_size, which may be
+     * slightly less than the data space after the header */
+    size_t data_size = n_chunks * chunk_size;
+    hdr->live_offset = hdr_size - live_size;
+    hdr->pin_offset = hdr->live_offset + (n_chunks * sizeof(chunk_live_t));
+    memset(log_region + hdr->live_offset, 0, live_size);
+
     hdr->hdr_sz = hdr_size;
     hdr->data_sz = data_size;
     hdr->data_offset = (off_t)hdr_size;
@@ -430,12 +553,16 @@ int unifyfs_logio_init_client(const int app_id,
             LOGERR("Failed to open logio spill file!");
             return UNIFYFS_FAILURE;
         } else {
-            /* estimate header size based on number of chunks */
-            size_t pgsz = get_page_size();
-            size_t n_chunks = spill_size / chunk_size;
-            size_t chunks_per_page = pgsz * 8; /* 8 chunks per map byte */
-            size_t n_pages = n_chunks / chunks_per_page;
-            n_pages++; /* +1 to account for logio metadata */
+            /* map all header pages, using the same layout that
+             * init_log_header() will use for the spill file */
+            size_t hdr_size, n_chunks, live_size;
+            rc = get_log_header_layout(spill_size, chunk_size,
+                                       &hdr_size, &n_chunks, &live_size);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("Failed to size logio spill file header");
+                return rc;
+            }
+            size_t n_pages = hdr_size / get_page_size();
 
             /* map start of the spill-over file, which contains log header
              * and chunk slot_map. client needs read and write access. */
@@ -495,8 +622,13 @@ int unifyfs_logio_close(logio_context* ctx,
 
     if (ctx->spill_sz) {
         if (NULL != ctx->spill_hdr) {
-            /* unmap log header page */
-            rc = munmap(ctx->spill_hdr, get_page_size());
+            /* unmap log header pages */
+            log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+            size_t hdr_sz = spill_hdr->hdr_sz;
+            if (hdr_sz < get_page_size()) {
+                hdr_sz = get_page_size();
+            }
+            rc = munmap(ctx->spill_hdr, hdr_sz);
             if (rc != 0) {
                 int err = errno;
                 LOGERR("Failed to unmap logio spill file header (errno=%s)",
@@ -521,6 +653,8 @@ int unifyfs_logio_close(logio_context* ctx,
                 LOGERR("Failed to unlink logio spill file %s (errno=%s)",
                        ctx->spill_file, strerror(err));
             }
+        }
+        if (ctx->spill_file != NULL) {
             free(ctx->spill_file);
         }
     }
@@ -531,6 +665,110 @@ int unifyfs_logio_close(logio_context* ctx,
     return UNIFYFS_SUCCESS;
 }
 
+/* mark chunks reserved by a whole-chunk allocation
+ * (note: caller must hold the log header lock) */
+static inline
+void mark_whole_chunks(log_header* hdr,
+                       size_t chunk_slot,
+                       size_t num_chunks)
+{
+    chunk_live_t* live = log_header_to_livemap(hdr);
+    for (size_t i = 0; i < num_chunks; i++) {
+        live[chunk_slot + i] = LOGIO_CHUNK_WHOLE;
+    }
+}
+
+/* allocations up to half a chunk are packed into the open chunk, larger
+ * ones get whole chunks so that packing never wastes more than half */
+static inline
+int is_packable(log_header* hdr,
+                size_t nbytes)
+{
+    return ((hdr->chunk_sz < (size_t)LOGIO_CHUNK_WHOLE) &&
+            (nbytes <= (hdr->chunk_sz / 2)));
+}
+
+/* carve nbytes from the open chunk of the given log, opening a new chunk
+ * when the current one is full. Returns data offset within the log,
+ * or -1 if no chunk is available (note: caller must hold the log header
+ * lock) */
+static off_t pack_alloc(log_header* hdr,
+                        size_t nbytes)
+{
+    chunk_live_t* live = log_header_to_livemap(hdr);
+    chunk_pin_t* pins = log_header_to_pinmap(hdr);
+    size_t chunk_sz = hdr->chunk_sz;
+
+    if ((-1 != hdr->open_chunk) && (0 == live[hdr->open_chunk]) &&
+        (0 == pins[hdr->open_chunk])) {
+        /* everything carved from the open chunk has been freed, reuse it
+         * from the start */
+        hdr->open_used = 0;
+    }
+
+    if ((-1 == hdr->open_chunk) ||
+        ((hdr->open_used + nbytes) > chunk_sz)) {
+        /* open a new chunk. the previous open chunk still has live bytes
+         * or pins, and will be released when the last of those goes */
+        slot_map* chunkmap = log_header_to_chunkmap(hdr);
+        ssize_t slot = slotmap_reserve(chunkmap, 1);
+        if (-1 == slot) {
+            return (off_t)-1;
+        }
+        live[slot] = 0;
+        hdr->reserved_sz += chunk_sz;
+        hdr->open_chunk = slot;
+        hdr->open_used = 0;
+    }
+
+    off_t off = (off_t)((hdr->open_chunk * chunk_sz) + hdr->open_used);
+    hdr->open_used += nbytes;
+    live[hdr->open_chunk] += (chunk_live_t) nbytes;
+    return off;
+}
+
+/* try to pack a small allocation into the open chunk of the shmem log,
+ * then the spill log. Returns ENOSPC if the allocation was not packed. */
+static int logio_pack_alloc(logio_context* ctx,
+                            const size_t nbytes,
+                            off_t* log_offset)
+{
+    off_t res_off;
+    size_t mem_size = 0;
+
+    if (NULL != ctx->shmem) {
+        log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+        mem_size = shmem_hdr->data_sz;
+        if (!is_packable(shmem_hdr, nbytes)) {
+            return ENOSPC;
+        }
+        LOCK_LOG_HEADER(shmem_hdr);
+        res_off = pack_alloc(shmem_hdr, nbytes);
+        UNLOCK_LOG_HEADER(shmem_hdr);
+        if (-1 != res_off) {
+            *log_offset = res_off;
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
+    if (NULL != ctx->spill_hdr) {
+        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+        if (!is_packable(spill_hdr, nbytes)) {
+            return ENOSPC;
+        }
+        LOCK_LOG_HEADER(spill_hdr);
+        res_off = pack_alloc(spill_hdr, nbytes);
+        UNLOCK_LOG_HEADER(spill_hdr);
+        if (-1 != res_off) {
+            /* update log offset to account for shmem log size */
+            *log_offset = res_off + (off_t)mem_size;
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
+    return ENOSPC;
+}
+
 /* Allocate write space from logio context */
 int unifyfs_logio_alloc(logio_context* ctx,
                         const size_t nbytes,
@@ -546,6 +784,11 @@ int unifyfs_logio_alloc(logio_context* ctx,
         return UNIFYFS_SUCCESS;
     }
 
+    /* small allocations share a partially-filled chunk */
+    if (UNIFYFS_SUCCESS == logio_pack_alloc(ctx, nbytes, log_offset)) {
+        return UNIFYFS_SUCCESS;
+    }
+
     size_t chunk_sz = 0;
     size_t allocated_bytes = 0;
     size_t needed_bytes = nbytes;
@@ -580,6 +823,7 @@ int unifyfs_logio_alloc(logio_context* ctx,
             /* success, all needed chunks allocated in shmem */
             allocated_bytes = res_chunks * chunk_sz;
             shmem_hdr->reserved_sz += allocated_bytes;
+            mark_whole_chunks(shmem_hdr, res_slot, res_chunks);
             UNLOCK_LOG_HEADER(shmem_hdr);
             res_off = (off_t)(res_slot * chunk_sz);
             *log_offset = res_off;
@@ -634,6 +878,7 @@ int unifyfs_logio_alloc(logio_context* ctx,
             if (0 == mem_res_at_end) {
                 /* success, full reservation in spill */
                 spill_hdr->reserved_sz += allocated_bytes;
+                mark_whole_chunks(spill_hdr, res_slot, res_chunks);
                 UNLOCK_LOG_HEADER(spill_hdr);
                 res_off = (off_t)(res_slot * chunk_sz);
                 if (NULL != shmem_hdr) {
@@ -675,6 +920,7 @@ int unifyfs_logio_alloc(logio_context* ctx,
                         /* success, full reservation in spill */
                         allocated_bytes = res_chunks * chunk_sz;
                         spill_hdr->reserved_sz += allocated_bytes;
+                        mark_whole_chunks(spill_hdr, res_slot, res_chunks);
                         UNLOCK_LOG_HEADER(spill_hdr);
                         res_off = (off_t)(res_slot * chunk_sz);
                         if (NULL != shmem_hdr) {
@@ -687,8 +933,10 @@ int unifyfs_logio_alloc(logio_context* ctx,
                 } else {
                     /* successful reservation spanning shmem and spill */
                     shmem_hdr->reserved_sz += mem_allocation;
+                    mark_whole_chunks(shmem_hdr, mem_res_slot, mem_res_nchk);
                     UNLOCK_LOG_HEADER(shmem_hdr);
                     spill_hdr->reserved_sz += allocated_bytes;
+                    mark_whole_chunks(spill_hdr, res_slot, res_chunks);
                     UNLOCK_LOG_HEADER(spill_hdr);
                     *log_offset = res_off;
                     return UNIFYFS_SUCCESS;
@@ -713,6 +961,65 @@ int unifyfs_logio_alloc(logio_context* ctx,
     return ENOSPC;
 }
 
+/* release the data bytes [offset, offset+nbytes) of the given log. Chunks
+ * from whole-chunk allocations are released on first free, while packed
+ * chunks are released once all their live bytes have been freed. Release
+ * of a pinned chunk is deferred until its last pin is dropped
+ * (note: caller must hold the log header lock) */
+static int release_log_range(log_header* hdr,
+                             off_t offset,
+                             size_t nbytes)
+{
+    int rc = UNIFYFS_SUCCESS;
+    slot_map* chunkmap = log_header_to_chunkmap(hdr);
+    chunk_live_t* live = log_header_to_livemap(hdr);
+    chunk_pin_t* pins = log_header_to_pinmap(hdr);
+    size_t chunk_sz = hdr->chunk_sz;
+    size_t range_start = (size_t) offset;
+    size_t range_end = range_start + nbytes;
+    size_t first_slot = range_start / chunk_sz;
+    size_t last_slot = (range_end - 1) / chunk_sz;
+
+    for (size_t slot = first_slot; slot <= last_slot; slot++) {
+        int release = 0;
+        if (LOGIO_CHUNK_WHOLE == live[slot]) {
+            live[slot] = 0;
+            release = 1;
+        } else if (live[slot] > 0) {
+            /* number of freed bytes that fall within this chunk */
+            size_t chunk_start = slot * chunk_sz;
+            size_t chunk_end = chunk_start + chunk_sz;
+            size_t start = (range_start > chunk_start) ? range_start
+                                                       : chunk_start;
+            size_t end = (range_end < chunk_end) ? range_end : chunk_end;
+            size_t freed = end - start;
+            if (freed >= live[slot]) {
+                live[slot] = 0;
+            } else {
+                live[slot] -= (chunk_live_t) freed;
+            }
+            if ((0 == live[slot]) && ((ssize_t)slot != hdr->open_chunk)) {
+                release = 1;
+            }
+        }
+
+        if (release && pins[slot]) {
+            /* chunk data is still mapped, dropping the last pin will
+             * release it */
+            release = 0;
+        }
+        if (release) {
+            live[slot] = 0;
+            int ret = slotmap_release(chunkmap, slot, 1);
+            if (ret != UNIFYFS_SUCCESS) {
+                rc = ret;
+            }
+            hdr->reserved_sz -= chunk_sz;
+        }
+    }
+    return rc;
+}
+
 /* Release previously allocated write space from logio context */
 int unifyfs_logio_free(logio_context* ctx,
                        const off_t log_offset,
@@ -729,7 +1036,6 @@ int unifyfs_logio_free(logio_context* ctx,
 
     log_header* shmem_hdr = NULL;
     log_header* spill_hdr = NULL;
-    slot_map* chunkmap;
 
     off_t mem_size = 0;
     if (NULL != ctx->shmem) {
@@ -738,7 +1044,6 @@ int unifyfs_logio_free(logio_context* ctx,
     }
 
     /* determine chunk allocations based on log offset */
-    size_t released_bytes;
     size_t sz_in_mem = 0;
     size_t sz_in_spill = 0;
     off_t spill_offset = 0;
@@ -748,36 +1053,23 @@ int unifyfs_logio_free(logio_context* ctx,
            log_offset, nbytes, sz_in_mem, sz_in_spill, (size_t)spill_offset);
 
     int rc = UNIFYFS_SUCCESS;
-    size_t chunk_sz, chunk_slot, num_chunks;
     if (sz_in_mem > 0) {
         /* release shared memory chunks */
         LOCK_LOG_HEADER(shmem_hdr);
-        chunk_sz = shmem_hdr->chunk_sz;
-        chunk_slot = log_offset / chunk_sz;
-        num_chunks = bytes_to_chunks(sz_in_mem, chunk_sz);
-        released_bytes = chunk_sz * num_chunks;
-        chunkmap = log_header_to_chunkmap(shmem_hdr);
-        rc = slotmap_release(chunkmap, chunk_slot, num_chunks);
+        rc = release_log_range(shmem_hdr, log_offset, sz_in_mem);
         if (rc != UNIFYFS_SUCCESS) {
             LOGERR("slotmap_release() for logio shmem failed");
         }
-        shmem_hdr->reserved_sz -= released_bytes;
         UNLOCK_LOG_HEADER(shmem_hdr);
     }
     if (sz_in_spill > 0) {
         /* release spill chunks */
         spill_hdr = (log_header*) ctx->spill_hdr;
         LOCK_LOG_HEADER(spill_hdr);
-        chunk_sz = spill_hdr->chunk_sz;
-        chunk_slot = spill_offset / chunk_sz;
-        num_chunks = bytes_to_chunks(sz_in_spill, chunk_sz);
-        released_bytes = chunk_sz * num_chunks;
-        chunkmap = log_header_to_chunkmap(spill_hdr);
-        rc = slotmap_release(chunkmap, chunk_slot, num_chunks);
+        rc = release_log_range(spill_hdr, spill_offset, sz_in_spill);
         if (rc != UNIFYFS_SUCCESS) {
             LOGERR("slotmap_release() for logio spill failed");
         }
-        spill_hdr->reserved_sz -= released_bytes;
         UNLOCK_LOG_HEADER(spill_hdr);
     }
     return rc;
@@ -858,6 +1150,183 @@ int unifyfs_logio_read(logio_context* ctx,
     }
 }
 
+/* adjust the pin counts of the chunks holding the data bytes
+ * [offset, offset+nbytes) of the given log. A chunk whose last pin is
+ * dropped after all its data was freed is released
+ * (note: caller must hold the log header lock) */
+static int pin_log_range(log_header* hdr,
+                         off_t offset,
+                         size_t nbytes,
+                         int pin)
+{
+    int rc = UNIFYFS_SUCCESS;
+    slot_map* chunkmap = log_header_to_chunkmap(hdr);
+    chunk_live_t* live = log_header_to_livemap(hdr);
+    chunk_pin_t* pins = log_header_to_pinmap(hdr);
+    size_t chunk_sz = hdr->chunk_sz;
+    size_t first_slot = (size_t)offset / chunk_sz;
+    size_t last_slot = ((size_t)offset + nbytes - 1) / chunk_sz;
+
+    for (size_t slot = first_slot; slot <= last_slot; slot++) {
+        if (pin) {
+            pins[slot]++;
+            continue;
+        }
+
+        if (0 == pins[slot]) {
+            LOGERR("unpin of unpinned log chunk %zu", slot);
+            rc = EINVAL;
+            continue;
+        }
+        pins[slot]--;
+        if ((0 == pins[slot]) && (0 == live[slot]) &&
+            ((ssize_t)slot != hdr->open_chunk)) {
+            /* data was freed while mapped, release the chunk now */
+            int ret = slotmap_release(chunkmap, slot, 1);
+            if (ret != UNIFYFS_SUCCESS) {
+                rc = ret;
+            }
+            hdr->reserved_sz -= chunk_sz;
+        }
+    }
+    return rc;
+}
+
+/* pin or unpin the chunks holding the given log data */
+static int logio_pin_range(logio_context* ctx,
+                           const off_t log_offset,
+                           const size_t nbytes,
+                           int pin)
+{
+    if ((NULL == ctx) || (0 == nbytes)) {
+        return EINVAL;
+    }
+
+    log_header* shmem_hdr = NULL;
+    off_t mem_size = 0;
+    if (NULL != ctx->shmem) {
+        shmem_hdr = (log_header*) ctx->shmem->addr;
+        mem_size = (off_t) shmem_hdr->data_sz;
+    }
+
+    size_t sz_in_mem = 0;
+    size_t sz_in_spill = 0;
+    off_t spill_offset = 0;
+    get_log_sizes(log_offset, nbytes, mem_size,
+                  &sz_in_mem, &sz_in_spill, &spill_offset);
+
+    int rc = UNIFYFS_SUCCESS;
+    if (sz_in_mem > 0) {
+        LOCK_LOG_HEADER(shmem_hdr);
+        rc = pin_log_range(shmem_hdr, log_offset, sz_in_mem, pin);
+        UNLOCK_LOG_HEADER(shmem_hdr);
+    }
+    if (sz_in_spill > 0) {
+        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+        LOCK_LOG_HEADER(spill_hdr);
+        int ret = pin_log_range(spill_hdr, spill_offset, sz_in_spill, pin);
+        UNLOCK_LOG_HEADER(spill_hdr);
+        if (ret != UNIFYFS_SUCCESS) {
+            rc = ret;
+        }
+    }
+    return rc;
+}
+
+/* Keep the chunks holding log data from being released */
+int unifyfs_logio_pin(logio_context* ctx,
+                      const off_t log_offset,
+                      const size_t nbytes)
+{
+    return logio_pin_range(ctx, log_offset, nbytes, 1);
+}
+
+/* Drop a pin taken by unifyfs_logio_pin() or unifyfs_logio_map() */
+int unifyfs_logio_unpin(logio_context* ctx,
+                        const off_t log_offset,
+                        const size_t nbytes)
+{
+    return logio_pin_range(ctx, log_offset, nbytes, 0);
+}
+
+/* Map data from logio context directly into memory */
+int unifyfs_logio_map(logio_context* ctx,
+                      const off_t log_offset,
+                      const size_t nbytes,
+                      const int prot,
+                      void** addr)
+{
+    if ((NULL == ctx) || (0 == nbytes) || (NULL == addr) ||
+        (prot & PROT_WRITE)) {
+        return EINVAL;
+    }
+
+    log_header* shmem_hdr = NULL;
+    off_t mem_size = 0;
+    if (NULL != ctx->shmem) {
+        shmem_hdr = (log_header*) ctx->shmem->addr;
+        mem_size = (off_t) shmem_hdr->data_sz;
+    }
+
+    size_t sz_in_mem = 0;
+    size_t sz_in_spill = 0;
+    off_t spill_offset = 0;
+    get_log_sizes(log_offset, nbytes, mem_size,
+                  &sz_in_mem, &sz_in_spill, &spill_offset);
+    if (sz_in_mem && sz_in_spill) {
+        /* data spans shared memory and spillover file */
+        return ENOTSUP;
+    }
+
+    int fd;
+    off_t map_offset;
+    if (sz_in_mem) {
+        /* open a new descriptor for the shmem region, so that the mapping
+         * is independent of our existing read-write mapping */
+        fd = shm_open(ctx->shmem->name, O_RDONLY, 0);
+        if (-1 == fd) {
+            int err = errno;
+            LOGERR("shm_open(%s) failed - %s",
+                   ctx->shmem->name, strerror(err));
+            return err;
+        }
+        map_offset = shmem_hdr->data_offset + log_offset;
+    } else {
+        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+        fd = ctx->spill_fd;
+        map_offset = spill_hdr->data_offset + spill_offset;
+    }
+
+    int rc = UNIFYFS_SUCCESS;
+    if (map_offset % get_page_size()) {
+        rc = ENOTSUP;
+    } else {
+        /* pin the chunks before mapping, so they can't be released and
+         * reused while the mapping exists */
+        rc = unifyfs_logio_pin(ctx, log_offset, nbytes);
+    }
+    if (rc == UNIFYFS_SUCCESS) {
+        int flags = MAP_SHARED;
+        if (NULL != *addr) {
+            flags |= MAP_FIXED;
+        }
+        void* map = mmap(*addr, nbytes, prot, flags, fd, map_offset);
+        if (MAP_FAILED == map) {
+            rc = errno;
+            LOGERR("mmap(fd=%d, off=%zu, sz=%zu) failed - %s",
+                   fd, (size_t)map_offset, nbytes, strerror(rc));
+            unifyfs_logio_unpin(ctx, log_offset, nbytes);
+        } else {
+            *addr = map;
+        }
+    }
+
+    if (sz_in_mem) {
+        close(fd);
+    }
+    return rc;
+}
+
 /* Write data to logio context */
 int unifyfs_logio_write(logio_context* ctx,
                         const off_t log_offset,
@@ -936,6 +1405,203 @@ int unifyfs_logio_write(logio_context* ctx,
     }
 }
 
+/* allocate nbytes from a single log (shmem or spill), returning the data
+ * offset within that log */
+static int log_alloc(log_header* hdr,
+                     size_t nbytes,
+                     off_t* offset)
+{
+    int rc = UNIFYFS_SUCCESS;
+    LOCK_LOG_HEADER(hdr);
+    if (is_packable(hdr, nbytes)) {
+        *offset = pack_alloc(hdr, nbytes);
+        if (-1 == *offset) {
+            rc = ENOSPC;
+        }
+    } else {
+        slot_map* chunkmap = log_header_to_chunkmap(hdr);
+        size_t n_chunks = bytes_to_chunks(nbytes, hdr->chunk_sz);
+        ssize_t slot = slotmap_reserve(chunkmap, n_chunks);
+        if (-1 == slot) {
+            rc = ENOSPC;
+        } else {
+            hdr->reserved_sz += n_chunks * hdr->chunk_sz;
+            mark_whole_chunks(hdr, slot, n_chunks);
+            *offset = (off_t)(slot * hdr->chunk_sz);
+        }
+    }
+    UNLOCK_LOG_HEADER(hdr);
+    return rc;
+}
+
+/* Move data between shmem and spill storage */
+int unifyfs_logio_migrate(logio_context* ctx,
+                          const off_t log_offset,
+                          const size_t nbytes,
+                          const int to_shmem,
+                          off_t* new_offset)
+{
+    if ((NULL == ctx) || (NULL == new_offset)) {
+        return EINVAL;
+    }
+
+    *new_offset = log_offset;
+    if ((0 == nbytes) || (NULL == ctx->shmem) || (NULL == ctx->spill_hdr)) {
+        /* nothing to move, or nowhere to move it */
+        return UNIFYFS_SUCCESS;
+    }
+
+    log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+    log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+    off_t mem_size = (off_t) shmem_hdr->data_sz;
+
+    size_t sz_in_mem = 0;
+    size_t sz_in_spill = 0;
+    off_t spill_offset = 0;
+    get_log_sizes(log_offset, nbytes, mem_size,
+                  &sz_in_mem, &sz_in_spill, &spill_offset);
+    if ((to_shmem && (0 == sz_in_spill)) ||
+        (!to_shmem && (0 == sz_in_mem))) {
+        /* already in target storage */
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* allocate space in target storage */
+    off_t res_off;
+    int rc = log_alloc((to_shmem ? shmem_hdr : spill_hdr), nbytes, &res_off);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGDBG("no space to move %zu bytes to %s", nbytes,
+               (to_shmem ? "shmem" : "spill"));
+        return rc;
+    }
+    if (!to_shmem) {
+        res_off += mem_size;
+    }
+
+    /* copy the data */
+    size_t bufsz = nbytes;
+    if (bufsz > LOGIO_MIGRATE_BUF_SIZE) {
+        bufsz = LOGIO_MIGRATE_BUF_SIZE;
+    }
+    char* buf = (char*) malloc(bufsz);
+    if (NULL == buf) {
+        rc = ENOMEM;
+    }
+    size_t copied = 0;
+    while ((rc == UNIFYFS_SUCCESS) && (copied < nbytes)) {
+        size_t len = nbytes - copied;
+        if (len > bufsz) {
+            len = bufsz;
+        }
+        size_t nread = 0;
+        rc = unifyfs_logio_read(ctx, log_offset + copied, len, buf, &nread);
+        if ((rc == UNIFYFS_SUCCESS) && (nread != len)) {
+            rc = EIO;
+        }
+        if (rc == UNIFYFS_SUCCESS) {
+            size_t nwrite = 0;
+            rc = unifyfs_logio_write(ctx, res_off + copied, len, buf,
+                                     &nwrite);
+            if ((rc == UNIFYFS_SUCCESS) && (nwrite != len)) {
+                rc = EIO;
+            }
+        }
+        copied += len;
+    }
+    free(buf);
+
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to copy %zu bytes from log offset %zu to %zu",
+               nbytes, (size_t)log_offset, (size_t)res_off);
+        unifyfs_logio_free(ctx, res_off, nbytes);
+        return rc;
+    }
+
+    LOGDBG("moved %zu bytes from log offset %zu to %zu",
+           nbytes, (size_t)log_offset, (size_t)res_off);
+    *new_offset = res_off;
+    return UNIFYFS_SUCCESS;
+}
+
+/* Pass expected access to log data on to the operating system */
+int unifyfs_logio_advise(logio_context* ctx,
+                         const off_t log_offset,
+                         const size_t nbytes,
+                         const logio_advice_e advice)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+
+    if (0 == nbytes) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    log_header* shmem_hdr = NULL;
+    off_t mem_size = 0;
+    if (NULL != ctx->shmem) {
+        shmem_hdr = (log_header*) ctx->shmem->addr;
+        mem_size = (off_t) shmem_hdr->data_sz;
+    }
+
+    size_t sz_in_mem = 0;
+    size_t sz_in_spill = 0;
+    off_t spill_offset = 0;
+    get_log_sizes(log_offset, nbytes, mem_size,
+                  &sz_in_mem, &sz_in_spill, &spill_offset);
+
+    int rc = UNIFYFS_SUCCESS;
+    if ((sz_in_mem > 0) && (advice != LOGIO_ADVICE_DONTNEED)) {
+        /* shmem pages can not be dropped without losing the data, but
+         * they can be faulted in ahead of use. madvise() requires a
+         * page-aligned start address. */
+        size_t pgsz = get_page_size();
+        char* shmem_data = (char*)(ctx->shmem->addr) + shmem_hdr->data_offset;
+        char* start = shmem_data + log_offset;
+        size_t pg_off = (size_t)((uintptr_t)start % pgsz);
+        int madv = MADV_WILLNEED;
+        if (advice == LOGIO_ADVICE_SEQUENTIAL) {
+            madv = MADV_SEQUENTIAL;
+        }
+        if (0 != madvise(start - pg_off, sz_in_mem + pg_off, madv)) {
+            rc = errno;
+            LOGERR("madvise(shmem) failed - %s", strerror(rc));
+        }
+    }
+    if (sz_in_spill > 0) {
+        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+        spill_offset += spill_hdr->data_offset;
+
+        int fadv = POSIX_FADV_WILLNEED;
+        if (advice == LOGIO_ADVICE_DONTNEED) {
+            /* the page cache only drops clean pages, so write back any
+             * dirty spill data first */
+            if (0 != sync_file_range(ctx->spill_fd, spill_offset,
+                                     (off_t)sz_in_spill,
+                                     (SYNC_FILE_RANGE_WAIT_BEFORE |
+                                      SYNC_FILE_RANGE_WRITE |
+                                      SYNC_FILE_RANGE_WAIT_AFTER))) {
+                rc = errno;
+                LOGERR("sync_file_range(spillfile) failed - %s",
+                       strerror(rc));
+            }
+            fadv = POSIX_FADV_DONTNEED;
+        } else if (advice == LOGIO_ADVICE_SEQUENTIAL) {
+            /* sequential access doubles the read-ahead window, then
+             * start reading ahead */
+            posix_fadvise(ctx->spill_fd, spill_offset, (off_t)sz_in_spill,
+                          POSIX_FADV_SEQUENTIAL);
+        }
+        int ret = posix_fadvise(ctx->spill_fd, spill_offset,
+                                (off_t)sz_in_spill, fadv);
+        if (ret != 0) {
+            rc = ret;
+            LOGERR("posix_fadvise(spillfile) failed - %s", strerror(rc));
+        }
+    }
+    return rc;
+}
+
 /* Sync any spill data to disk for given logio context */
 int unifyfs_logio_sync(logio_context* ctx)
 {
@@ -36,6 +36,13 @@ typedef struct logio_context {
     int    spill_fd;      /* spillover file descriptor */
 } logio_context;
 
+/* expected access to log data, see unifyfs_logio_advise() */
+typedef enum {
+    LOGIO_ADVICE_WILLNEED = 0, /* data will be accessed soon */
+    LOGIO_ADVICE_DONTNEED,     /* data will not be accessed soon */
+    LOGIO_ADVICE_SEQUENTIAL    /* data will be accessed sequentially */
+} logio_advice_e;
+
 /**
  * Initialize logio context for server.
  *
@@ -118,6 +125,57 @@ int unifyfs_logio_read(logio_context* ctx,
                        char* buf,
                        size_t* obytes);
 
+/**
+ * Map data from logio context at given log offset directly into memory,
+ * without copying. This is only possible when the data is not split
+ * between shmem and spill storage, and its storage offset is page-aligned.
+ * The chunks holding the data are pinned, so they are not released and
+ * reused while mapped. The caller releases the mapping with munmap(),
+ * then drops the pin with unifyfs_logio_unpin().
+ *
+ * @param ctx pointer to logio context
+ * @param log_offset log offset of data to map
+ * @param nbytes number of bytes to map
+ * @param prot memory protection of the mapping (must not allow writes)
+ * @param[in,out] addr if *addr is not NULL, the page-aligned address at
+ *                which to map the data (replacing any existing mapping).
+ *                Set to start address of the mapping
+ * @return UNIFYFS_SUCCESS, ENOTSUP if the data can't be mapped directly,
+ *         or error code
+ */
+int unifyfs_logio_map(logio_context* ctx,
+                      const off_t log_offset,
+                      const size_t nbytes,
+                      const int prot,
+                      void** addr);
+
+/**
+ * Pin the log chunks holding the given data. A pinned chunk is not
+ * released when its data is freed, until the last pin is dropped.
+ *
+ * @param ctx pointer to logio context
+ * @param log_offset log offset of pinned data
+ * @param nbytes number of bytes of pinned data
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_pin(logio_context* ctx,
+                      const off_t log_offset,
+                      const size_t nbytes);
+
+/**
+ * Drop a pin on the log chunks holding the given data, taken by
+ * unifyfs_logio_pin() or unifyfs_logio_map(). Chunks whose data was freed
+ * while pinned are released when their last pin is dropped.
+ *
+ * @param ctx pointer to logio context
+ * @param log_offset log offset of pinned data
+ * @param nbytes number of bytes of pinned data
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_unpin(logio_context* ctx,
+                        const off_t log_offset,
+                        const size_t nbytes);
+
 /**
  * Write data to logio context at given log offset.
  *
@@ -134,6 +192,44 @@ int unifyfs_logio_write(logio_context* ctx,
                         const char* buf,
                         size_t* obytes);
 
+/**
+ * Move data at given log offset to shmem or spill storage. New space is
+ * allocated in the target storage and the data is copied there. The old
+ * space is not released, so the caller should free it once all references
+ * to the old log offset have been updated. If the data is already in the
+ * target storage, or the context has only one kind of storage, new_offset
+ * is set to log_offset.
+ *
+ * @param ctx pointer to logio context
+ * @param log_offset log offset of data to move
+ * @param nbytes number of bytes to move
+ * @param to_shmem non-zero to move data to shmem, zero to move to spill
+ * @param[out] new_offset set to log offset of moved data
+ * @return UNIFYFS_SUCCESS, ENOSPC if the target storage is full,
+ *         or error code
+ */
+int unifyfs_logio_migrate(logio_context* ctx,
+                          const off_t log_offset,
+                          const size_t nbytes,
+                          const int to_shmem,
+                          off_t* new_offset);
+
+/**
+ * Pass expected access to data at given log offset on to the operating
+ * system, so that spill data may be read ahead into (or dropped from)
+ * the page cache, and shmem pages may be faulted in.
+ *
+ * @param ctx pointer to logio context
+ * @param log_offset log offset of data
+ * @param nbytes number of bytes
+ * @param advice expected access
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_advise(logio_context* ctx,
+                         const off_t log_offset,
+                         const size_t nbytes,
+                         const logio_advice_e advice);
+
 /**
  * Sync any spill data to disk for given logio context.
  *
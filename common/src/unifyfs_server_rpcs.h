@@ -52,7 +52,7 @@ typedef enum {
     UNIFYFS_SERVER_BCAST_RPC_TRANSFER,
     UNIFYFS_SERVER_BCAST_RPC_TRUNCATE,
     UNIFYFS_SERVER_BCAST_RPC_UNLINK,
-    UNIFYFS_SERVER_PENDING_SYNC
+    UNIFYFS_SERVER_RPC_TYPE_COUNT /* must be last */
 } server_rpc_e;
 
 /* structure to track server-to-server rpc request state */
@@ -63,6 +63,7 @@ typedef struct {
     void* input;
     void* bulk_buf;
     size_t bulk_sz;
+    uint64_t submit_time; /* when queued (nsec), for rpc stats */
 } server_rpc_req_t;
 
 /*---- Server Point-to-Point (p2p) RPCs ----*/
@@ -89,24 +90,32 @@ MERCURY_GEN_PROC(chunk_read_request_out_t,
                  ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(chunk_read_request_rpc)
 
-/* Chunk read response */
+/* Chunk read response
+ *
+ * The responses for a chunk read request are sent as a sequence of
+ * num_segs bounded-size segments, each holding num_chks read response
+ * headers followed by the corresponding data. */
 MERCURY_GEN_PROC(chunk_read_response_in_t,
                  ((int32_t)(src_rank))
                  ((int32_t)(app_id))
                  ((int32_t)(client_id))
                  ((int32_t)(req_id))
                  ((int32_t)(num_chks))
+                 ((int32_t)(num_segs))
                  ((hg_size_t)(bulk_size))
                  ((hg_bulk_t)(bulk_handle)))
 MERCURY_GEN_PROC(chunk_read_response_out_t,
                  ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(chunk_read_response_rpc)
 
-/* Add file extents at owner */
+/* Add file extents at owner. Range owners also get the file attributes,
+ * in case they have not yet seen the file create broadcast */
 MERCURY_GEN_PROC(add_extents_in_t,
                  ((int32_t)(src_rank))
                  ((int32_t)(gfid))
                  ((int32_t)(num_extents))
+                 ((hg_size_t)(file_size))
+                 ((unifyfs_file_attr_t)(attr))
                  ((hg_bulk_t)(extents)))
 MERCURY_GEN_PROC(add_extents_out_t,
                  ((int32_t)(ret)))
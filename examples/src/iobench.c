@@ -0,0 +1,802 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * End-to-end I/O benchmark using the UnifyFS library API.
+ *
+ * Each rank writes its blocks using one of the supported access patterns,
+ * then the data is synced, laminated, read back by the writer (local read),
+ * read by a different rank (remote read), and optionally transferred out
+ * of UnifyFS. Every operation is timed individually, and rank 0 reports
+ * the latency distribution and bandwidth of each phase as JSON.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <mpi.h>
+#include "unifyfs_api.h"
+
+#include "testlib.h"
+
+/* access patterns */
+enum {
+    PATTERN_NN = 0,      /* file per rank */
+    PATTERN_SEGMENTED,   /* shared file, contiguous segment per rank */
+    PATTERN_STRIDED,     /* shared file, blocks interleaved across ranks */
+    PATTERN_SMALL        /* shared file, interleaved small records */
+};
+
+static const char* pattern_names[] = {
+    "nn",
+    "n1-segmented",
+    "n1-strided",
+    "small"
+};
+
+/* benchmark phases, in execution order */
+enum {
+    PHASE_WRITE = 0,
+    PHASE_SYNC,
+    PHASE_LAMINATE,
+    PHASE_READ_LOCAL,
+    PHASE_READ_REMOTE,
+    PHASE_TRANSFER,
+    NUM_PHASES
+};
+
+static const char* phase_names[NUM_PHASES] = {
+    "write",
+    "sync",
+    "laminate",
+    "local_read",
+    "remote_read",
+    "transfer"
+};
+
+/* Latency histogram with LAT_SUB linear sub-buckets per power of two,
+ * giving percentiles within 12.5% of the recorded value over the full
+ * range of 64-bit nanosecond latencies */
+#define LAT_SUB_BITS 3
+#define LAT_SUB (1 << LAT_SUB_BITS)
+#define LAT_BUCKETS (LAT_SUB * (64 - LAT_SUB_BITS + 1))
+
+typedef struct {
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t elapsed_ns;   /* wall time of the phase on this rank */
+    uint64_t errors;
+    uint64_t bucket[LAT_BUCKETS];
+} lat_hist;
+
+static lat_hist phase_hist[NUM_PHASES];
+static int phase_ran[NUM_PHASES];
+
+/* options */
+static int rank;
+static int total_ranks;
+static int pattern = PATTERN_STRIDED;
+static int check;
+static int debug;
+static int keep;
+static int laminate = 1;
+static size_t block_sz;
+static size_t xfer_sz;
+static size_t n_blocks;
+static char* mountpoint;    /* unifyfs mountpoint */
+static char* filename;      /* base name of the test file(s) */
+static char* dst_dir;       /* transfer destination directory */
+static char* outfile;       /* JSON output file */
+static char* logio_chunk;
+static char* logio_shmem;
+static char* logio_spill;
+
+static struct option long_opts[] = {
+    { "blocksize", 1, 0, 'b' },
+    { "check", 0, 0, 'c' },
+    { "chunk-size", 1, 0, 'C' },
+    { "debug", 0, 0, 'd' },
+    { "destination", 1, 0, 'D' },
+    { "file", 1, 0, 'f' },
+    { "help", 0, 0, 'h' },
+    { "keep", 0, 0, 'k' },
+    { "no-laminate", 0, 0, 'L' },
+    { "mount", 1, 0, 'm' },
+    { "nblocks", 1, 0, 'n' },
+    { "output", 1, 0, 'o' },
+    { "pattern", 1, 0, 'p' },
+    { "shmem-size", 1, 0, 'S' },
+    { "transfersize", 1, 0, 't' },
+    { "spill-size", 1, 0, 'X' },
+    { 0, 0, 0, 0},
+};
+
+static char* short_opts = "b:cC:dD:f:hkLm:n:o:p:S:t:X:";
+
+static const char* usage_str =
+    "\n"
+    "Usage: %s [options...]\n"
+    "\n"
+    "Available options:\n"
+    " -b, --blocksize=<bytes>      bytes per block (default: 1 MiB)\n"
+    " -c, --check                  verify data of local and remote reads\n"
+    " -C, --chunk-size=<bytes>     logio chunk size\n"
+    " -d, --debug                  pause before running test\n"
+    "                              (handy for attaching in debugger)\n"
+    " -D, --destination=<dir>      transfer file(s) to <dir> after reads\n"
+    "                              (default: no transfer phase)\n"
+    " -f, --file=<name>            base name of the test file(s)\n"
+    "                              (default: iobench)\n"
+    " -h, --help                   help message\n"
+    " -k, --keep                   do not remove the test file(s) at exit\n"
+    " -L, --no-laminate            skip the laminate phase\n"
+    " -m, --mount=<mountpoint>     use <mountpoint> for unifyfs\n"
+    "                              (default: /unifyfs)\n"
+    " -n, --nblocks=<count>        blocks per rank (default: 16,\n"
+    "                              or 4096 for the small pattern)\n"
+    " -o, --output=<file>          write JSON results to <file>\n"
+    "                              (default: stdout)\n"
+    " -p, --pattern=<pattern>      one of nn, n1-segmented, n1-strided,\n"
+    "                              or small (default: n1-strided)\n"
+    " -S, --shmem-size=<bytes>     logio shared memory region size\n"
+    " -t, --transfersize=<bytes>   bytes per I/O operation (default: 64 KiB,\n"
+    "                              or 512 B for the small pattern)\n"
+    " -X, --spill-size=<bytes>     logio spillover file size\n"
+    "\n"
+    "The small pattern uses a block size equal to the transfer size.\n"
+    "\n";
+
+static char* program;
+
+static void print_usage(void)
+{
+    test_print_once(rank, usage_str, program);
+    exit(0);
+}
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int lat_bucket(uint64_t ns)
+{
+    if (ns < LAT_SUB) {
+        return (int) ns;
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - LAT_SUB_BITS;
+    return ((shift + 1) * LAT_SUB) + (int)((ns >> shift) & (LAT_SUB - 1));
+}
+
+/* largest latency value that falls into the given bucket */
+static uint64_t lat_bucket_max(int idx)
+{
+    if (idx < LAT_SUB) {
+        return (uint64_t) idx;
+    }
+    int shift = (idx / LAT_SUB) - 1;
+    uint64_t sub = (uint64_t)(idx % LAT_SUB);
+    uint64_t lower = (LAT_SUB + sub) << shift;
+    return lower + ((1ULL << shift) - 1);
+}
+
+static void lat_record(lat_hist* h, uint64_t ns, size_t bytes)
+{
+    if ((0 == h->count) || (ns < h->min_ns)) {
+        h->min_ns = ns;
+    }
+    if (ns > h->max_ns) {
+        h->max_ns = ns;
+    }
+    h->count++;
+    h->bytes += bytes;
+    h->sum_ns += ns;
+    h->bucket[lat_bucket(ns)]++;
+}
+
+/* value at the given percentile, clipped to the observed maximum */
+static uint64_t lat_percentile(const lat_hist* h, double pct)
+{
+    if (0 == h->count) {
+        return 0;
+    }
+    uint64_t target = (uint64_t)((pct / 100.0) * (double)h->count);
+    if (target < 1) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += h->bucket[i];
+        if (seen >= target) {
+            uint64_t val = lat_bucket_max(i);
+            return (val > h->max_ns) ? h->max_ns : val;
+        }
+    }
+    return h->max_ns;
+}
+
+/* combine the histograms of all ranks into *global on rank 0 */
+static void lat_reduce(const lat_hist* local, lat_hist* global)
+{
+    uint64_t sums[4] = { local->count, local->bytes,
+                         local->sum_ns, local->errors };
+    uint64_t gsums[4];
+    uint64_t min_ns = (local->count ? local->min_ns : UINT64_MAX);
+
+    MPI_Reduce(sums, gsums, 4, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&min_ns, &global->min_ns, 1, MPI_UINT64_T, MPI_MIN,
+               0, MPI_COMM_WORLD);
+    MPI_Reduce(&local->max_ns, &global->max_ns, 1, MPI_UINT64_T, MPI_MAX,
+               0, MPI_COMM_WORLD);
+    MPI_Reduce(&local->elapsed_ns, &global->elapsed_ns, 1, MPI_UINT64_T,
+               MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(local->bucket, global->bucket, LAT_BUCKETS, MPI_UINT64_T,
+               MPI_SUM, 0, MPI_COMM_WORLD);
+
+    global->count  = gsums[0];
+    global->bytes  = gsums[1];
+    global->sum_ns = gsums[2];
+    global->errors = gsums[3];
+    if (0 == global->count) {
+        global->min_ns = 0;
+    }
+}
+
+static int is_shared(void)
+{
+    return (pattern != PATTERN_NN);
+}
+
+/* path of the file written by rank r, under the given directory */
+static void file_path(char* buf, size_t len, const char* dir, int r)
+{
+    if (is_shared()) {
+        snprintf(buf, len, "%s/%s", dir, filename);
+    } else {
+        snprintf(buf, len, "%s/%s.%d", dir, filename, r);
+    }
+}
+
+/* file offset of the given block written by rank r */
+static off_t block_offset(int r, size_t blk)
+{
+    size_t idx;
+    switch (pattern) {
+    case PATTERN_NN:
+        idx = blk;
+        break;
+    case PATTERN_SEGMENTED:
+        idx = ((size_t)r * n_blocks) + blk;
+        break;
+    default:
+        idx = (blk * (size_t)total_ranks) + (size_t)r;
+        break;
+    }
+    return (off_t)(idx * block_sz);
+}
+
+/* data contents are a function of the writer rank and file offset */
+static inline char data_byte(int writer, off_t off)
+{
+    return (char)((uint64_t)off * 31 + (uint64_t)writer + 1);
+}
+
+static void fill_buf(char* buf, size_t len, int writer, off_t off)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = data_byte(writer, off + (off_t)i);
+    }
+}
+
+static int check_buf(const char* buf, size_t len, int writer, off_t off)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] != data_byte(writer, off + (off_t)i)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* issue a single I/O request and wait for it, recording its latency */
+static int timed_io(unifyfs_handle fshdl, lat_hist* h,
+                    unifyfs_ioreq_op op, unifyfs_gfid gfid,
+                    char* buf, size_t len, off_t off)
+{
+    unifyfs_io_request req;
+    memset(&req, 0, sizeof(req));
+    req.op = op;
+    req.gfid = gfid;
+    req.user_buf = buf;
+    req.nbytes = len;
+    req.offset = off;
+
+    uint64_t start = now_ns();
+    unifyfs_rc urc = unifyfs_dispatch_io(fshdl, 1, &req);
+    if (UNIFYFS_SUCCESS == urc) {
+        urc = unifyfs_wait_io(fshdl, 1, &req, 1);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    if ((UNIFYFS_SUCCESS != urc) || (req.result.error != 0) ||
+        (req.result.count != len)) {
+        test_print(rank, "%s of %zu bytes at offset %zu failed "
+                   "(rc=%d, error=%d, count=%zu)",
+                   (op == UNIFYFS_IOREQ_OP_WRITE ? "write" : "read"),
+                   len, (size_t)off, (int)urc, req.result.error,
+                   req.result.count);
+        h->errors++;
+        return 1;
+    }
+    lat_record(h, elapsed, len);
+    return 0;
+}
+
+/* write or read all blocks of the given writer rank */
+static void run_io_phase(unifyfs_handle fshdl, int phase,
+                         unifyfs_gfid gfid, int writer, char* buf)
+{
+    lat_hist* h = &phase_hist[phase];
+    int is_write = (PHASE_WRITE == phase);
+    unifyfs_ioreq_op op = (is_write ? UNIFYFS_IOREQ_OP_WRITE
+                                    : UNIFYFS_IOREQ_OP_READ);
+    size_t xfers_per_block = block_sz / xfer_sz;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    uint64_t start = now_ns();
+    for (size_t blk = 0; blk < n_blocks; blk++) {
+        off_t blk_off = block_offset(writer, blk);
+        for (size_t x = 0; x < xfers_per_block; x++) {
+            off_t off = blk_off + (off_t)(x * xfer_sz);
+            if (is_write) {
+                fill_buf(buf, xfer_sz, writer, off);
+            }
+            if (timed_io(fshdl, h, op, gfid, buf, xfer_sz, off)) {
+                continue;
+            }
+            if (!is_write && check &&
+                check_buf(buf, xfer_sz, writer, off)) {
+                test_print(rank, "%s data mismatch at offset %zu",
+                           phase_names[phase], (size_t)off);
+                h->errors++;
+            }
+        }
+    }
+    h->elapsed_ns = now_ns() - start;
+    phase_ran[phase] = 1;
+}
+
+static void run_sync_phase(unifyfs_handle fshdl, unifyfs_gfid gfid)
+{
+    lat_hist* h = &phase_hist[PHASE_SYNC];
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    uint64_t start = now_ns();
+    unifyfs_rc urc = unifyfs_sync(fshdl, gfid);
+    uint64_t elapsed = now_ns() - start;
+    if (UNIFYFS_SUCCESS != urc) {
+        test_print(rank, "unifyfs_sync() failed (rc=%d: %s)",
+                   (int)urc, unifyfs_rc_enum_description(urc));
+        h->errors++;
+    } else {
+        lat_record(h, elapsed, 0);
+    }
+    h->elapsed_ns = elapsed;
+    phase_ran[PHASE_SYNC] = 1;
+}
+
+static void run_laminate_phase(unifyfs_handle fshdl, const char* path)
+{
+    lat_hist* h = &phase_hist[PHASE_LAMINATE];
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (!is_shared() || (0 == rank)) {
+        uint64_t start = now_ns();
+        unifyfs_rc urc = unifyfs_laminate(fshdl, path);
+        uint64_t elapsed = now_ns() - start;
+        if (UNIFYFS_SUCCESS != urc) {
+            test_print(rank, "unifyfs_laminate(%s) failed (rc=%d: %s)",
+                       path, (int)urc, unifyfs_rc_enum_description(urc));
+            h->errors++;
+        } else {
+            lat_record(h, elapsed, 0);
+        }
+        h->elapsed_ns = elapsed;
+    }
+    phase_ran[PHASE_LAMINATE] = 1;
+}
+
+static void run_transfer_phase(unifyfs_handle fshdl, const char* path)
+{
+    lat_hist* h = &phase_hist[PHASE_TRANSFER];
+    char dst_path[PATH_MAX];
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (!is_shared() || (0 == rank)) {
+        unifyfs_transfer_request req;
+        memset(&req, 0, sizeof(req));
+        file_path(dst_path, sizeof(dst_path), dst_dir, rank);
+        req.src_path = path;
+        req.dst_path = dst_path;
+        req.mode = UNIFYFS_TRANSFER_MODE_COPY;
+        req.use_parallel = is_shared();
+
+        uint64_t start = now_ns();
+        unifyfs_rc urc = unifyfs_dispatch_transfer(fshdl, 1, &req);
+        if (UNIFYFS_SUCCESS == urc) {
+            urc = unifyfs_wait_transfer(fshdl, 1, &req, 1);
+        }
+        uint64_t elapsed = now_ns() - start;
+        if ((UNIFYFS_SUCCESS != urc) || (req.result.error != 0)) {
+            test_print(rank, "transfer of %s to %s failed (rc=%d, error=%d)",
+                       path, dst_path, (int)urc, req.result.error);
+            h->errors++;
+        } else {
+            lat_record(h, elapsed, req.result.file_size_bytes);
+        }
+        h->elapsed_ns = elapsed;
+    }
+    phase_ran[PHASE_TRANSFER] = 1;
+}
+
+static void print_cfg_str(FILE* fp, const char* name, const char* val,
+                          int last)
+{
+    if (NULL != val) {
+        fprintf(fp, "      \"%s\": \"%s\"%s\n", name, val, last ? "" : ",");
+    } else {
+        fprintf(fp, "      \"%s\": null%s\n", name, last ? "" : ",");
+    }
+}
+
+/* rank 0 writes the combined results of all phases as JSON */
+static void report(FILE* fp, const lat_hist* global, int nphases)
+{
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"benchmark\": \"iobench\",\n");
+    fprintf(fp, "  \"config\": {\n");
+    fprintf(fp, "    \"pattern\": \"%s\",\n", pattern_names[pattern]);
+    fprintf(fp, "    \"ranks\": %d,\n", total_ranks);
+    fprintf(fp, "    \"block_size\": %zu,\n", block_sz);
+    fprintf(fp, "    \"transfer_size\": %zu,\n", xfer_sz);
+    fprintf(fp, "    \"blocks_per_rank\": %zu,\n", n_blocks);
+    fprintf(fp, "    \"bytes_per_rank\": %zu,\n", block_sz * n_blocks);
+    fprintf(fp, "    \"mountpoint\": \"%s\",\n", mountpoint);
+    fprintf(fp, "    \"logio\": {\n");
+    print_cfg_str(fp, "chunk_size", logio_chunk, 0);
+    print_cfg_str(fp, "shmem_size", logio_shmem, 0);
+    print_cfg_str(fp, "spill_size", logio_spill, 1);
+    fprintf(fp, "    }\n");
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"phases\": [\n");
+
+    int printed = 0;
+    for (int p = 0; p < NUM_PHASES; p++) {
+        if (!phase_ran[p]) {
+            continue;
+        }
+        const lat_hist* h = &global[p];
+        double secs = (double)h->elapsed_ns / 1e9;
+        double mib = (double)h->bytes / (1024.0 * 1024.0);
+        double mean = (h->count ? (double)h->sum_ns / (double)h->count : 0);
+
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"name\": \"%s\",\n", phase_names[p]);
+        fprintf(fp, "      \"ops\": %" PRIu64 ",\n", h->count);
+        fprintf(fp, "      \"errors\": %" PRIu64 ",\n", h->errors);
+        fprintf(fp, "      \"bytes\": %" PRIu64 ",\n", h->bytes);
+        fprintf(fp, "      \"elapsed_sec\": %.6f,\n", secs);
+        fprintf(fp, "      \"bandwidth_mib_per_sec\": %.3f,\n",
+                (secs > 0.0 ? mib / secs : 0.0));
+        fprintf(fp, "      \"latency_usec\": {\n");
+        fprintf(fp, "        \"min\": %.3f,\n", (double)h->min_ns / 1e3);
+        fprintf(fp, "        \"mean\": %.3f,\n", mean / 1e3);
+        fprintf(fp, "        \"p50\": %.3f,\n",
+                (double)lat_percentile(h, 50.0) / 1e3);
+        fprintf(fp, "        \"p90\": %.3f,\n",
+                (double)lat_percentile(h, 90.0) / 1e3);
+        fprintf(fp, "        \"p99\": %.3f,\n",
+                (double)lat_percentile(h, 99.0) / 1e3);
+        fprintf(fp, "        \"max\": %.3f\n", (double)h->max_ns / 1e3);
+        fprintf(fp, "      }\n");
+        fprintf(fp, "    }%s\n", (++printed < nphases) ? "," : "");
+    }
+
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+}
+
+int main(int argc, char** argv)
+{
+    int ret = 0;
+    int ch = 0;
+    int optidx = 0;
+    int set_nblocks = 0;
+    int set_xfer = 0;
+    unifyfs_rc urc;
+    unifyfs_handle fshdl = UNIFYFS_INVALID_HANDLE;
+    unifyfs_gfid gfid = UNIFYFS_INVALID_GFID;
+    unifyfs_gfid peer_gfid = UNIFYFS_INVALID_GFID;
+    unifyfs_cfg_option options[3];
+    int n_opts = 0;
+    char path[PATH_MAX];
+    char peer_path[PATH_MAX];
+
+    program = basename(strdup(argv[0]));
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &total_ranks);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    block_sz = 1024 * 1024;
+    xfer_sz = 64 * 1024;
+    n_blocks = 16;
+
+    while ((ch = getopt_long(argc, argv,
+                             short_opts, long_opts, &optidx)) >= 0) {
+        switch (ch) {
+        case 'b':
+            block_sz = (size_t) strtoul(optarg, NULL, 0);
+            break;
+
+        case 'c':
+            check = 1;
+            break;
+
+        case 'C':
+            logio_chunk = strdup(optarg);
+            break;
+
+        case 'd':
+            debug = 1;
+            break;
+
+        case 'D':
+            dst_dir = strdup(optarg);
+            break;
+
+        case 'f':
+            filename = strdup(optarg);
+            break;
+
+        case 'k':
+            keep = 1;
+            break;
+
+        case 'L':
+            laminate = 0;
+            break;
+
+        case 'm':
+            mountpoint = strdup(optarg);
+            break;
+
+        case 'n':
+            n_blocks = (size_t) strtoul(optarg, NULL, 0);
+            set_nblocks = 1;
+            break;
+
+        case 'o':
+            outfile = strdup(optarg);
+            break;
+
+        case 'p':
+            for (pattern = 0; pattern <= PATTERN_SMALL; pattern++) {
+                if (0 == strcmp(optarg, pattern_names[pattern])) {
+                    break;
+                }
+            }
+            if (pattern > PATTERN_SMALL) {
+                test_print_once(rank, "ERROR - unknown pattern %s", optarg);
+                print_usage();
+            }
+            break;
+
+        case 'S':
+            logio_shmem = strdup(optarg);
+            break;
+
+        case 't':
+            xfer_sz = (size_t) strtoul(optarg, NULL, 0);
+            set_xfer = 1;
+            break;
+
+        case 'X':
+            logio_spill = strdup(optarg);
+            break;
+
+        case 'h':
+        default:
+            print_usage();
+            break;
+        }
+    }
+
+    if (PATTERN_SMALL == pattern) {
+        if (!set_xfer) {
+            xfer_sz = 512;
+        }
+        if (!set_nblocks) {
+            n_blocks = 4096;
+        }
+        block_sz = xfer_sz;
+    }
+
+    if ((0 == xfer_sz) || (0 == n_blocks) || (block_sz < xfer_sz) ||
+        (block_sz % xfer_sz)) {
+        test_print_once(rank, "ERROR - block size (%zu) must be a non-zero "
+                        "multiple of the transfer size (%zu)",
+                        block_sz, xfer_sz);
+        print_usage();
+    }
+
+    if (NULL == mountpoint) {
+        mountpoint = strdup("/unifyfs");
+    }
+    if (NULL == filename) {
+        filename = strdup("iobench");
+    }
+
+    if (NULL != logio_chunk) {
+        options[n_opts].opt_name = "logio.chunk_size";
+        options[n_opts++].opt_value = logio_chunk;
+    }
+    if (NULL != logio_shmem) {
+        options[n_opts].opt_name = "logio.shmem_size";
+        options[n_opts++].opt_value = logio_shmem;
+    }
+    if (NULL != logio_spill) {
+        options[n_opts].opt_name = "logio.spill_size";
+        options[n_opts++].opt_value = logio_spill;
+    }
+
+    if (debug) {
+        test_pause(rank, "Before initializing UnifyFS");
+    }
+
+    urc = unifyfs_initialize(mountpoint, options, n_opts, &fshdl);
+    if (UNIFYFS_SUCCESS != urc) {
+        test_print(rank, "unifyfs_initialize(%s) failed (rc=%d: %s)",
+                   mountpoint, (int)urc, unifyfs_rc_enum_description(urc));
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    char* buf = malloc(xfer_sz);
+    if (NULL == buf) {
+        test_print(rank, "failed to allocate %zu byte I/O buffer", xfer_sz);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    /* shared files are created by rank 0 and opened by the others */
+    file_path(path, sizeof(path), mountpoint, rank);
+    if (!is_shared() || (0 == rank)) {
+        urc = unifyfs_create(fshdl, 0, path, &gfid);
+        if (UNIFYFS_SUCCESS != urc) {
+            test_print(rank, "unifyfs_create(%s) failed (rc=%d: %s)",
+                       path, (int)urc, unifyfs_rc_enum_description(urc));
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (is_shared() && (0 != rank)) {
+        urc = unifyfs_open(fshdl, O_RDWR, path, &gfid);
+        if (UNIFYFS_SUCCESS != urc) {
+            test_print(rank, "unifyfs_open(%s) failed (rc=%d: %s)",
+                       path, (int)urc, unifyfs_rc_enum_description(urc));
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    run_io_phase(fshdl, PHASE_WRITE, gfid, rank, buf);
+    run_sync_phase(fshdl, gfid);
+    if (laminate) {
+        run_laminate_phase(fshdl, path);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    run_io_phase(fshdl, PHASE_READ_LOCAL, gfid, rank, buf);
+
+    /* read the data written by the next rank, which on a single node
+     * is served from the log of another client process */
+    if (total_ranks > 1) {
+        int peer = (rank + 1) % total_ranks;
+        peer_gfid = gfid;
+        if (!is_shared()) {
+            file_path(peer_path, sizeof(peer_path), mountpoint, peer);
+            urc = unifyfs_open(fshdl, O_RDONLY, peer_path, &peer_gfid);
+            if (UNIFYFS_SUCCESS != urc) {
+                test_print(rank, "unifyfs_open(%s) failed (rc=%d: %s)",
+                           peer_path, (int)urc,
+                           unifyfs_rc_enum_description(urc));
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        run_io_phase(fshdl, PHASE_READ_REMOTE, peer_gfid, peer, buf);
+    }
+
+    if (NULL != dst_dir) {
+        run_transfer_phase(fshdl, path);
+    }
+
+    /* combine per-rank results */
+    int nphases = 0;
+    lat_hist* global = calloc(NUM_PHASES, sizeof(lat_hist));
+    for (int p = 0; p < NUM_PHASES; p++) {
+        if (phase_ran[p]) {
+            lat_reduce(&phase_hist[p], &global[p]);
+            nphases++;
+            if (global[p].errors) {
+                ret = 1;
+            }
+        }
+    }
+
+    if (0 == rank) {
+        FILE* fp = stdout;
+        if ((NULL != outfile) && (0 != strcmp(outfile, "-"))) {
+            fp = fopen(outfile, "w");
+            if (NULL == fp) {
+                test_print(rank, "failed to open output file %s (%s)",
+                           outfile, strerror(errno));
+                fp = stdout;
+            }
+        }
+        report(fp, global, nphases);
+        if (fp != stdout) {
+            fclose(fp);
+        }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (!keep && (!is_shared() || (0 == rank))) {
+        urc = unifyfs_remove(fshdl, path);
+        if (UNIFYFS_SUCCESS != urc) {
+            test_print(rank, "unifyfs_remove(%s) failed (rc=%d: %s)",
+                       path, (int)urc, unifyfs_rc_enum_description(urc));
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    unifyfs_finalize(fshdl);
+
+    MPI_Bcast(&ret, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Finalize();
+
+    free(global);
+    free(buf);
+    free(mountpoint);
+    free(filename);
+    free(dst_dir);
+    free(outfile);
+    free(logio_chunk);
+    free(logio_shmem);
+    free(logio_spill);
+
+    return ret;
+}
@@ -47,6 +47,7 @@ int extent_tree_init(struct extent_tree* tree)
     memset(tree, 0, sizeof(*tree));
     ABT_rwlock_create(&(tree->rwlock));
     RB_INIT(&(tree->head));
+    node_pool_init(&(tree->pool), sizeof(struct extent_tree_node));
     return 0;
 }
 
@@ -56,21 +57,45 @@ int extent_tree_init(struct extent_tree* tree)
 void extent_tree_destroy(struct extent_tree* tree)
 {
     extent_tree_clear(tree);
+    node_pool_release(&(tree->pool));
     ABT_rwlock_free(&(tree->rwlock));
 }
 
-/* Allocate a node for the range tree.  Free node with free() when finished */
+/* Allocate a node for the range tree from the tree's node pool.
+ * Release node with extent_tree_node_free(). Caller must hold the
+ * write lock. */
 static
-struct extent_tree_node* extent_tree_node_alloc(extent_metadata* extent)
+struct extent_tree_node* extent_tree_node_alloc(struct extent_tree* tree,
+                                                extent_metadata* extent)
 {
     /* allocate a new node structure */
-    struct extent_tree_node* node = calloc(1, sizeof(*node));
+    struct extent_tree_node* node = node_pool_alloc(&(tree->pool));
     if (NULL != node) {
         memcpy(&(node->extent), extent, sizeof(*extent));
     }
     return node;
 }
 
+/* Return a node to the tree's node pool. Caller must hold the
+ * write lock. */
+static
+void extent_tree_node_free(struct extent_tree* tree,
+                           struct extent_tree_node* node)
+{
+    node_pool_free(&(tree->pool), node);
+}
+
+/* returns 1 if extent b continues extent a in the file and in the log */
+static int extents_contiguous(const extent_metadata* a,
+                              const extent_metadata* b)
+{
+    return ((a->end + 1) == b->start) &&
+           ((a->log_pos + extent_length(a)) == b->log_pos) &&
+           (a->svr_rank == b->svr_rank) &&
+           (a->app_id == b->app_id) &&
+           (a->cli_id == b->cli_id);
+}
+
 /*
  * Given two start/end ranges, return a new range from start1/end1 that
  * does not overlap start2/end2. The non-overlapping range is stored
@@ -129,15 +154,27 @@ int extent_tree_add(struct extent_tree* tree,
     /* assume we'll succeed */
     int ret = 0;
 
+    /* lock the tree so we can modify it */
+    extent_tree_wrlock(tree);
+
+    /* fast path for sequential writes: if the new extent continues the
+     * last extent in the tree in both the file and the log, nothing can
+     * overlap it, so just extend the last extent in place */
+    struct extent_tree_node* last = tree->last;
+    if ((NULL != last) && extents_contiguous(&(last->extent), extent)) {
+        last->extent.end = extent->end;
+        tree->max = MAX(tree->max, extent->end);
+        extent_tree_unlock(tree);
+        return 0;
+    }
+
     /* Create node to define our new range */
-    struct extent_tree_node* node = extent_tree_node_alloc(extent);
+    struct extent_tree_node* node = extent_tree_node_alloc(tree, extent);
     if (!node) {
+        extent_tree_unlock(tree);
         return ENOMEM;
     }
 
-    /* lock the tree so we can modify it */
-    extent_tree_wrlock(tree);
-
     /* Try to insert our range into the RB tree.  If it overlaps with any other
      * range, then it is not inserted, and the overlapping range node is
      * returned in 'conflict'.  If 'conflict' is NULL, then there were no
@@ -159,7 +196,7 @@ int extent_tree_add(struct extent_tree* tree,
              * range in the tree defined in 'conflict'.
              * Delete the existing range. */
             RB_REMOVE(ext_tree, &tree->head, conflict);
-            free(conflict);
+            extent_tree_node_free(tree, conflict);
             tree->count--;
         } else {
             /* Part of the old range 'conflict' was non-overlapping. Create a
@@ -175,12 +212,12 @@ int extent_tree_add(struct extent_tree* tree,
                 .cli_id   = conflict->extent.cli_id
             };
             struct extent_tree_node* non_overlap =
-                extent_tree_node_alloc(&non_overlap_extent);
+                extent_tree_node_alloc(tree, &non_overlap_extent);
             if (NULL == non_overlap) {
                 /* failed to allocate memory for range node,
                  * bail out and release lock without further
                  * changing state of extent tree */
-                free(node);
+                extent_tree_node_free(tree, node);
                 ret = ENOMEM;
                 goto release_add;
             }
@@ -201,13 +238,13 @@ int extent_tree_add(struct extent_tree* tree,
                     .app_id   = conflict->extent.app_id,
                     .cli_id   = conflict->extent.cli_id
                 };
-                conflict_tail = extent_tree_node_alloc(&tail_extent);
+                conflict_tail = extent_tree_node_alloc(tree, &tail_extent);
                 if (NULL == conflict_tail) {
                     /* failed to allocate memory for range node,
                      * bail out and release lock without further
                      * changing state of extent tree */
-                    free(node);
-                    free(non_overlap);
+                    extent_tree_node_free(tree, node);
+                    extent_tree_node_free(tree, non_overlap);
                     ret = ENOMEM;
                     goto release_add;
                 }
@@ -215,7 +252,7 @@ int extent_tree_add(struct extent_tree* tree,
 
             /* Remove old range 'conflict' and release it */
             RB_REMOVE(ext_tree, &tree->head, conflict);
-            free(conflict);
+            extent_tree_node_free(tree, conflict);
             tree->count--;
 
             /* Insert the non-overlapping part of the old range */
@@ -244,15 +281,10 @@ int extent_tree_add(struct extent_tree* tree,
 
     /* check whether we can coalesce new extent with any preceding extent */
     struct extent_tree_node* prev = RB_PREV(ext_tree, &tree->head, target);
-    if ((NULL != prev) && (prev->extent.end + 1 == target->extent.start)) {
-        /* found an extent that ends just before the new extent starts,
-         * check whether they are also contiguous in the log */
-        unsigned long pos_next = prev->extent.log_pos +
-                                 extent_length(&(prev->extent));
-        if ((prev->extent.svr_rank == target->extent.svr_rank) &&
-            (prev->extent.cli_id   == target->extent.cli_id)   &&
-            (prev->extent.app_id   == target->extent.app_id)   &&
-            (pos_next              == target->extent.log_pos)) {
+    if (NULL != prev) {
+        /* check for an extent that ends just before the new extent starts
+         * and is also contiguous in the log */
+        if (extents_contiguous(&(prev->extent), &(target->extent))) {
             /* the preceding extent describes a log position adjacent to
              * the extent we just added, so we can merge them,
              * append entry to previous by extending end of previous */
@@ -260,7 +292,7 @@ int extent_tree_add(struct extent_tree* tree,
 
             /* delete new extent from the tree and free it */
             RB_REMOVE(ext_tree, &tree->head, target);
-            free(target);
+            extent_tree_node_free(tree, target);
             tree->count--;
 
             /* update target to point at previous extent since we just
@@ -272,15 +304,10 @@ int extent_tree_add(struct extent_tree* tree,
     /* check whether we can coalesce new extent with any trailing extent */
     struct extent_tree_node* next = RB_NEXT(ext_tree, &tree->head,
                                             target);
-    if ((NULL != next) && (target->extent.end + 1 == next->extent.start)) {
-        /* found a extent that starts just after the new extent ends,
-         * check whether they are also contiguous in the log */
-        unsigned long pos_next = target->extent.log_pos +
-                                 extent_length(&(target->extent));
-        if (target->extent.svr_rank == next->extent.svr_rank &&
-            target->extent.cli_id   == next->extent.cli_id   &&
-            target->extent.app_id   == next->extent.app_id   &&
-            pos_next                == next->extent.log_pos) {
+    if (NULL != next) {
+        /* check for an extent that starts just after the new extent ends
+         * and is also contiguous in the log */
+        if (extents_contiguous(&(target->extent), &(next->extent))) {
             /* the target extent describes a log position adjacent to
              * the next extent, so we can merge them,
              * append entry to target by extending end of to cover next */
@@ -288,19 +315,47 @@ int extent_tree_add(struct extent_tree* tree,
 
             /* delete next extent from the tree and free it */
             RB_REMOVE(ext_tree, &tree->head, next);
-            free(next);
+            extent_tree_node_free(tree, next);
             tree->count--;
         }
     }
 
 release_add:
 
+    /* remember the last extent for the sequential write fast path, which
+     * is also needed on failure since conflicting extents may be gone */
+    tree->last = RB_MAX(ext_tree, &tree->head);
+
     /* done modifying the tree */
     extent_tree_unlock(tree);
 
     return ret;
 }
 
+/* Merge consecutive entries of the array that are contiguous in both
+ * file offset and log position of the same server/app/client, in place.
+ * Only neighboring entries are merged, so the relative order of
+ * (possibly overlapping) extents is preserved. Returns the new count. */
+size_t extent_list_coalesce(extent_metadata* extents, size_t n)
+{
+    if ((NULL == extents) || (n < 2)) {
+        return n;
+    }
+
+    size_t last = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (extents_contiguous(extents + last, extents + i)) {
+            extents[last].end = extents[i].end;
+        } else {
+            last++;
+            if (last != i) {
+                extents[last] = extents[i];
+            }
+        }
+    }
+    return last + 1;
+}
+
 /* search tree for entry that overlaps with given start/end
  * offsets, return first overlapping entry if found, NULL otherwise,
  * assumes caller has lock on tree */
@@ -309,26 +364,18 @@ struct extent_tree_node* extent_tree_find(
     unsigned long start, /* starting offset to search */
     unsigned long end)   /* ending offset to search */
 {
-    /* Create a range of just our starting byte offset */
-    extent_metadata start_byte = {
-        .start    = start,
-        .end      = start,
-        .log_pos  = 0,
-        .svr_rank = 0,
-        .app_id   = 0,
-        .cli_id   = 0
-    };
-    struct extent_tree_node* node = extent_tree_node_alloc(&start_byte);
-    if (NULL == node) {
-        return NULL;
-    }
+    /* Create a range of just our starting byte offset, which is only
+     * a search key and so is kept on the stack rather than taken from
+     * the node pool (callers may only hold the read lock) */
+    struct extent_tree_node key;
+    memset(&key, 0, sizeof(key));
+    key.extent.start = start;
+    key.extent.end   = start;
 
     /* search tree for either a range that overlaps with
      * the target range (starting byte), or otherwise the
      * node for the next biggest starting byte */
-    struct extent_tree_node* next = RB_NFIND(ext_tree, &tree->head, node);
-
-    free(node);
+    struct extent_tree_node* next = RB_NFIND(ext_tree, &tree->head, &key);
 
     /* we may have found a node that doesn't include our starting
      * byte offset, but it would be the range with the lowest
@@ -377,9 +424,9 @@ int extent_tree_truncate(
 
             /* remove this node from the tree and release it */
             LOGDBG("removing node [%lu, %lu] due to truncate=%lu",
-                   node->extent.start, node->extent.end, size);
+                   oldnode->extent.start, oldnode->extent.end, size);
             RB_REMOVE(ext_tree, &tree->head, oldnode);
-            free(oldnode);
+            extent_tree_node_free(tree, oldnode);
 
             /* decrement the number of extents in the tree */
             tree->count--;
@@ -400,6 +447,7 @@ int extent_tree_truncate(
         /* no extents left in the tree, set max back to 0 */
         tree->max = 0;
     }
+    tree->last = node;
 
     /* done updating the tree */
     extent_tree_unlock(tree);
@@ -499,29 +547,15 @@ void extent_tree_unlock(struct extent_tree* tree)
  */
 void extent_tree_clear(struct extent_tree* tree)
 {
-    struct extent_tree_node* node = NULL;
-    struct extent_tree_node* oldnode = NULL;
-
     extent_tree_wrlock(tree);
 
-    if (RB_EMPTY(&tree->head)) {
-        /* extent_tree is empty, nothing to do */
-        extent_tree_unlock(tree);
-        return;
-    }
-
-    /* Remove and free each node in the tree */
-    while ((node = extent_tree_iter(tree, node)) != NULL) {
-        if (NULL != oldnode) {
-            RB_REMOVE(ext_tree, &tree->head, oldnode);
-            free(oldnode);
-        }
-        oldnode = node;
-    }
-    if (NULL != oldnode) {
-        RB_REMOVE(ext_tree, &tree->head, oldnode);
-        free(oldnode);
-    }
+    /* all nodes come from the tree's pool, so empty the tree and
+     * release the pool at once rather than removing each node. The
+     * server clears a tree once its extents have been frozen into an
+     * index at laminate time, so no slab is kept for reuse. */
+    RB_INIT(&(tree->head));
+    node_pool_release(&(tree->pool));
+    tree->last = NULL;
 
     tree->count = 0;
     tree->max   = 0;
@@ -549,12 +583,12 @@ unsigned long extent_tree_max_offset(struct extent_tree* tree)
 static void chunk_req_from_extent(
     unsigned long req_offset,
     unsigned long req_len,
-    struct extent_tree_node* n,
+    extent_metadata* ext,
     chunk_read_req_t* chunk)
 {
-    unsigned long offset     = n->extent.start;
-    unsigned long nbytes     = n->extent.end - n->extent.start + 1;
-    unsigned long log_offset = n->extent.log_pos;
+    unsigned long offset     = ext->start;
+    unsigned long nbytes     = ext->end - ext->start + 1;
+    unsigned long log_offset = ext->log_pos;
     unsigned long last       = req_offset + req_len - 1;
 
     unsigned long diff;
@@ -565,17 +599,17 @@ static void chunk_req_from_extent(
         nbytes -= diff;
     }
 
-    if (n->extent.end > last) {
-        diff = n->extent.end - last;
+    if (ext->end > last) {
+        diff = ext->end - last;
         nbytes -= diff;
     }
 
     chunk->offset        = offset;
     chunk->nbytes        = nbytes;
     chunk->log_offset    = log_offset;
-    chunk->rank          = n->extent.svr_rank;
-    chunk->log_client_id = n->extent.cli_id;
-    chunk->log_app_id    = n->extent.app_id;
+    chunk->rank          = ext->svr_rank;
+    chunk->log_client_id = ext->cli_id;
+    chunk->log_app_id    = ext->app_id;
 }
 
 int extent_tree_get_chunk_list(
@@ -643,7 +677,7 @@ int extent_tree_get_chunk_list(
     while ((NULL != next) && (next->extent.start <= end)) {
         /* trim out the extent so it does not include the data that is not
          * requested */
-        chunk_req_from_extent(offset, len, next, current);
+        chunk_req_from_extent(offset, len, &(next->extent), current);
 
         next = extent_tree_iter(tree, next);
         current += 1;
@@ -661,3 +695,231 @@ out_unlock:
     return ret;
 }
 
+
+/* ---------------------------------------
+ * Immutable extent index
+ * --------------------------------------- */
+
+/* return the id of the log location for the extent, adding it to the
+ * table if new. Most files have few distinct logs, so the most recent
+ * id is checked first. */
+static unsigned int index_location_id(struct extent_index* index,
+                                      const extent_metadata* ext,
+                                      unsigned int* last_id,
+                                      unsigned int max_locs)
+{
+    struct extent_index_loc* loc = index->locs + *last_id;
+    if ((index->n_locs > 0) &&
+        (loc->svr_rank == ext->svr_rank) &&
+        (loc->app_id == ext->app_id) &&
+        (loc->cli_id == ext->cli_id)) {
+        return *last_id;
+    }
+
+    unsigned int i;
+    for (i = 0; i < index->n_locs; i++) {
+        loc = index->locs + i;
+        if ((loc->svr_rank == ext->svr_rank) &&
+            (loc->app_id == ext->app_id) &&
+            (loc->cli_id == ext->cli_id)) {
+            *last_id = i;
+            return i;
+        }
+    }
+
+    assert(index->n_locs < max_locs);
+    loc = index->locs + index->n_locs;
+    loc->svr_rank = ext->svr_rank;
+    loc->app_id   = ext->app_id;
+    loc->cli_id   = ext->cli_id;
+    *last_id = index->n_locs;
+    index->n_locs++;
+    return *last_id;
+}
+
+/* allocate the index arrays for the given number of extents and log
+ * locations as a single block of memory, starting at index->start */
+static int index_alloc_arrays(struct extent_index* index,
+                              unsigned long n_extents,
+                              unsigned int n_locs)
+{
+    size_t arrays_sz = (3 * n_extents * sizeof(unsigned long)) +
+                       (n_extents * sizeof(unsigned int)) +
+                       (n_locs * sizeof(struct extent_index_loc));
+    char* mem = malloc(arrays_sz);
+    if (NULL == mem) {
+        return ENOMEM;
+    }
+    index->start   = (unsigned long*) mem;
+    index->end     = index->start + n_extents;
+    index->log_pos = index->end + n_extents;
+    index->loc_id  = (unsigned int*)(index->log_pos + n_extents);
+    index->locs    = (struct extent_index_loc*)(index->loc_id + n_extents);
+    return 0;
+}
+
+/* Build an immutable index from the current extents of the tree.
+ * Returns 0 on success, positive non-zero error code otherwise */
+int extent_index_create(struct extent_tree* tree,
+                        struct extent_index** out_index)
+{
+    *out_index = NULL;
+
+    struct extent_index* index = calloc(1, sizeof(*index));
+    if (NULL == index) {
+        return ENOMEM;
+    }
+
+    extent_tree_rdlock(tree);
+
+    /* allocate for the worst case of no merged extents and a distinct
+     * log for each extent, compacted once the real counts are known */
+    unsigned long max = tree->count;
+    if (max > 0) {
+        if (index_alloc_arrays(index, max, (unsigned int) max) != 0) {
+            extent_tree_unlock(tree);
+            free(index);
+            return ENOMEM;
+        }
+    }
+
+    /* copy extents in file order, merging runs that are contiguous
+     * in both the file and the log */
+    unsigned long n = 0;
+    unsigned int last_id = 0;
+    extent_metadata prev;
+    struct extent_tree_node* node = NULL;
+    while ((node = extent_tree_iter(tree, node)) != NULL) {
+        extent_metadata* ext = &(node->extent);
+        if ((n > 0) && extents_contiguous(&prev, ext)) {
+            index->end[n - 1] = ext->end;
+            prev.end = ext->end;
+            continue;
+        }
+        index->start[n]   = ext->start;
+        index->end[n]     = ext->end;
+        index->log_pos[n] = ext->log_pos;
+        index->loc_id[n]  = index_location_id(index, ext, &last_id,
+                                              (unsigned int) max);
+        prev = *ext;
+        n++;
+    }
+    index->count = n;
+
+    extent_tree_unlock(tree);
+
+    if ((n > 0) && ((n < max) || (index->n_locs < max))) {
+        /* copy to arrays of the final size, keeping the oversized
+         * ones if that fails */
+        struct extent_index compact = *index;
+        if (index_alloc_arrays(&compact, n, index->n_locs) == 0) {
+            memcpy(compact.start, index->start, n * sizeof(unsigned long));
+            memcpy(compact.end, index->end, n * sizeof(unsigned long));
+            memcpy(compact.log_pos, index->log_pos,
+                   n * sizeof(unsigned long));
+            memcpy(compact.loc_id, index->loc_id, n * sizeof(unsigned int));
+            memcpy(compact.locs, index->locs,
+                   index->n_locs * sizeof(struct extent_index_loc));
+            free(index->start);
+            *index = compact;
+        }
+    }
+
+    LOGDBG("built extent index with %lu extents (from %lu) in %u logs",
+           n, max, index->n_locs);
+
+    *out_index = index;
+    return 0;
+}
+
+/* Free the index */
+void extent_index_destroy(struct extent_index* index)
+{
+    if (NULL != index) {
+        /* all arrays share the start allocation */
+        free(index->start);
+        free(index);
+    }
+}
+
+/* Copy the extent at position i of the index into ext */
+void extent_index_get(const struct extent_index* index,
+                      unsigned long i,
+                      extent_metadata* ext)
+{
+    const struct extent_index_loc* loc = index->locs + index->loc_id[i];
+    ext->start    = index->start[i];
+    ext->end      = index->end[i];
+    ext->log_pos  = index->log_pos[i];
+    ext->svr_rank = loc->svr_rank;
+    ext->app_id   = loc->app_id;
+    ext->cli_id   = loc->cli_id;
+}
+
+/* Return the position of the first value in the sorted array that is
+ * not less than key, or n if there is none. The loop has no data
+ * dependent branches, so the compiler can use conditional moves. */
+static inline unsigned long lower_bound(const unsigned long* vals,
+                                        unsigned long n,
+                                        unsigned long key)
+{
+    if (0 == n) {
+        return 0;
+    }
+    const unsigned long* base = vals;
+    while (n > 1) {
+        unsigned long half = n / 2;
+        base = (base[half] < key) ? (base + half) : base;
+        n -= half;
+    }
+    return (unsigned long)(base - vals) + (*base < key);
+}
+
+int extent_index_get_chunk_list(
+    const struct extent_index* index, /* extent index to search */
+    unsigned long offset,      /* starting logical offset */
+    unsigned long len,         /* length of extent */
+    unsigned int* n_chunks,    /* [out] number of chunks returned */
+    chunk_read_req_t** chunks, /* [out] chunk array */
+    int* extent_covered)       /* [out] set=1 if extent fully covered */
+{
+    unsigned long end = offset + len - 1;
+
+    *extent_covered = 0;
+    *n_chunks = 0;
+
+    /* the first extent that ends at or after the offset, through the
+     * last extent that starts at or before the end */
+    unsigned long first = lower_bound(index->end, index->count, offset);
+    unsigned long last  = lower_bound(index->start, index->count, end + 1);
+    if (first >= last) {
+        return 0;
+    }
+    unsigned int count = (unsigned int)(last - first);
+
+    bool gap_found = ((index->start[first] > offset) ||
+                      (index->end[last - 1] < end));
+    for (unsigned long i = first + 1; (i < last) && !gap_found; i++) {
+        if ((index->end[i - 1] + 1) != index->start[i]) {
+            gap_found = true;
+        }
+    }
+
+    chunk_read_req_t* out_chunks = calloc(count, sizeof(*out_chunks));
+    if (NULL == out_chunks) {
+        return ENOMEM;
+    }
+
+    extent_metadata ext;
+    for (unsigned long i = first; i < last; i++) {
+        extent_index_get(index, i, &ext);
+        chunk_req_from_extent(offset, len, &ext, out_chunks + (i - first));
+    }
+
+    *n_chunks = count;
+    *chunks = out_chunks;
+    if (!gap_found) {
+        *extent_covered = 1;
+    }
+    return 0;
+}
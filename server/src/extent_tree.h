@@ -15,6 +15,7 @@
 #ifndef __EXTENT_TREE_H__
 #define __EXTENT_TREE_H__
 
+#include "node_pool.h"
 #include "unifyfs_global.h"
 
 typedef struct extent_metadata {
@@ -45,6 +46,8 @@ struct extent_tree {
     ABT_rwlock rwlock;
     unsigned long count;     /* number of segments stored in tree */
     unsigned long max;       /* maximum logical offset value in the tree */
+    struct extent_tree_node* last; /* node with highest offsets, or NULL */
+    struct node_pool pool;   /* node storage, used under the write lock */
 };
 
 /* Returns 0 on success, positive non-zero error code otherwise */
@@ -67,6 +70,13 @@ void extent_tree_destroy(struct extent_tree* tree);
 int extent_tree_add(struct extent_tree* tree,
                     struct extent_metadata* extent);
 
+/*
+ * Merge neighboring entries of an extent array that are contiguous in
+ * both file offset and log position, in place. Returns the new number
+ * of entries.
+ */
+size_t extent_list_coalesce(extent_metadata* extents, size_t n);
+
 /* search tree for entry that overlaps with given start/end
  * offsets, return first overlapping entry if found, NULL otherwise,
  * assumes caller has lock on tree */
@@ -157,6 +167,60 @@ int extent_tree_get_chunk_list(
     chunk_read_req_t** chunks, /* [out] chunk array */
     int* extent_covered);      /* [out] set=1 if extent fully covered */
 
+/*
+ * Immutable, flat index of the extents of a laminated file.
+ *
+ * Extents are kept sorted by file offset in separate start, end, and log
+ * position arrays, and runs that are contiguous in both the file and the
+ * same log are merged. Log locations (server, app, client) are stored
+ * once in a small table. Since the index never changes once built, it
+ * may be searched without locking.
+ */
+struct extent_index_loc {
+    int svr_rank;
+    int app_id;
+    int cli_id;
+};
+
+struct extent_index {
+    unsigned long count;            /* number of extents */
+    unsigned long* start;           /* logical offset of first byte */
+    unsigned long* end;             /* logical offset of last byte */
+    unsigned long* log_pos;         /* physical offset of data in log */
+    unsigned int* loc_id;           /* index of log location in locs */
+    struct extent_index_loc* locs;  /* distinct log locations */
+    unsigned int n_locs;            /* number of log locations */
+};
+
+/* Build an immutable index from the current extents of the tree.
+ * Returns 0 on success, positive non-zero error code otherwise */
+int extent_index_create(struct extent_tree* tree,
+                        struct extent_index** index);
+
+/* Free the index */
+void extent_index_destroy(struct extent_index* index);
+
+/* Return the number of extents in the index */
+static inline
+unsigned long extent_index_count(const struct extent_index* index)
+{
+    return index->count;
+}
+
+/* Copy the extent at position i (< count) of the index into ext */
+void extent_index_get(const struct extent_index* index,
+                      unsigned long i,
+                      extent_metadata* ext);
+
+/* Same as extent_tree_get_chunk_list(), for an index */
+int extent_index_get_chunk_list(
+    const struct extent_index* index, /* extent index to search */
+    unsigned long offset,      /* starting logical offset */
+    unsigned long len,         /* length of extent */
+    unsigned int* n_chunks,    /* [out] number of chunks returned */
+    chunk_read_req_t** chunks, /* [out] chunk array */
+    int* extent_covered);      /* [out] set=1 if extent fully covered */
+
 /* dump method for debugging extent trees */
 static inline
 void extent_tree_dump(struct extent_tree* tree)
@@ -177,4 +241,21 @@ void extent_tree_dump(struct extent_tree* tree)
     extent_tree_unlock(tree);
 }
 
+/* dump method for debugging extent indexes */
+static inline
+void extent_index_dump(const struct extent_index* index)
+{
+    if (NULL == index) {
+        return;
+    }
+
+    extent_metadata ext;
+    for (unsigned long i = 0; i < index->count; i++) {
+        extent_index_get(index, i, &ext);
+        LOGDBG("[%lu-%lu] @ %d(%d:%d) log offset %lu",
+               ext.start, ext.end, ext.svr_rank,
+               ext.app_id, ext.cli_id, ext.log_pos);
+    }
+}
+
 #endif /* __EXTENT_TREE_H__ */
@@ -342,6 +342,10 @@ static void register_client_server_rpcs(margo_instance_id mid)
                    unifyfs_get_gfids_in_t, unifyfs_get_gfids_out_t,
                    unifyfs_get_gfids_rpc);
 
+    MARGO_REGISTER(mid, "unifyfs_server_stats_rpc",
+                   unifyfs_server_stats_in_t, unifyfs_server_stats_out_t,
+                   unifyfs_server_stats_rpc);
+
     /* register the RPCs we call (and capture assigned hg_id_t) */
     unifyfsd_rpc_context->rpcs.client_heartbeat_id =
             MARGO_REGISTER(mid, "unifyfs_heartbeat_rpc",
@@ -355,6 +359,12 @@ static void register_client_server_rpcs(margo_instance_id mid)
                        unifyfs_mread_req_data_out_t,
                        NULL);
 
+    unifyfsd_rpc_context->rpcs.client_mread_local_id =
+        MARGO_REGISTER(mid, "unifyfs_mread_req_local_rpc",
+                       unifyfs_mread_req_local_in_t,
+                       unifyfs_mread_req_local_out_t,
+                       NULL);
+
     unifyfsd_rpc_context->rpcs.client_mread_complete_id =
         MARGO_REGISTER(mid, "unifyfs_mread_req_complete_rpc",
                        unifyfs_mread_req_complete_in_t,
@@ -496,7 +506,7 @@ int margo_connect_server(int rank)
     /* lookup rpc address for this server */
     char* margo_addr_str = rpc_lookup_remote_server_addr(rank);
     if (NULL == margo_addr_str) {
-        LOGERR("server index=%zu - margo server lookup failed", rank);
+        LOGERR("server index=%d - margo server lookup failed", rank);
         return (int)UNIFYFS_ERROR_KEYVAL;
     }
     LOGDBG("server rank=%d, margo_addr=%s", rank, margo_addr_str);
@@ -506,7 +516,7 @@ int margo_connect_server(int rank)
                                          server->margo_svr_addr_str,
                                          &(server->margo_svr_addr));
     if (hret != HG_SUCCESS) {
-        LOGERR("server index=%zu - margo_addr_lookup(%s) failed",
+        LOGERR("server index=%d - margo_addr_lookup(%s) failed",
                rank, margo_addr_str);
         ret = UNIFYFS_ERROR_MARGO;
     }
@@ -733,6 +743,67 @@ int invoke_client_mread_req_data_rpc(int app_id,
     return ret;
 }
 
+/* invokes the client mread request local data location rpc function */
+int invoke_client_mread_req_local_rpc(int app_id,
+                                      int client_id,
+                                      int mread_id,
+                                      int read_index,
+                                      size_t read_offset,
+                                      int log_client_id,
+                                      size_t log_offset,
+                                      size_t length)
+{
+    hg_return_t hret;
+
+    /* check that we have initialized margo */
+    if (NULL == unifyfsd_rpc_context) {
+        return UNIFYFS_FAILURE;
+    }
+
+    /* fill input struct */
+    unifyfs_mread_req_local_in_t in;
+    in.app_id        = (int32_t) app_id;
+    in.client_id     = (int32_t) client_id;
+    in.mread_id      = (int32_t) mread_id;
+    in.read_index    = (int32_t) read_index;
+    in.read_offset   = (hg_size_t) read_offset;
+    in.log_client_id = (int32_t) log_client_id;
+    in.log_offset    = (hg_size_t) log_offset;
+    in.length        = (hg_size_t) length;
+
+    /* get handle to rpc function */
+    hg_id_t rpc_id = unifyfsd_rpc_context->rpcs.client_mread_local_id;
+    hg_handle_t handle = create_client_handle(rpc_id, app_id, client_id);
+
+    /* call rpc function */
+    LOGDBG("invoking the mread[%d] req local (index=%d) rpc function in "
+           "client[%d:%d]", mread_id, read_index, app_id, client_id);
+    int rc = forward_to_client(handle, &in);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("forward of mread-req-local rpc to client failed");
+        margo_destroy(handle);
+        return rc;
+    }
+
+    /* decode response */
+    int ret;
+    unifyfs_mread_req_local_out_t out;
+    hret = margo_get_output(handle, &out);
+    if (hret == HG_SUCCESS) {
+        LOGDBG("Got response ret=%" PRIi32, out.ret);
+        ret = (int) out.ret;
+        margo_free_output(handle, &out);
+    } else {
+        LOGERR("margo_get_output() failed");
+        ret = UNIFYFS_ERROR_MARGO;
+    }
+
+    /* free resources */
+    margo_destroy(handle);
+
+    return ret;
+}
+
 /* invokes the client mread request completion rpc function */
 int invoke_client_mread_req_complete_rpc(int app_id,
                                          int client_id,
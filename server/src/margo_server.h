@@ -55,6 +55,7 @@ typedef struct ServerRpcIds {
     /* client-server rpcs */
     hg_id_t client_heartbeat_id;
     hg_id_t client_mread_data_id;
+    hg_id_t client_mread_local_id;
     hg_id_t client_mread_complete_id;
     hg_id_t client_transfer_complete_id;
     hg_id_t client_unlink_callback_id;
@@ -97,6 +98,16 @@ int invoke_client_mread_req_data_rpc(int app_id,
                                      size_t extent_size,
                                      void* extent_buffer);
 
+/* invokes the client mread request local data location rpc function */
+int invoke_client_mread_req_local_rpc(int app_id,
+                                      int client_id,
+                                      int mread_id,
+                                      int read_index,
+                                      size_t read_offset,
+                                      int log_client_id,
+                                      size_t log_offset,
+                                      size_t length);
+
 /* invokes the client mread request completion rpc function */
 int invoke_client_mread_req_complete_rpc(int app_id,
                                          int client_id,
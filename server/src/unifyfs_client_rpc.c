@@ -38,6 +38,7 @@
 // margo rpcs
 #include "margo_server.h"
 #include "unifyfs_client_rpcs.h"
+#include "unifyfs_rpc_stats.h"
 #include "unifyfs_rpc_util.h"
 #include "unifyfs_misc.h"
 
@@ -998,3 +999,73 @@ static void unifyfs_node_local_extents_get_rpc(hg_handle_t handle)
     }
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_node_local_extents_get_rpc)
+
+/* returns a text report of the server's rpc statistics. The report is
+ * built and pushed directly from the margo handler rather than through
+ * the request manager, so that reporting does not perturb the queues
+ * being measured. */
+static void unifyfs_server_stats_rpc(hg_handle_t handle)
+{
+    int ret = UNIFYFS_SUCCESS;
+    hg_size_t report_size = 0;
+
+    /* get input params */
+    unifyfs_server_stats_in_t in;
+    hg_return_t hret = margo_get_input(handle, &in);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_get_input() failed");
+        ret = UNIFYFS_ERROR_MARGO;
+    } else {
+        char* report = NULL;
+        ret = rpc_stats_report((int)in.reset, (size_t)in.bulk_size,
+                               &report);
+        if (ret == UNIFYFS_SUCCESS) {
+            report_size = (hg_size_t)(strlen(report) + 1);
+
+            /* push as much of the report as fits in the client buffer */
+            hg_size_t push_size = report_size;
+            if (push_size > in.bulk_size) {
+                push_size = in.bulk_size;
+            }
+            if (push_size > 0) {
+                margo_instance_id mid = margo_hg_handle_get_instance(handle);
+                const struct hg_info* info = margo_get_info(handle);
+                void* buf_ptrs[1] = { (void*) report };
+                hg_size_t buf_sizes[1] = { push_size };
+                hg_bulk_t bulk_handle;
+                hret = margo_bulk_create(mid, 1, buf_ptrs, buf_sizes,
+                                         HG_BULK_READ_ONLY, &bulk_handle);
+                if (hret != HG_SUCCESS) {
+                    LOGERR("margo_bulk_create() failed");
+                    ret = UNIFYFS_ERROR_MARGO;
+                } else {
+                    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr,
+                                               in.bulk_report, 0,
+                                               bulk_handle, 0, push_size);
+                    if (hret != HG_SUCCESS) {
+                        LOGERR("margo_bulk_transfer() failed");
+                        ret = UNIFYFS_ERROR_MARGO;
+                    }
+                    margo_bulk_free(bulk_handle);
+                }
+            }
+            free(report);
+        }
+        margo_free_input(handle, &in);
+    }
+
+    /* build output structure to return to caller */
+    unifyfs_server_stats_out_t out;
+    out.ret = (int32_t) ret;
+    out.report_size = report_size;
+
+    /* send output back to caller */
+    hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* free margo resources */
+    margo_destroy(handle);
+}
+DEFINE_MARGO_RPC_HANDLER(unifyfs_server_stats_rpc)
@@ -51,19 +51,110 @@ int rpc_metaset(unifyfs_fops_ctx_t* ctx,
     return unifyfs_invoke_metaset_rpc(gfid, attr_op, attr);
 }
 
+/* add a run of index entries for one file as pending extents, and submit
+ * the file for batched sync processing */
+static int add_pending_sync(unifyfs_fops_ctx_t* ctx,
+                            int gfid,
+                            client_rpc_req_t* client_req,
+                            pending_sync_group* group,
+                            size_t num_extents,
+                            unifyfs_index_t* index_entry)
+{
+    int ret;
+    size_t i;
+
+    extent_metadata* extents = calloc(num_extents, sizeof(*extents));
+    if (NULL == extents) {
+        LOGERR("failed to allocate memory for local extents sync");
+        return ENOMEM;
+    }
+
+    for (i = 0; i < num_extents; i++) {
+        unifyfs_index_t* meta = index_entry + i;
+        extent_metadata* extent = extents + i;
+        extent->start    = meta->file_pos;
+        extent->end      = (meta->file_pos + meta->length) - 1;
+        extent->svr_rank = glb_pmi_rank;
+        extent->app_id   = ctx->app_id;
+        extent->cli_id   = ctx->client_id;
+        extent->log_pos  = meta->log_pos;
+    }
+
+    /* update local inode state first */
+    ret = unifyfs_inode_add_pending_extents(gfid, client_req, group,
+                                            num_extents, extents);
+    if (ret) {
+        LOGERR("failed to add pending local extents (gfid=%d, ret=%d)",
+               gfid, ret);
+        free(extents);
+        return ret;
+    }
+
+    /* then ask svcmgr to process the pending extent sync(s) */
+    return sm_submit_pending_sync(gfid, num_extents);
+}
+
 /*
- * sync rpc from client contains extents for a single gfid (file).
+ * sync rpc from client contains extents for multiple files. The index
+ * holds a run of entries for each file, which are added as pending
+ * extents of a common sync group.
  */
 static
-int rpc_fsync(unifyfs_fops_ctx_t* ctx,
-              int gfid,
-              client_rpc_req_t* client_req)
+int rpc_fsync_multi(unifyfs_fops_ctx_t* ctx,
+                    client_rpc_req_t* client_req,
+                    size_t num_extents,
+                    unifyfs_index_t* index_entry)
 {
     size_t i;
 
-    /* assume we'll succeed */
-    int ret = UNIFYFS_SUCCESS;
+    /* count the runs of entries for each file */
+    int num_runs = 1;
+    for (i = 1; i < num_extents; i++) {
+        if (index_entry[i].gfid != index_entry[i-1].gfid) {
+            num_runs++;
+        }
+    }
 
+    pending_sync_group* group = calloc(1, sizeof(*group));
+    if (NULL == group) {
+        return ENOMEM;
+    }
+    ABT_mutex_create(&(group->sync));
+    group->client_req  = client_req;
+    group->num_pending = num_runs;
+    group->ret         = UNIFYFS_SUCCESS;
+
+    LOGDBG("syncing %zu extents for %d files", num_extents, num_runs);
+
+    /* the group owns the client response from here on. runs that fail to
+     * be added are completed immediately with their error. */
+    size_t run_start = 0;
+    for (i = 1; i <= num_extents; i++) {
+        if ((i < num_extents) &&
+            (index_entry[i].gfid == index_entry[run_start].gfid)) {
+            continue;
+        }
+        int gfid = index_entry[run_start].gfid;
+        int rc = add_pending_sync(ctx, gfid, client_req, group,
+                                  (i - run_start), index_entry + run_start);
+        if (rc != UNIFYFS_SUCCESS) {
+            sm_complete_pending_sync(client_req, group, rc);
+        }
+        run_start = i;
+    }
+
+    return UNIFYFS_SUCCESS;
+}
+
+/*
+ * sync rpc from client contains extents for a single gfid (file), or
+ * extents for multiple files when gfid is INVALID_GFID.
+ */
+static
+int rpc_fsync(unifyfs_fops_ctx_t* ctx,
+              int gfid,
+              client_rpc_req_t* client_req)
+{
     /* get application client */
     app_client* client = get_app_client(ctx->app_id, ctx->client_id);
     if (NULL == client) {
@@ -88,49 +179,15 @@ int rpc_fsync(unifyfs_fops_ctx_t* ctx,
 
     unifyfs_index_t* index_entry = client->state.write_index.index_entries;
 
-    /* the sync rpc now contains extents from a single file/gfid */
-    assert(gfid == index_entry[0].gfid);
-
-    server_rpc_req_t* svr_req = malloc(sizeof(*svr_req));
-    int* pending_gfid = malloc(sizeof(int));
-    extent_metadata* extents = calloc(num_extents, sizeof(*extents));
-    if ((NULL == svr_req) || (NULL == pending_gfid) || (NULL == extents)) {
-        LOGERR("failed to allocate memory for local extents sync");
-        return ENOMEM;
-    }
-
-    for (i = 0; i < num_extents; i++) {
-        unifyfs_index_t* meta = index_entry + i;
-        extent_metadata* extent = extents + i;
-        extent->start    = meta->file_pos;
-        extent->end      = (meta->file_pos + meta->length) - 1;
-        extent->svr_rank = glb_pmi_rank;
-        extent->app_id   = ctx->app_id;
-        extent->cli_id   = ctx->client_id;
-        extent->log_pos  = meta->log_pos;
+    if (gfid == INVALID_GFID) {
+        return rpc_fsync_multi(ctx, client_req, num_extents, index_entry);
     }
 
-    /* update local inode state first */
-    ret = unifyfs_inode_add_pending_extents(gfid, client_req,
-                                            num_extents, extents);
-    if (ret) {
-        LOGERR("failed to add pending local extents (gfid=%d, ret=%d)",
-               gfid, ret);
-        free(pending_gfid);
-        free(svr_req);
-        return ret;
-    } else {
-        /* then ask svcmgr to process the pending extent sync(s) */
-        *pending_gfid = gfid;
-        svr_req->req_type = UNIFYFS_SERVER_PENDING_SYNC;
-        svr_req->handle   = HG_HANDLE_NULL;
-        svr_req->input    = (void*) pending_gfid;
-        svr_req->bulk_buf = NULL;
-        svr_req->bulk_sz  = 0;
-        ret = sm_submit_service_request(svr_req);
-    }
+    /* the sync rpc contains extents from a single file/gfid */
+    assert(gfid == index_entry[0].gfid);
 
-    return ret;
+    return add_pending_sync(ctx, gfid, client_req, NULL,
+                            num_extents, index_entry);
 }
 
 static
@@ -157,7 +214,7 @@ int rpc_transfer(unifyfs_fops_ctx_t* ctx,
                                                  transfer_id, gfid,
                                                  transfer_mode, dest_file);
     } else {
-        LOGERR("invalid transfer mode=%d");
+        LOGERR("invalid transfer mode=%d", transfer_mode);
         return EINVAL;
     }
 
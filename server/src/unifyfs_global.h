@@ -84,12 +84,23 @@ typedef struct {
 /* number of entries in glb_servers array */
 extern size_t glb_num_servers;
 
-/* global inode tree */
-extern struct unifyfs_inode_tree* global_inode_tree;
-
 /* flag to control the use of server local extents for faster local reads */
 extern bool use_server_local_extents;
 
+/* flag to control whether node-local reads are serviced by handing the
+ * client the log location of the data rather than the data itself */
+extern bool use_server_direct_local_reads;
+
+/* flag to control whether shared file extent metadata is distributed
+ * across servers by file offset range (see meta_slice_sz) */
+extern bool use_meta_range_owners;
+
+/* transfer settings: size of each staging buffer, number of concurrent
+ * writer threads per transfer, and whether to use O_DIRECT writes */
+extern size_t transfer_buffer_sz;
+extern int transfer_writer_count;
+extern bool use_transfer_direct_io;
+
 // NEW READ REQUEST STRUCTURES
 typedef enum {
     READREQ_NULL = 0,          /* request not initialized */
@@ -136,6 +147,9 @@ typedef struct {
                               * @SM: received requests buffer */
     chunk_read_resp_t* resp; /* @RM: received responses buffer
                               * @SM: allocated responses buffer */
+    int resp_chunks;         /* @RM: number of responses in resp buffer */
+    int num_segments;        /* @RM: number of response segments expected */
+    int segments_done;       /* @RM: number of response segments handled */
 } server_chunk_reads_t;
 
 // forward declaration of reqmgr_thrd
@@ -780,7 +780,7 @@ int invoke_bcast_progress_rpc(coll_request* coll_req)
                               &(coll_req->progress_req));
         if (hret != HG_SUCCESS) {
             LOGERR("failed to forward bcast progress for coll(%p) - %s",
-                   HG_Error_to_string(hret), coll_req);
+                   coll_req, HG_Error_to_string(hret));
             ret = UNIFYFS_ERROR_MARGO;
         }
     }
@@ -1764,7 +1764,7 @@ int unifyfs_invoke_broadcast_metaget_all(unifyfs_file_attr_t** file_attrs,
 
     if (sizeof(metaget_all_bcast_out_t) != coll->output_sz) {
         LOGERR("Unexpected size for collective output struct. "
-                "Expected %d but value was %d",
+                "Expected %zu but value was %zu",
                 sizeof(metaget_all_bcast_out_t),
                 coll->output_sz);
     }
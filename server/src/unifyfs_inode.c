@@ -23,8 +23,40 @@
 #include "unifyfs_request_manager.h"
 #include "unifyfs_p2p_rpc.h"  // for hash_gfid_to_server()
 
-struct unifyfs_inode_tree _global_inode_tree;
-struct unifyfs_inode_tree* global_inode_tree = &_global_inode_tree;
+/* The global inode table is split into shards by gfid hash, each of which
+ * is an inode tree with its own lock. Lookups, inserts, and removals only
+ * lock the shard for the target gfid, so metadata operations on different
+ * files rarely contend. Walks of the full table lock one shard at a time. */
+#define INODE_TABLE_SHARDS 64
+
+static struct unifyfs_inode_tree inode_table[INODE_TABLE_SHARDS];
+
+static inline
+struct unifyfs_inode_tree* unifyfs_inode_shard(int gfid)
+{
+    /* gfids are hashes already, but mix so the low bits are well spread */
+    uint32_t h = (uint32_t)gfid * 2654435761U;
+    return &(inode_table[(h >> 16) % INODE_TABLE_SHARDS]);
+}
+
+int unifyfs_inode_table_init(void)
+{
+    for (int i = 0; i < INODE_TABLE_SHARDS; i++) {
+        int rc = unifyfs_inode_tree_init(&(inode_table[i]));
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed to initialize inode table shard %d", i);
+            return rc;
+        }
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+void unifyfs_inode_table_fini(void)
+{
+    for (int i = 0; i < INODE_TABLE_SHARDS; i++) {
+        unifyfs_inode_tree_destroy(&(inode_table[i]));
+    }
+}
 
 static inline
 struct unifyfs_inode* unifyfs_inode_alloc(int gfid, unifyfs_file_attr_t* attr)
@@ -92,6 +124,66 @@ void unifyfs_inode_unlock(struct unifyfs_inode* ino)
     ABT_rwlock_unlock(ino->rwlock);
 }
 
+/* Once a file is laminated its extents never change, so replace the
+ * extent tree contents with a flat index that can be searched without
+ * locking. Assumes caller holds the inode write lock. */
+static void unifyfs_inode_freeze_extents(struct unifyfs_inode* ino)
+{
+    if ((NULL != ino->frozen_extents) || (NULL == ino->extents)) {
+        return;
+    }
+
+    struct extent_index* index = NULL;
+    int rc = extent_index_create(ino->extents, &index);
+    if (rc) {
+        /* keep using the tree */
+        LOGERR("failed to build extent index for gfid=%d (rc=%d)",
+               ino->gfid, rc);
+        return;
+    }
+    extent_tree_clear(ino->extents);
+
+    /* publish the index for lock-free readers */
+    __atomic_store_n(&(ino->frozen_extents), index, __ATOMIC_RELEASE);
+}
+
+/* cursor for iterating over the extents of an inode, from its index if
+ * laminated or its tree otherwise. Assumes caller holds the inode lock. */
+typedef struct {
+    struct extent_tree_node* node;
+    unsigned long ndx;
+} inode_extent_cursor;
+
+static unsigned long unifyfs_inode_extent_count(struct unifyfs_inode* ino)
+{
+    if (NULL != ino->frozen_extents) {
+        return extent_index_count(ino->frozen_extents);
+    }
+    return ino->extents->count;
+}
+
+/* copy the next extent into ext, returns 0 when there are no more */
+static int unifyfs_inode_extent_next(struct unifyfs_inode* ino,
+                                     inode_extent_cursor* cursor,
+                                     extent_metadata* ext)
+{
+    struct extent_index* index = ino->frozen_extents;
+    if (NULL != index) {
+        if (cursor->ndx >= extent_index_count(index)) {
+            return 0;
+        }
+        extent_index_get(index, cursor->ndx, ext);
+        cursor->ndx++;
+        return 1;
+    }
+
+    cursor->node = extent_tree_iter(ino->extents, cursor->node);
+    if (NULL == cursor->node) {
+        return 0;
+    }
+    *ext = cursor->node->extent;
+    return 1;
+}
 
 /**
  * @brief get the inode for a gfid.
@@ -102,11 +194,12 @@ static inline
 struct unifyfs_inode* unifyfs_inode_lookup(int gfid)
 {
     struct unifyfs_inode* ino = NULL;
-    unifyfs_inode_tree_rdlock(global_inode_tree);
+    struct unifyfs_inode_tree* shard = unifyfs_inode_shard(gfid);
+    unifyfs_inode_tree_rdlock(shard);
     {
-        ino = unifyfs_inode_tree_search(global_inode_tree, gfid);
+        ino = unifyfs_inode_tree_search(shard, gfid);
     }
-    unifyfs_inode_tree_unlock(global_inode_tree);
+    unifyfs_inode_tree_unlock(shard);
     return ino;
 }
 
@@ -123,11 +216,12 @@ int unifyfs_inode_create(int gfid, unifyfs_file_attr_t* attr)
     }
 
     int ret = UNIFYFS_SUCCESS;
-    unifyfs_inode_tree_wrlock(global_inode_tree);
+    struct unifyfs_inode_tree* shard = unifyfs_inode_shard(gfid);
+    unifyfs_inode_tree_wrlock(shard);
     {
-        ret = unifyfs_inode_tree_insert(global_inode_tree, ino);
+        ret = unifyfs_inode_tree_insert(shard, ino);
     }
-    unifyfs_inode_tree_unlock(global_inode_tree);
+    unifyfs_inode_tree_unlock(shard);
 
     if (ret != UNIFYFS_SUCCESS) {
         unifyfs_inode_destroy(ino);
@@ -136,6 +230,25 @@ int unifyfs_inode_create(int gfid, unifyfs_file_attr_t* attr)
     return ret;
 }
 
+/* submit a request to the client's reqmgr thread to cleanup client
+ * state for an unlinked file */
+static void submit_unlink_callback(int app_id, int client_id, int gfid)
+{
+    client_callback_req* cb = malloc(sizeof(*cb));
+    if (NULL != cb) {
+        cb->req_type  = UNIFYFS_CLIENT_CALLBACK_UNLINK;
+        cb->app_id    = app_id;
+        cb->client_id = client_id;
+        cb->gfid      = gfid;
+        int rc = rm_submit_client_callback_request(cb);
+        if (UNIFYFS_SUCCESS != rc) {
+            LOGERR("failed to submit unlink callback req to client[%d:%d]",
+                   app_id, client_id);
+            free(cb);
+        }
+    }
+}
+
 int unifyfs_inode_destroy(struct unifyfs_inode* ino)
 {
     int ret = UNIFYFS_SUCCESS;
@@ -145,36 +258,40 @@ int unifyfs_inode_destroy(struct unifyfs_inode* ino)
             free(ino->attr.filename);
         }
 
+        /* local clients to which we have sent an unlink callback,
+         * sorted by client id (all from app cb_app_id) */
+        size_t n_clients = 0;
+        int* local_clients = NULL;
+        int cb_app_id = -1;
+
         if (NULL != ino->extents) {
 
             /* allocate an array to track local clients to which we should
              * send an unlink callback */
-            size_t n_clients = 0;
-            size_t max_clients = (size_t) ino->extents->count;
-            int* local_clients = calloc(max_clients, sizeof(int));
+            size_t max_clients = (size_t) unifyfs_inode_extent_count(ino);
+            local_clients = calloc(max_clients, sizeof(int));
             int last_client;
-            int cb_app_id = -1;
 
             /* iterate over extents and release local logio allocations */
             unifyfs_inode_rdlock(ino);
             {
                 last_client = -1;
-                struct extent_tree* tree = ino->extents;
-                struct extent_tree_node* curr = NULL;
-                while (NULL != (curr = extent_tree_iter(tree, curr))) {
-                    if (curr->extent.svr_rank == glb_pmi_rank) {
+                inode_extent_cursor cursor = { NULL, 0 };
+                extent_metadata curr;
+                while (unifyfs_inode_extent_next(ino, &cursor, &curr)) {
+                    if (curr.svr_rank == glb_pmi_rank) {
                         /* lookup client's logio context and release
                          * allocation for this extent */
-                        int app_id    = curr->extent.app_id;
-                        int client_id = curr->extent.cli_id;
+                        int app_id    = curr.app_id;
+                        int client_id = curr.cli_id;
                         app_client* client = get_app_client(app_id, client_id);
                         if ((NULL == client) ||
                             (NULL == client->state.logio_ctx)) {
                             continue;
                         }
                         logio_context* logio = client->state.logio_ctx;
-                        size_t nbytes = extent_length(&(curr->extent));
-                        off_t log_off = curr->extent.log_pos;
+                        size_t nbytes = extent_length(&curr);
+                        off_t log_off = curr.log_pos;
                         int rc = unifyfs_logio_free(logio, log_off, nbytes);
                         if (UNIFYFS_SUCCESS != rc) {
                             LOGERR("failed to free logio allocation for "
@@ -201,6 +318,7 @@ int unifyfs_inode_destroy(struct unifyfs_inode* ino)
 
             extent_tree_destroy(ino->extents);
             free(ino->extents);
+            extent_index_destroy(ino->frozen_extents);
 
             if (NULL != local_clients) {
                 qsort(local_clients, n_clients, sizeof(int), int_compare_fn);
@@ -211,27 +329,30 @@ int unifyfs_inode_destroy(struct unifyfs_inode* ino)
                         continue;
                     }
                     last_client = cb_client_id;
-
-                    /* submit a request to the client's reqmgr thread
-                     * to cleanup client state */
-                    client_callback_req* cb = malloc(sizeof(*cb));
-                    if (NULL != cb) {
-                        cb->req_type  = UNIFYFS_CLIENT_CALLBACK_UNLINK;
-                        cb->app_id    = cb_app_id;
-                        cb->client_id = cb_client_id;
-                        cb->gfid      = ino->gfid;
-                        int rc = rm_submit_client_callback_request(cb);
-                        if (UNIFYFS_SUCCESS != rc) {
-                            LOGERR("failed to submit unlink callback "
-                                   "req to client[%d:%d]",
-                                   cb_app_id, cb_client_id);
-                        }
-                    }
+                    submit_unlink_callback(cb_app_id, cb_client_id,
+                                           ino->gfid);
                 }
-                free(local_clients);
             }
         }
 
+        /* local clients that fetched the file attributes may have
+         * cached them, so notify those not already sent a callback */
+        for (size_t i = 0; i < ino->n_attr_clients; i++) {
+            inode_client* ac = ino->attr_clients + i;
+            if ((ac->app_id == cb_app_id) && (NULL != local_clients) &&
+                (NULL != bsearch(&(ac->client_id), local_clients, n_clients,
+                                 sizeof(int), int_compare_fn))) {
+                continue;
+            }
+            submit_unlink_callback(ac->app_id, ac->client_id, ino->gfid);
+        }
+        if (NULL != ino->attr_clients) {
+            free(ino->attr_clients);
+        }
+        if (NULL != local_clients) {
+            free(local_clients);
+        }
+
         ABT_rwlock_free(&(ino->rwlock));
 
         free(ino);
@@ -257,6 +378,9 @@ int unifyfs_inode_update_attr(int gfid, int attr_op,
         unifyfs_inode_wrlock(ino);
         {
             unifyfs_file_attr_update(attr_op, &ino->attr, attr);
+            if (ino->attr.is_laminated) {
+                unifyfs_inode_freeze_extents(ino);
+            }
         }
         unifyfs_inode_unlock(ino);
     }
@@ -277,7 +401,7 @@ int unifyfs_inode_metaset(int gfid, int attr_op,
 
 int unifyfs_inode_metaget(int gfid, unifyfs_file_attr_t* attr)
 {
-    if ((NULL == global_inode_tree) || (NULL == attr)) {
+    if (NULL == attr) {
         return EINVAL;
     }
 
@@ -291,16 +415,60 @@ int unifyfs_inode_metaget(int gfid, unifyfs_file_attr_t* attr)
     return ret;
 }
 
+int unifyfs_inode_add_attr_client(int gfid, int app_id, int client_id)
+{
+    struct unifyfs_inode* ino = unifyfs_inode_lookup(gfid);
+    if (NULL == ino) {
+        return ENOENT;
+    }
+
+    int ret = UNIFYFS_SUCCESS;
+    unifyfs_inode_wrlock(ino);
+    {
+        for (size_t i = 0; i < ino->n_attr_clients; i++) {
+            inode_client* ac = ino->attr_clients + i;
+            if ((ac->app_id == app_id) && (ac->client_id == client_id)) {
+                /* already tracked */
+                goto attr_client_unlock;
+            }
+        }
+
+        if (ino->n_attr_clients == ino->max_attr_clients) {
+            size_t new_max = 2 * ino->max_attr_clients;
+            if (0 == new_max) {
+                new_max = 4;
+            }
+            inode_client* clients = realloc(ino->attr_clients,
+                                            new_max * sizeof(*clients));
+            if (NULL == clients) {
+                ret = ENOMEM;
+                goto attr_client_unlock;
+            }
+            ino->attr_clients = clients;
+            ino->max_attr_clients = new_max;
+        }
+        inode_client* ac = ino->attr_clients + ino->n_attr_clients;
+        ac->app_id = app_id;
+        ac->client_id = client_id;
+        ino->n_attr_clients++;
+    }
+attr_client_unlock:
+    unifyfs_inode_unlock(ino);
+
+    return ret;
+}
+
 int unifyfs_inode_unlink(int gfid)
 {
     int ret = UNIFYFS_SUCCESS;
     struct unifyfs_inode* ino = NULL;
+    struct unifyfs_inode_tree* shard = unifyfs_inode_shard(gfid);
 
-    unifyfs_inode_tree_wrlock(global_inode_tree);
+    unifyfs_inode_tree_wrlock(shard);
     {
-        ret = unifyfs_inode_tree_remove(global_inode_tree, gfid, &ino);
+        ret = unifyfs_inode_tree_remove(shard, gfid, &ino);
     }
-    unifyfs_inode_tree_unlock(global_inode_tree);
+    unifyfs_inode_tree_unlock(shard);
 
     if (ret == UNIFYFS_SUCCESS) {
         ret = unifyfs_inode_destroy(ino);
@@ -337,6 +505,7 @@ int unifyfs_inode_truncate(int gfid, unsigned long size)
 
 int unifyfs_inode_add_pending_extents(int gfid,
                                       client_rpc_req_t* client_req,
+                                      pending_sync_group* group,
                                       int num_extents,
                                       extent_metadata* extents)
 {
@@ -372,6 +541,7 @@ int unifyfs_inode_add_pending_extents(int gfid,
 
         }
         list_item->client_req = client_req;
+        list_item->group = group;
         list_item->num_extents = num_extents;
         list_item->extents = extents;
 
@@ -448,9 +618,32 @@ int unifyfs_inode_add_extents(int gfid,
         return EINVAL;
     }
 
+    /* merge log-contiguous extents to reduce the number of tree
+     * insertions. The caller's array may be a bulk buffer that is
+     * still being forwarded to other servers, so coalesce a copy */
+    extent_metadata* merged = NULL;
+    if (num_extents > 1) {
+        merged = malloc((size_t)num_extents * sizeof(*merged));
+        if (NULL != merged) {
+            memcpy(merged, extents, (size_t)num_extents * sizeof(*merged));
+            num_extents = (int) extent_list_coalesce(merged,
+                                                     (size_t)num_extents);
+            extents = merged;
+        }
+    }
+
     int ret = UNIFYFS_SUCCESS;
     unifyfs_inode_wrlock(ino);
     {
+        /* recheck now that we hold the lock, the extents of a
+         * laminated file are frozen */
+        if (ino->attr.is_laminated) {
+            LOGERR("trying to add extents to a laminated file (gfid=%d)",
+                   gfid);
+            ret = EINVAL;
+            goto add_unlock_inode;
+        }
+
         struct extent_tree* tree = ino->extents;
         if (NULL == tree) {
             LOGERR("inode extent tree is missing");
@@ -481,10 +674,31 @@ add_unlock_inode:
     LOGINFO("added %d extents to inode (gfid=%d, filesize=%" PRIu64 ")",
             num_extents, gfid, ino->attr.size);
 
+    if (NULL != merged) {
+        free(merged);
+    }
 
     return ret;
 }
 
+int unifyfs_inode_extend_size(int gfid, size_t size)
+{
+    struct unifyfs_inode* ino = unifyfs_inode_lookup(gfid);
+    if (NULL == ino) {
+        return ENOENT;
+    }
+
+    unifyfs_inode_wrlock(ino);
+    {
+        if (!ino->attr.is_laminated && ((uint64_t)size > ino->attr.size)) {
+            ino->attr.size = (uint64_t) size;
+        }
+    }
+    unifyfs_inode_unlock(ino);
+
+    return UNIFYFS_SUCCESS;
+}
+
 int unifyfs_inode_get_filesize(int gfid, size_t* outsize)
 {
     int ret = UNIFYFS_SUCCESS;
@@ -519,6 +733,7 @@ int unifyfs_inode_laminate(int gfid)
         unifyfs_inode_wrlock(ino);
         {
             ino->attr.is_laminated = 1;
+            unifyfs_inode_freeze_extents(ino);
         }
         unifyfs_inode_unlock(ino);
         LOGDBG("laminated file (gfid=%d)", gfid);
@@ -541,19 +756,22 @@ int unifyfs_inode_get_extents(int gfid,
     } else {
         unifyfs_inode_rdlock(ino);
         {
-            struct extent_tree* tree = ino->extents;
-            size_t n_extents = tree->count;
+            size_t n_extents = (size_t) unifyfs_inode_extent_count(ino);
             extent_metadata* _extents = calloc(n_extents, sizeof(*_extents));
             if (NULL == _extents) {
                 ret = ENOMEM;
             } else {
                 int i = 0;
-                struct extent_tree_node* curr = NULL;
-                while ((curr = extent_tree_iter(tree, curr)) != NULL) {
-                    _extents[i] = curr->extent;
+                inode_extent_cursor cursor = { NULL, 0 };
+                while (unifyfs_inode_extent_next(ino, &cursor,
+                                                 _extents + i)) {
                     i++;
                 }
 
+                /* the list is sorted by offset, so anything the tree did
+                 * not merge on insert is merged here, which keeps the
+                 * broadcast payloads small */
+                n_extents = extent_list_coalesce(_extents, n_extents);
                 *n = n_extents;
                 *extents = _extents;
             }
@@ -575,8 +793,20 @@ int unifyfs_inode_get_extent_chunks(unifyfs_extent_t* extent,
     *full_coverage = 0;
 
     struct unifyfs_inode* ino = unifyfs_inode_lookup(gfid);
+    struct extent_index* index = NULL;
+    if (NULL != ino) {
+        index = __atomic_load_n(&(ino->frozen_extents), __ATOMIC_ACQUIRE);
+    }
     if (NULL == ino) {
         ret = ENOENT;
+    } else if (NULL != index) {
+        /* laminated file, the index never changes so no lock needed */
+        ret = extent_index_get_chunk_list(index, extent->offset,
+                                          extent->length,
+                                          n_chunks, chunks, &covered);
+        if (ret) {
+            LOGERR("failed to get chunks for gfid=%d (rc=%d)", gfid, ret);
+        }
     } else {
         unifyfs_inode_rdlock(ino);
         {
@@ -746,7 +976,10 @@ int unifyfs_inode_dump(int gfid)
         unifyfs_inode_rdlock(ino);
         {
             LOGDBG("== inode (gfid=%d) ==\n", ino->gfid);
-            if (NULL != ino->extents) {
+            if (NULL != ino->frozen_extents) {
+                LOGDBG("extents (laminated):");
+                extent_index_dump(ino->frozen_extents);
+            } else if (NULL != ino->extents) {
                 LOGDBG("extents:");
                 extent_tree_dump(ino->extents);
             }
@@ -769,25 +1002,27 @@ int unifyfs_get_gfids(int* num_gfids, int** gfid_list)
         return ENOMEM;
     }
 
-    unifyfs_inode_tree_rdlock(global_inode_tree);
-    {
-        struct unifyfs_inode* node =
-            unifyfs_inode_tree_iter(global_inode_tree, NULL);
-        while (node) {
-            if (_num_gfids == gfid_list_size) {
-                gfid_list_size *= 2;  // Double the list size each time
-                _gfid_list = realloc(_gfid_list, sizeof(int)*gfid_list_size);
-                if (!_gfid_list) {
-                    unifyfs_inode_tree_unlock(global_inode_tree);
-                    return ENOMEM;
+    for (int i = 0; i < INODE_TABLE_SHARDS; i++) {
+        struct unifyfs_inode_tree* shard = &(inode_table[i]);
+        unifyfs_inode_tree_rdlock(shard);
+        {
+            struct unifyfs_inode* node = unifyfs_inode_tree_iter(shard, NULL);
+            while (node) {
+                if (_num_gfids == gfid_list_size) {
+                    gfid_list_size *= 2;  // Double the list size each time
+                    _gfid_list = realloc(_gfid_list,
+                                         sizeof(int)*gfid_list_size);
+                    if (!_gfid_list) {
+                        unifyfs_inode_tree_unlock(shard);
+                        return ENOMEM;
+                    }
                 }
+                _gfid_list[_num_gfids++] = node->gfid;
+                node = unifyfs_inode_tree_iter(shard, node);
             }
-            _gfid_list[_num_gfids++] = node->gfid;
-            node = unifyfs_inode_tree_iter(global_inode_tree, node);
         }
-
+        unifyfs_inode_tree_unlock(shard);
     }
-    unifyfs_inode_tree_unlock(global_inode_tree);
 
     *num_gfids = _num_gfids;
     *gfid_list = _gfid_list;
@@ -798,7 +1033,7 @@ int unifyfs_get_gfids(int* num_gfids, int** gfid_list)
 int unifyfs_get_owned_files(unsigned int* num_files,
                             unifyfs_file_attr_t** attr_list)
 {
-    /* Iterate through the global_inode_tree and copy all the file
+    /* Iterate through the global inode table and copy all the file
      * attr structs for the files this server owns.
      * Note: the file names in the unifyfs_file_attr_t are pointers to
      * separately allocated memory, so they will be created using strdup(). */
@@ -815,41 +1050,43 @@ int unifyfs_get_owned_files(unsigned int* num_files,
         return ENOMEM;
     }
 
-    unifyfs_inode_tree_rdlock(global_inode_tree);
-    {
-        struct unifyfs_inode* node =
-            unifyfs_inode_tree_iter(global_inode_tree, NULL);
-        while (node) {
-            if (num_files_int == attr_list_size) {
-                attr_list_size *= 2;  // Double the list size each time
-                attr_list_int =
-                    realloc(attr_list_int,
-                            sizeof(unifyfs_file_attr_t)*attr_list_size);
-                if (!attr_list_int) {
-                    unifyfs_inode_tree_unlock(global_inode_tree);
-                    free(attr_list_int);
-                    return ENOMEM;
+    for (int i = 0; i < INODE_TABLE_SHARDS; i++) {
+        struct unifyfs_inode_tree* shard = &(inode_table[i]);
+        unifyfs_inode_tree_rdlock(shard);
+        {
+            struct unifyfs_inode* node = unifyfs_inode_tree_iter(shard, NULL);
+            while (node) {
+                if (num_files_int == attr_list_size) {
+                    attr_list_size *= 2;  // Double the list size each time
+                    attr_list_int =
+                        realloc(attr_list_int,
+                                sizeof(unifyfs_file_attr_t)*attr_list_size);
+                    if (!attr_list_int) {
+                        unifyfs_inode_tree_unlock(shard);
+                        free(attr_list_int);
+                        return ENOMEM;
+                    }
                 }
-            }
 
-            /* We only want to copy file attrs that we're the owner of */
-            int owner_rank = hash_gfid_to_server(node->attr.gfid);
-            if (owner_rank == glb_pmi_rank) {
-                memcpy(&attr_list_int[num_files_int], &node->attr,
-                    sizeof(unifyfs_file_attr_t));
+                /* We only want to copy file attrs that we're the owner of */
+                int owner_rank = hash_gfid_to_server(node->attr.gfid);
+                if (owner_rank == glb_pmi_rank) {
+                    memcpy(&attr_list_int[num_files_int], &node->attr,
+                        sizeof(unifyfs_file_attr_t));
 
-                /* filename is a pointer to separately allocated memory.
-                 *  We need to do a deep copy, so create a new string with
-                 *  strdup(). */
-                attr_list_int[num_files_int].filename =
-                    strdup(node->attr.filename);
+                    /* filename is a pointer to separately allocated memory.
+                     *  We need to do a deep copy, so create a new string
+                     *  with strdup(). */
+                    attr_list_int[num_files_int].filename =
+                        strdup(node->attr.filename);
 
-                num_files_int++;
+                    num_files_int++;
+                }
+                node = unifyfs_inode_tree_iter(shard, node);
             }
-            node = unifyfs_inode_tree_iter(global_inode_tree, node);
         }
+        unifyfs_inode_tree_unlock(shard);
     }
-    unifyfs_inode_tree_unlock(global_inode_tree);
 
     /* realloc() the array list space down to only what we need.
      *
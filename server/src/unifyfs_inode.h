@@ -18,12 +18,29 @@
 #include "unifyfs_global.h"
 #include "extent_tree.h"
 
+/* A client sync request whose extents span multiple files. A single
+ * response is sent to the client once the pending extents of every file
+ * have been processed. */
+typedef struct pending_sync_group {
+    client_rpc_req_t* client_req; /* req details, including response handle */
+    ABT_mutex sync;               /* protects the fields below */
+    int num_pending;              /* number of files not yet processed */
+    int ret;                      /* first error seen, if any */
+} pending_sync_group;
+
 typedef struct pending_extents_item {
     client_rpc_req_t* client_req; /* req details, including response handle */
+    pending_sync_group* group;    /* multi-file sync group (or NULL) */
     unsigned int num_extents;     /* number of extents in array */
     extent_metadata* extents;     /* array of extent metadata */
 } pending_extents_item;
 
+/* a local client, identified by app and client id */
+typedef struct inode_client {
+    int app_id;
+    int client_id;
+} inode_client;
+
 /**
  * @brief file and directory inode structure. this holds:
  */
@@ -34,14 +51,34 @@ struct unifyfs_inode {
     int gfid;                     /* global file identifier */
     unifyfs_file_attr_t attr;     /* file attributes */
     struct extent_tree* extents;  /* extent information */
+    struct extent_index* frozen_extents; /* flat index, once laminated */
     arraylist_t* pending_extents; /* list of pending_extents_item */
 
+    /* local clients that fetched the attributes, and so may cache them */
+    inode_client* attr_clients;
+    size_t n_attr_clients;
+    size_t max_attr_clients;
+
     ABT_rwlock rwlock;            /* reader-writer lock */
 };
 
+/**
+ * @brief initialize the global inode table. The table is split into
+ * shards, each an independently locked inode tree that holds the inodes
+ * whose gfids hash to it.
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_inode_table_init(void);
+
+/**
+ * @brief remove and free all inodes in the global inode table.
+ */
+void unifyfs_inode_table_fini(void);
+
 /**
  * @brief create a new inode with given parameters. The newly created inode
- * will be inserted to the global inode tree (global_inode_tree).
+ * will be inserted to the global inode table.
  *
  * @param gfid global file identifier.
  * @param attr attributes of the new file.
@@ -96,6 +133,19 @@ int unifyfs_inode_metaset(int gfid, int attr_op,
  */
 int unifyfs_inode_metaget(int gfid, unifyfs_file_attr_t* attr);
 
+/**
+ * @brief record that a local client fetched the attributes of file with
+ * @gfid, so it is sent an unlink callback when the inode is destroyed.
+ *
+ * @param gfid       global file identifier
+ * @param app_id     application id of the client
+ * @param client_id  client id
+ *
+ * @return 0 on success, ENOENT if the inode no longer exists,
+ * errno otherwise
+ */
+int unifyfs_inode_add_attr_client(int gfid, int app_id, int client_id);
+
 /**
  * @brief unlink file with @gfid. this will remove the target file inode from
  * the global inode tree.
@@ -134,6 +184,8 @@ int unifyfs_inode_get_extents(int gfid,
  *
  * @param gfid               the global file identifier
  * @param client_req         the client req to sync the extents
+ * @param group              the multi-file sync group of the client req
+ *                           (NULL for single-file syncs)
  * @param num_extents        the number of extents in @extents
  * @param extents            an array of extents to be added as pending
  *
@@ -141,6 +193,7 @@ int unifyfs_inode_get_extents(int gfid,
  */
 int unifyfs_inode_add_pending_extents(int gfid,
                                       client_rpc_req_t* client_req,
+                                      pending_sync_group* group,
                                       int num_extents,
                                       extent_metadata* extents);
 
@@ -179,6 +232,17 @@ int unifyfs_inode_add_extents(int gfid,
                               int num_extents,
                               extent_metadata* extents);
 
+/**
+ * @brief grow the file size to at least the given size (e.g., due to extents
+ * held by other servers).
+ *
+ * @param gfid global file identifier
+ * @param size new minimum file size
+ *
+ * @return 0 on success, errno otherwise
+ */
+int unifyfs_inode_extend_size(int gfid, size_t size);
+
 /**
  * @brief get the maximum file size from the local extent tree of given file
  *
@@ -244,7 +308,8 @@ int unifyfs_inode_dump(int gfid);
 
 
 /**
- * @brief walks the tree and gets a list of the gfids for all the inodes
+ * @brief walks the inode table and gets a list of the gfids for all the
+ * inodes
  *
  * @return 0 on success, errno otherwise
  */
@@ -252,8 +317,8 @@ int unifyfs_get_gfids(int* num_gfids, int** gfid_list);
 
 
 /**
- * @brief Walk the tree and return a list file_attr_t structs for all files
- * that we own.
+ * @brief Walk the inode table and return a list file_attr_t structs for all
+ * files that we own.
  *
  * Upon success, the caller will be responsible for freeing attr_list.  If
  * this function returns an error code, then the caller must *NOT* free
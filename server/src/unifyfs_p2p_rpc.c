@@ -27,6 +27,72 @@ int hash_gfid_to_server(int gfid)
     return gfid % glb_pmi_size;
 }
 
+/* determine server responsible for maintaining the extent metadata of
+ * a shared file at the given file offset. Consecutive ranges of
+ * meta_slice_sz bytes are assigned round-robin to servers, starting with
+ * the server that owns the file's attributes. */
+int hash_gfid_range_to_server(int gfid, size_t offset)
+{
+    size_t owner = (size_t) hash_gfid_to_server(gfid);
+    if (use_meta_range_owners) {
+        size_t range = offset / meta_slice_sz;
+        owner = (owner + range) % (size_t)glb_pmi_size;
+    }
+    return (int) owner;
+}
+
+/* returns non-zero if extent metadata for the target file is distributed
+ * across range owners, rather than held only by the file owner */
+static int use_range_owners(int gfid)
+{
+    if (!use_meta_range_owners || (glb_pmi_size == 1)) {
+        return 0;
+    }
+
+    /* private files are only known to their owner */
+    unifyfs_file_attr_t attrs;
+    int rc = sm_get_fileattr(gfid, &attrs);
+    return ((rc == UNIFYFS_SUCCESS) && attrs.is_shared);
+}
+
+/* per-server sets of extents, used to split extent metadata operations
+ * across the range owners of a file */
+typedef struct {
+    unsigned int count;
+    unsigned int capacity;
+    void* extents;
+} range_owner_extents;
+
+/* append an extent of given size to the owner set, growing as needed */
+static void* range_owner_append(range_owner_extents* set,
+                                size_t extent_size)
+{
+    if (set->count == set->capacity) {
+        unsigned int new_cap = (set->capacity ? (2 * set->capacity) : 8);
+        void* tmp = realloc(set->extents, (size_t)new_cap * extent_size);
+        if (NULL == tmp) {
+            return NULL;
+        }
+        set->extents = tmp;
+        set->capacity = new_cap;
+    }
+    char* slot = (char*)set->extents + ((size_t)set->count * extent_size);
+    set->count++;
+    return (void*) slot;
+}
+
+static void range_owners_free(range_owner_extents* sets)
+{
+    if (NULL != sets) {
+        for (int i = 0; i < glb_pmi_size; i++) {
+            if (NULL != sets[i].extents) {
+                free(sets[i].extents);
+            }
+        }
+        free(sets);
+    }
+}
+
 /* helper method to initialize peer request rpc handle */
 int init_p2p_request_handle(hg_id_t request_hgid,
                            int peer_rank,
@@ -248,82 +314,344 @@ static void chunk_read_request_rpc(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(chunk_read_request_rpc)
 
-/* Respond to chunk read request. Sends a set of read reply
- * headers and corresponding data back to the requesting server.
- * The headers and data are posted as a bulk transfer buffer */
-int invoke_chunk_read_response_rpc(server_chunk_reads_t* scr)
+/* state for one segment of a pipelined chunk read response */
+typedef struct {
+    char* buf;                  /* response headers followed by data */
+    int num_chks;               /* number of responses in segment */
+    int first_ndx;              /* index of first chunk in segment */
+    size_t first_off;           /* byte offset within first chunk */
+    size_t size;                /* used size of buf */
+    int in_flight;              /* set when rpc has been forwarded */
+    p2p_request preq;           /* rpc request */
+    chunk_read_response_in_t in; /* rpc input */
+} chunk_read_segment;
+
+/* Determine the next response segment for the chunk reads, starting at
+ * byte offset (*chk_off) in chunk (*chk_ndx) and holding at most
+ * UNIFYFS_SERVER_READ_SEGMENT_SIZE bytes of data. Chunks larger than
+ * the segment size are split across segments. The cursor is advanced
+ * past the segment, and the number of responses and bytes of data in
+ * the segment are returned */
+static void next_chunk_read_segment(server_chunk_reads_t* scr,
+                                    int* chk_ndx,
+                                    size_t* chk_off,
+                                    int* seg_chks,
+                                    size_t* seg_data)
 {
-    /* assume we'll succeed */
-    int ret = UNIFYFS_SUCCESS;
+    size_t data = 0;
+    int nchks = 0;
+    while ((*chk_ndx < scr->num_chunks) &&
+           (data < UNIFYFS_SERVER_READ_SEGMENT_SIZE)) {
+        chunk_read_req_t* rreq = scr->reqs + *chk_ndx;
+        size_t nbytes = rreq->nbytes - *chk_off;
+        size_t space = UNIFYFS_SERVER_READ_SEGMENT_SIZE - data;
+        if (nbytes > space) {
+            nbytes = space;
+        }
+        data += nbytes;
+        nchks++;
+        *chk_off += nbytes;
+        if (*chk_off >= rreq->nbytes) {
+            (*chk_ndx)++;
+            *chk_off = 0;
+        }
+    }
+    *seg_chks = nchks;
+    *seg_data = data;
+}
 
-    /* rank of destination server */
-    int dst_rank = scr->rank;
-    assert(dst_rank < (int)glb_num_servers);
+/* Read the data for the next response segment into its buffer */
+static void fill_chunk_read_segment(server_chunk_reads_t* scr,
+                                    int* chk_ndx,
+                                    size_t* chk_off,
+                                    chunk_read_segment* seg)
+{
+    /* figure out what is in the segment */
+    int first_ndx = *chk_ndx;
+    size_t first_off = *chk_off;
+    size_t seg_data;
+    seg->first_ndx = first_ndx;
+    seg->first_off = first_off;
+    next_chunk_read_segment(scr, chk_ndx, chk_off, &(seg->num_chks),
+                            &seg_data);
+
+    /* read the data, the response headers precede the data in buffer */
+    chunk_read_resp_t* resp = (chunk_read_resp_t*) seg->buf;
+    char* databuf = (char*)(resp + seg->num_chks);
+    size_t buf_cursor = 0;
+    int ndx = first_ndx;
+    size_t off = first_off;
+    for (int i = 0; i < seg->num_chks; i++) {
+        chunk_read_req_t* rreq = scr->reqs + ndx;
+        size_t nbytes = rreq->nbytes - off;
+        if (nbytes > (seg_data - buf_cursor)) {
+            nbytes = seg_data - buf_cursor;
+        }
+        sm_read_chunk_data(rreq, off, nbytes, resp + i,
+                           databuf + buf_cursor);
+        buf_cursor += nbytes;
+        off += nbytes;
+        if (off >= rreq->nbytes) {
+            ndx++;
+            off = 0;
+        }
+    }
+    seg->size = (sizeof(chunk_read_resp_t) * seg->num_chks) + seg_data;
+}
 
-    /* forward response to requesting server */
-    p2p_request preq;
+/* wait for completion of an in-flight response segment rpc */
+static int finish_chunk_read_segment(int dst_rank,
+                                     chunk_read_segment* seg)
+{
+    int ret = wait_for_p2p_request(&(seg->preq));
+    if (ret == UNIFYFS_SUCCESS) {
+        /* rpc executed, now decode response */
+        chunk_read_response_out_t out;
+        hg_return_t hret = margo_get_output(seg->preq.handle, &out);
+        if (hret == HG_SUCCESS) {
+            ret = (int)out.ret;
+            LOGDBG("chunk-read-response rpc to server[%d] - ret=%d",
+                   dst_rank, ret);
+            margo_free_output(seg->preq.handle, &out);
+        } else {
+            LOGERR("margo_get_output() failed - %s",
+                   HG_Error_to_string(hret));
+            ret = UNIFYFS_ERROR_MARGO;
+        }
+    }
+
+    /* free resources allocated for executing margo rpc */
+    margo_bulk_free(seg->in.bulk_handle);
+    margo_destroy(seg->preq.handle);
+    seg->in_flight = 0;
+
+    return ret;
+}
+
+/* Forward a filled response segment to the requesting server, the
+ * segment is in flight on success */
+static int post_chunk_read_segment(server_chunk_reads_t* scr,
+                                   int num_segs,
+                                   chunk_read_segment* seg)
+{
     hg_id_t req_hgid = unifyfsd_rpc_context->rpcs.chunk_read_response_id;
-    int rc = init_p2p_request_handle(req_hgid, dst_rank, &preq);
+    int rc = init_p2p_request_handle(req_hgid, scr->rank, &(seg->preq));
     if (rc != UNIFYFS_SUCCESS) {
         return rc;
     }
 
-    /* get address and size of our response buffer */
-    void* data_buf = (void*) scr->resp;
-    hg_size_t bulk_sz = scr->total_sz;
-
-    /* register our response buffer for bulk remote read access */
-    chunk_read_response_in_t in;
+    /* register segment buffer for bulk remote read access */
+    void* data_buf = (void*) seg->buf;
+    hg_size_t bulk_sz = (hg_size_t) seg->size;
+    chunk_read_response_in_t* in = &(seg->in);
     hg_return_t hret = margo_bulk_create(unifyfsd_rpc_context->svr_mid,
                                          1, &data_buf, &bulk_sz,
-                                         HG_BULK_READ_ONLY, &in.bulk_handle);
+                                         HG_BULK_READ_ONLY,
+                                         &(in->bulk_handle));
     if (hret != HG_SUCCESS) {
-        LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
-        margo_destroy(preq.handle);
+        LOGERR("margo_bulk_create() failed - %s",
+               HG_Error_to_string(hret));
+        margo_destroy(seg->preq.handle);
         return UNIFYFS_ERROR_MARGO;
     }
 
     /* fill input struct */
-    in.src_rank  = (int32_t) glb_pmi_rank;
-    in.app_id    = (int32_t) scr->app_id;
-    in.client_id = (int32_t) scr->client_id;
-    in.req_id    = (int32_t) scr->rdreq_id;
-    in.num_chks  = (int32_t) scr->num_chunks;
-    in.bulk_size = bulk_sz;
+    in->src_rank  = (int32_t) glb_pmi_rank;
+    in->app_id    = (int32_t) scr->app_id;
+    in->client_id = (int32_t) scr->client_id;
+    in->req_id    = (int32_t) scr->rdreq_id;
+    in->num_chks  = (int32_t) seg->num_chks;
+    in->num_segs  = (int32_t) num_segs;
+    in->bulk_size = bulk_sz;
 
     /* call the read response rpc */
-    LOGDBG("invoking the chunk-read-response rpc function");
-    rc = forward_p2p_request((void*)&in, &preq);
+    rc = forward_p2p_request((void*)in, &(seg->preq));
     if (rc != UNIFYFS_SUCCESS) {
-        ret = rc;
-    } else {
-        rc = wait_for_p2p_request(&preq);
+        margo_bulk_free(in->bulk_handle);
+        margo_destroy(seg->preq.handle);
+        return rc;
+    }
+    seg->in_flight = 1;
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* Send a final response segment that reports the error (errcode) for
+ * all chunk reads starting at byte offset (chk_off) in chunk (chk_ndx).
+ * The segment holds only response headers, and declares a total of
+ * (num_segs) segments so the requesting server completes its read with
+ * the error instead of waiting for segments that will never arrive */
+static int send_chunk_read_error_segment(server_chunk_reads_t* scr,
+                                         int chk_ndx,
+                                         size_t chk_off,
+                                         int num_segs,
+                                         int errcode)
+{
+    int num_chks = scr->num_chunks - chk_ndx;
+    if (num_chks <= 0) {
+        return EINVAL;
+    }
+
+    chunk_read_segment seg;
+    memset(&seg, 0, sizeof(seg));
+    seg.buf = (char*) calloc(num_chks, sizeof(chunk_read_resp_t));
+    if (NULL == seg.buf) {
+        return ENOMEM;
+    }
+    seg.num_chks = num_chks;
+    seg.first_ndx = chk_ndx;
+    seg.first_off = chk_off;
+    seg.size = sizeof(chunk_read_resp_t) * num_chks;
+
+    chunk_read_resp_t* resp = (chunk_read_resp_t*) seg.buf;
+    for (int i = 0; i < num_chks; i++) {
+        chunk_read_req_t* rreq = scr->reqs + chk_ndx + i;
+        size_t off = (i == 0) ? chk_off : 0;
+        resp[i].gfid    = rreq->gfid;
+        resp[i].offset  = rreq->offset + off;
+        resp[i].nbytes  = rreq->nbytes - off;
+        resp[i].read_rc = (ssize_t)(-errcode);
+    }
+
+    LOGDBG("sending chunk-read-response error segment (segment %d) - %s",
+           num_segs, unifyfs_rc_enum_description(errcode));
+    int ret = post_chunk_read_segment(scr, num_segs, &seg);
+    if (ret == UNIFYFS_SUCCESS) {
+        ret = finish_chunk_read_segment(scr->rank, &seg);
+    }
+    free(seg.buf);
+
+    return ret;
+}
+
+/* remember the earliest chunk position that was not delivered */
+static void note_failed_segment(chunk_read_segment* seg,
+                                int* err_ndx,
+                                size_t* err_off)
+{
+    if ((*err_ndx < 0) ||
+        (seg->first_ndx < *err_ndx) ||
+        ((seg->first_ndx == *err_ndx) && (seg->first_off < *err_off))) {
+        *err_ndx = seg->first_ndx;
+        *err_off = seg->first_off;
+    }
+}
+
+/* Respond to chunk read request. Reads the requested data and sends
+ * a set of read reply headers and corresponding data back to the
+ * requesting server. The responses are sent as a pipelined sequence of
+ * bounded-size segments posted as bulk transfer buffers, where the data
+ * for the next segment is read while the previous segment is being
+ * transferred. At most two segment buffers are in use at any time, so
+ * memory use does not depend on the total size of the request. If a
+ * segment cannot be delivered, a final error segment covering the
+ * undelivered chunks is sent instead of the remaining segments. */
+int invoke_chunk_read_response_rpc(server_chunk_reads_t* scr)
+{
+    /* assume we'll succeed */
+    int ret = UNIFYFS_SUCCESS;
+
+    /* rank of destination server */
+    int dst_rank = scr->rank;
+    assert(dst_rank < (int)glb_num_servers);
+
+    /* count the segments, and the largest buffer size needed */
+    int num_segs = 0;
+    size_t max_seg_sz = 0;
+    int chk_ndx = 0;
+    size_t chk_off = 0;
+    while (chk_ndx < scr->num_chunks) {
+        int seg_chks;
+        size_t seg_data;
+        next_chunk_read_segment(scr, &chk_ndx, &chk_off,
+                                &seg_chks, &seg_data);
+        size_t seg_sz = (sizeof(chunk_read_resp_t) * seg_chks) + seg_data;
+        if (seg_sz > max_seg_sz) {
+            max_seg_sz = seg_sz;
+        }
+        num_segs++;
+    }
+    if (0 == num_segs) {
+        LOGERR("empty chunk read request");
+        return EINVAL;
+    }
+
+    /* allocate segment buffers, only need two if multiple segments */
+    chunk_read_segment segs[2];
+    memset(segs, 0, sizeof(segs));
+    int num_bufs = (num_segs > 1) ? 2 : 1;
+    for (int i = 0; i < num_bufs; i++) {
+        // NOTE: calloc() is required here, don't use malloc
+        segs[i].buf = (char*) calloc(1, max_seg_sz);
+        if (NULL == segs[i].buf) {
+            LOGERR("failed to allocate chunk read response segment "
+                   "(size=%zu)", max_seg_sz);
+            free(segs[0].buf);
+            send_chunk_read_error_segment(scr, 0, 0, 1, ENOMEM);
+            return ENOMEM;
+        }
+    }
+
+    /* number of segments accepted by the requesting server, and the
+     * first chunk position not delivered due to an error */
+    int num_delivered = 0;
+    int err_ndx = -1;
+    size_t err_off = 0;
+
+    chk_ndx = 0;
+    chk_off = 0;
+    for (int n = 0; n < num_segs; n++) {
+        chunk_read_segment* seg = segs + (n % num_bufs);
+
+        /* make sure the rpc that last used this buffer has completed */
+        if (seg->in_flight) {
+            int rc = finish_chunk_read_segment(dst_rank, seg);
+            if (rc != UNIFYFS_SUCCESS) {
+                note_failed_segment(seg, &err_ndx, &err_off);
+                ret = rc;
+                break;
+            }
+            num_delivered++;
+        }
+
+        /* read data for this segment, while previous one is in flight */
+        fill_chunk_read_segment(scr, &chk_ndx, &chk_off, seg);
+
+        /* forward response segment to requesting server */
+        LOGDBG("invoking the chunk-read-response rpc function "
+               "(segment %d of %d)", n + 1, num_segs);
+        int rc = post_chunk_read_segment(scr, num_segs, seg);
         if (rc != UNIFYFS_SUCCESS) {
+            note_failed_segment(seg, &err_ndx, &err_off);
             ret = rc;
-        } else {
-            /* rpc executed, now decode response */
-            chunk_read_response_out_t out;
-            hret = margo_get_output(preq.handle, &out);
-            if (hret == HG_SUCCESS) {
-                ret = (int)out.ret;
-                LOGDBG("chunk-read-response rpc to server[%d] - ret=%d",
-                       dst_rank, rc);
-                margo_free_output(preq.handle, &out);
+            break;
+        }
+    }
+
+    /* wait for outstanding segments and free buffers */
+    for (int i = 0; i < num_bufs; i++) {
+        if (segs[i].in_flight) {
+            int rc = finish_chunk_read_segment(dst_rank, segs + i);
+            if (rc != UNIFYFS_SUCCESS) {
+                note_failed_segment(segs + i, &err_ndx, &err_off);
+                ret = rc;
             } else {
-                LOGERR("margo_get_output() failed - %s",
-                       HG_Error_to_string(hret));
-                ret = UNIFYFS_ERROR_MARGO;
+                num_delivered++;
             }
         }
+        free(segs[i].buf);
     }
 
-    /* free resources allocated for executing margo rpc */
-    margo_bulk_free(in.bulk_handle);
-    margo_destroy(preq.handle);
-
-    /* free response data buffer */
-    free(data_buf);
-    scr->resp = NULL;
+    /* the requester counts response segments to know when its read is
+     * complete, so report the undelivered chunks in a final segment */
+    if ((ret != UNIFYFS_SUCCESS) && (err_ndx >= 0)) {
+        int rc = send_chunk_read_error_segment(scr, err_ndx, err_off,
+                                               num_delivered + 1, ret);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed to send chunk read error segment to "
+                   "server[%d] (rc=%d)", dst_rank, rc);
+        }
+    }
 
     return ret;
 }
@@ -347,6 +675,7 @@ static void chunk_read_response_rpc(hg_handle_t handle)
         int client_id  = (int)in.client_id;
         int req_id     = (int)in.req_id;
         int num_chks   = (int)in.num_chks;
+        int num_segs   = (int)in.num_segs;
         size_t bulk_sz = (size_t)in.bulk_size;
 
         LOGDBG("received read response from server[%d] (%d chunks)",
@@ -381,8 +710,8 @@ static void chunk_read_response_rpc(hg_handle_t handle)
                 /* process read replies we just received */
                 int rc = rm_post_chunk_read_responses(app_id, client_id,
                                                       src_rank, req_id,
-                                                      num_chks, bulk_sz,
-                                                      resp_buf);
+                                                      num_chks, num_segs,
+                                                      bulk_sz, resp_buf);
                 if (rc != UNIFYFS_SUCCESS) {
                     LOGERR("failed to handle chunk read responses");
                     ret = rc;
@@ -409,18 +738,17 @@ DEFINE_MARGO_RPC_HANDLER(chunk_read_response_rpc)
  * File extents metadata update request
  *************************************************************************/
 
-/* Add extents to target file */
-int unifyfs_invoke_add_extents_rpc(int gfid,
-                                   unsigned int num_extents,
-                                   extent_metadata* extents)
+/* Forward extents to the given owner of (a range of) the target file.
+ * A non-zero file_size tells the owner the file is at least that large.
+ * When given, attrs lets the owner create the file if it does not
+ * know about it yet. */
+static int forward_add_extents(int owner_rank,
+                               int gfid,
+                               unsigned int num_extents,
+                               extent_metadata* extents,
+                               size_t file_size,
+                               unifyfs_file_attr_t* attrs)
 {
-    int owner_rank = hash_gfid_to_server(gfid);
-    if (owner_rank == glb_pmi_rank) {
-        /* I'm the owner, already did local add */
-        return UNIFYFS_SUCCESS;
-    }
-
-    /* forward request to file owner */
     p2p_request preq;
     hg_id_t req_hgid = unifyfsd_rpc_context->rpcs.extent_add_id;
     int rc = init_p2p_request_handle(req_hgid, owner_rank, &preq);
@@ -429,16 +757,20 @@ int unifyfs_invoke_add_extents_rpc(int gfid,
     }
 
     /* create a margo bulk transfer handle for extents array */
-    hg_bulk_t bulk_handle;
-    void* buf = (void*) extents;
-    size_t buf_sz = (size_t)num_extents * sizeof(extent_metadata);
-    hg_return_t hret = margo_bulk_create(unifyfsd_rpc_context->svr_mid,
-                                         1, &buf, &buf_sz,
-                                         HG_BULK_READ_ONLY, &bulk_handle);
-    if (hret != HG_SUCCESS) {
-        LOGERR("margo_bulk_create() failed - %s", HG_Error_to_string(hret));
-        margo_destroy(preq.handle);
-        return UNIFYFS_ERROR_MARGO;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t hret;
+    if (num_extents > 0) {
+        void* buf = (void*) extents;
+        size_t buf_sz = (size_t)num_extents * sizeof(extent_metadata);
+        hret = margo_bulk_create(unifyfsd_rpc_context->svr_mid,
+                                 1, &buf, &buf_sz,
+                                 HG_BULK_READ_ONLY, &bulk_handle);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_bulk_create() failed - %s",
+                   HG_Error_to_string(hret));
+            margo_destroy(preq.handle);
+            return UNIFYFS_ERROR_MARGO;
+        }
     }
 
     /* fill rpc input struct and forward request */
@@ -446,11 +778,19 @@ int unifyfs_invoke_add_extents_rpc(int gfid,
     in.src_rank    = (int32_t) glb_pmi_rank;
     in.gfid        = (int32_t) gfid;
     in.num_extents = (int32_t) num_extents;
+    in.file_size   = (hg_size_t) file_size;
     in.extents     = bulk_handle;
+    if (NULL != attrs) {
+        in.attr = *attrs;
+    } else {
+        unifyfs_file_attr_set_invalid(&(in.attr));
+    }
     LOGDBG("forwarding add_extents(gfid=%d) to server[%d]", gfid, owner_rank);
     rc = forward_p2p_request((void*)&in, &preq);
     if (rc != UNIFYFS_SUCCESS) {
-        margo_bulk_free(bulk_handle);
+        if (HG_BULK_NULL != bulk_handle) {
+            margo_bulk_free(bulk_handle);
+        }
         margo_destroy(preq.handle);
         return rc;
     }
@@ -474,12 +814,94 @@ int unifyfs_invoke_add_extents_rpc(int gfid,
         }
     }
 
-    margo_bulk_free(bulk_handle);
+    if (HG_BULK_NULL != bulk_handle) {
+        margo_bulk_free(bulk_handle);
+    }
     margo_destroy(preq.handle);
 
     return ret;
 }
 
+/* Add extents to target file. The caller has already added the extents
+ * to the local inode. */
+int unifyfs_invoke_add_extents_rpc(int gfid,
+                                   unsigned int num_extents,
+                                   extent_metadata* extents)
+{
+    int owner_rank = hash_gfid_to_server(gfid);
+    if (!use_range_owners(gfid)) {
+        if (owner_rank == glb_pmi_rank) {
+            /* I'm the owner, already did local add */
+            return UNIFYFS_SUCCESS;
+        }
+        return forward_add_extents(owner_rank, gfid, num_extents, extents,
+                                   0, NULL);
+    }
+
+    /* the file create broadcast may not have reached all range owners */
+    unifyfs_file_attr_t attrs;
+    int rc = sm_get_fileattr(gfid, &attrs);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
+
+    /* split extents at range boundaries and group them by range owner */
+    range_owner_extents* sets = calloc((size_t)glb_pmi_size, sizeof(*sets));
+    if (NULL == sets) {
+        return ENOMEM;
+    }
+    size_t file_size = 0;
+    for (unsigned int i = 0; i < num_extents; i++) {
+        extent_metadata* ext = extents + i;
+        if ((size_t)ext->end + 1 > file_size) {
+            file_size = (size_t)ext->end + 1;
+        }
+
+        unsigned long start = ext->start;
+        while (start <= ext->end) {
+            unsigned long range_end =
+                ((start / meta_slice_sz) + 1) * meta_slice_sz - 1;
+            unsigned long end = (range_end < ext->end) ? range_end : ext->end;
+            int rank = hash_gfid_range_to_server(gfid, (size_t)start);
+            extent_metadata* piece =
+                range_owner_append(&(sets[rank]), sizeof(*piece));
+            if (NULL == piece) {
+                range_owners_free(sets);
+                return ENOMEM;
+            }
+            *piece = *ext;
+            piece->start   = start;
+            piece->end     = end;
+            piece->log_pos = ext->log_pos + (start - ext->start);
+            start = end + 1;
+        }
+    }
+
+    /* forward each owner its extents. the file owner also gets the new
+     * file size, since it may not own the range at the end of file. */
+    int ret = UNIFYFS_SUCCESS;
+    for (int rank = 0; rank < glb_pmi_size; rank++) {
+        if (rank == glb_pmi_rank) {
+            /* already did local add */
+            continue;
+        }
+        unsigned int n_ext = sets[rank].count;
+        size_t size_hint = (rank == owner_rank) ? file_size : 0;
+        if ((n_ext > 0) || (size_hint > 0)) {
+            rc = forward_add_extents(rank, gfid, n_ext, sets[rank].extents,
+                                     size_hint, &attrs);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to add extents at range owner %d (gfid=%d)",
+                       rank, gfid);
+                ret = rc;
+            }
+        }
+    }
+    range_owners_free(sets);
+
+    return ret;
+}
+
 /* Add extents rpc handler */
 static void add_extents_rpc(hg_handle_t handle)
 {
@@ -502,9 +924,12 @@ static void add_extents_rpc(hg_handle_t handle)
             size_t bulk_sz = num_extents * sizeof(extent_metadata);
 
             /* allocate memory for extents */
-            void* extents_buf = pull_margo_bulk_buffer(handle, in->extents,
-                                                       bulk_sz, NULL);
-            if (NULL == extents_buf) {
+            void* extents_buf = NULL;
+            if (num_extents > 0) {
+                extents_buf = pull_margo_bulk_buffer(handle, in->extents,
+                                                     bulk_sz, NULL);
+            }
+            if ((NULL == extents_buf) && (num_extents > 0)) {
                 LOGERR("failed to get bulk extents");
                 ret = UNIFYFS_ERROR_MARGO;
             } else {
@@ -552,6 +977,106 @@ DEFINE_MARGO_RPC_HANDLER(add_extents_rpc)
  * File extents metadata lookup request
  *************************************************************************/
 
+static int forward_find_extents(int owner_rank,
+                                int gfid,
+                                unsigned int num_extents,
+                                unifyfs_extent_t* extents,
+                                unsigned int* num_chunks,
+                                chunk_read_req_t** chunks);
+
+/* Lookup extent locations for target file by splitting the extents
+ * among the owners of the offset ranges they cover */
+static int find_extents_at_range_owners(int gfid,
+                                        unsigned int num_extents,
+                                        unifyfs_extent_t* extents,
+                                        unsigned int* num_chunks,
+                                        chunk_read_req_t** chunks)
+{
+    range_owner_extents* sets = calloc((size_t)glb_pmi_size, sizeof(*sets));
+    if (NULL == sets) {
+        return ENOMEM;
+    }
+    for (unsigned int i = 0; i < num_extents; i++) {
+        unifyfs_extent_t* ext = extents + i;
+        if (0 == ext->length) {
+            continue;
+        }
+        size_t start = ext->offset;
+        size_t last = ext->offset + ext->length - 1;
+        while (start <= last) {
+            size_t range_end = ((start / meta_slice_sz) + 1) * meta_slice_sz;
+            size_t end = (range_end - 1 < last) ? (range_end - 1) : last;
+            int rank = hash_gfid_range_to_server(gfid, start);
+            unifyfs_extent_t* piece =
+                range_owner_append(&(sets[rank]), sizeof(*piece));
+            if (NULL == piece) {
+                range_owners_free(sets);
+                return ENOMEM;
+            }
+            piece->gfid   = gfid;
+            piece->offset = start;
+            piece->length = end - start + 1;
+            start = end + 1;
+        }
+    }
+
+    int ret = UNIFYFS_SUCCESS;
+    unsigned int total_chunks = 0;
+    chunk_read_req_t* all_chunks = NULL;
+    for (int rank = 0; rank < glb_pmi_size; rank++) {
+        unsigned int n_ext = sets[rank].count;
+        if (0 == n_ext) {
+            continue;
+        }
+
+        int rc;
+        int full_coverage = 0;
+        unsigned int n_chks = 0;
+        chunk_read_req_t* chks = NULL;
+        if (rank == glb_pmi_rank) {
+            rc = sm_find_extents(gfid, (size_t)n_ext, sets[rank].extents,
+                                 &n_chks, &chks, &full_coverage);
+        } else {
+            rc = forward_find_extents(rank, gfid, n_ext, sets[rank].extents,
+                                      &n_chks, &chks);
+        }
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("extent lookup at range owner %d failed (gfid=%d)",
+                   rank, gfid);
+            ret = rc;
+            break;
+        }
+        if (n_chks > 0) {
+            size_t sz = (size_t)(total_chunks + n_chks) * sizeof(*chks);
+            chunk_read_req_t* tmp = realloc(all_chunks, sz);
+            if (NULL == tmp) {
+                free(chks);
+                ret = ENOMEM;
+                break;
+            }
+            all_chunks = tmp;
+            memcpy(all_chunks + total_chunks, chks,
+                   (size_t)n_chks * sizeof(*chks));
+            total_chunks += n_chks;
+            free(chks);
+        }
+    }
+    range_owners_free(sets);
+
+    if (ret != UNIFYFS_SUCCESS) {
+        if (NULL != all_chunks) {
+            free(all_chunks);
+        }
+        return ret;
+    }
+
+    LOGDBG("range owners returned %u chunk locations for gfid=%d",
+           total_chunks, gfid);
+    *num_chunks = total_chunks;
+    *chunks = all_chunks;
+    return UNIFYFS_SUCCESS;
+}
+
 /* Lookup extent locations for target file */
 int unifyfs_invoke_find_extents_rpc(int gfid,
                                     unsigned int num_extents,
@@ -567,12 +1092,19 @@ int unifyfs_invoke_find_extents_rpc(int gfid,
 
     int owner_rank = hash_gfid_to_server(gfid);
     int is_owner = (owner_rank == glb_pmi_rank);
+    int by_range = use_range_owners(gfid);
 
     /* do local inode metadata lookup */
     unifyfs_file_attr_t attrs;
     int ret = sm_get_fileattr(gfid, &attrs);
     if (ret == UNIFYFS_SUCCESS) {
+        /* with range owners, neither the file owner nor a laminated
+         * copy has the complete set of extents */
         int file_laminated = (attrs.is_shared && attrs.is_laminated);
+        if (by_range) {
+            is_owner = 0;
+            file_laminated = 0;
+        }
         if (is_owner || use_server_local_extents || file_laminated) {
             /* try local lookup */
             int full_coverage = 0;
@@ -603,6 +1135,24 @@ int unifyfs_invoke_find_extents_rpc(int gfid,
         }
     }
 
+    if (by_range) {
+        return find_extents_at_range_owners(gfid, num_extents, extents,
+                                            num_chunks, chunks);
+    }
+    return forward_find_extents(owner_rank, gfid, num_extents, extents,
+                                num_chunks, chunks);
+}
+
+/* Forward extent lookups to the given owner of (a range of) the file */
+static int forward_find_extents(int owner_rank,
+                                int gfid,
+                                unsigned int num_extents,
+                                unifyfs_extent_t* extents,
+                                unsigned int* num_chunks,
+                                chunk_read_req_t** chunks)
+{
+    int ret = UNIFYFS_SUCCESS;
+
     /* forward request to file owner */
     p2p_request preq;
     margo_instance_id mid = unifyfsd_rpc_context->svr_mid;
@@ -786,7 +1336,8 @@ int unifyfs_invoke_metaget_rpc(int gfid,
             return UNIFYFS_SUCCESS;
         } else {
             LOGINFO("cached attributes for gfid=%d have expired "
-                    "(now=%d, expiration=%d)", gfid, tp.tv_sec, expire);
+                    "(now=%ld, expiration=%ld)", gfid,
+                    (long)tp.tv_sec, (long)expire);
         }
     } else if (rc == ENOENT) {
         /* local metaget gave ENOENT, need to create inode if file exists */
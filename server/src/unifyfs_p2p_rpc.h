@@ -26,6 +26,10 @@
 /* determine server responsible for maintaining target file's metadata */
 int hash_gfid_to_server(int gfid);
 
+/* determine server responsible for maintaining target file's extent
+ * metadata at the given offset (when range owners are enabled) */
+int hash_gfid_range_to_server(int gfid, size_t offset);
+
 /* server peer-to-peer (p2p) margo request structure */
 typedef struct {
     margo_request request;
@@ -60,7 +64,8 @@ int invoke_chunk_read_request_rpc(int dst_srvr_rank,
                                   server_read_req_t* rdreq,
                                   server_chunk_reads_t* remote_reads);
 /**
- * @brief Respond to chunk read request
+ * @brief Respond to chunk read request, reading and sending the
+ *        requested data as a pipelined sequence of bounded-size segments
  *
  * @param scr  server chunk reads structure
  *
@@ -42,20 +42,9 @@
 #include "unifyfs_server_rpcs.h"
 #include "seg_tree.h"
 #include "unifyfs_rpc_util.h"
+#include "unifyfs_rpc_stats.h"
 
 
-#define RM_LOCK(rm) \
-do { \
-    /*LOGDBG("locking RM[%d:%d] state", rm->app_id, rm->client_id);*/ \
-    pthread_mutex_lock(&(rm->thrd_lock)); \
-} while (0)
-
-#define RM_UNLOCK(rm) \
-do { \
-    /*LOGDBG("unlocking RM[%d:%d] state", rm->app_id, rm->client_id);*/ \
-    pthread_mutex_unlock(&(rm->thrd_lock)); \
-} while (0)
-
 #define RM_REQ_LOCK(rm) \
 do { \
     /*LOGDBG("locking RM[%d:%d] requests", rm->app_id, rm->client_id);*/ \
@@ -68,76 +57,231 @@ do { \
     ABT_mutex_unlock(rm->reqs_sync); \
 } while (0)
 
-/* One request manager thread is created for each client of the
- * server. The margo rpc handler thread(s) assign work to the
- * request manager thread to handle data and metadata operations.
- *
- * The request manager thread coordinates with other threads
- * using a lock and a condition variable to protect the shared data
- * structure and impose flow control. When assigned work, the
- * request manager thread either handles the request directly, or
- * forwards requests to remote servers.
+/* Request manager state is created for each client of the server, and
+ * a fixed-size pool of request manager threads services the state of all
+ * clients. The margo rpc handler thread(s) assign work to a client's
+ * request manager state and then schedule it on the pool's work queue.
+ * An idle pool thread takes the next client off the queue and handles its
+ * pending data and metadata operations, either directly or by forwarding
+ * requests to remote servers. A client is serviced by at most one pool
+ * thread at a time, and is put back on the queue if new work arrives
+ * while it is being serviced.
  *
  * For read requests, the request manager waits for data chunk
- * responses and places the data into a shared memory data buffer
- * specific to the client. When the shared memory is full or all
- * data has been received, the request manager signals the client
- * to process the read replies. It iterates with the client until
- * all incoming read replies have been transferred. */
-
-/* Create a request manager thread for the application client
- * corresponding to the given app_id and client_id.
- * Returns pointer to thread control structure on success, or
+ * responses and forwards the data to the client. */
+
+/* request manager thread pool */
+typedef struct reqmgr_pool {
+    /* lock and condition variables for pool state (variables below) */
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond; /* signaled when a client is queued */
+    pthread_cond_t idle_cond; /* signaled when a client has been serviced */
+
+    /* pool threads */
+    int num_threads;
+    pthread_t* threads;
+
+    /* list of all registered client request managers */
+    reqmgr_thrd_t* clients;
+
+    /* FIFO queue of client request managers with pending work */
+    reqmgr_thrd_t* queue_head;
+    reqmgr_thrd_t* queue_tail;
+
+    /* flag set to indicate pool threads should exit */
+    int exit_flag;
+} reqmgr_pool_t;
+
+static reqmgr_pool_t rm_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_cond = PTHREAD_COND_INITIALIZER,
+    .idle_cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* interval for pool threads to check clients with outstanding reads
+ * and heartbeats, when there is no other work */
+#define RM_POOL_POLL_USECS 10000 /* 10 ms */
+
+/* interval between heartbeat rpcs to each client */
+#define RM_HEARTBEAT_SECS 30
+
+static void* request_manager_thread(void* arg);
+
+/* add client request manager to the tail of the pool work queue
+ * (caller must hold the pool lock) */
+static void pool_enqueue(reqmgr_thrd_t* reqmgr)
+{
+    reqmgr->has_work = 1;
+    if (reqmgr->queued || (0 != reqmgr->tid) || reqmgr->exit_flag) {
+        /* already queued or being serviced, the servicing thread will
+         * requeue it once done */
+        return;
+    }
+    reqmgr->queued = 1;
+    reqmgr->next_queued = NULL;
+    if (NULL == rm_pool.queue_tail) {
+        rm_pool.queue_head = reqmgr;
+    } else {
+        rm_pool.queue_tail->next_queued = reqmgr;
+    }
+    rm_pool.queue_tail = reqmgr;
+    pthread_cond_signal(&rm_pool.work_cond);
+}
+
+/* remove and return the client request manager at the head of the pool
+ * work queue, or NULL if empty (caller must hold the pool lock) */
+static reqmgr_thrd_t* pool_dequeue(void)
+{
+    reqmgr_thrd_t* reqmgr = rm_pool.queue_head;
+    if (NULL != reqmgr) {
+        rm_pool.queue_head = reqmgr->next_queued;
+        if (NULL == rm_pool.queue_head) {
+            rm_pool.queue_tail = NULL;
+        }
+        reqmgr->next_queued = NULL;
+        reqmgr->queued = 0;
+    }
+    return reqmgr;
+}
+
+/* remove the given client request manager from the pool work queue
+ * (caller must hold the pool lock) */
+static void pool_unqueue(reqmgr_thrd_t* reqmgr)
+{
+    reqmgr_thrd_t* prev = NULL;
+    reqmgr_thrd_t* curr = rm_pool.queue_head;
+    while (NULL != curr) {
+        if (curr == reqmgr) {
+            if (NULL == prev) {
+                rm_pool.queue_head = curr->next_queued;
+            } else {
+                prev->next_queued = curr->next_queued;
+            }
+            if (rm_pool.queue_tail == curr) {
+                rm_pool.queue_tail = prev;
+            }
+            curr->next_queued = NULL;
+            curr->queued = 0;
+            break;
+        }
+        prev = curr;
+        curr = curr->next_queued;
+    }
+}
+
+/* queue any clients that need periodic attention, i.e., clients with
+ * outstanding read requests or due for a heartbeat
+ * (caller must hold the pool lock) */
+static void pool_queue_periodic(void)
+{
+    time_t now = time(NULL);
+    reqmgr_thrd_t* reqmgr = rm_pool.clients;
+    while (NULL != reqmgr) {
+        if ((reqmgr->num_read_reqs > 0) ||
+            (reqmgr->attached &&
+             ((now - reqmgr->last_heartbeat) >= RM_HEARTBEAT_SECS))) {
+            pool_enqueue(reqmgr);
+        }
+        reqmgr = reqmgr->next_client;
+    }
+}
+
+/* start the pool of request manager threads */
+int rm_pool_init(int num_threads)
+{
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    pthread_mutex_lock(&rm_pool.lock);
+    if (NULL != rm_pool.threads) {
+        /* already started */
+        pthread_mutex_unlock(&rm_pool.lock);
+        return UNIFYFS_SUCCESS;
+    }
+    rm_pool.threads = (pthread_t*) calloc(num_threads, sizeof(pthread_t));
+    if (NULL == rm_pool.threads) {
+        LOGERR("failed to allocate request manager thread pool");
+        pthread_mutex_unlock(&rm_pool.lock);
+        return ENOMEM;
+    }
+    rm_pool.exit_flag = 0;
+    pthread_mutex_unlock(&rm_pool.lock);
+
+    /* launch request manager threads */
+    for (int i = 0; i < num_threads; i++) {
+        int rc = pthread_create(&(rm_pool.threads[i]), NULL,
+                                request_manager_thread, NULL);
+        if (rc != 0) {
+            LOGERR("failed to create request manager thread %d - rc=%d (%s)",
+                   i, rc, strerror(rc));
+            if (i == 0) {
+                free(rm_pool.threads);
+                rm_pool.threads = NULL;
+                return UNIFYFS_FAILURE;
+            }
+            break;
+        }
+        rm_pool.num_threads++;
+    }
+    LOGINFO("started %d request manager threads", rm_pool.num_threads);
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* stop the pool of request manager threads */
+int rm_pool_fini(void)
+{
+    pthread_mutex_lock(&rm_pool.lock);
+    if (NULL == rm_pool.threads) {
+        pthread_mutex_unlock(&rm_pool.lock);
+        return UNIFYFS_SUCCESS;
+    }
+    rm_pool.exit_flag = 1;
+    pthread_cond_broadcast(&rm_pool.work_cond);
+    pthread_mutex_unlock(&rm_pool.lock);
+
+    for (int i = 0; i < rm_pool.num_threads; i++) {
+        pthread_join(rm_pool.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&rm_pool.lock);
+    free(rm_pool.threads);
+    rm_pool.threads = NULL;
+    rm_pool.num_threads = 0;
+    pthread_mutex_unlock(&rm_pool.lock);
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* Create request manager state for the application client
+ * corresponding to the given app_id and client_id, and register it
+ * with the request manager thread pool.
+ * Returns pointer to request manager structure on success, or
  * NULL on failure */
 reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id, int client_id)
 {
-    /* allocate a new thread control structure */
+    /* allocate a new request manager structure */
     reqmgr_thrd_t* thrd_ctrl = (reqmgr_thrd_t*)
         calloc(1, sizeof(reqmgr_thrd_t));
     if (thrd_ctrl == NULL) {
         LOGERR("Failed to allocate structure for request "
-               "manager thread for app_id=%d client_id=%d",
+               "manager for app_id=%d client_id=%d",
                app_id, client_id);
         return NULL;
     }
 
-    /* initialize lock for shared data structures of the
-     * request manager */
-    pthread_mutexattr_t attr;
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    int rc = pthread_mutex_init(&(thrd_ctrl->thrd_lock), &attr);
-    if (rc != 0) {
-        LOGERR("pthread_mutex_init failed for request "
-               "manager thread app_id=%d client_id=%d rc=%d (%s)",
-               app_id, client_id, rc, strerror(rc));
-        free(thrd_ctrl);
-        return NULL;
-    }
-
-    /* initialize condition variable to synchronize work
-     * notifications for the request manager thread */
-    rc = pthread_cond_init(&(thrd_ctrl->thrd_cond), NULL);
-    if (rc != 0) {
-        LOGERR("pthread_cond_init failed for request "
-               "manager thread app_id=%d client_id=%d rc=%d (%s)",
-               app_id, client_id, rc, strerror(rc));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
-        free(thrd_ctrl);
-        return NULL;
-    }
-
     /* create the argobots mutex for synchronizing access to reqs state */
     ABT_mutex_create(&(thrd_ctrl->reqs_sync));
+    ABT_cond_create(&(thrd_ctrl->resp_cond));
 
     /* allocate a list to track client rpc requests */
     thrd_ctrl->client_reqs =
         arraylist_create(UNIFYFS_CLIENT_MAX_ACTIVE_REQUESTS);
     if (thrd_ctrl->client_reqs == NULL) {
         LOGERR("failed to allocate request manager client_reqs!");
+        ABT_cond_free(&(thrd_ctrl->resp_cond));
         ABT_mutex_free(&(thrd_ctrl->reqs_sync));
-        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
         free(thrd_ctrl);
         return NULL;
     }
@@ -148,14 +292,13 @@ reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id, int client_id)
     if (thrd_ctrl->client_callbacks == NULL) {
         LOGERR("failed to allocate request manager client_callbacks!");
         arraylist_free(thrd_ctrl->client_reqs);
+        ABT_cond_free(&(thrd_ctrl->resp_cond));
         ABT_mutex_free(&(thrd_ctrl->reqs_sync));
-        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
         free(thrd_ctrl);
         return NULL;
     }
 
-    /* record app and client id this thread will be serving */
+    /* record app and client id this request manager will be serving */
     thrd_ctrl->app_id    = app_id;
     thrd_ctrl->client_id = client_id;
 
@@ -163,27 +306,30 @@ reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id, int client_id)
     thrd_ctrl->attached = 0;
     thrd_ctrl->exit_flag = 0;
     thrd_ctrl->exited = 0;
-    thrd_ctrl->waiting_for_work = 0;
-
-    /* launch request manager thread */
-    rc = pthread_create(&(thrd_ctrl->thrd), NULL,
-                        request_manager_thread, (void*)thrd_ctrl);
-    if (rc != 0) {
-        LOGERR("failed to create request manager thread for "
-               "app_id=%d client_id=%d - rc=%d (%s)",
-               app_id, client_id, rc, strerror(rc));
-        arraylist_free(thrd_ctrl->client_callbacks);
-        arraylist_free(thrd_ctrl->client_reqs);
-        ABT_mutex_free(&(thrd_ctrl->reqs_sync));
-        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
-        free(thrd_ctrl);
-        return NULL;
-    }
+    thrd_ctrl->last_heartbeat = time(NULL);
+
+    /* register with the thread pool */
+    pthread_mutex_lock(&rm_pool.lock);
+    thrd_ctrl->next_client = rm_pool.clients;
+    rm_pool.clients = thrd_ctrl;
+    pthread_mutex_unlock(&rm_pool.lock);
 
     return thrd_ctrl;
 }
 
+/* return the server read request at the given index, or NULL if the
+ * block containing the index has not been allocated */
+static inline
+server_read_req_t* get_read_req(reqmgr_thrd_t* thrd_ctrl, int ndx)
+{
+    server_read_req_t* block =
+        thrd_ctrl->read_req_blocks[ndx / RM_READ_REQ_BLOCK_SZ];
+    if (NULL == block) {
+        return NULL;
+    }
+    return block + (ndx % RM_READ_REQ_BLOCK_SZ);
+}
+
 static void debug_print_read_req(server_read_req_t* req)
 {
     if (NULL != req) {
@@ -197,24 +343,42 @@ server_read_req_t* rm_reserve_read_req(reqmgr_thrd_t* thrd_ctrl)
     server_read_req_t* rdreq = NULL;
     RM_REQ_LOCK(thrd_ctrl);
     if (thrd_ctrl->num_read_reqs < UNIFYFS_SERVER_MAX_READS) {
+        int ndx = -1;
         if (thrd_ctrl->next_rdreq_ndx < (UNIFYFS_SERVER_MAX_READS - 1)) {
-            rdreq = thrd_ctrl->read_reqs + thrd_ctrl->next_rdreq_ndx;
-            assert((rdreq->req_ndx == 0) && (rdreq->in_use == 0));
-            rdreq->req_ndx = thrd_ctrl->next_rdreq_ndx++;
+            ndx = thrd_ctrl->next_rdreq_ndx++;
         } else { // search for unused slot
             for (int i = 0; i < UNIFYFS_SERVER_MAX_READS; i++) {
-                rdreq = thrd_ctrl->read_reqs + i;
-                if ((rdreq->req_ndx == 0) && (rdreq->in_use == 0)) {
-                    rdreq->req_ndx = i;
+                server_read_req_t* req = get_read_req(thrd_ctrl, i);
+                if ((NULL == req) || (req->in_use == 0)) {
+                    ndx = i;
                     break;
                 }
             }
         }
-        thrd_ctrl->num_read_reqs++;
-        rdreq->in_use = 1;
-        LOGDBG("reserved read req %d (active=%d, next=%d)", rdreq->req_ndx,
-               thrd_ctrl->num_read_reqs, thrd_ctrl->next_rdreq_ndx);
-        debug_print_read_req(rdreq);
+        assert(ndx != -1);
+
+        /* allocate block of read requests containing the slot if needed */
+        int block_ndx = ndx / RM_READ_REQ_BLOCK_SZ;
+        if (NULL == thrd_ctrl->read_req_blocks[block_ndx]) {
+            thrd_ctrl->read_req_blocks[block_ndx] = (server_read_req_t*)
+                calloc(RM_READ_REQ_BLOCK_SZ, sizeof(server_read_req_t));
+        }
+        rdreq = get_read_req(thrd_ctrl, ndx);
+        if (NULL != rdreq) {
+            assert(rdreq->in_use == 0);
+            rdreq->req_ndx = ndx;
+            thrd_ctrl->num_read_reqs++;
+            rdreq->in_use = 1;
+            LOGDBG("reserved read req %d (active=%d, next=%d)",
+                   rdreq->req_ndx, thrd_ctrl->num_read_reqs,
+                   thrd_ctrl->next_rdreq_ndx);
+            debug_print_read_req(rdreq);
+        } else {
+            LOGERR("failed to allocate request manager read_reqs block");
+            if (ndx == (thrd_ctrl->next_rdreq_ndx - 1)) {
+                thrd_ctrl->next_rdreq_ndx--;
+            }
+        }
     } else {
         LOGERR("maxed-out request manager read_reqs array!!");
     }
@@ -246,6 +410,9 @@ static int release_read_req(reqmgr_thrd_t* thrd_ctrl,
         }
         LOGDBG("after release (active=%d, next=%d)",
                thrd_ctrl->num_read_reqs, thrd_ctrl->next_rdreq_ndx);
+
+        /* wake any response posters waiting on the released request */
+        ABT_cond_broadcast(thrd_ctrl->resp_cond);
         RM_REQ_UNLOCK(thrd_ctrl);
     } else {
         rc = EINVAL;
@@ -261,30 +428,17 @@ int rm_release_read_req(reqmgr_thrd_t* thrd_ctrl,
     return release_read_req(thrd_ctrl, rdreq);
 }
 
-static void signal_new_requests(reqmgr_thrd_t* reqmgr)
-{
-    pid_t this_thread = unifyfs_gettid();
-    if ((!reqmgr->exit_flag) && (this_thread != reqmgr->tid)) {
-        /* signal reqmgr to begin processing the requests we just added */
-        LOGDBG("signaling new requests");
-        pthread_cond_signal(&reqmgr->thrd_cond);
-    }
-}
-
-static void signal_new_responses(reqmgr_thrd_t* reqmgr)
+/* schedule the client request manager on the thread pool to begin
+ * processing the requests or responses we just added */
+static void signal_new_work(reqmgr_thrd_t* reqmgr)
 {
-    pid_t this_thread = unifyfs_gettid();
-    if (this_thread != reqmgr->tid) {
-        /* wake up the request manager thread */
-        RM_LOCK(reqmgr);
-        if (reqmgr->waiting_for_work) {
-            /* reqmgr thread is waiting on condition variable,
-             * signal it to begin processing the responses we just added */
-            LOGDBG("signaling new responses");
-            pthread_cond_signal(&reqmgr->thrd_cond);
-        }
-        RM_UNLOCK(reqmgr);
+    pthread_mutex_lock(&rm_pool.lock);
+    if (!reqmgr->exit_flag) {
+        LOGDBG("signaling new work for RM[%d:%d]",
+               reqmgr->app_id, reqmgr->client_id);
+        pool_enqueue(reqmgr);
     }
+    pthread_mutex_unlock(&rm_pool.lock);
 }
 
 int rm_submit_read_request(server_read_req_t* req)
@@ -331,12 +485,12 @@ int rm_submit_read_request(server_read_req_t* req)
     }
 
     rdreq->status = READREQ_READY;
-    signal_new_requests(thrd_ctrl);
+    signal_new_work(thrd_ctrl);
 
     return ret;
 }
 
-/* cleanup Request Manager thread state */
+/* cleanup Request Manager state */
 int unifyfs_rm_thrd_cleanup(reqmgr_thrd_t* thrd_ctrl)
 {
     if (NULL == thrd_ctrl) {
@@ -353,13 +507,28 @@ int unifyfs_rm_thrd_cleanup(reqmgr_thrd_t* thrd_ctrl)
         arraylist_free(thrd_ctrl->client_callbacks);
     }
 
+    for (int i = 0; i < RM_READ_REQ_BLOCKS; i++) {
+        server_read_req_t* block = thrd_ctrl->read_req_blocks[i];
+        if (NULL != block) {
+            for (int j = 0; j < RM_READ_REQ_BLOCK_SZ; j++) {
+                if (block[j].in_use) {
+                    free(block[j].chunks);
+                    free(block[j].remote_reads);
+                }
+            }
+            free(block);
+            thrd_ctrl->read_req_blocks[i] = NULL;
+        }
+    }
+
+    ABT_cond_free(&(thrd_ctrl->resp_cond));
     ABT_mutex_free(&(thrd_ctrl->reqs_sync));
 
     return UNIFYFS_SUCCESS;
 }
 
 /* function called by main thread to instruct
- * resource manager thread to exit,
+ * request manager thread pool to stop servicing client,
  * returns UNIFYFS_SUCCESS on success */
 int rm_request_exit(reqmgr_thrd_t* thrd_ctrl)
 {
@@ -368,27 +537,42 @@ int rm_request_exit(reqmgr_thrd_t* thrd_ctrl)
         return UNIFYFS_SUCCESS;
     }
 
-    /* grab the lock */
-    RM_LOCK(thrd_ctrl);
+    pthread_mutex_lock(&rm_pool.lock);
 
-    /* inform reqmgr thread that it's time to exit */
+    /* inform pool threads that it's time to stop servicing client */
     thrd_ctrl->exit_flag = 1;
-
-    /* if reqmgr thread is waiting for work, wake it up */
-    if (thrd_ctrl->waiting_for_work) {
-         /* signal reqmgr thread */
-        pthread_cond_signal(&thrd_ctrl->thrd_cond);
+    if (thrd_ctrl->queued) {
+        pool_unqueue(thrd_ctrl);
     }
 
-    /* release the lock */
-    RM_UNLOCK(thrd_ctrl);
+    /* wait for any pool thread currently servicing client to finish,
+     * unless we are that thread */
+    pid_t this_thread = unifyfs_gettid();
+    while ((0 != thrd_ctrl->tid) && (this_thread != thrd_ctrl->tid)) {
+        pthread_cond_wait(&rm_pool.idle_cond, &rm_pool.lock);
+    }
 
-    /* wait for reqmgr thread to exit */
-    int rc = pthread_join(thrd_ctrl->thrd, NULL);
-    if (0 == rc) {
-        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
+    /* deregister from the thread pool */
+    reqmgr_thrd_t* prev = NULL;
+    reqmgr_thrd_t* curr = rm_pool.clients;
+    while (NULL != curr) {
+        if (curr == thrd_ctrl) {
+            if (NULL == prev) {
+                rm_pool.clients = curr->next_client;
+            } else {
+                prev->next_client = curr->next_client;
+            }
+            break;
+        }
+        prev = curr;
+        curr = curr->next_client;
     }
+    thrd_ctrl->next_client = NULL;
+    thrd_ctrl->exited = 1;
+
+    pthread_mutex_unlock(&rm_pool.lock);
+
+    LOGDBG("RM[%d:%d] stopped", thrd_ctrl->app_id, thrd_ctrl->client_id);
     return UNIFYFS_SUCCESS;
 }
 
@@ -396,6 +580,118 @@ int rm_request_exit(reqmgr_thrd_t* thrd_ctrl)
  * These functions define the logic of the request manager thread
  ***********************/
 
+/* if all remote reads are complete, mark the request as complete
+ * and notify the client
+ *
+ * @param rdreq    server read request
+ * @param errcode  error (if any) encountered while processing request
+ * @return success/error code
+ */
+static int rm_check_read_req_complete(server_read_req_t* rdreq,
+                                      int errcode)
+{
+    int ret = UNIFYFS_SUCCESS;
+
+    for (int i = 0; i < rdreq->num_server_reads; i++) {
+        if (rdreq->remote_reads[i].status != READREQ_COMPLETE) {
+            return ret;
+        }
+    }
+    rdreq->status = READREQ_COMPLETE;
+
+    int app_id = rdreq->app_id;
+    int client_id = rdreq->client_id;
+    int mread_id = rdreq->client_mread;
+    int read_ndx = rdreq->client_read_ndx;
+    int rc = invoke_client_mread_req_complete_rpc(app_id, client_id,
+                                                  mread_id, read_ndx,
+                                                  errcode);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("mread[%d] request %d completion rpc failed (rc=%d)",
+               mread_id, read_ndx, rc);
+        ret = rc;
+    }
+    return ret;
+}
+
+/* check whether all chunks of a node-local read can be copied by the
+ * client directly from the logs of its peer clients, which are only
+ * accessible to clients of the same application */
+static int can_send_local_read_locations(server_read_req_t* rdreq,
+                                         server_chunk_reads_t* local_reads)
+{
+    if (!use_server_direct_local_reads ||
+        (local_reads->rank != glb_pmi_rank)) {
+        return 0;
+    }
+    for (int i = 0; i < local_reads->num_chunks; i++) {
+        chunk_read_req_t* chk = local_reads->reqs + i;
+        if ((chk->log_app_id != rdreq->app_id) ||
+            (NULL == get_app_client(chk->log_app_id, chk->log_client_id))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* service node-local chunk reads by sending the log location of each
+ * chunk to the client, which copies the data directly from the peer
+ * client's log. This avoids copying the data into a server buffer and
+ * transferring it back to the client.
+ *
+ * @param rdreq        server read request
+ * @param local_reads  chunk reads for data held by this server
+ * @return success/error code
+ */
+static int rm_send_local_read_locations(server_read_req_t* rdreq,
+                                        server_chunk_reads_t* local_reads)
+{
+    int ret = UNIFYFS_SUCCESS;
+    size_t req_file_offset = (size_t) rdreq->extent.offset;
+
+    for (int i = 0; i < local_reads->num_chunks; i++) {
+        chunk_read_req_t* chk = local_reads->reqs + i;
+        assert(chk->offset >= req_file_offset);
+        size_t read_byte_offset = chk->offset - req_file_offset;
+
+        LOGDBG("sending log location for client[%d:%d] mread[%d] "
+               "request %d (gfid=%d, offset=%zu, length=%zu) "
+               "@ log(client=%d, offset=%zu)",
+               rdreq->app_id, rdreq->client_id, rdreq->client_mread,
+               rdreq->client_read_ndx, chk->gfid, chk->offset,
+               chk->nbytes, chk->log_client_id, chk->log_offset);
+
+        int rc = invoke_client_mread_req_local_rpc(rdreq->app_id,
+                                                   rdreq->client_id,
+                                                   rdreq->client_mread,
+                                                   rdreq->client_read_ndx,
+                                                   read_byte_offset,
+                                                   chk->log_client_id,
+                                                   chk->log_offset,
+                                                   chk->nbytes);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed local rpc for mread[%d] request %d "
+                   "(gfid=%d, offset=%zu, length=%zu)",
+                   rdreq->client_mread, rdreq->client_read_ndx,
+                   chk->gfid, chk->offset, chk->nbytes);
+            ret = rc;
+        }
+    }
+
+    local_reads->status = READREQ_COMPLETE;
+    int rc = rm_check_read_req_complete(rdreq, ret);
+    if (rc != UNIFYFS_SUCCESS) {
+        ret = rc;
+    }
+    return ret;
+}
+
+/* node-local chunk reads whose log locations are sent to the client */
+typedef struct {
+    server_read_req_t* rdreq;
+    server_chunk_reads_t* local_reads;
+} local_read_locations_t;
+
 /* send the chunk read requests to remote servers
  *
  * @param thrd_ctrl : reqmgr thread control structure
@@ -406,10 +702,23 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
     int i, j, rc;
     int ret = (int)UNIFYFS_SUCCESS;
 
+    /* node-local reads are serviced by per-chunk client rpcs, which are
+     * sent after releasing the lock so other requests are not stalled.
+     * Read requests are only released by this thread, so they remain
+     * valid until then. */
+    local_read_locations_t* locations = NULL;
+    size_t n_locations = 0;
+    size_t max_locations = 0;
+
     /* iterate over each active read request */
     RM_REQ_LOCK(thrd_ctrl);
     for (i = 0; i < UNIFYFS_SERVER_MAX_READS; i++) {
-        server_read_req_t* req = thrd_ctrl->read_reqs + i;
+        server_read_req_t* req = get_read_req(thrd_ctrl, i);
+        if (NULL == req) {
+            /* skip unallocated block */
+            i += RM_READ_REQ_BLOCK_SZ - 1;
+            continue;
+        }
         if (!req->in_use) {
             continue;
         }
@@ -426,6 +735,26 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
 
                     /* send requests */
                     int remote_rank = remote_reads->rank;
+                    if (can_send_local_read_locations(req, remote_reads)) {
+                        if (n_locations == max_locations) {
+                            size_t new_max = (0 == max_locations) ?
+                                             8 : (2 * max_locations);
+                            local_read_locations_t* tmp =
+                                realloc(locations, new_max * sizeof(*tmp));
+                            if (NULL != tmp) {
+                                locations = tmp;
+                                max_locations = new_max;
+                            }
+                        }
+                        if (n_locations < max_locations) {
+                            locations[n_locations].rdreq = req;
+                            locations[n_locations].local_reads = remote_reads;
+                            n_locations++;
+                            continue;
+                        }
+                        /* no memory to defer the locations, fall back
+                         * to having this server read the chunks */
+                    }
                     LOGDBG("[%d of %d] sending %d chunk requests to server[%d]",
                            j, req->num_server_reads,
                            remote_reads->num_chunks, remote_rank);
@@ -450,6 +779,22 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
     }
     RM_REQ_UNLOCK(thrd_ctrl);
 
+    for (size_t k = 0; k < n_locations; k++) {
+        server_read_req_t* req = locations[k].rdreq;
+        server_chunk_reads_t* local_reads = locations[k].local_reads;
+        LOGDBG("sending %d local chunk locations for read req %d",
+               local_reads->num_chunks, req->req_ndx);
+        rc = rm_send_local_read_locations(req, local_reads);
+        if (rc != UNIFYFS_SUCCESS) {
+            ret = rc;
+            LOGERR("local chunk locations failed - %s",
+                   unifyfs_rc_enum_str((unifyfs_rc)rc));
+        }
+    }
+    if (NULL != locations) {
+        free(locations);
+    }
+
     return ret;
 }
 
@@ -460,14 +805,19 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
  */
 static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
 {
-    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
+    // NOTE: this fn assumes the calling pool thread is servicing thrd_ctrl
 
     int i, j, rc;
     int ret = (int)UNIFYFS_SUCCESS;
 
     /* iterate over each active read request */
     for (i = 0; i < UNIFYFS_SERVER_MAX_READS; i++) {
-        server_read_req_t* req = thrd_ctrl->read_reqs + i;
+        server_read_req_t* req = get_read_req(thrd_ctrl, i);
+        if (NULL == req) {
+            /* skip unallocated block */
+            i += RM_READ_REQ_BLOCK_SZ - 1;
+            continue;
+        }
         if (!req->in_use) {
             continue;
         }
@@ -489,7 +839,8 @@ static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
                     }
                 }
             }
-        } else if (req->status == READREQ_COMPLETE) {
+        }
+        if (req->status == READREQ_COMPLETE) {
             /* cleanup completed server_read_req */
             rc = release_read_req(thrd_ctrl, req);
             if (rc != (int)UNIFYFS_SUCCESS) {
@@ -507,6 +858,7 @@ int rm_post_chunk_read_responses(int app_id,
                                  int src_rank,
                                  int req_id,
                                  int num_chks,
+                                 int num_segs,
                                  size_t bulk_sz,
                                  char* resp_buf)
 {
@@ -522,42 +874,65 @@ int rm_post_chunk_read_responses(int app_id,
     reqmgr_thrd_t* thrd_ctrl = client->reqmgr;
     assert(NULL != thrd_ctrl);
 
-    server_chunk_reads_t* server_chunks = NULL;
+    server_chunk_reads_t* server_chunks;
 
-    /* find read req associated with req_id */
-    if (src_rank != glb_pmi_rank) {
-        /* only need to lock for posting responses from remote servers.
-         * when response is local, we already have the lock */
-        RM_REQ_LOCK(thrd_ctrl);
-    }
-    server_read_req_t* rdreq = thrd_ctrl->read_reqs + req_id;
-    for (int i = 0; i < rdreq->num_server_reads; i++) {
-        if (rdreq->remote_reads[i].rank == src_rank) {
-            server_chunks = rdreq->remote_reads + i;
-            break;
+    while (1) {
+        /* find read req associated with req_id */
+        server_chunks = NULL;
+        if (src_rank != glb_pmi_rank) {
+            /* only need to lock for posting responses from remote servers.
+             * when response is local, we already have the lock */
+            RM_REQ_LOCK(thrd_ctrl);
+        }
+        server_read_req_t* rdreq = NULL;
+        if ((req_id >= 0) && (req_id < UNIFYFS_SERVER_MAX_READS)) {
+            rdreq = get_read_req(thrd_ctrl, req_id);
+        }
+        for (int i = 0; (NULL != rdreq) && (i < rdreq->num_server_reads);
+             i++) {
+            if (rdreq->remote_reads[i].rank == src_rank) {
+                server_chunks = rdreq->remote_reads + i;
+                break;
+            }
         }
-    }
 
-    if (NULL != server_chunks) {
-        LOGDBG("posting chunk responses for req %d from server %d",
-               req_id, src_rank);
-        server_chunks->resp = (chunk_read_resp_t*)resp_buf;
-        if (server_chunks->num_chunks != num_chks) {
-            LOGERR("mismatch on request vs. response chunks");
-            server_chunks->num_chunks = num_chks;
+        if ((NULL != server_chunks) && (NULL != server_chunks->resp)) {
+            /* a previous response segment has not been handled yet,
+             * wait for the request manager to consume it. waiting on
+             * the condition variable yields this ULT, so other rpc
+             * handlers keep running on the execution stream */
+            assert(src_rank != glb_pmi_rank);
+            signal_new_work(thrd_ctrl);
+            ABT_cond_wait(thrd_ctrl->resp_cond, thrd_ctrl->reqs_sync);
+            RM_REQ_UNLOCK(thrd_ctrl);
+            continue;
         }
-        server_chunks->total_sz = bulk_sz;
-        rc = (int)UNIFYFS_SUCCESS;
-    } else {
-        LOGERR("failed to find matching chunk-reads request");
-        rc = (int)UNIFYFS_FAILURE;
-    }
-    if (src_rank != glb_pmi_rank) {
-        RM_REQ_UNLOCK(thrd_ctrl);
+
+        if (NULL != server_chunks) {
+            LOGDBG("posting chunk responses for req %d from server %d",
+                   req_id, src_rank);
+            server_chunks->resp = (chunk_read_resp_t*)resp_buf;
+            if ((num_segs == 1) && (server_chunks->num_chunks != num_chks)) {
+                LOGERR("mismatch on request vs. response chunks");
+            }
+            server_chunks->resp_chunks = num_chks;
+            /* a responder that fails part way through sends a final
+             * error segment that declares a reduced segment count */
+            server_chunks->num_segments = num_segs;
+            server_chunks->total_sz = bulk_sz;
+            rc = (int)UNIFYFS_SUCCESS;
+        } else {
+            LOGERR("failed to find matching chunk-reads request");
+            rc = (int)UNIFYFS_FAILURE;
+        }
+        if (src_rank != glb_pmi_rank) {
+            RM_REQ_UNLOCK(thrd_ctrl);
+        }
+        break;
     }
 
-    /* inform the request manager thread we added responses */
-    signal_new_responses(thrd_ctrl);
+    /* inform the request manager we added responses */
+    signal_new_work(thrd_ctrl);
 
     return rc;
 }
@@ -641,7 +1016,7 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
                                    server_read_req_t* rdreq,
                                    server_chunk_reads_t* server_chunks)
 {
-    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
+    // NOTE: this fn assumes the calling pool thread is servicing thrd_ctrl
 
     int i, num_chks, rc;
     int ret = (int)UNIFYFS_SUCCESS;
@@ -653,7 +1028,7 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
            (NULL != server_chunks) &&
            (NULL != server_chunks->resp));
 
-    num_chks = server_chunks->num_chunks;
+    num_chks = server_chunks->resp_chunks;
     if (server_chunks->status != READREQ_STARTED) {
         LOGERR("chunk read response for non-started req @ index=%d",
                rdreq->req_ndx);
@@ -662,6 +1037,14 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
         LOGERR("empty chunk read response from server %d",
                server_chunks->rank);
         ret = (int32_t)EINVAL;
+    }
+    if (ret != UNIFYFS_SUCCESS) {
+        /* drop the bad response so a later one can be posted */
+        RM_REQ_LOCK(thrd_ctrl);
+        free((void*)server_chunks->resp);
+        server_chunks->resp = NULL;
+        ABT_cond_broadcast(thrd_ctrl->resp_cond);
+        RM_REQ_UNLOCK(thrd_ctrl);
     } else {
         LOGDBG("handling chunk read responses from server %d: "
                "num_chunks=%d buf_size=%zu",
@@ -682,40 +1065,24 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
             data_buf += processed;
         }
 
-        /* cleanup */
+        /* cleanup, which also lets the next response segment be posted */
+        RM_REQ_LOCK(thrd_ctrl);
         free((void*)responses);
         server_chunks->resp = NULL;
+        server_chunks->segments_done++;
+        ABT_cond_broadcast(thrd_ctrl->resp_cond);
+        RM_REQ_UNLOCK(thrd_ctrl);
 
-        /* update request status */
+        /* update request status once all response segments are handled */
+        if (server_chunks->segments_done < server_chunks->num_segments) {
+            return ret;
+        }
         server_chunks->status = READREQ_COMPLETE;
 
-        /* if all remote reads are complete, mark the request as complete */
-        int completed_remote_reads = 0;
-        for (i = 0; i < rdreq->num_server_reads; i++) {
-            if (rdreq->remote_reads[i].status != READREQ_COMPLETE) {
-                break;
-            }
-            completed_remote_reads++;
-        }
-        if (completed_remote_reads == rdreq->num_server_reads) {
-            rdreq->status = READREQ_COMPLETE;
-
-            int app_id = rdreq->app_id;
-            int client_id = rdreq->client_id;
-            int mread_id = rdreq->client_mread;
-            int read_ndx = rdreq->client_read_ndx;
-            int errcode = 0;
-            if (ret != UNIFYFS_SUCCESS) {
-                errcode = ret;
-            }
-            rc = invoke_client_mread_req_complete_rpc(app_id, client_id,
-                                                      mread_id, read_ndx,
-                                                      errcode);
-            if (rc != UNIFYFS_SUCCESS) {
-                LOGERR("mread[%d] request %d completion rpc failed (rc=%d)",
-                       mread_id, read_ndx, rc);
-                ret = rc;
-            }
+        /* notify client if all remote reads are complete */
+        rc = rm_check_read_req_complete(rdreq, ret);
+        if (rc != UNIFYFS_SUCCESS) {
+            ret = rc;
         }
     }
 
@@ -745,7 +1112,7 @@ int rm_submit_client_callback_request(client_callback_req* req)
     arraylist_add(reqmgr->client_callbacks, req);
     RM_REQ_UNLOCK(reqmgr);
 
-    signal_new_requests(reqmgr);
+    signal_new_work(reqmgr);
 
     return UNIFYFS_SUCCESS;
 }
@@ -919,11 +1286,12 @@ int rm_submit_client_rpc_request(unifyfs_fops_ctx_t* ctx,
     /* get thread control structure */
     reqmgr_thrd_t* reqmgr = client->reqmgr;
     assert(NULL != reqmgr);
+    req->submit_time = rpc_stats_now();
     RM_REQ_LOCK(reqmgr);
     arraylist_add(reqmgr->client_reqs, req);
     RM_REQ_UNLOCK(reqmgr);
 
-    signal_new_requests(reqmgr);
+    signal_new_work(reqmgr);
 
     return UNIFYFS_SUCCESS;
 }
@@ -1109,6 +1477,18 @@ static int process_metaget_rpc(reqmgr_thrd_t* reqmgr,
     ret = unifyfs_fops_metaget(&ctx, gfid, &fattr);
     if (ret != UNIFYFS_SUCCESS) {
         LOGDBG("unifyfs_fops_metaget() failed");
+    } else {
+        /* the client may cache these attributes, so make sure it is
+         * told when the file is unlinked. If the inode is already gone,
+         * the file was unlinked after we read its attributes */
+        int rc = unifyfs_inode_add_attr_client(gfid, ctx.app_id,
+                                               ctx.client_id);
+        if (ENOENT == rc) {
+            ret = ENOENT;
+        } else if (rc != UNIFYFS_SUCCESS) {
+            LOGWARN("failed to track attribute client[%d:%d] of gfid=%d",
+                    ctx.app_id, ctx.client_id, gfid);
+        }
     }
 
     /* send rpc response */
@@ -1524,6 +1904,12 @@ static int rm_process_client_requests(reqmgr_thrd_t* reqmgr)
         int rret;
         client_rpc_req_t* req = (client_rpc_req_t*)
             arraylist_get(client_reqs, i);
+
+        /* the handler may hand off or free the request */
+        client_rpc_e req_type = req->req_type;
+        uint64_t submit_time = req->submit_time;
+        uint64_t start_time = rpc_stats_now();
+
         switch (req->req_type) {
         case UNIFYFS_CLIENT_RPC_ATTACH:
             rret = process_attach_rpc(reqmgr, req);
@@ -1569,6 +1955,8 @@ static int rm_process_client_requests(reqmgr_thrd_t* reqmgr)
             rret = UNIFYFS_ERROR_NYI;
             break;
         }
+        rpc_stats_record_client(req_type, submit_time, start_time,
+                                rpc_stats_now());
         if (rret != UNIFYFS_SUCCESS) {
             if ((rret != ENOENT) && (rret != EEXIST)) {
                 LOGERR("client rpc request %d failed (%s)",
@@ -1589,9 +1977,6 @@ static int rm_process_client_requests(reqmgr_thrd_t* reqmgr)
 
 static int rm_heartbeat(reqmgr_thrd_t* reqmgr)
 {
-    static time_t last_check; // = 0
-    static int check_interval = 30; /* seconds */
-
     int ret = UNIFYFS_SUCCESS;
 
     if (!reqmgr->attached) {
@@ -1600,13 +1985,13 @@ static int rm_heartbeat(reqmgr_thrd_t* reqmgr)
 
     /* send a heartbeat rpc to associated client every 30 seconds */
     time_t now = time(NULL);
-    if (0 == last_check) {
-        last_check = now;
+    if (0 == reqmgr->last_heartbeat) {
+        reqmgr->last_heartbeat = now;
     }
 
-    time_t elapsed = now - last_check;
-    if (elapsed >= check_interval) {
-        last_check = now;
+    time_t elapsed = now - reqmgr->last_heartbeat;
+    if (elapsed >= RM_HEARTBEAT_SECS) {
+        reqmgr->last_heartbeat = now;
 
         /* invoke heartbeat rpc */
         LOGDBG("sending heartbeat rpc");
@@ -1623,94 +2008,104 @@ static int rm_heartbeat(reqmgr_thrd_t* reqmgr)
     return ret;
 }
 
-/* Entry point for request manager thread. One thread is created
- * for each client process to retrieve remote data and notify the
- * client when data is ready.
+/* handle all pending work for a single client
  *
- * @param arg: pointer to RM thread control structure
- * @return NULL */
-void* request_manager_thread(void* arg)
+ * @param thrd_ctrl : client request manager state
+ */
+static void rm_service_client(reqmgr_thrd_t* thrd_ctrl)
 {
-    /* get pointer to our thread control structure */
-    reqmgr_thrd_t* thrd_ctrl = (reqmgr_thrd_t*) arg;
-    int appid = thrd_ctrl->app_id;
-    int clid  = thrd_ctrl->client_id;
-
-    thrd_ctrl->tid = unifyfs_gettid();
-    LOGINFO("I am request manager [app=%d:client=%d] thread!", appid, clid);
-
-    /* loop forever to handle read requests from the client,
-     * new requests are added to a list on a shared data structure
-     * with main thread, new items inserted by the rpc handler */
     int rc;
-    while (1) {
-        /* process any client callback requests */
-        rc = rm_process_client_callbacks(thrd_ctrl);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGWARN("failed to process client rpc requests");
-        }
 
-        /* process any client requests */
-        rc = rm_process_client_requests(thrd_ctrl);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGWARN("failed to process client rpc requests");
-        }
+    /* process any client callback requests */
+    rc = rm_process_client_callbacks(thrd_ctrl);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGWARN("failed to process client rpc requests");
+    }
 
-         /* send chunk read requests to remote servers */
-        rc = rm_request_remote_chunks(thrd_ctrl);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGWARN("failed to request remote chunks");
-        }
+    /* process any client requests */
+    rc = rm_process_client_requests(thrd_ctrl);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGWARN("failed to process client rpc requests");
+    }
 
-        /* process any chunk read responses */
-        rc = rm_process_remote_chunk_responses(thrd_ctrl);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGWARN("failed to process remote chunk responses");
-        }
+    /* send chunk read requests to remote servers */
+    rc = rm_request_remote_chunks(thrd_ctrl);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGWARN("failed to request remote chunks");
+    }
 
-        /* grab lock */
-        RM_LOCK(thrd_ctrl);
+    /* process any chunk read responses */
+    rc = rm_process_remote_chunk_responses(thrd_ctrl);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGWARN("failed to process remote chunk responses");
+    }
 
-        /* set flag to indicate that we're waiting for work */
-        thrd_ctrl->waiting_for_work = 1;
+    rc = rm_heartbeat(thrd_ctrl);
+    if (rc != UNIFYFS_SUCCESS) {
+        /* detected failure of our client, stop servicing it */
+        pthread_mutex_lock(&rm_pool.lock);
+        thrd_ctrl->exit_flag = 1;
+        pthread_mutex_unlock(&rm_pool.lock);
+    }
+}
 
-        /* release lock and wait to be signaled by dispatcher */
-        //LOGDBG("RM[%d:%d] waiting for work", appid, clid);
-        struct timespec timeout;
-        clock_gettime(CLOCK_REALTIME, &timeout);
-        timeout.tv_nsec += 10000000; /* 10 ms */
-        if (timeout.tv_nsec >= 1000000000) {
-            timeout.tv_nsec -= 1000000000;
-            timeout.tv_sec++;
-        }
-        int wait_rc = pthread_cond_timedwait(&thrd_ctrl->thrd_cond,
-                                             &thrd_ctrl->thrd_lock,
-                                             &timeout);
-        if (0 == wait_rc) {
-            LOGDBG("RM[%d:%d] got work", appid, clid);
-        } else if (ETIMEDOUT != wait_rc) {
-            LOGERR("RM[%d:%d] work condition wait failed (rc=%d)",
-                   appid, clid, wait_rc);
+/* Entry point for request manager pool threads. Each thread takes
+ * clients with pending work off the pool work queue to retrieve remote
+ * data, notify the client when data is ready, and service its rpc
+ * requests.
+ *
+ * @param arg: unused
+ * @return NULL */
+static void* request_manager_thread(void* arg)
+{
+    pid_t tid = unifyfs_gettid();
+    LOGINFO("I am request manager pool thread %d!", (int)tid);
+
+    pthread_mutex_lock(&rm_pool.lock);
+    while (!rm_pool.exit_flag) {
+        reqmgr_thrd_t* thrd_ctrl = pool_dequeue();
+        if (NULL == thrd_ctrl) {
+            /* wait to be signaled by dispatcher */
+            struct timespec timeout;
+            clock_gettime(CLOCK_REALTIME, &timeout);
+            timeout.tv_nsec += RM_POOL_POLL_USECS * 1000;
+            if (timeout.tv_nsec >= 1000000000) {
+                timeout.tv_nsec -= 1000000000;
+                timeout.tv_sec++;
+            }
+            int wait_rc = pthread_cond_timedwait(&rm_pool.work_cond,
+                                                 &rm_pool.lock,
+                                                 &timeout);
+            if (ETIMEDOUT == wait_rc) {
+                /* pick up clients with outstanding reads or heartbeats */
+                pool_queue_periodic();
+            } else if (0 != wait_rc) {
+                LOGERR("RM pool work condition wait failed (rc=%d)",
+                       wait_rc);
+            }
+            continue;
         }
 
-        /* set flag to indicate we're no longer waiting */
-        thrd_ctrl->waiting_for_work = 0;
-        RM_UNLOCK(thrd_ctrl);
+        /* mark client as being serviced by this thread */
+        thrd_ctrl->tid = tid;
+        thrd_ctrl->has_work = 0;
+        int exiting = thrd_ctrl->exit_flag;
+        pthread_mutex_unlock(&rm_pool.lock);
 
-        rc = rm_heartbeat(thrd_ctrl);
-        if (rc != UNIFYFS_SUCCESS) {
-            /* detected failure of our client, time to exit */
-            thrd_ctrl->exit_flag = 1;
+        if (!exiting) {
+            rm_service_client(thrd_ctrl);
         }
 
-        /* bail out if we've been told to exit */
-        if (thrd_ctrl->exit_flag) {
-            break;
+        pthread_mutex_lock(&rm_pool.lock);
+        thrd_ctrl->tid = 0;
+        if (thrd_ctrl->has_work) {
+            /* new work arrived while servicing, requeue at tail */
+            pool_enqueue(thrd_ctrl);
         }
+        pthread_cond_broadcast(&rm_pool.idle_cond);
     }
+    pthread_mutex_unlock(&rm_pool.lock);
 
-    LOGDBG("RM[%d:%d] thread exiting", appid, clid);
-    thrd_ctrl->exited = 1;
+    LOGDBG("RM pool thread %d exiting", (int)tid);
     return NULL;
 }
-
@@ -55,32 +55,28 @@ typedef struct {
     unifyfs_extent_t extent;   /* the requested extent */
 } server_read_req_t;
 
-/* Request manager state structure - created by main thread for each request
- * manager thread. Contains shared data structures for client-server and
- * server-server requests and associated synchronization constructs */
+/* number of server read requests allocated together as a block */
+#define RM_READ_REQ_BLOCK_SZ 64
+#define RM_READ_REQ_BLOCKS (UNIFYFS_SERVER_MAX_READS / RM_READ_REQ_BLOCK_SZ)
+
+/* Request manager state structure - created by main thread for each
+ * application client. Contains shared data structures for client-server and
+ * server-server requests and associated synchronization constructs. The
+ * request manager state for all clients is serviced by a shared pool of
+ * request manager threads. */
 typedef struct reqmgr_thrd {
-    /* request manager (RM) thread */
-    pthread_t thrd;
-    pid_t tid;
-
-    /* condition variable to synchronize request manager thread
-     * and margo rpc handler ULT delivering work */
-    pthread_cond_t thrd_cond;
-
-    /* lock for shared data structures (variables below) */
-    pthread_mutex_t thrd_lock;
-
-    /* flag indicating request manager thread is waiting on thrd_cond CV */
-    int waiting_for_work;
-
     /* argobots mutex for synchronizing access to request state between
-     * margo rpc handler ULTs and request manager thread */
+     * margo rpc handler ULTs and request manager threads */
     ABT_mutex reqs_sync;
 
-    /* array of server read requests */
+    /* argobots condition variable, used with reqs_sync, signaled when
+     * a posted chunk read response segment has been consumed */
+    ABT_cond resp_cond;
+
+    /* array of server read requests, allocated in blocks on demand */
     int num_read_reqs;
     int next_rdreq_ndx;
-    server_read_req_t read_reqs[UNIFYFS_SERVER_MAX_READS];
+    server_read_req_t* read_req_blocks[RM_READ_REQ_BLOCKS];
 
     /* list of client rpc requests */
     arraylist_t* client_reqs;
@@ -91,36 +87,50 @@ typedef struct reqmgr_thrd {
     /* flag set when client has fully attached */
     int attached;
 
-    /* flag set to indicate request manager thread should exit */
+    /* flag set to indicate request manager should stop servicing client */
     int exit_flag;
 
-    /* flag set after thread has exited and join completed */
+    /* flag set after request manager has stopped servicing client */
     int exited;
 
-    /* app_id this thread is serving */
+    /* app_id this request manager is serving */
     int app_id;
 
-    /* client_id this thread is serving */
+    /* client_id this request manager is serving */
     int client_id;
+
+    /* time of last heartbeat rpc to client */
+    time_t last_heartbeat;
+
+    /* thread pool scheduling state, protected by the pool lock */
+    int queued;                     /* on the pool work queue? */
+    int has_work;                   /* new work arrived since last service */
+    pid_t tid;                      /* tid of servicing thread, or 0 */
+    struct reqmgr_thrd* next_queued; /* next on the pool work queue */
+    struct reqmgr_thrd* next_client; /* next on the pool client list */
 } reqmgr_thrd_t;
 
+/* start the pool of request manager threads */
+int rm_pool_init(int num_threads);
+
+/* stop the pool of request manager threads */
+int rm_pool_fini(void);
+
 /* reserve/release read requests */
 server_read_req_t* rm_reserve_read_req(reqmgr_thrd_t* thrd_ctrl);
 int rm_release_read_req(reqmgr_thrd_t* thrd_ctrl,
                         server_read_req_t* rdreq);
 
-/* create Request Manager thread for application client */
+/* create Request Manager state for application client, and register it
+ * with the request manager thread pool */
 reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id,
                                       int client_id);
 
-/* cleanup Request Manager thread state */
+/* cleanup Request Manager state */
 int unifyfs_rm_thrd_cleanup(reqmgr_thrd_t* thrd_ctrl);
 
-/* Request Manager pthread main */
-void* request_manager_thread(void* arg);
-
 /* function called by main thread to instruct
- * Request Manager thread to exit */
+ * Request Manager thread pool to stop servicing client */
 int rm_request_exit(reqmgr_thrd_t* thrd_ctrl);
 
 /* update state for remote chunk reads with received response data */
@@ -129,6 +139,7 @@ int rm_post_chunk_read_responses(int app_id,
                                  int src_rank,
                                  int req_id,
                                  int num_chks,
+                                 int num_segs,
                                  size_t bulk_sz,
                                  char* resp_buf);
 
@@ -138,7 +149,7 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
                                    server_chunk_reads_t* del_reads);
 
 /**
- * @brief hand over a read request to the request manager thread.
+ * @brief hand over a read request to the request manager.
  *
  * @param req all members except for status and req_ndx need to be filled by
  * the caller. @req->chunks and @req->remote_reads should be allocated from
@@ -149,7 +160,7 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
 int rm_submit_read_request(server_read_req_t* req);
 
 /**
- * @brief submit a client callback request to the request manager thread.
+ * @brief submit a client callback request to the request manager.
  *
  * @param req   pointer to client callback request struct
  *
@@ -158,7 +169,7 @@ int rm_submit_read_request(server_read_req_t* req);
 int rm_submit_client_callback_request(client_callback_req* req);
 
 /**
- * @brief submit a client rpc request to the request manager thread.
+ * @brief submit a client rpc request to the request manager.
  *
  * @param ctx   application client context
  * @param req   pointer to client rpc request struct
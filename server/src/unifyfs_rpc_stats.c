@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "unifyfs_global.h"
+#include "unifyfs_rpc_stats.h"
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[UNIFYFS_RPC_STATS_BUCKETS];
+} latency_hist;
+
+typedef struct {
+    latency_hist queue;   /* submission until processing starts */
+    latency_hist handler; /* processing time */
+} rpc_stats;
+
+static rpc_stats client_stats[UNIFYFS_CLIENT_RPC_TYPE_COUNT];
+static rpc_stats server_stats[UNIFYFS_SERVER_RPC_TYPE_COUNT];
+
+static const char* client_rpc_names[UNIFYFS_CLIENT_RPC_TYPE_COUNT] = {
+    [UNIFYFS_CLIENT_RPC_ATTACH]    = "attach",
+    [UNIFYFS_CLIENT_RPC_FILESIZE]  = "filesize",
+    [UNIFYFS_CLIENT_RPC_GET_GFIDS] = "get_gfids",
+    [UNIFYFS_CLIENT_RPC_LAMINATE]  = "laminate",
+    [UNIFYFS_CLIENT_RPC_METAGET]   = "metaget",
+    [UNIFYFS_CLIENT_RPC_METASET]   = "metaset",
+    [UNIFYFS_CLIENT_RPC_MOUNT]     = "mount",
+    [UNIFYFS_CLIENT_RPC_READ]      = "read",
+    [UNIFYFS_CLIENT_RPC_SYNC]      = "sync",
+    [UNIFYFS_CLIENT_RPC_TRANSFER]  = "transfer",
+    [UNIFYFS_CLIENT_RPC_TRUNCATE]  = "truncate",
+    [UNIFYFS_CLIENT_RPC_UNLINK]    = "unlink",
+    [UNIFYFS_CLIENT_RPC_UNMOUNT]   = "unmount",
+    [UNIFYFS_CLIENT_RPC_NODE_LOCAL_EXTENTS_GET] = "node_local_extents_get"
+};
+
+static const char* server_rpc_names[UNIFYFS_SERVER_RPC_TYPE_COUNT] = {
+    [UNIFYFS_SERVER_RPC_CHUNK_READ]     = "chunk_read",
+    [UNIFYFS_SERVER_RPC_EXTENTS_ADD]    = "extents_add",
+    [UNIFYFS_SERVER_RPC_EXTENTS_FIND]   = "extents_find",
+    [UNIFYFS_SERVER_RPC_FILESIZE]       = "filesize",
+    [UNIFYFS_SERVER_RPC_LAMINATE]       = "laminate",
+    [UNIFYFS_SERVER_RPC_METAGET]        = "metaget",
+    [UNIFYFS_SERVER_RPC_METASET]        = "metaset",
+    [UNIFYFS_SERVER_RPC_PID_REPORT]     = "pid_report",
+    [UNIFYFS_SERVER_RPC_TRANSFER]       = "transfer",
+    [UNIFYFS_SERVER_RPC_TRUNCATE]       = "truncate",
+    [UNIFYFS_SERVER_BCAST_RPC_EXTENTS]  = "bcast_extents",
+    [UNIFYFS_SERVER_BCAST_RPC_FILEATTR] = "bcast_fileattr",
+    [UNIFYFS_SERVER_BCAST_RPC_LAMINATE] = "bcast_laminate",
+    [UNIFYFS_SERVER_BCAST_RPC_METAGET]  = "bcast_metaget",
+    [UNIFYFS_SERVER_BCAST_RPC_TRANSFER] = "bcast_transfer",
+    [UNIFYFS_SERVER_BCAST_RPC_TRUNCATE] = "bcast_truncate",
+    [UNIFYFS_SERVER_BCAST_RPC_UNLINK]   = "bcast_unlink"
+};
+
+uint64_t rpc_stats_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void hist_add(latency_hist* hist, uint64_t ns)
+{
+    /* bucket is the bit width of the latency in microseconds */
+    uint64_t usec = ns / 1000;
+    int bucket = 0;
+    if (usec) {
+        bucket = 64 - __builtin_clzll(usec);
+        if (bucket >= UNIFYFS_RPC_STATS_BUCKETS) {
+            bucket = UNIFYFS_RPC_STATS_BUCKETS - 1;
+        }
+    }
+
+    __atomic_fetch_add(&(hist->count), 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&(hist->total_ns), ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&(hist->buckets[bucket]), 1, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&(hist->max_ns), __ATOMIC_RELAXED);
+    while ((ns > max) &&
+           !__atomic_compare_exchange_n(&(hist->max_ns), &max, ns, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        /* max was reloaded, try again */
+    }
+}
+
+static void stats_add(rpc_stats* stats,
+                      uint64_t submit_ns,
+                      uint64_t start_ns,
+                      uint64_t end_ns)
+{
+    /* requests submitted before the clock was read have no queue time */
+    uint64_t queued = (submit_ns && (start_ns > submit_ns)) ?
+                      (start_ns - submit_ns) : 0;
+    uint64_t handled = (end_ns > start_ns) ? (end_ns - start_ns) : 0;
+    hist_add(&(stats->queue), queued);
+    hist_add(&(stats->handler), handled);
+}
+
+void rpc_stats_record_client(client_rpc_e rpc,
+                             uint64_t submit_ns,
+                             uint64_t start_ns,
+                             uint64_t end_ns)
+{
+    if ((rpc > UNIFYFS_CLIENT_RPC_INVALID) &&
+        (rpc < UNIFYFS_CLIENT_RPC_TYPE_COUNT)) {
+        stats_add(client_stats + rpc, submit_ns, start_ns, end_ns);
+    }
+}
+
+void rpc_stats_record_server(server_rpc_e rpc,
+                             uint64_t submit_ns,
+                             uint64_t start_ns,
+                             uint64_t end_ns)
+{
+    if ((rpc > UNIFYFS_SERVER_RPC_INVALID) &&
+        (rpc < UNIFYFS_SERVER_RPC_TYPE_COUNT)) {
+        stats_add(server_stats + rpc, submit_ns, start_ns, end_ns);
+    }
+}
+
+/* take a snapshot of the histogram */
+static void hist_snapshot(latency_hist* hist, latency_hist* snap)
+{
+    snap->count    = __atomic_load_n(&(hist->count), __ATOMIC_RELAXED);
+    snap->total_ns = __atomic_load_n(&(hist->total_ns), __ATOMIC_RELAXED);
+    snap->max_ns   = __atomic_load_n(&(hist->max_ns), __ATOMIC_RELAXED);
+    for (int i = 0; i < UNIFYFS_RPC_STATS_BUCKETS; i++) {
+        snap->buckets[i] = __atomic_load_n(&(hist->buckets[i]),
+                                           __ATOMIC_RELAXED);
+    }
+}
+
+/* remove the latencies in the snapshot from the histogram, keeping any
+ * recorded since the snapshot was taken */
+static void hist_reset(latency_hist* hist, latency_hist* snap)
+{
+    __atomic_fetch_sub(&(hist->count), snap->count, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&(hist->total_ns), snap->total_ns, __ATOMIC_RELAXED);
+    for (int i = 0; i < UNIFYFS_RPC_STATS_BUCKETS; i++) {
+        __atomic_fetch_sub(&(hist->buckets[i]), snap->buckets[i],
+                           __ATOMIC_RELAXED);
+    }
+
+    /* clear the max unless a larger latency was recorded since */
+    uint64_t max = snap->max_ns;
+    __atomic_compare_exchange_n(&(hist->max_ns), &max, 0, 0,
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/* upper bound in microseconds of the bucket holding the given percentile */
+static uint64_t hist_percentile(latency_hist* hist, int pct)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < UNIFYFS_RPC_STATS_BUCKETS; i++) {
+        total += hist->buckets[i];
+    }
+    if (0 == total) {
+        return 0;
+    }
+
+    uint64_t target = ((total * pct) + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < UNIFYFS_RPC_STATS_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= target) {
+            return (1ULL << i);
+        }
+    }
+    return (1ULL << (UNIFYFS_RPC_STATS_BUCKETS - 1));
+}
+
+/* append formatted text to the report buffer, growing it as needed */
+static int report_append(char** buf, size_t* len, size_t* cap,
+                         const char* fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static int report_append(char** buf, size_t* len, size_t* cap,
+                         const char* fmt, ...)
+{
+    va_list args;
+    while (1) {
+        size_t avail = *cap - *len;
+        va_start(args, fmt);
+        int n = vsnprintf(*buf + *len, avail, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            return EINVAL;
+        }
+        if ((size_t)n < avail) {
+            *len += (size_t)n;
+            return UNIFYFS_SUCCESS;
+        }
+        size_t new_cap = (*cap * 2) + (size_t)n;
+        char* new_buf = realloc(*buf, new_cap);
+        if (NULL == new_buf) {
+            return ENOMEM;
+        }
+        *buf = new_buf;
+        *cap = new_cap;
+    }
+}
+
+static int report_hist(char** buf, size_t* len, size_t* cap,
+                       const char* label, latency_hist* hist)
+{
+    double mean = (double)hist->total_ns / (double)hist->count / 1000.0;
+    int rc = report_append(buf, len, cap,
+        "    %-7s usec: mean=%.1f p50<%" PRIu64 " p99<%" PRIu64
+        " max=%.1f\n      buckets:",
+        label, mean, hist_percentile(hist, 50), hist_percentile(hist, 99),
+        (double)hist->max_ns / 1000.0);
+    for (int i = 0; (rc == UNIFYFS_SUCCESS) &&
+                    (i < UNIFYFS_RPC_STATS_BUCKETS); i++) {
+        if (hist->buckets[i]) {
+            rc = report_append(buf, len, cap, " <%llu:%" PRIu64,
+                               (1ULL << i), hist->buckets[i]);
+        }
+    }
+    if (rc == UNIFYFS_SUCCESS) {
+        rc = report_append(buf, len, cap, "\n");
+    }
+    return rc;
+}
+
+static void snapshot_rpcs(rpc_stats* stats, rpc_stats* snaps, int n_types)
+{
+    for (int i = 1; i < n_types; i++) {
+        hist_snapshot(&(stats[i].queue), &(snaps[i].queue));
+        hist_snapshot(&(stats[i].handler), &(snaps[i].handler));
+    }
+}
+
+static void reset_rpcs(rpc_stats* stats, rpc_stats* snaps, int n_types)
+{
+    for (int i = 1; i < n_types; i++) {
+        hist_reset(&(stats[i].queue), &(snaps[i].queue));
+        hist_reset(&(stats[i].handler), &(snaps[i].handler));
+    }
+}
+
+static int report_rpcs(char** buf, size_t* len, size_t* cap,
+                       const char* kind, rpc_stats* snaps,
+                       const char** names, int n_types)
+{
+    int rc = UNIFYFS_SUCCESS;
+    for (int i = 1; (rc == UNIFYFS_SUCCESS) && (i < n_types); i++) {
+        rpc_stats* snap = snaps + i;
+        if (0 == snap->handler.count) {
+            continue;
+        }
+        rc = report_append(buf, len, cap, "  %s %s: count=%" PRIu64 "\n",
+                           kind, (NULL != names[i]) ? names[i] : "?",
+                           snap->handler.count);
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = report_hist(buf, len, cap, "queue", &(snap->queue));
+        }
+        if (rc == UNIFYFS_SUCCESS) {
+            rc = report_hist(buf, len, cap, "handler", &(snap->handler));
+        }
+    }
+    return rc;
+}
+
+int rpc_stats_report(int reset, size_t max_size, char** report)
+{
+    size_t len = 0;
+    size_t cap = 4096;
+    char* buf = malloc(cap);
+    if (NULL == buf) {
+        return ENOMEM;
+    }
+    buf[0] = '\0';
+
+    /* snapshots are large, so keep them off the (small) ULT stack */
+    rpc_stats* client_snaps = calloc(UNIFYFS_CLIENT_RPC_TYPE_COUNT,
+                                     sizeof(rpc_stats));
+    rpc_stats* server_snaps = calloc(UNIFYFS_SERVER_RPC_TYPE_COUNT,
+                                     sizeof(rpc_stats));
+    if ((NULL == client_snaps) || (NULL == server_snaps)) {
+        free(client_snaps);
+        free(server_snaps);
+        free(buf);
+        return ENOMEM;
+    }
+    snapshot_rpcs(client_stats, client_snaps, UNIFYFS_CLIENT_RPC_TYPE_COUNT);
+    snapshot_rpcs(server_stats, server_snaps, UNIFYFS_SERVER_RPC_TYPE_COUNT);
+
+    int rc = report_append(&buf, &len, &cap,
+                           "server %d (%s) rpc statistics\n",
+                           glb_pmi_rank, glb_host);
+    if (rc == UNIFYFS_SUCCESS) {
+        rc = report_rpcs(&buf, &len, &cap, "client", client_snaps,
+                         client_rpc_names, UNIFYFS_CLIENT_RPC_TYPE_COUNT);
+    }
+    if (rc == UNIFYFS_SUCCESS) {
+        rc = report_rpcs(&buf, &len, &cap, "server", server_snaps,
+                         server_rpc_names, UNIFYFS_SERVER_RPC_TYPE_COUNT);
+    }
+
+    /* only reset what is actually delivered, so a truncated report
+     * does not lose statistics */
+    if ((rc == UNIFYFS_SUCCESS) && reset && ((len + 1) <= max_size)) {
+        reset_rpcs(client_stats, client_snaps, UNIFYFS_CLIENT_RPC_TYPE_COUNT);
+        reset_rpcs(server_stats, server_snaps, UNIFYFS_SERVER_RPC_TYPE_COUNT);
+    }
+    free(client_snaps);
+    free(server_snaps);
+
+    if (rc != UNIFYFS_SUCCESS) {
+        free(buf);
+        return rc;
+    }
+
+    *report = buf;
+    return UNIFYFS_SUCCESS;
+}
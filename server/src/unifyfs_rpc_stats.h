@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#ifndef UNIFYFS_RPC_STATS_H
+#define UNIFYFS_RPC_STATS_H
+
+#include <stdint.h>
+
+#include "unifyfs_client_rpcs.h"
+#include "unifyfs_server_rpcs.h"
+
+/*
+ * Per-RPC statistics for requests serviced by the request manager
+ * (client rpcs) and service manager (server rpcs). For each rpc type we
+ * keep a count and two latency histograms: the time a request waited in
+ * the manager's queue, and the time spent handling it. Histogram bucket
+ * i counts latencies below 2^i microseconds (the last bucket counts the
+ * rest). Updates are lock-free atomic adds.
+ */
+
+#define UNIFYFS_RPC_STATS_BUCKETS 24
+
+/* current time in nanoseconds, for request timestamps */
+uint64_t rpc_stats_now(void);
+
+/* record a client rpc that was submitted, started processing, and
+ * finished processing at the given times */
+void rpc_stats_record_client(client_rpc_e rpc,
+                             uint64_t submit_ns,
+                             uint64_t start_ns,
+                             uint64_t end_ns);
+
+/* record a server rpc that was submitted, started processing, and
+ * finished processing at the given times */
+void rpc_stats_record_server(server_rpc_e rpc,
+                             uint64_t submit_ns,
+                             uint64_t start_ns,
+                             uint64_t end_ns);
+
+/* format a text report of the statistics of all rpcs seen so far.
+ * If reset is set and the report (including its nul) fits in max_size
+ * bytes, the reported statistics are reset. The caller frees the report.
+ * Returns UNIFYFS_SUCCESS or ENOMEM */
+int rpc_stats_report(int reset, size_t max_size, char** report);
+
+#endif /* UNIFYFS_RPC_STATS_H */
@@ -39,7 +39,7 @@
 #include "unifyfs_global.h"
 #include "unifyfs_request_manager.h"
 #include "unifyfs_service_manager.h"
-#include "unifyfs_inode_tree.h"
+#include "unifyfs_inode.h"
 
 // margo rpcs
 #include "margo_server.h"
@@ -54,6 +54,13 @@ unifyfs_cfg_t server_cfg;
 
 bool use_server_local_extents; // = false
 
+bool use_server_direct_local_reads; // = false
+bool use_meta_range_owners; // = false
+
+size_t transfer_buffer_sz = UNIFYFS_SERVER_TRANSFER_BUF_SIZE;
+int transfer_writer_count = UNIFYFS_SERVER_TRANSFER_WRITERS;
+bool use_transfer_direct_io; // = false
+
 /* arraylist to track failed clients */
 arraylist_t* failed_clients; // = NULL
 
@@ -305,6 +312,14 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (server_cfg.log_async != NULL) {
+        bool enable = true;
+        rc = configurator_bool_val(server_cfg.log_async, &enable);
+        if (0 == rc) {
+            unifyfs_set_log_async((int)enable);
+        }
+    }
+
     if (server_cfg.log_on_error != NULL) {
         bool enable = false;
         rc = configurator_bool_val(server_cfg.log_on_error, &enable);
@@ -321,6 +336,53 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (server_cfg.server_direct_local_reads != NULL) {
+        bool enable = false;
+        rc = configurator_bool_val(server_cfg.server_direct_local_reads,
+                                   &enable);
+        if ((0 == rc) && enable) {
+            use_server_direct_local_reads = true;
+        }
+    }
+
+    if (server_cfg.meta_range_owners != NULL) {
+        bool enable = false;
+        rc = configurator_bool_val(server_cfg.meta_range_owners, &enable);
+        if ((0 == rc) && enable) {
+            use_meta_range_owners = true;
+        }
+    }
+
+    if (server_cfg.meta_range_size != NULL) {
+        rc = configurator_int_val(server_cfg.meta_range_size, &l);
+        if ((0 == rc) && (l > 0)) {
+            meta_slice_sz = (size_t) l;
+        }
+    }
+
+    if (server_cfg.server_transfer_buffer_size != NULL) {
+        rc = configurator_int_val(server_cfg.server_transfer_buffer_size, &l);
+        if ((0 == rc) && (l > 0)) {
+            transfer_buffer_sz = (size_t) l;
+        }
+    }
+
+    if (server_cfg.server_transfer_direct_io != NULL) {
+        bool enable = false;
+        rc = configurator_bool_val(server_cfg.server_transfer_direct_io,
+                                   &enable);
+        if ((0 == rc) && enable) {
+            use_transfer_direct_io = true;
+        }
+    }
+
+    if (server_cfg.server_transfer_writers != NULL) {
+        rc = configurator_int_val(server_cfg.server_transfer_writers, &l);
+        if ((0 == rc) && (l > 0)) {
+            transfer_writer_count = (int) l;
+        }
+    }
+
     // setup clean termination by signal
     memset(&sa, 0, sizeof(struct sigaction));
     sa.sa_handler = exit_request;
@@ -461,6 +523,22 @@ int main(int argc, char* argv[])
         exit(1);
     }
 
+    /* launch the request manager thread pool (note: must happen after
+     * ABT_init, since client request managers use ABT mutexes) */
+    int num_reqmgr_threads = UNIFYFS_SERVER_REQMGR_THREADS;
+    if (server_cfg.server_reqmgr_threads != NULL) {
+        rc = configurator_int_val(server_cfg.server_reqmgr_threads, &l);
+        if ((0 == rc) && (l > 0)) {
+            num_reqmgr_threads = (int) l;
+        }
+    }
+    LOGDBG("launching %d request manager threads", num_reqmgr_threads);
+    rc = rm_pool_init(num_reqmgr_threads);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        LOGERR("launch failed - %s", unifyfs_rc_enum_description(rc));
+        exit(1);
+    }
+
     LOGDBG("initializing file operations");
     rc = unifyfs_fops_init(&server_cfg);
     if (rc != 0) {
@@ -475,8 +553,12 @@ int main(int argc, char* argv[])
         exit(1);
     }
 
-    /* initialize our tree that maps a gfid to its extent tree */
-    unifyfs_inode_tree_init(global_inode_tree);
+    /* initialize our table that maps a gfid to its inode */
+    rc = unifyfs_inode_table_init();
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("%s", unifyfs_rc_enum_description(rc));
+        exit(1);
+    }
 
     LOGDBG("publishing server pid");
     rc = unifyfs_publish_server_pids();
@@ -500,12 +582,15 @@ int main(int argc, char* argv[])
         }
     }
 
-    /* tear down gfid-to-extents tree */
-    unifyfs_inode_tree_destroy(global_inode_tree);
+    /* tear down gfid-to-inode table */
+    unifyfs_inode_table_fini();
 
     LOGDBG("stopping service manager thread");
     rc = svcmgr_fini();
 
+    LOGDBG("stopping request manager threads");
+    rc = rm_pool_fini();
+
     return unifyfs_exit();
 }
 
@@ -34,8 +34,49 @@
 #include "unifyfs_service_manager.h"
 #include "unifyfs_server_rpcs.h"
 #include "unifyfs_transfer.h"
+#include "unifyfs_rpc_stats.h"
 #include "margo_server.h"
 
+/* Pending extent sync batching.
+ *
+ * A client sync adds its extents to the file's inode as pending, and the
+ * sync batching thread later adds all of the file's pending extents at once
+ * (forwarding them to the owner), so that syncs from many clients share a
+ * single owner update. A batch is flushed once it holds SYNC_BATCH_MAX_EXTENTS
+ * extents, or once its oldest sync has waited for the batch window. The
+ * window adapts to the sync arrival rate: it is twice the smoothed gap
+ * between arrivals, so bursts of syncs are coalesced while an isolated sync
+ * is processed right away. */
+#define SYNC_BATCH_MAX_EXTENTS 4096
+#define SYNC_BATCH_MAX_USEC    50000 /* 50 ms */
+
+typedef struct {
+    /* the sync batching thread */
+    pthread_t thrd;
+    int thrd_created;
+    volatile int time_to_exit;
+
+    /* pthread mutex and condition variable for sync notification,
+     * valid once initialized is set */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int initialized;
+
+    /* files with pending syncs in the current batch, in arrival order */
+    int* gfids;
+    size_t num_gfids;
+    size_t max_gfids;
+
+    /* number of extents pending in the current batch */
+    size_t num_extents;
+
+    /* arrival times (usec) of the batch's oldest sync and the latest sync,
+     * and the smoothed gap between sync arrivals */
+    uint64_t batch_start;
+    uint64_t last_arrival;
+    uint64_t avg_gap;
+} sync_batch_state_t;
+
 /* Service Manager (SM) state */
 typedef struct {
     /* the SM thread */
@@ -68,9 +109,14 @@ typedef struct {
     /* list of service requests (server_rpc_req_t*) */
     arraylist_t* svc_reqs;
 
+    /* pending extent sync batching state */
+    sync_batch_state_t sync_batch;
+
 } svcmgr_state_t;
 svcmgr_state_t* sm; // = NULL
 
+static void* sync_batch_thread(void* arg);
+
 #define SM_LOCK() \
 do { \
     if ((NULL != sm) && sm->initialized) { \
@@ -121,6 +167,7 @@ int sm_submit_service_request(server_rpc_req_t* req)
         return UNIFYFS_FAILURE;
     }
 
+    req->submit_time = rpc_stats_now();
     SM_REQ_LOCK();
     arraylist_add(sm->svc_reqs, req);
     SM_REQ_UNLOCK();
@@ -239,6 +286,32 @@ int svcmgr_init(void)
         return UNIFYFS_ERROR_THREAD;
     }
 
+    /* start the pending extent sync batching thread */
+    sync_batch_state_t* sb = &(sm->sync_batch);
+    rc = pthread_mutex_init(&(sb->lock), NULL);
+    if (rc != 0) {
+        LOGERR("pthread_mutex_init failed for sync batching rc=%d (%s)",
+               rc, strerror(rc));
+        svcmgr_fini();
+        return rc;
+    }
+    rc = pthread_cond_init(&(sb->cond), NULL);
+    if (rc != 0) {
+        LOGERR("pthread_cond_init failed for sync batching rc=%d (%s)",
+               rc, strerror(rc));
+        pthread_mutex_destroy(&(sb->lock));
+        svcmgr_fini();
+        return rc;
+    }
+    sb->initialized = 1;
+    rc = pthread_create(&(sb->thrd), NULL, sync_batch_thread, (void*)sb);
+    if (rc != 0) {
+        LOGERR("failed to create sync batching thread");
+        svcmgr_fini();
+        return UNIFYFS_ERROR_THREAD;
+    }
+    sb->thrd_created = 1;
+
     return UNIFYFS_SUCCESS;
 }
 
@@ -247,6 +320,26 @@ int svcmgr_fini(void)
 {
     if (NULL != sm) {
         if (sm->initialized) {
+            /* stop the sync batching thread, which flushes any pending
+             * syncs before exiting */
+            sync_batch_state_t* sb = &(sm->sync_batch);
+            if (sb->thrd_created) {
+                pthread_mutex_lock(&(sb->lock));
+                sb->time_to_exit = 1;
+                pthread_cond_signal(&(sb->cond));
+                pthread_mutex_unlock(&(sb->lock));
+                pthread_join(sb->thrd, NULL);
+                sb->thrd_created = 0;
+            }
+            if (sb->initialized) {
+                pthread_mutex_destroy(&(sb->lock));
+                pthread_cond_destroy(&(sb->cond));
+                sb->initialized = 0;
+            }
+            if (NULL != sb->gfids) {
+                free(sb->gfids);
+            }
+
             /* join thread before cleaning up state */
             if (sm->tid != -1) {
                 pthread_mutex_lock(&(sm->thrd_lock));
@@ -291,11 +384,65 @@ int svcmgr_fini(void)
     return UNIFYFS_SUCCESS;
 }
 
+/* Read data for (part of) a chunk read request from the client log
+ * holding the data, and record the result in the given read response.
+ *
+ * @param rreq       : chunk read request
+ * @param chk_offset : byte offset within the chunk to start reading
+ * @param nbytes     : number of bytes to read
+ * @param rresp      : [out] chunk read response
+ * @param buf        : [out] buffer to hold read data
+ */
+void sm_read_chunk_data(chunk_read_req_t* rreq,
+                        size_t chk_offset,
+                        size_t nbytes,
+                        chunk_read_resp_t* rresp,
+                        char* buf)
+{
+    /* record request metadata in response */
+    rresp->gfid    = rreq->gfid;
+    rresp->read_rc = 0;
+    rresp->nbytes  = nbytes;
+    rresp->offset  = rreq->offset + chk_offset;
+
+    /* read data from client log */
+    int app_id = rreq->log_app_id;
+    int cli_id = rreq->log_client_id;
+    app_client* app_clnt = get_app_client(app_id, cli_id);
+    if (NULL != app_clnt) {
+        logio_context* logio_ctx = app_clnt->state.logio_ctx;
+        if (NULL != logio_ctx) {
+            size_t nread = 0;
+            off_t log_offset = (off_t)(rreq->log_offset + chk_offset);
+            int rc = unifyfs_logio_read(logio_ctx, log_offset, nbytes,
+                                        buf, &nread);
+            if (UNIFYFS_SUCCESS == rc) {
+                rresp->read_rc = nread;
+            } else {
+                rresp->read_rc = (ssize_t)(-rc);
+            }
+        } else {
+            LOGERR("app client [%d:%d] has NULL logio context",
+                   app_id, cli_id);
+            rresp->read_rc = (ssize_t)(-EINVAL);
+        }
+    } else {
+        LOGERR("failed to get application client [%d:%d] state",
+               app_id, cli_id);
+        rresp->read_rc = (ssize_t)(-EINVAL);
+    }
+}
+
 /* Decode and issue chunk-reads received from request manager.
  * We get a list of read requests for data on our node.  Read
  * data for each request and construct a set of read replies
  * that will be sent back to the request manager.
  *
+ * For requests from remote servers, the data is not read here. Instead,
+ * the requests are queued for the service manager thread, which reads
+ * and sends the data in bounded-size segments
+ * (see invoke_chunk_read_response_rpc()).
+ *
  * @param src_rank      : source server rank
  * @param src_app_id    : app id at source server
  * @param src_client_id : client id at source server
@@ -315,6 +462,44 @@ int sm_issue_chunk_reads(int src_rank,
     /* get pointer to read request array */
     chunk_read_req_t* reqs = (chunk_read_req_t*)msg_buf;
 
+    if (src_rank != glb_pmi_rank) {
+        /* we need to send these read responses to another rank,
+         * add chunk_reads to svcmgr response list */
+        size_t reqs_sz = sizeof(chunk_read_req_t) * num_chks;
+        server_chunk_reads_t* scr = (server_chunk_reads_t*)
+            calloc(1, sizeof(server_chunk_reads_t) + reqs_sz);
+        if (NULL == scr) {
+            LOGERR("failed to allocate remote_chunk_reads");
+            return ENOMEM;
+        }
+
+        /* fill in chunk read request, keeping a copy of the requests
+         * after the struct since the message buffer will be freed */
+        scr->rank       = src_rank;
+        scr->app_id     = src_app_id;
+        scr->client_id  = src_client_id;
+        scr->rdreq_id   = src_req_id;
+        scr->num_chunks = num_chks;
+        scr->reqs       = (chunk_read_req_t*)(scr + 1);
+        scr->total_sz   = total_data_sz;
+        scr->resp       = NULL;
+        memcpy(scr->reqs, reqs, reqs_sz);
+
+        LOGDBG("adding to svcmgr chunk_reads (req=%d, num_chunks=%d, "
+               "total data size = %zu)", src_req_id, num_chks,
+               total_data_sz);
+        assert(NULL != sm);
+
+        SM_REQ_LOCK();
+        arraylist_add(sm->chunk_reads, scr);
+        SM_REQ_UNLOCK();
+
+        /* scr will be freed later by the sending thread */
+
+        LOGDBG("done adding to svcmgr chunk_reads");
+        return UNIFYFS_SUCCESS;
+    }
+
     /* we'll allocate a buffer to hold a list of chunk read response
      * structures, one for each chunk, followed by a data buffer
      * to hold all data for all reads */
@@ -337,24 +522,6 @@ int sm_issue_chunk_reads(int src_rank,
     chunk_read_resp_t* resp = (chunk_read_resp_t*)crbuf;
     char* databuf = crbuf + resp_sz;
 
-    /* allocate a struct for the chunk read request */
-    server_chunk_reads_t* scr = (server_chunk_reads_t*)
-        calloc(1, sizeof(server_chunk_reads_t));
-    if (NULL == scr) {
-        LOGERR("failed to allocate remote_chunk_reads");
-        return ENOMEM;
-    }
-
-    /* fill in chunk read request */
-    scr->rank       = src_rank;
-    scr->app_id     = src_app_id;
-    scr->client_id  = src_client_id;
-    scr->rdreq_id   = src_req_id;
-    scr->num_chunks = num_chks;
-    scr->reqs       = NULL;
-    scr->total_sz   = buf_sz;
-    scr->resp       = resp;
-
     LOGDBG("issuing %d requests for req=%d, total data size = %zu",
            num_chks, src_req_id, total_data_sz);
 
@@ -363,87 +530,29 @@ int sm_issue_chunk_reads(int src_rank,
     size_t buf_cursor = 0;
 
     int i;
-    app_client* app_clnt = NULL;
     for (i = 0; i < num_chks; i++) {
         /* pointer to next read request */
         chunk_read_req_t* rreq = reqs + i;
         debug_print_chunk_read_req(rreq);
 
-        /* pointer to next read response */
-        chunk_read_resp_t* rresp = resp + i;
-
-        /* get size and log offset of data we are to read */
-        size_t nbytes = rreq->nbytes;
-        size_t log_offset = rreq->log_offset;
-
-        /* record request metadata in response */
-        rresp->gfid    = rreq->gfid;
-        rresp->read_rc = 0;
-        rresp->nbytes  = nbytes;
-        rresp->offset  = rreq->offset;
-
-        /* get pointer to next position in buffer to store read data */
-        char* buf_ptr = databuf + buf_cursor;
-
-        /* read data from client log */
-        int app_id = rreq->log_app_id;
-        int cli_id = rreq->log_client_id;
-        app_clnt = get_app_client(app_id, cli_id);
-        if (NULL != app_clnt) {
-            logio_context* logio_ctx = app_clnt->state.logio_ctx;
-            if (NULL != logio_ctx) {
-                size_t nread = 0;
-                int rc = unifyfs_logio_read(logio_ctx, log_offset, nbytes,
-                                            buf_ptr, &nread);
-                if (UNIFYFS_SUCCESS == rc) {
-                    rresp->read_rc = nread;
-                } else {
-                    rresp->read_rc = (ssize_t)(-rc);
-                }
-            } else {
-                LOGERR("app client [%d:%d] has NULL logio context",
-                       app_id, cli_id);
-                rresp->read_rc = (ssize_t)(-EINVAL);
-            }
-        } else {
-            LOGERR("failed to get application client [%d:%d] state",
-                   app_id, cli_id);
-            rresp->read_rc = (ssize_t)(-EINVAL);
-        }
+        /* read data from client log into next position in buffer */
+        sm_read_chunk_data(rreq, 0, rreq->nbytes, resp + i,
+                           databuf + buf_cursor);
 
         /* update to point to next slot in read reply buffer */
-        buf_cursor += nbytes;
+        buf_cursor += rreq->nbytes;
     }
 
-    if (src_rank != glb_pmi_rank) {
-        /* we need to send these read responses to another rank,
-         * add chunk_reads to svcmgr response list */
-        LOGDBG("adding to svcmgr chunk_reads");
-        assert(NULL != sm);
-
-        SM_REQ_LOCK();
-        arraylist_add(sm->chunk_reads, scr);
-        SM_REQ_UNLOCK();
-
-        /* scr will be freed later by the sending thread */
-
-        LOGDBG("done adding to svcmgr chunk_reads");
-        return UNIFYFS_SUCCESS;
-    } else {
-        /* response is for myself, post it directly */
-        LOGDBG("responding to myself");
-        int rc = rm_post_chunk_read_responses(src_app_id, src_client_id,
-                                              src_rank, src_req_id,
-                                              num_chks, buf_sz, crbuf);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGERR("failed to handle chunk read responses");
-        }
-
-        /* clean up allocated buffers */
-        free(scr);
-
-        return rc;
+    /* response is for myself, post it directly */
+    LOGDBG("responding to myself");
+    int rc = rm_post_chunk_read_responses(src_app_id, src_client_id,
+                                          src_rank, src_req_id,
+                                          num_chks, 1, buf_sz, crbuf);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to handle chunk read responses");
     }
+
+    return rc;
 }
 
 int sm_laminate(int gfid)
@@ -515,11 +624,10 @@ int sm_add_extents(int gfid,
     int owner_rank = hash_gfid_to_server(gfid);
     int is_owner = (owner_rank == glb_pmi_rank);
 
-    unsigned int n_extents = (unsigned int)num_extents;
-    int ret = unifyfs_inode_add_extents(gfid, n_extents, extents);
+    int ret = unifyfs_inode_add_extents(gfid, num_extents, extents);
     if (ret) {
-        LOGERR("failed to add %u extents to gfid=%d (rc=%d, is_owner=%d)",
-               n_extents, gfid, ret, is_owner);
+        LOGERR("failed to add %zu extents to gfid=%d (rc=%d, is_owner=%d)",
+               num_extents, gfid, ret, is_owner);
     }
     return ret;
 }
@@ -860,16 +968,43 @@ static int process_add_extents_rpc(server_rpc_req_t* req)
     extent_metadata* extents = req->bulk_buf;
 
     /* add extents */
-    LOGDBG("adding %zu extents to gfid=%d from server[%d]",
-           num_extents, gfid, sender);
-    int ret = sm_add_extents(gfid, num_extents, extents);
-    if (ret) {
-        LOGERR("failed to add extents from %d (ret=%d)", sender, ret);
+    int ret = UNIFYFS_SUCCESS;
+    if (num_extents > 0) {
+        LOGDBG("adding %zu extents to gfid=%d from server[%d]",
+               num_extents, gfid, sender);
+        ret = sm_add_extents(gfid, num_extents, extents);
+        if ((ret == ENOENT) && (in->attr.gfid == gfid)) {
+            /* the file create broadcast has not reached this range owner
+             * yet, so create the file from the attributes sent along */
+            LOGDBG("creating gfid=%d for extents from server[%d]",
+                   gfid, sender);
+            ret = sm_set_fileattr(gfid, UNIFYFS_FILE_ATTR_OP_CREATE,
+                                  &(in->attr));
+            if ((ret == UNIFYFS_SUCCESS) || (ret == EEXIST)) {
+                ret = sm_add_extents(gfid, num_extents, extents);
+            }
+        }
+        if (ret) {
+            LOGERR("failed to add extents from %d (ret=%d)", sender, ret);
+        }
+    }
+
+    /* when extents are held by range owners, the sender tells the file
+     * owner how far the new extents extend the file */
+    size_t file_size = (size_t) in->file_size;
+    if ((ret == UNIFYFS_SUCCESS) && (file_size > 0)) {
+        ret = unifyfs_inode_extend_size(gfid, file_size);
+        if (ret) {
+            LOGERR("failed to extend size of gfid=%d to %zu (ret=%d)",
+                   gfid, file_size, ret);
+        }
     }
 
     margo_free_input(req->handle, in);
     free(in);
-    free(req->bulk_buf);
+    if (NULL != req->bulk_buf) {
+        free(req->bulk_buf);
+    }
 
     /* send rpc response */
     add_extents_out_t out;
@@ -1335,7 +1470,7 @@ static int process_unlink_bcast_rpc(server_rpc_req_t* req)
 
 static int process_metaget_bcast_rpc(server_rpc_req_t* req)
 {
-    /* Iterate through the global_inode_tree and copy all the file
+    /* Iterate through the global inode table and copy all the file
      * attr structs for the files this server owns */
 
     /* The file names in the unifyfs_file_attr_t are pointers to separately
@@ -1397,7 +1532,7 @@ static int process_metaget_bcast_rpc(server_rpc_req_t* req)
     }
     if (sizeof(metaget_all_bcast_out_t) != coll->output_sz) {
         LOGERR("Unexpected size for collective output struct. "
-                "Expected %d but value was %d",
+                "Expected %zu but value was %zu",
                 sizeof(metaget_all_bcast_out_t),
                 coll->output_sz);
         free(attr_list);
@@ -1445,23 +1580,49 @@ static int process_metaget_bcast_rpc(server_rpc_req_t* req)
     return invoke_bcast_progress_rpc(req->coll);
 }
 
-static int process_pending_sync(server_rpc_req_t* req)
+/* Complete the pending sync of a client request. For a multi-file sync
+ * group, the client is only sent a response once all of the group's
+ * files have completed. */
+void sm_complete_pending_sync(client_rpc_req_t* creq,
+                              pending_sync_group* group,
+                              int ret)
 {
-    int ret = UNIFYFS_SUCCESS;
+    if (NULL != group) {
+        int remaining;
+        ABT_mutex_lock(group->sync);
+        if ((ret != UNIFYFS_SUCCESS) && (group->ret == UNIFYFS_SUCCESS)) {
+            group->ret = ret;
+        }
+        remaining = --(group->num_pending);
+        ret = group->ret;
+        ABT_mutex_unlock(group->sync);
+        if (remaining > 0) {
+            return;
+        }
+        ABT_mutex_free(&(group->sync));
+        free(group);
+    }
 
-    /* get target file */
-    int* pending_gfid = req->input;
-    int gfid = *pending_gfid;
-    free(pending_gfid);
+    /* send rpc response to requesting client */
+    unifyfs_fsync_out_t out;
+    out.ret = (int32_t) ret;
+    hg_return_t hret = margo_respond(creq->handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* cleanup req */
+    margo_destroy(creq->handle);
+    free(creq);
+}
+
+static int process_pending_sync(int gfid)
+{
+    int ret = UNIFYFS_SUCCESS;
 
     int owner_rank = hash_gfid_to_server(gfid);
     int is_owner = (owner_rank == glb_pmi_rank);
 
-    bool has_pending = unifyfs_inode_has_pending_extents(gfid);
-    if (has_pending) {
-        usleep(50000); /* sleep 50 ms to catch more pending extents */
-    }
-
     arraylist_t* pending_list = NULL;
     int rc = unifyfs_inode_get_pending_extents(gfid, &pending_list);
     if (NULL != pending_list) {
@@ -1499,12 +1660,22 @@ static int process_pending_sync(server_rpc_req_t* req)
                 }
             }
 
+            /* merge extents that are contiguous in the file and log,
+             * which shrinks both the local tree updates and the list
+             * sent to the owner */
+            unsigned int n_merged = (unsigned int)
+                extent_list_coalesce(combined_extents, total_extents);
+            LOGDBG("coalesced %u pending extents into %u (gfid=%d)",
+                   total_extents, n_merged, gfid);
+            total_extents = n_merged;
+
             /* add the combined list to local inode */
             ret = unifyfs_inode_add_extents(gfid, total_extents,
                                             combined_extents);
 
-            if ((ret == UNIFYFS_SUCCESS) && !is_owner) {
-                /* send the combined list to the owner */
+            if ((ret == UNIFYFS_SUCCESS) &&
+                (!is_owner || use_meta_range_owners)) {
+                /* send the combined list to the owner (or range owners) */
                 ret = unifyfs_invoke_add_extents_rpc(gfid, total_extents,
                                                      combined_extents);
             }
@@ -1515,19 +1686,7 @@ static int process_pending_sync(server_rpc_req_t* req)
             void* item = arraylist_get(pending_list, i);
             if (NULL != item) {
                 pending_extents_item* pei = (pending_extents_item*) item;
-                client_rpc_req_t* creq = pei->client_req;
-
-                /* send rpc response to requesting client */
-                unifyfs_fsync_out_t out;
-                out.ret = (int32_t) ret;
-                hg_return_t hret = margo_respond(creq->handle, &out);
-                if (hret != HG_SUCCESS) {
-                    LOGERR("margo_respond() failed");
-                }
-
-                /* cleanup req */
-                margo_destroy(creq->handle);
-                free(creq);
+                sm_complete_pending_sync(pei->client_req, pei->group, ret);
             }
         }
 
@@ -1542,6 +1701,147 @@ static int process_pending_sync(server_rpc_req_t* req)
     return ret;
 }
 
+static inline uint64_t sync_batch_now_usec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000) + ((uint64_t)now.tv_nsec / 1000);
+}
+
+/* returns the time (usec) a batch may wait for more syncs, based on the
+ * recent sync arrival rate */
+static inline uint64_t sync_batch_window(sync_batch_state_t* sb)
+{
+    uint64_t window = 2 * sb->avg_gap;
+    if ((0 == sb->avg_gap) || (window > SYNC_BATCH_MAX_USEC)) {
+        /* syncs are too sparse for waiting to help */
+        return 0;
+    }
+    return window;
+}
+
+/* submit a file with new pending extents for batched sync processing */
+int sm_submit_pending_sync(int gfid,
+                           size_t num_extents)
+{
+    if ((NULL == sm) || !(sm->sync_batch.thrd_created)) {
+        return UNIFYFS_FAILURE;
+    }
+    sync_batch_state_t* sb = &(sm->sync_batch);
+
+    pthread_mutex_lock(&(sb->lock));
+
+    /* update smoothed gap between arrivals, capping the gap so one long
+     * idle period does not dominate */
+    uint64_t now = sync_batch_now_usec();
+    if (sb->last_arrival != 0) {
+        uint64_t gap = now - sb->last_arrival;
+        if (gap > (2 * SYNC_BATCH_MAX_USEC)) {
+            gap = 2 * SYNC_BATCH_MAX_USEC;
+        }
+        sb->avg_gap = ((7 * sb->avg_gap) + gap) / 8;
+    }
+    sb->last_arrival = now;
+
+    /* add file to the batch, if not already there */
+    if (0 == sb->num_gfids) {
+        sb->batch_start = now;
+    }
+    size_t i;
+    for (i = 0; i < sb->num_gfids; i++) {
+        if (sb->gfids[i] == gfid) {
+            break;
+        }
+    }
+    if (i == sb->num_gfids) {
+        if (sb->num_gfids == sb->max_gfids) {
+            size_t new_max = (sb->max_gfids ? (2 * sb->max_gfids) : 64);
+            int* tmp = realloc(sb->gfids, new_max * sizeof(int));
+            if (NULL == tmp) {
+                pthread_mutex_unlock(&(sb->lock));
+                LOGERR("failed to grow sync batch for gfid=%d", gfid);
+                return ENOMEM;
+            }
+            sb->gfids = tmp;
+            sb->max_gfids = new_max;
+        }
+        sb->gfids[sb->num_gfids++] = gfid;
+    }
+    sb->num_extents += num_extents;
+
+    pthread_cond_signal(&(sb->cond));
+    pthread_mutex_unlock(&(sb->lock));
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* Entry point for sync batching thread. Waits for the current batch of
+ * pending syncs to fill or time out, then processes each file's pending
+ * extents. Remaining syncs are flushed when asked to exit.
+ *
+ * @param arg: pointer to sync batching state
+ * @return NULL */
+static void* sync_batch_thread(void* arg)
+{
+    sync_batch_state_t* sb = (sync_batch_state_t*) arg;
+
+    pthread_mutex_lock(&(sb->lock));
+    while (1) {
+        if (0 == sb->num_gfids) {
+            if (sb->time_to_exit) {
+                break;
+            }
+            pthread_cond_wait(&(sb->cond), &(sb->lock));
+            continue;
+        }
+
+        uint64_t now = sync_batch_now_usec();
+        uint64_t deadline = sb->batch_start + sync_batch_window(sb);
+        if (!sb->time_to_exit &&
+            (sb->num_extents < SYNC_BATCH_MAX_EXTENTS) &&
+            (now < deadline)) {
+            /* wait for more syncs, or the batch deadline */
+            uint64_t wait_usec = deadline - now;
+            struct timespec timeout;
+            clock_gettime(CLOCK_REALTIME, &timeout);
+            timeout.tv_sec  += (time_t)(wait_usec / 1000000);
+            timeout.tv_nsec += (long)((wait_usec % 1000000) * 1000);
+            if (timeout.tv_nsec >= 1000000000) {
+                timeout.tv_nsec -= 1000000000;
+                timeout.tv_sec++;
+            }
+            pthread_cond_timedwait(&(sb->cond), &(sb->lock), &timeout);
+            continue;
+        }
+
+        /* take the current batch */
+        int* gfids = sb->gfids;
+        size_t num_gfids = sb->num_gfids;
+        LOGDBG("processing sync batch of %zu files (%zu extents)",
+               num_gfids, sb->num_extents);
+        sb->gfids = NULL;
+        sb->num_gfids = 0;
+        sb->max_gfids = 0;
+        sb->num_extents = 0;
+        pthread_mutex_unlock(&(sb->lock));
+
+        for (size_t i = 0; i < num_gfids; i++) {
+            int rc = process_pending_sync(gfids[i]);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to process pending sync for gfid=%d (rc=%d)",
+                       gfids[i], rc);
+            }
+        }
+        free(gfids);
+
+        pthread_mutex_lock(&(sb->lock));
+    }
+    pthread_mutex_unlock(&(sb->lock));
+
+    LOGDBG("sync batching thread exiting");
+    return NULL;
+}
+
 static int process_service_requests(void)
 {
     /* assume we'll succeed */
@@ -1574,6 +1874,12 @@ static int process_service_requests(void)
         int rret;
         server_rpc_req_t* req = (server_rpc_req_t*)
             arraylist_get(svc_reqs, i);
+
+        /* the handler may hand off or free the request */
+        server_rpc_e req_type = req->req_type;
+        uint64_t submit_time = req->submit_time;
+        uint64_t start_time = rpc_stats_now();
+
         switch (req->req_type) {
         case UNIFYFS_SERVER_RPC_CHUNK_READ:
             rret = process_chunk_read_rpc(req);
@@ -1626,14 +1932,13 @@ static int process_service_requests(void)
         case UNIFYFS_SERVER_BCAST_RPC_UNLINK:
             rret = process_unlink_bcast_rpc(req);
             break;
-        case UNIFYFS_SERVER_PENDING_SYNC:
-            rret = process_pending_sync(req);
-            break;
         default:
             LOGERR("unsupported server rpc request type %d", req->req_type);
             rret = UNIFYFS_ERROR_NYI;
             break;
         }
+        rpc_stats_record_server(req_type, submit_time, start_time,
+                                rpc_stats_now());
         if (rret != UNIFYFS_SUCCESS) {
             if ((rret != ENOENT) && (rret != EEXIST)) {
                 LOGERR("server rpc request %d failed (%s)",
@@ -31,6 +31,7 @@
 #define UNIFYFS_SERVICE_MANAGER_H
 
 #include "unifyfs_global.h"
+#include "unifyfs_inode.h"
 #include "unifyfs_transfer.h"
 
 
@@ -58,6 +59,23 @@ int sm_submit_transfer_request(transfer_thread_args* tta);
 /* tell service manager thread transfer has completed */
 int sm_complete_transfer_request(transfer_thread_args* tta);
 
+/* submit a file with new pending extents for (batched) sync processing */
+int sm_submit_pending_sync(int gfid,
+                           size_t num_extents);
+
+/* complete the pending extents sync of a client request (or of one file
+ * within a multi-file sync group), responding to the client when done */
+void sm_complete_pending_sync(client_rpc_req_t* creq,
+                              pending_sync_group* group,
+                              int ret);
+
+/* read data for (part of) a chunk read request from client log */
+void sm_read_chunk_data(chunk_read_req_t* rreq,
+                        size_t chk_offset,
+                        size_t nbytes,
+                        chunk_read_resp_t* rresp,
+                        char* buf);
+
 /* decode and issue chunk reads contained in message buffer */
 int sm_issue_chunk_reads(int src_rank,
                          int src_app_id,
@@ -24,30 +24,68 @@
 #define UNIFYFS_TRANSFER_MAX_WRITE (16 * 1048576) // 16 MiB
 #endif
 
-/* maximum memory allocation for temporary transfer data copies */
-#ifndef UNIFYFS_TRANSFER_MAX_BUFFER
-#define UNIFYFS_TRANSFER_MAX_BUFFER (512 * 1048576) // 512 MiB
+/* alignment of file offsets, lengths, and memory for O_DIRECT writes */
+#ifndef UNIFYFS_TRANSFER_DIRECT_ALIGN
+#define UNIFYFS_TRANSFER_DIRECT_ALIGN 4096
 #endif
 
+/* maximum number of separate file ranges held in one transfer buffer */
+#ifndef UNIFYFS_TRANSFER_MAX_BUFFER_CHUNKS
+#define UNIFYFS_TRANSFER_MAX_BUFFER_CHUNKS 1024
+#endif
+
+/* a contiguous range of destination file data held in a transfer buffer.
+ * Extents that are adjacent in the file are coalesced into one chunk. */
 typedef struct transfer_chunk {
     char*  chunk_data;
     size_t chunk_sz;
     off_t  file_offset;
 } transfer_chunk;
 
-/* write a transfer_chunk to given file descriptor */
-static int write_transfer_chunk(int fd,
-                                transfer_chunk* chk)
+/* a buffer of chunks, filled by the transfer thread from local client
+ * logs and written to the destination file by a writer thread */
+typedef struct transfer_buffer {
+    char* data;             /* buffer memory */
+    size_t used;            /* bytes of buffer in use */
+    transfer_chunk chunks[UNIFYFS_TRANSFER_MAX_BUFFER_CHUNKS];
+    size_t n_chunks;        /* number of chunks in buffer */
+    struct transfer_buffer* next;
+} transfer_buffer;
+
+/* state shared between the transfer thread and its writers. Buffers
+ * cycle from the free list to the full queue and back, so reading local
+ * data for one buffer overlaps with writing out the others. */
+typedef struct transfer_pipeline {
+    int fd;                 /* destination file descriptor */
+    int direct_fd;          /* O_DIRECT descriptor, or -1 */
+    size_t buf_sz;          /* size of each buffer */
+
+    pthread_mutex_t sync;
+    pthread_cond_t  cond;
+    transfer_buffer* free_bufs;  /* buffers ready to be filled */
+    transfer_buffer* full_head;  /* buffers ready to be written */
+    transfer_buffer* full_tail;
+    int filled;             /* set once all buffers have been queued */
+    int status;             /* first error encountered */
+
+    pthread_t* writers;
+    int n_writers;
+} transfer_pipeline;
+
+/* write a range of data to the given file descriptor */
+static int write_transfer_range(int fd,
+                                char* data,
+                                size_t sz,
+                                off_t file_offset)
 {
-    // TODO: use lio_listio to submit all writes at once?
     size_t max_write = UNIFYFS_TRANSFER_MAX_WRITE;
     size_t n_write = 0;
-    size_t n_remain = chk->chunk_sz;
-    do {
-        char* data = chk->chunk_data + n_write;
-        off_t off  = chk->file_offset + (off_t)n_write;
+    size_t n_remain = sz;
+    while (n_remain) {
+        char* buf  = data + n_write;
+        off_t off  = file_offset + (off_t)n_write;
         size_t n_bytes = (n_remain > max_write ? max_write : n_remain);
-        ssize_t szrc = pwrite(fd, data, n_bytes, off);
+        ssize_t szrc = pwrite(fd, buf, n_bytes, off);
         if (-1 == szrc) {
             int err = errno;
             if ((err != EINTR) && (err != EAGAIN)) {
@@ -55,39 +93,79 @@ static int write_transfer_chunk(int fd,
                        fd, n_remain, strerror(err));
                 return err;
             }
-
         } else {
             n_write += szrc;
             n_remain -= szrc;
         }
-    } while (n_remain);
+    }
 
     return UNIFYFS_SUCCESS;
 }
 
+/* write a transfer_chunk to the destination file. When O_DIRECT is in
+ * use, the aligned middle of the chunk bypasses the page cache, and any
+ * unaligned head or tail goes through the buffered descriptor. */
+static int write_transfer_chunk(transfer_pipeline* xfer,
+                                transfer_chunk* chk)
+{
+    if (-1 == xfer->direct_fd) {
+        return write_transfer_range(xfer->fd, chk->chunk_data,
+                                    chk->chunk_sz, chk->file_offset);
+    }
+
+    size_t align = UNIFYFS_TRANSFER_DIRECT_ALIGN;
+    size_t head = (align - ((size_t)chk->file_offset % align)) % align;
+    if (head > chk->chunk_sz) {
+        head = chk->chunk_sz;
+    }
+    size_t body = ((chk->chunk_sz - head) / align) * align;
+    size_t tail = chk->chunk_sz - head - body;
+
+    int rc = UNIFYFS_SUCCESS;
+    if (head) {
+        rc = write_transfer_range(xfer->fd, chk->chunk_data, head,
+                                  chk->file_offset);
+    }
+    if ((UNIFYFS_SUCCESS == rc) && body) {
+        char* data = chk->chunk_data + head;
+        off_t off = chk->file_offset + (off_t)head;
+        rc = write_transfer_range(xfer->direct_fd, data, body, off);
+        if (EINVAL == rc) {
+            /* file system rejected the direct write, use buffered I/O */
+            LOGDBG("O_DIRECT write failed, retrying with buffered write");
+            rc = write_transfer_range(xfer->fd, data, body, off);
+        }
+    }
+    if ((UNIFYFS_SUCCESS == rc) && tail) {
+        rc = write_transfer_range(xfer->fd,
+                                  chk->chunk_data + head + body, tail,
+                                  chk->file_offset + (off_t)(head + body));
+    }
+    return rc;
+}
+
+/* read part of a local extent's data from the client log into buf */
 static int read_local_extent(extent_metadata* ext,
-                             transfer_chunk* chk)
+                             size_t ext_pos,
+                             size_t sz,
+                             char* buf)
 {
     int ret = UNIFYFS_SUCCESS;
 
-    char* buf = chk->chunk_data;
-    chk->chunk_sz = extent_length(ext);
-    chk->file_offset = extent_offset(ext);
-
     /* read data from client log */
     app_client* app_clnt = NULL;
     int app_id = ext->app_id;
     int cli_id = ext->cli_id;
-    off_t log_offset = (off_t) ext->log_pos;
+    off_t log_offset = (off_t)(ext->log_pos + ext_pos);
     app_clnt = get_app_client(app_id, cli_id);
     if (NULL != app_clnt) {
         logio_context* logio_ctx = app_clnt->state.logio_ctx;
         if (NULL != logio_ctx) {
             LOGDBG("reading extent(file_offset=%zu, sz=%zu) from log[%d:%d]",
-                   (size_t)chk->file_offset, chk->chunk_sz, app_id, cli_id);
+                   (size_t)extent_offset(ext) + ext_pos, sz, app_id, cli_id);
 
             size_t nread = 0;
-            int rc = unifyfs_logio_read(logio_ctx, log_offset, chk->chunk_sz,
+            int rc = unifyfs_logio_read(logio_ctx, log_offset, sz,
                                         buf, &nread);
             if (rc != UNIFYFS_SUCCESS) {
                 ret = rc;
@@ -106,6 +184,306 @@ static int read_local_extent(extent_metadata* ext,
     return ret;
 }
 
+/* record an error for the transfer, keeping the first one */
+static void pipeline_set_error(transfer_pipeline* xfer, int err)
+{
+    pthread_mutex_lock(&(xfer->sync));
+    if (UNIFYFS_SUCCESS == xfer->status) {
+        xfer->status = err;
+    }
+    pthread_cond_broadcast(&(xfer->cond));
+    pthread_mutex_unlock(&(xfer->sync));
+}
+
+/* writer thread main, writes out full buffers until all have been
+ * queued and written, or an error occurs */
+static void* transfer_writer_thread(void* arg)
+{
+    transfer_pipeline* xfer = (transfer_pipeline*) arg;
+
+    pthread_mutex_lock(&(xfer->sync));
+    while (1) {
+        while ((NULL == xfer->full_head) && !xfer->filled &&
+               (UNIFYFS_SUCCESS == xfer->status)) {
+            pthread_cond_wait(&(xfer->cond), &(xfer->sync));
+        }
+        transfer_buffer* buf = xfer->full_head;
+        if (NULL == buf) {
+            /* nothing left to write */
+            break;
+        }
+        xfer->full_head = buf->next;
+        if (NULL == xfer->full_head) {
+            xfer->full_tail = NULL;
+        }
+        int status = xfer->status;
+        pthread_mutex_unlock(&(xfer->sync));
+
+        /* after an error, buffers are recycled without writing */
+        int rc = UNIFYFS_SUCCESS;
+        for (size_t i = 0; (i < buf->n_chunks) &&
+                           (UNIFYFS_SUCCESS == status); i++) {
+            rc = write_transfer_chunk(xfer, buf->chunks + i);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("write_transfer_chunk(chk=%zu) failed", i);
+                break;
+            }
+        }
+        buf->used = 0;
+        buf->n_chunks = 0;
+
+        pthread_mutex_lock(&(xfer->sync));
+        if ((rc != UNIFYFS_SUCCESS) && (UNIFYFS_SUCCESS == xfer->status)) {
+            xfer->status = rc;
+        }
+        buf->next = xfer->free_bufs;
+        xfer->free_bufs = buf;
+        pthread_cond_broadcast(&(xfer->cond));
+    }
+    pthread_mutex_unlock(&(xfer->sync));
+
+    return NULL;
+}
+
+/* get an empty buffer, waiting for one to be written out if needed.
+ * Returns NULL if the transfer has failed. */
+static transfer_buffer* pipeline_get_buffer(transfer_pipeline* xfer)
+{
+    transfer_buffer* buf = NULL;
+    pthread_mutex_lock(&(xfer->sync));
+    while ((NULL == xfer->free_bufs) &&
+           (UNIFYFS_SUCCESS == xfer->status)) {
+        pthread_cond_wait(&(xfer->cond), &(xfer->sync));
+    }
+    if (UNIFYFS_SUCCESS == xfer->status) {
+        buf = xfer->free_bufs;
+        xfer->free_bufs = buf->next;
+        buf->next = NULL;
+    }
+    pthread_mutex_unlock(&(xfer->sync));
+    return buf;
+}
+
+/* queue a filled buffer for the writers */
+static void pipeline_put_buffer(transfer_pipeline* xfer,
+                                transfer_buffer* buf)
+{
+    pthread_mutex_lock(&(xfer->sync));
+    buf->next = NULL;
+    if (NULL == xfer->full_tail) {
+        xfer->full_head = buf;
+    } else {
+        xfer->full_tail->next = buf;
+    }
+    xfer->full_tail = buf;
+    pthread_cond_signal(&(xfer->cond));
+    pthread_mutex_unlock(&(xfer->sync));
+}
+
+/* release the buffers of a pipeline, writers must have exited */
+static void pipeline_free_buffers(transfer_pipeline* xfer)
+{
+    /* buffers may remain queued if the writers stopped on an error */
+    if (NULL != xfer->full_tail) {
+        xfer->full_tail->next = xfer->free_bufs;
+        xfer->free_bufs = xfer->full_head;
+        xfer->full_head = NULL;
+        xfer->full_tail = NULL;
+    }
+
+    transfer_buffer* buf = xfer->free_bufs;
+    while (NULL != buf) {
+        transfer_buffer* next = buf->next;
+        free(buf->data);
+        free(buf);
+        buf = next;
+    }
+    xfer->free_bufs = NULL;
+}
+
+/* allocate buffers and start writer threads */
+static int pipeline_start(transfer_pipeline* xfer,
+                          size_t total_data_sz)
+{
+    int ret;
+    size_t align = UNIFYFS_TRANSFER_DIRECT_ALIGN;
+
+    pthread_mutex_init(&(xfer->sync), NULL);
+    pthread_cond_init(&(xfer->cond), NULL);
+
+    /* use a single smaller buffer when all the data fits */
+    size_t buf_sz = transfer_buffer_sz;
+    if (-1 != xfer->direct_fd) {
+        /* leave room for padding chunks to the file alignment */
+        total_data_sz += (align * UNIFYFS_TRANSFER_MAX_BUFFER_CHUNKS);
+        if (buf_sz < (4 * align)) {
+            buf_sz = 4 * align;
+        }
+    }
+    size_t n_bufs = (size_t)transfer_writer_count + 2;
+    if (total_data_sz <= buf_sz) {
+        buf_sz = total_data_sz;
+        n_bufs = 1;
+    }
+    xfer->buf_sz = buf_sz;
+
+    for (size_t i = 0; i < n_bufs; i++) {
+        transfer_buffer* buf = calloc(1, sizeof(transfer_buffer));
+        if (NULL == buf) {
+            break;
+        }
+        if (posix_memalign((void**)&(buf->data), align, buf_sz) != 0) {
+            free(buf);
+            break;
+        }
+        buf->next = xfer->free_bufs;
+        xfer->free_bufs = buf;
+    }
+    if (NULL == xfer->free_bufs) {
+        LOGERR("failed to allocate transfer buffers");
+        ret = ENOMEM;
+        goto start_fail;
+    }
+
+    int n_writers = transfer_writer_count;
+    if (n_writers > (int)n_bufs) {
+        n_writers = (int)n_bufs;
+    }
+    xfer->writers = calloc(n_writers, sizeof(pthread_t));
+    if (NULL == xfer->writers) {
+        ret = ENOMEM;
+        goto start_fail;
+    }
+    for (int i = 0; i < n_writers; i++) {
+        int rc = pthread_create(xfer->writers + i, NULL,
+                                transfer_writer_thread, (void*)xfer);
+        if (rc != 0) {
+            LOGERR("failed to create transfer writer thread - %s",
+                   strerror(rc));
+            break;
+        }
+        xfer->n_writers++;
+    }
+    if (0 == xfer->n_writers) {
+        free(xfer->writers);
+        xfer->writers = NULL;
+        ret = EAGAIN;
+        goto start_fail;
+    }
+
+    LOGDBG("started %d transfer writers with %zu buffers of %zu bytes",
+           xfer->n_writers, n_bufs, buf_sz);
+    return UNIFYFS_SUCCESS;
+
+start_fail:
+    pipeline_free_buffers(xfer);
+    pthread_mutex_destroy(&(xfer->sync));
+    pthread_cond_destroy(&(xfer->cond));
+    return ret;
+}
+
+/* wait for the writers to drain the queue and exit, then release the
+ * pipeline state. Returns the transfer status. */
+static int pipeline_finish(transfer_pipeline* xfer)
+{
+    pthread_mutex_lock(&(xfer->sync));
+    xfer->filled = 1;
+    pthread_cond_broadcast(&(xfer->cond));
+    pthread_mutex_unlock(&(xfer->sync));
+
+    for (int i = 0; i < xfer->n_writers; i++) {
+        pthread_join(xfer->writers[i], NULL);
+    }
+    free(xfer->writers);
+    xfer->writers = NULL;
+
+    pipeline_free_buffers(xfer);
+    pthread_mutex_destroy(&(xfer->sync));
+    pthread_cond_destroy(&(xfer->cond));
+
+    return xfer->status;
+}
+
+/* read all local extents into transfer buffers, coalescing extents
+ * that are adjacent in the file, and hand full buffers to the writers */
+static int pipeline_fill(transfer_pipeline* xfer,
+                         transfer_thread_args* tta)
+{
+    size_t align = UNIFYFS_TRANSFER_DIRECT_ALIGN;
+    int direct = (-1 != xfer->direct_fd);
+    transfer_buffer* buf = NULL;
+    transfer_chunk* chk = NULL;
+
+    for (size_t i = 0; i < tta->n_extents; i++) {
+        extent_metadata* ext = tta->local_extents + i;
+        size_t ext_sz = extent_length(ext);
+        size_t ext_pos = 0;
+        while (ext_pos < ext_sz) {
+            off_t file_off = extent_offset(ext) + (off_t)ext_pos;
+
+            /* extend the current chunk if this data follows it */
+            int append = ((NULL != chk) &&
+                          ((chk->file_offset + (off_t)chk->chunk_sz) ==
+                           file_off));
+            size_t pad = 0;
+            if ((NULL != buf) && !append && direct) {
+                /* place chunk data so its memory and file offsets have
+                 * the same alignment */
+                pad = ((size_t)file_off % align) + align -
+                      (buf->used % align);
+                pad %= align;
+            }
+            if ((NULL != buf) &&
+                ((buf->used + pad >= xfer->buf_sz) ||
+                 (!append &&
+                  (buf->n_chunks == UNIFYFS_TRANSFER_MAX_BUFFER_CHUNKS)))) {
+                pipeline_put_buffer(xfer, buf);
+                buf = NULL;
+            }
+            if (NULL == buf) {
+                buf = pipeline_get_buffer(xfer);
+                if (NULL == buf) {
+                    /* a writer failed */
+                    return UNIFYFS_FAILURE;
+                }
+                chk = NULL;
+                append = 0;
+                pad = (direct ? ((size_t)file_off % align) : 0);
+            }
+            if (!append) {
+                buf->used += pad;
+                chk = buf->chunks + buf->n_chunks;
+                buf->n_chunks++;
+                chk->chunk_data  = buf->data + buf->used;
+                chk->chunk_sz    = 0;
+                chk->file_offset = file_off;
+            }
+
+            size_t n_bytes = ext_sz - ext_pos;
+            if (n_bytes > (xfer->buf_sz - buf->used)) {
+                n_bytes = xfer->buf_sz - buf->used;
+            }
+            int rc = read_local_extent(ext, ext_pos, n_bytes,
+                                       buf->data + buf->used);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to copy extent[%zu] data for gfid=%d",
+                       i, tta->gfid);
+                pipeline_set_error(xfer, rc);
+                pipeline_put_buffer(xfer, buf);
+                return rc;
+            }
+            buf->used += n_bytes;
+            chk->chunk_sz += n_bytes;
+            ext_pos += n_bytes;
+        }
+    }
+
+    if (NULL != buf) {
+        pipeline_put_buffer(xfer, buf);
+    }
+    return UNIFYFS_SUCCESS;
+}
+
 /* find local extents for the given gfid and initialize transfer helper
  * thread state */
 int create_local_transfers(int gfid,
@@ -196,10 +574,7 @@ void* transfer_helper_thread(void* arg)
     int rc;
     int ret = UNIFYFS_SUCCESS;
     coll_request* coll = NULL;
-    char* data_copy_buf = NULL;
-    transfer_chunk* chunks = NULL;
-    transfer_chunk* chk;
-    extent_metadata* ext;
+    transfer_pipeline xfer;
 
     if (NULL != tta->bcast_coll) {
         coll = (coll_request*) tta->bcast_coll;
@@ -211,6 +586,10 @@ void* transfer_helper_thread(void* arg)
     LOGDBG("I am transfer thread for gfid=%d file=%s collective=%p",
            tta->gfid, tta->dst_file, coll);
 
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.fd = -1;
+    xfer.direct_fd = -1;
+
     if (tta->local_data_sz) {
         /* open destination file (create if it doesn't exist) */
         int flags = O_CREAT | O_WRONLY;
@@ -222,88 +601,39 @@ void* transfer_helper_thread(void* arg)
             tta->status = err;
             return arg;
         }
-
-        /* get number of local extents and their total size */
-        size_t total_local_data_sz = tta->local_data_sz;
-        size_t n_extents = tta->n_extents;
-
-        /* allocate transfer_chunk array */
-        chunks = calloc(n_extents, sizeof(transfer_chunk));
-        if (NULL == chunks) {
-            LOGERR("failed to allocate transfer chunk state");
-            ret = ENOMEM;
-            goto transfer_cleanup;
-        }
-
-        /* allocate copy buffer for chunk data */
-        size_t max_buffer = UNIFYFS_TRANSFER_MAX_BUFFER;
-        size_t buf_sz = max_buffer;
-        if (total_local_data_sz <= max_buffer) {
-            buf_sz = total_local_data_sz;
-        } else {
-            /* make sure longest extent will fit in copy buffer */
-            for (size_t i = 0; i < n_extents; i++) {
-                ext = tta->local_extents + i;
-                size_t ext_sz = extent_length(ext);
-                if (ext_sz > buf_sz) {
-                    buf_sz = ext_sz;
-                }
+        xfer.fd = fd;
+
+        if (use_transfer_direct_io) {
+            /* unaligned parts of each write still use fd */
+            xfer.direct_fd = open(tta->dst_file, O_WRONLY | O_DIRECT);
+            if (xfer.direct_fd == -1) {
+                LOGDBG("O_DIRECT open(%s) failed, using buffered writes - %s",
+                       tta->dst_file, strerror(errno));
             }
         }
-        data_copy_buf = malloc(buf_sz);
-        if (NULL == data_copy_buf) {
-            LOGERR("failed to allocate transfer copy buffer");
-            ret = ENOMEM;
-            goto transfer_cleanup;
-        }
 
         /* read local data for all extents and write it to corresponding
-         * offsets within destination file. */
-        size_t ext_ndx = 0; /* tracks extent array index */
-        size_t chk_ndx = 0; /* tracks chunk array index */
-        do {
-            size_t begin_chk_ndx = chk_ndx;
-            size_t copy_sz = 0;
-            for (size_t i = ext_ndx; i < n_extents; i++) {
-                ext = tta->local_extents + i;
-                size_t ext_sz = extent_length(ext);
-                if ((copy_sz + ext_sz) <= buf_sz) {
-                    chk = chunks + chk_ndx;
-                    chk_ndx++;
-                    ext_ndx++;
-
-                    chk->chunk_data = data_copy_buf + copy_sz;
-                    copy_sz += ext_sz;
-
-                    rc = read_local_extent(ext, chk);
-                    if (rc != UNIFYFS_SUCCESS) {
-                        LOGERR("failed to copy extent[%zu] data for gfid=%d",
-                               i, tta->gfid);
-                        ret = rc;
-                        goto transfer_cleanup;
-                    }
-                } else {
-                    /* no room left in copy buffer */
-                    break;
-                }
+         * offsets within destination file, reading into one buffer while
+         * writers drain the others */
+        rc = pipeline_start(&xfer, tta->local_data_sz);
+        if (rc != UNIFYFS_SUCCESS) {
+            ret = rc;
+        } else {
+            rc = pipeline_fill(&xfer, tta);
+            ret = pipeline_finish(&xfer);
+            if ((UNIFYFS_SUCCESS == ret) && (rc != UNIFYFS_SUCCESS)) {
+                ret = rc;
             }
-
-            /* write out data chunks for extents processed in this iteration */
-            for (size_t i = begin_chk_ndx; i < chk_ndx; i++) {
-                chk = chunks + i;
-                rc = write_transfer_chunk(fd, chk);
-                if (rc != UNIFYFS_SUCCESS) {
-                    LOGERR("write_transfer_chunk(dst=%s, chk=%zu) failed",
-                        tta->dst_file, i);
-                    ret = rc;
-                    goto transfer_cleanup;
-                }
+            if (ret != UNIFYFS_SUCCESS) {
+                LOGERR("transfer of gfid=%d to %s failed",
+                       tta->gfid, tta->dst_file);
             }
-        } while (ext_ndx < n_extents);
+        }
     }
 
-transfer_cleanup:
-
+    if (-1 != xfer.direct_fd) {
+        close(xfer.direct_fd);
+    }
     if (-1 != fd) {
         close(fd);
     }
@@ -328,13 +658,5 @@ transfer_cleanup:
         LOGERR("sm_complete_transfer_request() failed");
     }
 
-    /* release allocated memory */
-    if (NULL != data_copy_buf) {
-        free(data_copy_buf);
-    }
-    if (NULL != chunks) {
-        free(chunks);
-    }
-
     return arg;
 }
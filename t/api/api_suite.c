@@ -61,6 +61,8 @@ int main(int argc, char* argv[])
 
         api_create_open_remove_test(unifyfs_root, &fshdl);
 
+        api_file_lookup_test(unifyfs_root, &fshdl, 100);
+
         api_write_read_sync_stat_test(unifyfs_root, &fshdl,
                                       (size_t)64 * KIB, (size_t)4 * KIB);
         api_write_read_sync_stat_test(unifyfs_root, &fshdl,
@@ -47,6 +47,11 @@ int api_finalize_test(char* unifyfs_root,
 int api_create_open_remove_test(char* unifyfs_root,
                                 unifyfs_handle* fshdl);
 
+/* Tests path and gfid lookups (open and stat) across many files */
+int api_file_lookup_test(char* unifyfs_root,
+                         unifyfs_handle* fshdl,
+                         int nfiles);
+
 /* Tests file write, read, sync, and stat */
 int api_write_read_sync_stat_test(char* unifyfs_root,
                                   unifyfs_handle* fshdl,
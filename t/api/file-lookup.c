@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include "api_suite.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double elapsed_usecs(struct timespec* start,
+                            struct timespec* end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e6) +
+           ((double)(end->tv_nsec - start->tv_nsec) / 1e3);
+}
+
+int api_file_lookup_test(char* unifyfs_root,
+                         unifyfs_handle* fshdl,
+                         int nfiles)
+{
+    struct timespec start, end;
+    int rc;
+    int i;
+
+    char (*paths)[64] = calloc((size_t)nfiles, sizeof(*paths));
+    unifyfs_gfid* gfids = calloc((size_t)nfiles, sizeof(unifyfs_gfid));
+    if ((NULL == paths) || (NULL == gfids)) {
+        free(paths);
+        free(gfids);
+        return ENOMEM;
+    }
+
+    //-------------
+
+    diag("Starting API file lookup tests (%d files)", nfiles);
+
+    int created = 0;
+    for (i = 0; i < nfiles; i++) {
+        testutil_rand_path(paths[i], sizeof(paths[i]), unifyfs_root);
+        gfids[i] = UNIFYFS_INVALID_GFID;
+        rc = unifyfs_create(*fshdl, 0, paths[i], &(gfids[i]));
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        created++;
+    }
+    ok(created == nfiles,
+       "%s:%d unifyfs_create() of %d files is successful: created=%d",
+       __FILE__, __LINE__, nfiles, created);
+
+    /* lookups by path */
+    int opened = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < created; i++) {
+        unifyfs_gfid gfid = UNIFYFS_INVALID_GFID;
+        rc = unifyfs_open(*fshdl, O_RDONLY, paths[i], &gfid);
+        if ((rc == UNIFYFS_SUCCESS) && (gfid == gfids[i])) {
+            opened++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ok(opened == created,
+       "%s:%d unifyfs_open() of %d files is successful: opened=%d",
+       __FILE__, __LINE__, created, opened);
+    diag("unifyfs_open() average time: %.3f usec",
+         (created ? elapsed_usecs(&start, &end) / created : 0.0));
+
+    /* lookups by gfid */
+    int statted = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < created; i++) {
+        unifyfs_file_status st;
+        rc = unifyfs_stat(*fshdl, gfids[i], &st);
+        if (rc == UNIFYFS_SUCCESS) {
+            statted++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ok(statted == created,
+       "%s:%d unifyfs_stat() of %d files is successful: statted=%d",
+       __FILE__, __LINE__, created, statted);
+    diag("unifyfs_stat() average time: %.3f usec",
+         (created ? elapsed_usecs(&start, &end) / created : 0.0));
+
+    int removed = 0;
+    for (i = 0; i < created; i++) {
+        rc = unifyfs_remove(*fshdl, paths[i]);
+        if (rc == UNIFYFS_SUCCESS) {
+            removed++;
+        }
+    }
+    ok(removed == created,
+       "%s:%d unifyfs_remove() of %d files is successful: removed=%d",
+       __FILE__, __LINE__, created, removed);
+
+    diag("Finished API file lookup tests");
+
+    //-------------
+
+    free(paths);
+    free(gfids);
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#!/bin/bash
+
+# This contains tests of shared files whose extent metadata is distributed
+# across servers by file offset range (i.e., meta.range_owners is on).
+#
+# Each process writes one block spanning several metadata ranges to a newly
+# created shared file, and syncs right away. The sync can reach some range
+# owners before the broadcast announcing the new file does, so this checks
+# that those range owners keep the extents and the data reads back.
+#
+# The servers must be started with UNIFYFS_META_RANGE_OWNERS=on, on more
+# than one host, otherwise these tests are skipped.
+
+test_description="Range Owner Tests"
+
+RANGE_OWNER_USAGE="$(cat <<EOF
+usage ./130-range-owner-tests.sh [options]
+
+  options:
+    -h, --help        print this (along with overall) help message
+
+Run the UnifyFS writeread example application on a shared file that spans
+several metadata ranges, syncing immediately after the file is created.
+Requires servers started with UNIFYFS_META_RANGE_OWNERS=on on more than one
+host.
+
+For more information on manually running tests, run './001-setup.sh -h'.
+EOF
+)"
+
+for arg in "$@"
+do
+    case $arg in
+        -h|--help)
+            echo "$RANGE_OWNER_USAGE"
+            ci_dir=$(dirname "$(readlink -fm $BASH_SOURCE)")
+            exit
+            ;;
+        *)
+            echo "$RANGE_OWNER_USAGE"
+            exit 1
+            ;;
+    esac
+done
+
+range_owners=$(echo "${UNIFYFS_META_RANGE_OWNERS:-off}" | tr 'A-Z' 'a-z')
+if [[ ! $range_owners =~ ^(on|yes|true|1)$ ]] || [ "$nnodes" -lt 2 ]; then
+    say "Skipping range owner tests (need UNIFYFS_META_RANGE_OWNERS=on" \
+        "and more than one host)"
+else
+    # metadata range size used by the servers (default is 1 MiB)
+    range_size=${UNIFYFS_META_RANGE_SIZE:-$MB}
+
+    # one block of four ranges per process, written a range at a time
+    app_name=writeread-gotcha
+    app_args="-p n1 -n 1 -c $range_size -b $((4 * $range_size))"
+
+    unify_run_test $app_name "$app_args" app_output
+    rc=$?
+    lcount=$(echo "$app_output" | wc -l)
+
+    test_expect_success "$app_name $app_args: (line_count=${lcount}, rc=$rc)" '
+        test $rc = 0 &&
+        test $lcount = 17
+    '
+fi
+
+unset range_owners
+unset range_size
@@ -230,6 +230,8 @@ if [ "$WRITEREAD" == "true" ]; then
 
     # POSIX-IO writeread example w/out laminate tests
     source $UNIFYFS_CI_DIR/100-writeread-tests.sh --shuffle
+    # POSIX-IO writeread example on a shared file distributed by range
+    source $UNIFYFS_CI_DIR/130-range-owner-tests.sh
     echo "Finished WRITEREAD-POSIX test suite"
   fi
 
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "extent_tree.h"
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+/*
+ * Test that chunk lists from an immutable extent index match the ones
+ * from the extent tree it was built from. The index merges runs that are
+ * contiguous in both the file and the log, so adjacent chunks are merged
+ * the same way on both sides before comparing.
+ */
+
+/* add an extent of len bytes at offset, with data at log_pos in the
+ * log of the given server rank and client */
+static void add_extent(struct extent_tree* tree,
+                       unsigned long offset,
+                       unsigned long len,
+                       unsigned long log_pos,
+                       int rank,
+                       int cli_id)
+{
+    struct extent_metadata ext = {
+        .start    = offset,
+        .end      = offset + len - 1,
+        .log_pos  = log_pos,
+        .svr_rank = rank,
+        .app_id   = 0,
+        .cli_id   = cli_id
+    };
+    int rc = extent_tree_add(tree, &ext);
+    ok(rc == 0, "%s:%d add extent [%lu-%lu] at log %lu (%d:%d): rc=%d",
+       __FILE__, __LINE__, ext.start, ext.end, log_pos, rank, cli_id, rc);
+}
+
+/* merge chunks that follow each other in both the file and the same log,
+ * returns the new number of chunks */
+static unsigned int merge_chunks(chunk_read_req_t* chunks, unsigned int n)
+{
+    unsigned int out = 0;
+    unsigned int i;
+    for (i = 0; i < n; i++) {
+        chunk_read_req_t* prev = chunks + out - 1;
+        chunk_read_req_t* curr = chunks + i;
+        if ((out > 0) &&
+            ((prev->offset + prev->nbytes) == curr->offset) &&
+            ((prev->log_offset + prev->nbytes) == curr->log_offset) &&
+            (prev->rank == curr->rank) &&
+            (prev->log_app_id == curr->log_app_id) &&
+            (prev->log_client_id == curr->log_client_id)) {
+            prev->nbytes += curr->nbytes;
+            continue;
+        }
+        chunks[out++] = *curr;
+    }
+    return out;
+}
+
+/* look up [offset, offset+len) in both the tree and the index,
+ * returns 0 if the results match, or 1 after printing a diagnostic */
+static int compare_lookup(struct extent_tree* tree,
+                          struct extent_index* index,
+                          unsigned long offset,
+                          unsigned long len)
+{
+    unsigned int tree_n = 0;
+    unsigned int index_n = 0;
+    chunk_read_req_t* tree_chunks = NULL;
+    chunk_read_req_t* index_chunks = NULL;
+    int tree_covered = -1;
+    int index_covered = -1;
+    int mismatch = 0;
+
+    int tree_rc = extent_tree_get_chunk_list(tree, offset, len,
+                                             &tree_n, &tree_chunks,
+                                             &tree_covered);
+    int index_rc = extent_index_get_chunk_list(index, offset, len,
+                                               &index_n, &index_chunks,
+                                               &index_covered);
+    if ((tree_rc != 0) || (index_rc != 0)) {
+        diag("[%lu+%lu] tree rc=%d, index rc=%d",
+             offset, len, tree_rc, index_rc);
+        mismatch = 1;
+        goto out;
+    }
+
+    if (tree_covered != index_covered) {
+        diag("[%lu+%lu] tree covered=%d, index covered=%d",
+             offset, len, tree_covered, index_covered);
+        mismatch = 1;
+        goto out;
+    }
+
+    tree_n = merge_chunks(tree_chunks, tree_n);
+    index_n = merge_chunks(index_chunks, index_n);
+    if (tree_n != index_n) {
+        diag("[%lu+%lu] tree has %u chunks, index has %u",
+             offset, len, tree_n, index_n);
+        mismatch = 1;
+        goto out;
+    }
+
+    unsigned int i;
+    for (i = 0; i < tree_n; i++) {
+        chunk_read_req_t* t = tree_chunks + i;
+        chunk_read_req_t* x = index_chunks + i;
+        if ((t->offset != x->offset) ||
+            (t->nbytes != x->nbytes) ||
+            (t->log_offset != x->log_offset) ||
+            (t->rank != x->rank) ||
+            (t->log_app_id != x->log_app_id) ||
+            (t->log_client_id != x->log_client_id)) {
+            diag("[%lu+%lu] chunk %u: tree [%zu+%zu] at log %zu (%d:%d), "
+                 "index [%zu+%zu] at log %zu (%d:%d)",
+                 offset, len, i,
+                 t->offset, t->nbytes, t->log_offset,
+                 t->rank, t->log_client_id,
+                 x->offset, x->nbytes, x->log_offset,
+                 x->rank, x->log_client_id);
+            mismatch = 1;
+            break;
+        }
+    }
+
+out:
+    free(tree_chunks);
+    free(index_chunks);
+    return mismatch;
+}
+
+/* compare the tree and its index for every range that starts and ends
+ * within [0, limit), which should extend past the last extent */
+static void compare_all_ranges(struct extent_tree* tree,
+                               unsigned long limit,
+                               const char* name)
+{
+    struct extent_index* index = NULL;
+    int rc = extent_index_create(tree, &index);
+    ok(rc == 0 && index != NULL, "%s:%d %s: create index: rc=%d",
+       __FILE__, __LINE__, name, rc);
+    if (NULL == index) {
+        return;
+    }
+
+    ok(extent_index_count(index) <= extent_tree_count(tree),
+       "%s:%d %s: index has %lu extents, tree has %lu",
+       __FILE__, __LINE__, name,
+       extent_index_count(index), extent_tree_count(tree));
+
+    unsigned long offset, len;
+    int mismatches = 0;
+    for (offset = 0; offset < limit; offset++) {
+        for (len = 1; (offset + len) <= limit; len++) {
+            mismatches += compare_lookup(tree, index, offset, len);
+        }
+    }
+    ok(mismatches == 0, "%s:%d %s: all ranges below %lu match: "
+       "%d mismatches", __FILE__, __LINE__, name, limit, mismatches);
+
+    extent_index_destroy(index);
+}
+
+/* check the chunks returned by the index for one range */
+static void check_index_lookup(struct extent_tree* tree,
+                               unsigned long offset,
+                               unsigned long len,
+                               unsigned int expect_n,
+                               int expect_covered)
+{
+    struct extent_index* index = NULL;
+    unsigned int n = 0;
+    chunk_read_req_t* chunks = NULL;
+    int covered = -1;
+
+    int rc = extent_index_create(tree, &index);
+    if (0 == rc) {
+        rc = extent_index_get_chunk_list(index, offset, len,
+                                         &n, &chunks, &covered);
+    }
+    ok(rc == 0 && n == expect_n && covered == expect_covered,
+       "%s:%d index lookup [%lu+%lu]: rc=%d, %u chunks (expected %u), "
+       "covered=%d (expected %d)", __FILE__, __LINE__, offset, len,
+       rc, n, expect_n, covered, expect_covered);
+
+    free(chunks);
+    extent_index_destroy(index);
+}
+
+int main(int argc, char** argv)
+{
+    struct extent_tree tree;
+
+    plan(NO_PLAN);
+
+    ok(extent_tree_init(&tree) == 0, "%s:%d init extent tree",
+       __FILE__, __LINE__);
+
+    /* an empty file has nothing to find */
+    compare_all_ranges(&tree, 8, "empty");
+    check_index_lookup(&tree, 0, 1, 0, 0);
+
+    /* one byte at the start of the file */
+    add_extent(&tree, 0, 1, 100, 0, 0);
+    compare_all_ranges(&tree, 4, "single byte");
+    check_index_lookup(&tree, 0, 1, 1, 1);
+    check_index_lookup(&tree, 0, 2, 1, 0);
+    check_index_lookup(&tree, 1, 1, 0, 0);
+
+    /*
+     * Build up a file with gaps, single byte extents, several logs and
+     * overwrites that split earlier extents:
+     *
+     *   [0]        1 byte, log 0:0
+     *   [4-11]     log 0:0, then [6-7] overwritten from log 1:0
+     *   [12-15]    log 0:0, contiguous in the log with [8-11]
+     *   [17]       1 byte, log 1:1
+     *   [18]       1 byte, log 1:1, contiguous with [17]
+     *   [20]       1 byte, log 0:1
+     *   [24-39]    log 0:0, then [28-35] overwritten by four 2 byte
+     *              extents alternating between two logs
+     *   [40]       1 byte, log 1:0
+     *   [47]       1 byte at the end of the file, log 0:0
+     */
+    add_extent(&tree, 4, 8, 200, 0, 0);
+    add_extent(&tree, 6, 2, 300, 1, 0);
+    add_extent(&tree, 12, 4, 208, 0, 0);
+    add_extent(&tree, 17, 1, 400, 1, 1);
+    add_extent(&tree, 18, 1, 401, 1, 1);
+    add_extent(&tree, 20, 1, 500, 0, 1);
+    add_extent(&tree, 24, 16, 600, 0, 0);
+    add_extent(&tree, 28, 2, 700, 1, 0);
+    add_extent(&tree, 30, 2, 800, 0, 1);
+    add_extent(&tree, 32, 2, 702, 1, 0);
+    add_extent(&tree, 34, 2, 802, 0, 1);
+    add_extent(&tree, 40, 1, 900, 1, 0);
+    add_extent(&tree, 47, 1, 1000, 0, 0);
+
+    compare_all_ranges(&tree, 52, "gaps");
+
+    /* start, end and single bytes of the file */
+    check_index_lookup(&tree, 0, 1, 1, 1);
+    check_index_lookup(&tree, 0, 48, 14, 0);
+    check_index_lookup(&tree, 47, 1, 1, 1);
+    check_index_lookup(&tree, 46, 2, 1, 0);
+    check_index_lookup(&tree, 47, 4, 1, 0);
+    check_index_lookup(&tree, 48, 1, 0, 0);
+    check_index_lookup(&tree, 17, 2, 1, 1);
+    check_index_lookup(&tree, 19, 1, 0, 0);
+    check_index_lookup(&tree, 20, 1, 1, 1);
+
+    /* covered runs that span several logs */
+    check_index_lookup(&tree, 4, 12, 3, 1);
+    check_index_lookup(&tree, 24, 17, 7, 1);
+
+    /* a gap that falls between chunks of the range */
+    check_index_lookup(&tree, 15, 6, 3, 0);
+
+    extent_tree_destroy(&tree);
+
+    done_testing();
+
+    return 0;
+}
@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "unifyfs_configurator.h"
+#include "unifyfs_logio.h"
+#include "unifyfs_rc.h"
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+/*
+ * Test client log initialization for chunk and spill sizes whose log
+ * header needs one or more pages, then write and read back data in the
+ * last chunk of the log. The spill file header must be mapped in full
+ * by the client that initializes it and the server that attaches to it,
+ * so the expected header size is checked and the server reads back and
+ * frees the data.
+ */
+
+static char spill_dir[] = "/tmp/unifyfs-logio-test.XXXXXX";
+
+static void test_spill_log(int client_id,
+                           size_t chunk_size,
+                           size_t spill_size,
+                           size_t hdr_pages)
+{
+    char chunk_str[32];
+    char spill_str[32];
+    char path[256];
+    unifyfs_cfg_t cfg;
+    logio_context* ctx = NULL;
+    off_t shmem_sz = 0;
+    off_t data_sz = 0;
+    off_t first_off = -1;
+    off_t last_off = -1;
+    size_t nbytes = 0;
+    int rc;
+
+    snprintf(chunk_str, sizeof(chunk_str), "%zu", chunk_size);
+    snprintf(spill_str, sizeof(spill_str), "%zu", spill_size);
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.logio_chunk_size = chunk_str;
+    cfg.logio_spill_size = spill_str;
+    cfg.logio_spill_dir = spill_dir;
+
+    rc = unifyfs_logio_init_client((int)getpid(), client_id, &cfg, &ctx);
+    ok(rc == UNIFYFS_SUCCESS,
+       "%s:%d logio init with chunk=%zu spill=%zu: rc=%d",
+       __FILE__, __LINE__, chunk_size, spill_size, rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        return;
+    }
+
+    rc = unifyfs_logio_get_sizes(ctx, &shmem_sz, &data_sz);
+    ok((rc == UNIFYFS_SUCCESS) && (data_sz > 0) &&
+       ((size_t)data_sz <= spill_size) && ((data_sz % chunk_size) == 0),
+       "%s:%d spill data size %zu is a multiple of the chunk size",
+       __FILE__, __LINE__, (size_t)data_sz);
+
+    /* reserve every chunk, so the last one is used as well */
+    size_t n_chunks = (size_t)data_sz / chunk_size;
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &first_off);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc first chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    if (n_chunks > 2) {
+        off_t mid_off;
+        size_t mid_bytes = (n_chunks - 2) * chunk_size;
+        rc = unifyfs_logio_alloc(ctx, mid_bytes, &mid_off);
+        ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc %zu middle chunks: rc=%d",
+           __FILE__, __LINE__, n_chunks - 2, rc);
+    }
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &last_off);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc last chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    off_t extra_off;
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &extra_off);
+    ok(rc != UNIFYFS_SUCCESS, "%s:%d alloc beyond log size fails: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    /* write and read back the end of the last chunk */
+    char wbuf[4096];
+    char rbuf[4096];
+    for (size_t i = 0; i < sizeof(wbuf); i++) {
+        wbuf[i] = (char)('a' + (i % 26));
+    }
+    off_t io_off = last_off + (off_t)(chunk_size - sizeof(wbuf));
+    rc = unifyfs_logio_write(ctx, io_off, sizeof(wbuf), wbuf, &nbytes);
+    ok((rc == UNIFYFS_SUCCESS) && (nbytes == sizeof(wbuf)),
+       "%s:%d write end of last chunk: rc=%d", __FILE__, __LINE__, rc);
+
+    memset(rbuf, 0, sizeof(rbuf));
+    rc = unifyfs_logio_read(ctx, io_off, sizeof(rbuf), rbuf, &nbytes);
+    ok((rc == UNIFYFS_SUCCESS) && (nbytes == sizeof(rbuf)) &&
+       (memcmp(wbuf, rbuf, sizeof(rbuf)) == 0),
+       "%s:%d read end of last chunk: rc=%d", __FILE__, __LINE__, rc);
+
+    /* the log header size is the first field of the spill file */
+    size_t pgsz = (size_t) sysconf(_SC_PAGESIZE);
+    size_t hdr_sz = 0;
+    snprintf(path, sizeof(path), "%s/logio_spill.%d.%d",
+             spill_dir, (int)getpid(), client_id);
+    int fd = open(path, O_RDONLY);
+    if (fd != -1) {
+        if (pread(fd, &hdr_sz, sizeof(hdr_sz), 0) != sizeof(hdr_sz)) {
+            hdr_sz = 0;
+        }
+        close(fd);
+    }
+    ok(hdr_sz == (hdr_pages * pgsz),
+       "%s:%d spill header size %zu is %zu pages",
+       __FILE__, __LINE__, hdr_sz, hdr_pages);
+
+    /* server attaches to the spill file, reads the data, and frees it */
+    logio_context* svr_ctx = NULL;
+    rc = unifyfs_logio_init((int)getpid(), client_id, 0, spill_size,
+                            spill_dir, &svr_ctx);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d server logio init: rc=%d",
+       __FILE__, __LINE__, rc);
+    if (rc == UNIFYFS_SUCCESS) {
+        memset(rbuf, 0, sizeof(rbuf));
+        rc = unifyfs_logio_read(svr_ctx, io_off, sizeof(rbuf), rbuf,
+                                &nbytes);
+        ok((rc == UNIFYFS_SUCCESS) && (nbytes == sizeof(rbuf)) &&
+           (memcmp(wbuf, rbuf, sizeof(rbuf)) == 0),
+           "%s:%d server read end of last chunk: rc=%d",
+           __FILE__, __LINE__, rc);
+
+        rc = unifyfs_logio_free(svr_ctx, last_off, chunk_size);
+        ok(rc == UNIFYFS_SUCCESS, "%s:%d server free last chunk: rc=%d",
+           __FILE__, __LINE__, rc);
+
+        rc = unifyfs_logio_close(svr_ctx, 0);
+        ok(rc == UNIFYFS_SUCCESS, "%s:%d server logio close: rc=%d",
+           __FILE__, __LINE__, rc);
+    }
+
+    /* the chunk freed by the server is available to the client again */
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &extra_off);
+    ok((rc == UNIFYFS_SUCCESS) && (extra_off == last_off),
+       "%s:%d realloc last chunk freed by server: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    rc = unifyfs_logio_free(ctx, first_off, (size_t)data_sz);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d free all chunks: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    rc = unifyfs_logio_close(ctx, 1);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d logio close: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    unlink(path);
+}
+
+/* open a spill-only client log with 16 chunks of the given size */
+static logio_context* open_small_log(int client_id,
+                                     size_t chunk_size)
+{
+    char chunk_str[32];
+    char spill_str[32];
+    unifyfs_cfg_t cfg;
+    logio_context* ctx = NULL;
+
+    snprintf(chunk_str, sizeof(chunk_str), "%zu", chunk_size);
+    snprintf(spill_str, sizeof(spill_str), "%zu", 16 * chunk_size);
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.logio_chunk_size = chunk_str;
+    cfg.logio_spill_size = spill_str;
+    cfg.logio_spill_dir = spill_dir;
+
+    int rc = unifyfs_logio_init_client((int)getpid(), client_id, &cfg, &ctx);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d logio init with chunk=%zu: rc=%d",
+       __FILE__, __LINE__, chunk_size, rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        return NULL;
+    }
+    return ctx;
+}
+
+static void close_small_log(int client_id,
+                            logio_context* ctx)
+{
+    char path[256];
+
+    int rc = unifyfs_logio_close(ctx, 1);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d logio close: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    snprintf(path, sizeof(path), "%s/logio_spill.%d.%d",
+             spill_dir, (int)getpid(), client_id);
+    unlink(path);
+}
+
+/* count the chunks that are not reserved, by reserving them one at
+ * a time and then releasing them again */
+static size_t count_free_chunks(logio_context* ctx,
+                                size_t chunk_size)
+{
+    off_t offs[64];
+    size_t n = 0;
+    while ((n < 64) &&
+           (unifyfs_logio_alloc(ctx, chunk_size, offs + n) ==
+            UNIFYFS_SUCCESS)) {
+        n++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        unifyfs_logio_free(ctx, offs[i], chunk_size);
+    }
+    return n;
+}
+
+/*
+ * Test packing of small allocations into the shared open chunk. A packed
+ * chunk tracks its live bytes, stays reserved while any are allocated,
+ * and is released once all have been freed (unless it is still the open
+ * chunk, which is then reused from its start).
+ */
+static void test_packed_allocs(int client_id)
+{
+    size_t chunk_size = 65536;
+    size_t half = chunk_size / 2;
+    off_t a, b, c, d, e;
+    int rc;
+
+    logio_context* ctx = open_small_log(client_id, chunk_size);
+    if (NULL == ctx) {
+        return;
+    }
+    size_t total = count_free_chunks(ctx, chunk_size);
+    ok(total > 4, "%s:%d log has %zu free chunks",
+       __FILE__, __LINE__, total);
+
+    /* small allocations are packed back to back into one chunk */
+    rc = unifyfs_logio_alloc(ctx, 1000, &a);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc 1000 bytes: rc=%d",
+       __FILE__, __LINE__, rc);
+    rc = unifyfs_logio_alloc(ctx, 2000, &b);
+    ok((rc == UNIFYFS_SUCCESS) && (b == (a + 1000)),
+       "%s:%d alloc 2000 bytes packed after first: off=%zu",
+       __FILE__, __LINE__, (size_t)b);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 1),
+       "%s:%d packed allocations use one chunk", __FILE__, __LINE__);
+
+    /* the chunk stays reserved while any of its bytes are live, including
+     * after frees of parts of an allocation */
+    unifyfs_logio_free(ctx, a, 1000);
+    unifyfs_logio_free(ctx, b, 500);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 1),
+       "%s:%d chunk with live bytes stays reserved", __FILE__, __LINE__);
+    unifyfs_logio_free(ctx, b + 500, 1500);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 1),
+       "%s:%d open chunk stays reserved when empty", __FILE__, __LINE__);
+
+    /* the empty open chunk is reused from its start */
+    rc = unifyfs_logio_alloc(ctx, 100, &c);
+    ok((rc == UNIFYFS_SUCCESS) && (c == a),
+       "%s:%d empty open chunk is reused: off=%zu",
+       __FILE__, __LINE__, (size_t)c);
+
+    /* an allocation that does not fit opens a new chunk */
+    rc = unifyfs_logio_alloc(ctx, half, &d);
+    ok((rc == UNIFYFS_SUCCESS) && (d == (c + 100)),
+       "%s:%d alloc half chunk packed after: off=%zu",
+       __FILE__, __LINE__, (size_t)d);
+    rc = unifyfs_logio_alloc(ctx, half, &e);
+    ok((rc == UNIFYFS_SUCCESS) &&
+       ((e / (off_t)chunk_size) != (c / (off_t)chunk_size)),
+       "%s:%d alloc that does not fit opens a new chunk: off=%zu",
+       __FILE__, __LINE__, (size_t)e);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 2),
+       "%s:%d two packed chunks reserved", __FILE__, __LINE__);
+
+    /* the previous chunk is released once its live bytes are freed */
+    unifyfs_logio_free(ctx, c, 100);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 2),
+       "%s:%d chunk with live bytes stays reserved", __FILE__, __LINE__);
+    unifyfs_logio_free(ctx, d, half);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 1),
+       "%s:%d chunk is released when its live count reaches zero",
+       __FILE__, __LINE__);
+
+    unifyfs_logio_free(ctx, e, half);
+    close_small_log(client_id, ctx);
+}
+
+/*
+ * Test a free that spans the end of a packed chunk and the following
+ * whole-chunk allocation (as when adjacent extents are freed together).
+ * The whole chunk is released, while the packed chunk only loses the
+ * freed bytes.
+ */
+static void test_packed_whole_free(int client_id)
+{
+    size_t chunk_size = 65536;
+    size_t half = chunk_size / 2;
+    off_t p, q, w, x;
+    int rc;
+
+    logio_context* ctx = open_small_log(client_id, chunk_size);
+    if (NULL == ctx) {
+        return;
+    }
+    size_t total = count_free_chunks(ctx, chunk_size);
+
+    /* fill a packed chunk with two halves, then take the next chunk */
+    rc = unifyfs_logio_alloc(ctx, half, &p);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc half chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    rc = unifyfs_logio_alloc(ctx, half, &q);
+    ok((rc == UNIFYFS_SUCCESS) && (q == (p + (off_t)half)),
+       "%s:%d alloc second half chunk: off=%zu",
+       __FILE__, __LINE__, (size_t)q);
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &w);
+    ok((rc == UNIFYFS_SUCCESS) && (w == (p + (off_t)chunk_size)),
+       "%s:%d alloc whole chunk after packed chunk: off=%zu",
+       __FILE__, __LINE__, (size_t)w);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 2),
+       "%s:%d packed and whole chunk reserved", __FILE__, __LINE__);
+
+    /* free the second half and the whole chunk in one call */
+    rc = unifyfs_logio_free(ctx, q, half + chunk_size);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d free across chunk boundary: rc=%d",
+       __FILE__, __LINE__, rc);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 1),
+       "%s:%d whole chunk released, packed chunk kept",
+       __FILE__, __LINE__);
+
+    /* the packed chunk is still full, so the next packed allocation
+     * opens a new chunk rather than overwriting the live first half */
+    rc = unifyfs_logio_alloc(ctx, 100, &x);
+    ok((rc == UNIFYFS_SUCCESS) &&
+       ((x / (off_t)chunk_size) != (p / (off_t)chunk_size)),
+       "%s:%d packed alloc avoids live bytes: off=%zu",
+       __FILE__, __LINE__, (size_t)x);
+
+    /* once no longer open, freeing the first half releases the chunk */
+    unifyfs_logio_free(ctx, p, half);
+    ok(count_free_chunks(ctx, chunk_size) == (total - 1),
+       "%s:%d packed chunk released after last free",
+       __FILE__, __LINE__);
+
+    unifyfs_logio_free(ctx, x, 100);
+    close_small_log(client_id, ctx);
+}
+
+/*
+ * Test that chunks holding directly mapped data are not released and
+ * reused until they are unpinned, even though their data was freed.
+ */
+static void test_pinned_chunks(int client_id)
+{
+    char path[256];
+    unifyfs_cfg_t cfg;
+    logio_context* ctx = NULL;
+    off_t data_off = -1;
+    off_t other_off = -1;
+    size_t chunk_size = 65536;
+    size_t nbytes = 0;
+    int rc;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.logio_chunk_size = "65536";
+    cfg.logio_spill_size = "1048576";
+    cfg.logio_spill_dir = spill_dir;
+
+    rc = unifyfs_logio_init_client((int)getpid(), client_id, &cfg, &ctx);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d logio init: rc=%d",
+       __FILE__, __LINE__, rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        return;
+    }
+
+    char* wbuf = (char*) malloc(chunk_size);
+    for (size_t i = 0; i < chunk_size; i++) {
+        wbuf[i] = (char)('a' + (i % 26));
+    }
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &data_off);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    rc = unifyfs_logio_write(ctx, data_off, chunk_size, wbuf, &nbytes);
+    ok((rc == UNIFYFS_SUCCESS) && (nbytes == chunk_size),
+       "%s:%d write chunk: rc=%d", __FILE__, __LINE__, rc);
+
+    void* addr = NULL;
+    rc = unifyfs_logio_map(ctx, data_off, chunk_size, PROT_READ, &addr);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d map chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    if (rc != UNIFYFS_SUCCESS) {
+        addr = NULL;
+    }
+
+    /* the mapped chunk stays reserved after its data is freed */
+    rc = unifyfs_logio_free(ctx, data_off, chunk_size);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d free mapped chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &other_off);
+    ok((rc == UNIFYFS_SUCCESS) && (other_off != data_off),
+       "%s:%d alloc does not reuse mapped chunk: off=%zu",
+       __FILE__, __LINE__, (size_t)other_off);
+
+    char* zbuf = (char*) calloc(1, chunk_size);
+    rc = unifyfs_logio_write(ctx, other_off, chunk_size, zbuf, &nbytes);
+    ok((rc == UNIFYFS_SUCCESS) && (nbytes == chunk_size),
+       "%s:%d write other chunk: rc=%d", __FILE__, __LINE__, rc);
+    if (NULL != addr) {
+        ok(memcmp(addr, wbuf, chunk_size) == 0,
+           "%s:%d mapped data is unchanged", __FILE__, __LINE__);
+        munmap(addr, chunk_size);
+    }
+    rc = unifyfs_logio_free(ctx, other_off, chunk_size);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d free other chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    /* dropping the last pin releases the freed chunk */
+    rc = unifyfs_logio_unpin(ctx, data_off, chunk_size);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d unpin chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    off_t sizes_off = 0;
+    off_t sizes_data = 0;
+    unifyfs_logio_get_sizes(ctx, &sizes_off, &sizes_data);
+    size_t n_chunks = (size_t)sizes_data / chunk_size;
+    off_t off;
+    rc = unifyfs_logio_alloc(ctx, n_chunks * chunk_size, &off);
+    ok(rc == UNIFYFS_SUCCESS,
+       "%s:%d alloc of all %zu chunks after unpin: rc=%d",
+       __FILE__, __LINE__, n_chunks, rc);
+    if (rc == UNIFYFS_SUCCESS) {
+        unifyfs_logio_free(ctx, off, n_chunks * chunk_size);
+    }
+
+    /* pinning unreleased data does not release it on unpin */
+    rc = unifyfs_logio_alloc(ctx, chunk_size, &data_off);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d alloc chunk: rc=%d",
+       __FILE__, __LINE__, rc);
+    unifyfs_logio_pin(ctx, data_off, chunk_size);
+    unifyfs_logio_unpin(ctx, data_off, chunk_size);
+    rc = unifyfs_logio_alloc(ctx, n_chunks * chunk_size, &off);
+    ok(rc != UNIFYFS_SUCCESS,
+       "%s:%d unpin keeps allocated chunk reserved: rc=%d",
+       __FILE__, __LINE__, rc);
+    unifyfs_logio_free(ctx, data_off, chunk_size);
+
+    free(zbuf);
+    free(wbuf);
+
+    rc = unifyfs_logio_close(ctx, 1);
+    ok(rc == UNIFYFS_SUCCESS, "%s:%d logio close: rc=%d",
+       __FILE__, __LINE__, rc);
+
+    snprintf(path, sizeof(path), "%s/logio_spill.%d.%d",
+             spill_dir, (int)getpid(), client_id);
+    unlink(path);
+}
+
+int main(int argc, char** argv)
+{
+    plan(NO_PLAN);
+
+    if (NULL == mkdtemp(spill_dir)) {
+        BAIL_OUT("ERROR: mkdtemp(%s) failed!\n", spill_dir);
+    }
+
+    /* header fits in one page */
+    test_spill_log(0, (size_t)1 * MIB, (size_t)64 * MIB, 1);
+
+    /* at 489 and 490 chunks, the chunk live byte and pin counts and
+     * chunk slot map just fill or just overflow the first header page */
+    test_spill_log(1, (size_t)4 * MIB, (size_t)1960 * MIB, 1);
+    test_spill_log(3, (size_t)4 * MIB, (size_t)1964 * MIB, 2);
+
+    /* many small chunks need several header pages */
+    test_spill_log(2, 4096, (size_t)256 * MIB, 130);
+
+    test_packed_allocs(5);
+    test_packed_whole_free(6);
+
+    test_pinned_chunks(4);
+
+    rmdir(spill_dir);
+
+    done_testing();
+
+    return 0;
+}
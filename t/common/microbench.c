@@ -0,0 +1,655 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Microbenchmarks for the core data structures: the segment tree used by
+ * clients, the server extent tree, the slot map, and the log-based I/O
+ * context. Each operation is timed with one or more threads sharing the
+ * structure under test, using sequential, strided, or random offsets.
+ *
+ * Results are written to stdout as CSV, one row per timed operation:
+ *   benchmark,operation,pattern,threads,ops,size,wall_ns,ops_per_sec,
+ *   mean_ns,errors
+ * where ops is the total across all threads, wall_ns is the time from the
+ * first thread starting to the last one finishing, and mean_ns is the
+ * average time a thread spent per operation.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "extent_tree.h"
+#include "seg_tree.h"
+#include "slotmap.h"
+#include "unifyfs_configurator.h"
+#include "unifyfs_const.h"
+#include "unifyfs_logio.h"
+
+#define MAX_THREAD_COUNTS 16
+
+/* stride (in operations) between consecutive accesses of the strided
+ * pattern for slot releases and log reads */
+#define ORDER_STRIDE 16
+
+typedef enum {
+    PATTERN_SEQUENTIAL = 0,
+    PATTERN_STRIDED,
+    PATTERN_RANDOM,
+    PATTERN_COUNT
+} bench_pattern;
+
+static const char* pattern_names[PATTERN_COUNT] = {
+    "sequential",
+    "strided",
+    "random"
+};
+
+typedef struct bench_run bench_run;
+typedef struct bench_thread bench_thread;
+
+/* perform operation i of the calling thread,
+ * returns 0 on success or an error code */
+typedef int (*bench_op_fn)(bench_run* run, bench_thread* thrd, size_t i);
+
+struct bench_thread {
+    pthread_t tid;
+    int rank;
+    bench_run* run;
+    unsigned int rng;      /* random state for the random pattern */
+    size_t* order;         /* per-pattern order of item accesses */
+    unsigned long* items;  /* slots or log offsets from the prior phase */
+    char* buf;             /* data buffer for log reads and writes */
+    uint64_t start_ns;
+    uint64_t end_ns;
+    size_t errors;
+};
+
+struct bench_run {
+    const char* bench;
+    bench_pattern pattern;
+    int nthreads;
+    size_t nops;           /* operations per thread */
+    size_t size;           /* bytes per extent, log allocation */
+    bench_op_fn op;
+    pthread_barrier_t barrier;
+    bench_thread* threads;
+
+    /* structure under test */
+    struct seg_tree seg_tree;
+    struct extent_tree extent_tree;
+    slot_map* smap;
+    pthread_mutex_t smap_lock;
+    logio_context* logio;
+};
+
+static unsigned int rand_seed = 12345678;
+static int total_errors; // = 0
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* file offset of operation i of the thread for tree benchmarks:
+ *   sequential - each thread appends to its own region of the file
+ *   strided    - threads interleave fixed-size blocks (N-to-1 strided)
+ *   random     - random blocks across the file, so writes overlap */
+static unsigned long bench_offset(bench_run* run, bench_thread* thrd,
+                                  size_t i)
+{
+    size_t block;
+    switch (run->pattern) {
+    case PATTERN_SEQUENTIAL:
+        block = ((size_t)thrd->rank * run->nops) + i;
+        break;
+    case PATTERN_STRIDED:
+        block = (i * (size_t)run->nthreads) + (size_t)thrd->rank;
+        break;
+    default:
+        block = (size_t)rand_r(&(thrd->rng)) %
+                (run->nops * (size_t)run->nthreads);
+        break;
+    }
+    return (unsigned long)(block * run->size);
+}
+
+/* log position of operation i of the thread, each thread writes its
+ * own contiguous region of the log */
+static unsigned long bench_log_pos(bench_run* run, bench_thread* thrd,
+                                   size_t i)
+{
+    return (unsigned long)((((size_t)thrd->rank * run->nops) + i) *
+                           run->size);
+}
+
+/* fill in the order in which a thread visits the items of a prior
+ * phase (e.g., slots to release or log offsets to read) */
+static void bench_order_init(bench_run* run, bench_thread* thrd)
+{
+    size_t n = run->nops;
+    size_t k = 0;
+    switch (run->pattern) {
+    case PATTERN_SEQUENTIAL:
+        for (size_t i = 0; i < n; i++) {
+            thrd->order[i] = i;
+        }
+        break;
+    case PATTERN_STRIDED:
+        for (size_t r = 0; r < ORDER_STRIDE; r++) {
+            for (size_t i = r; i < n; i += ORDER_STRIDE) {
+                thrd->order[k++] = i;
+            }
+        }
+        break;
+    default:
+        for (size_t i = 0; i < n; i++) {
+            thrd->order[i] = i;
+        }
+        for (size_t i = n; i > 1; i--) {
+            size_t j = (size_t)rand_r(&(thrd->rng)) % i;
+            size_t tmp = thrd->order[i - 1];
+            thrd->order[i - 1] = thrd->order[j];
+            thrd->order[j] = tmp;
+        }
+        break;
+    }
+}
+
+static void* bench_thread_main(void* arg)
+{
+    bench_thread* thrd = (bench_thread*) arg;
+    bench_run* run = thrd->run;
+
+    pthread_barrier_wait(&(run->barrier));
+    thrd->start_ns = now_ns();
+    for (size_t i = 0; i < run->nops; i++) {
+        if (run->op(run, thrd, i) != 0) {
+            thrd->errors++;
+        }
+    }
+    thrd->end_ns = now_ns();
+    return NULL;
+}
+
+/* time one operation across all threads of the run and report it */
+static void run_phase(bench_run* run, const char* opname, bench_op_fn op)
+{
+    run->op = op;
+    pthread_barrier_init(&(run->barrier), NULL, (unsigned)run->nthreads);
+    for (int t = 0; t < run->nthreads; t++) {
+        bench_thread* thrd = run->threads + t;
+        thrd->errors = 0;
+        int rc = pthread_create(&(thrd->tid), NULL, bench_thread_main, thrd);
+        if (rc != 0) {
+            fprintf(stderr, "ERROR: pthread_create() failed - %s\n",
+                    strerror(rc));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    uint64_t first_start = UINT64_MAX;
+    uint64_t last_end = 0;
+    uint64_t busy_ns = 0;
+    size_t errors = 0;
+    for (int t = 0; t < run->nthreads; t++) {
+        bench_thread* thrd = run->threads + t;
+        pthread_join(thrd->tid, NULL);
+        if (thrd->start_ns < first_start) {
+            first_start = thrd->start_ns;
+        }
+        if (thrd->end_ns > last_end) {
+            last_end = thrd->end_ns;
+        }
+        busy_ns += thrd->end_ns - thrd->start_ns;
+        errors += thrd->errors;
+    }
+    pthread_barrier_destroy(&(run->barrier));
+
+    size_t total_ops = run->nops * (size_t)run->nthreads;
+    uint64_t wall_ns = last_end - first_start;
+    double ops_per_sec = 0.0;
+    if (wall_ns) {
+        ops_per_sec = ((double)total_ops * 1e9) / (double)wall_ns;
+    }
+    double mean_ns = (double)busy_ns / (double)total_ops;
+    printf("%s,%s,%s,%d,%zu,%zu,%llu,%.1f,%.1f,%zu\n",
+           run->bench, opname, pattern_names[run->pattern], run->nthreads,
+           total_ops, run->size, (unsigned long long)wall_ns,
+           ops_per_sec, mean_ns, errors);
+    fflush(stdout);
+
+    if (errors) {
+        total_errors++;
+    }
+}
+
+/* ------------------------------ seg_tree ------------------------------ */
+
+static int seg_tree_add_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    unsigned long start = bench_offset(run, thrd, i);
+    unsigned long end = start + run->size - 1;
+    return seg_tree_add(&(run->seg_tree), start, end,
+                        bench_log_pos(run, thrd, i), thrd->rank);
+}
+
+static int seg_tree_find_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    unsigned long start = bench_offset(run, thrd, i);
+    unsigned long end = start + run->size - 1;
+    struct seg_tree_node* node = seg_tree_find(&(run->seg_tree), start, end);
+    return ((NULL == node) && (run->pattern != PATTERN_RANDOM)) ? ENOENT : 0;
+}
+
+static void bench_seg_tree(bench_run* run)
+{
+    int rc = seg_tree_init(&(run->seg_tree));
+    if (rc != 0) {
+        fprintf(stderr, "ERROR: seg_tree_init() failed (rc=%d)\n", rc);
+        total_errors++;
+        return;
+    }
+    run_phase(run, "add", seg_tree_add_op);
+    run_phase(run, "find", seg_tree_find_op);
+    seg_tree_destroy(&(run->seg_tree));
+}
+
+/* ----------------------------- extent_tree ---------------------------- */
+
+static int extent_tree_add_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    struct extent_metadata extent;
+    extent.start = bench_offset(run, thrd, i);
+    extent.end = extent.start + run->size - 1;
+    extent.log_pos = bench_log_pos(run, thrd, i);
+    extent.svr_rank = 0;
+    extent.app_id = 0;
+    extent.cli_id = thrd->rank;
+    return extent_tree_add(&(run->extent_tree), &extent);
+}
+
+static int extent_tree_chunks_op(bench_run* run, bench_thread* thrd,
+                                 size_t i)
+{
+    unsigned int n_chunks = 0;
+    chunk_read_req_t* chunks = NULL;
+    int covered = 0;
+    int rc = extent_tree_get_chunk_list(&(run->extent_tree),
+                                        bench_offset(run, thrd, i),
+                                        run->size, &n_chunks, &chunks,
+                                        &covered);
+    free(chunks);
+    return rc;
+}
+
+static void bench_extent_tree(bench_run* run)
+{
+    int rc = extent_tree_init(&(run->extent_tree));
+    if (rc != 0) {
+        fprintf(stderr, "ERROR: extent_tree_init() failed (rc=%d)\n", rc);
+        total_errors++;
+        return;
+    }
+    run_phase(run, "add", extent_tree_add_op);
+    run_phase(run, "get_chunk_list", extent_tree_chunks_op);
+    extent_tree_destroy(&(run->extent_tree));
+}
+
+/* ------------------------------- slotmap ------------------------------ */
+
+/* reservations vary in size, as log allocations do */
+#define slots_for_item(i) (1 + ((i) % 8))
+
+static int slotmap_reserve_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    /* like the log chunk map, the slot map is shared under a lock */
+    pthread_mutex_lock(&(run->smap_lock));
+    ssize_t slot = slotmap_reserve(run->smap, slots_for_item(i));
+    pthread_mutex_unlock(&(run->smap_lock));
+    thrd->items[i] = (unsigned long) slot;
+    return (-1 == slot) ? ENOSPC : 0;
+}
+
+static int slotmap_release_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    size_t item = thrd->order[i];
+    if ((unsigned long)-1 == thrd->items[item]) {
+        return ENOENT;
+    }
+    pthread_mutex_lock(&(run->smap_lock));
+    int rc = slotmap_release(run->smap, (size_t)thrd->items[item],
+                             slots_for_item(item));
+    pthread_mutex_unlock(&(run->smap_lock));
+    return rc;
+}
+
+static void bench_slotmap(bench_run* run)
+{
+    size_t num_slots = run->nops * (size_t)run->nthreads * 8;
+    size_t buf_sz = sizeof(slot_map) + (num_slots / 4) + 4096;
+    void* buf = malloc(buf_sz);
+    if (NULL == buf) {
+        fprintf(stderr, "ERROR: malloc(%zu) for slot map failed\n", buf_sz);
+        total_errors++;
+        return;
+    }
+    run->smap = slotmap_init(num_slots, buf, buf_sz);
+    if (NULL == run->smap) {
+        fprintf(stderr, "ERROR: slotmap_init(%zu) failed\n", num_slots);
+        total_errors++;
+        free(buf);
+        return;
+    }
+    pthread_mutex_init(&(run->smap_lock), NULL);
+    run_phase(run, "reserve", slotmap_reserve_op);
+    run_phase(run, "release", slotmap_release_op);
+    pthread_mutex_destroy(&(run->smap_lock));
+    run->smap = NULL;
+    free(buf);
+}
+
+/* -------------------------------- logio ------------------------------- */
+
+static int logio_alloc_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    off_t log_off = 0;
+    int rc = unifyfs_logio_alloc(run->logio, run->size, &log_off);
+    thrd->items[i] = (rc == UNIFYFS_SUCCESS) ?
+                     (unsigned long) log_off : (unsigned long) -1;
+    return rc;
+}
+
+static int logio_write_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    if ((unsigned long)-1 == thrd->items[i]) {
+        return ENOENT;
+    }
+    size_t nwrite = 0;
+    int rc = unifyfs_logio_write(run->logio, (off_t)thrd->items[i],
+                                 run->size, thrd->buf, &nwrite);
+    if ((rc == UNIFYFS_SUCCESS) && (nwrite != run->size)) {
+        rc = EIO;
+    }
+    return rc;
+}
+
+static int logio_read_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    size_t item = thrd->order[i];
+    if ((unsigned long)-1 == thrd->items[item]) {
+        return ENOENT;
+    }
+    size_t nread = 0;
+    int rc = unifyfs_logio_read(run->logio, (off_t)thrd->items[item],
+                                run->size, thrd->buf, &nread);
+    if ((rc == UNIFYFS_SUCCESS) && (nread != run->size)) {
+        rc = EIO;
+    }
+    return rc;
+}
+
+static int logio_free_op(bench_run* run, bench_thread* thrd, size_t i)
+{
+    if ((unsigned long)-1 == thrd->items[i]) {
+        return ENOENT;
+    }
+    return unifyfs_logio_free(run->logio, (off_t)thrd->items[i], run->size);
+}
+
+static void bench_logio(bench_run* run)
+{
+    /* size the shmem log to hold all allocations, allowing for
+     * whole-chunk rounding and space lost when packing small ones */
+    size_t chunk_sz = UNIFYFS_LOGIO_CHUNK_SIZE;
+    size_t alloc_sz = run->size;
+    if (alloc_sz >= chunk_sz) {
+        alloc_sz = ((alloc_sz + chunk_sz - 1) / chunk_sz) * chunk_sz;
+    }
+    size_t mem_sz = (2 * alloc_sz * run->nops * (size_t)run->nthreads) +
+                    (4 * chunk_sz);
+
+    char shmem_size[32];
+    char chunk_size[32];
+    snprintf(shmem_size, sizeof(shmem_size), "%zu", mem_sz);
+    snprintf(chunk_size, sizeof(chunk_size), "%zu", chunk_sz);
+
+    unifyfs_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.logio_shmem_size = shmem_size;
+    cfg.logio_chunk_size = chunk_size;
+
+    int rc = unifyfs_logio_init_client((int)getpid(), 0, &cfg, &(run->logio));
+    if (rc != UNIFYFS_SUCCESS) {
+        fprintf(stderr, "ERROR: unifyfs_logio_init_client(shmem=%zu) "
+                "failed (rc=%d)\n", mem_sz, rc);
+        total_errors++;
+        return;
+    }
+
+    run_phase(run, "alloc", logio_alloc_op);
+    run_phase(run, "write", logio_write_op);
+    run_phase(run, "read", logio_read_op);
+    run_phase(run, "free", logio_free_op);
+
+    unifyfs_logio_close(run->logio, 1);
+    run->logio = NULL;
+}
+
+/* --------------------------------------------------------------------- */
+
+typedef struct {
+    const char* name;
+    void (*fn)(bench_run* run);
+} bench_def;
+
+static bench_def benchmarks[] = {
+    { "seg_tree",    bench_seg_tree },
+    { "extent_tree", bench_extent_tree },
+    { "slotmap",     bench_slotmap },
+    { "logio",       bench_logio }
+};
+#define NUM_BENCHMARKS (sizeof(benchmarks) / sizeof(bench_def))
+
+static void run_benchmark(bench_def* def, bench_pattern pattern,
+                          int nthreads, size_t nops, size_t size)
+{
+    bench_run run;
+    memset(&run, 0, sizeof(run));
+    run.bench = def->name;
+    run.pattern = pattern;
+    run.nthreads = nthreads;
+    run.nops = nops;
+    run.size = size;
+
+    run.threads = (bench_thread*) calloc((size_t)nthreads,
+                                         sizeof(bench_thread));
+    if (NULL == run.threads) {
+        fprintf(stderr, "ERROR: calloc() for threads failed\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < nthreads; t++) {
+        bench_thread* thrd = run.threads + t;
+        thrd->rank = t;
+        thrd->run = &run;
+        thrd->rng = rand_seed + (unsigned int)t;
+        thrd->order = (size_t*) calloc(nops, sizeof(size_t));
+        thrd->items = (unsigned long*) calloc(nops, sizeof(unsigned long));
+        thrd->buf = (char*) malloc(size);
+        if ((NULL == thrd->order) || (NULL == thrd->items) ||
+            (NULL == thrd->buf)) {
+            fprintf(stderr, "ERROR: allocation of thread state failed\n");
+            exit(EXIT_FAILURE);
+        }
+        memset(thrd->buf, 'a' + (t % 26), size);
+        bench_order_init(&run, thrd);
+    }
+
+    def->fn(&run);
+
+    for (int t = 0; t < nthreads; t++) {
+        bench_thread* thrd = run.threads + t;
+        free(thrd->order);
+        free(thrd->items);
+        free(thrd->buf);
+    }
+    free(run.threads);
+}
+
+static void usage(char* arg0)
+{
+    fprintf(stderr,
+        "USAGE: %s [options]\n"
+        "  -b, --bench=LIST     benchmarks to run (default: all)\n"
+        "                       seg_tree,extent_tree,slotmap,logio\n"
+        "  -p, --pattern=LIST   access patterns (default: all)\n"
+        "                       sequential,strided,random\n"
+        "  -t, --threads=LIST   thread counts (default: 1,4)\n"
+        "  -n, --ops=N          operations per thread (default: 10000)\n"
+        "  -s, --size=BYTES     extent/allocation size (default: 1024)\n"
+        "  -r, --seed=N         random seed (default: 12345678)\n"
+        "  -h, --help           print this usage\n",
+        arg0);
+}
+
+/* return 1 if name is in the comma-separated list (or list is NULL) */
+static int in_list(const char* list, const char* name)
+{
+    if (NULL == list) {
+        return 1;
+    }
+    size_t len = strlen(name);
+    const char* p = list;
+    while (NULL != p) {
+        if ((0 == strncmp(p, name, len)) &&
+            ((p[len] == ',') || (p[len] == '\0'))) {
+            return 1;
+        }
+        p = strchr(p, ',');
+        if (NULL != p) {
+            p++;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* bench_list = NULL;
+    const char* pattern_list = NULL;
+    char* thread_list = NULL;
+    size_t nops = 10000;
+    size_t size = 1024;
+
+    static struct option long_opts[] = {
+        { "bench",   required_argument, 0, 'b' },
+        { "pattern", required_argument, 0, 'p' },
+        { "threads", required_argument, 0, 't' },
+        { "ops",     required_argument, 0, 'n' },
+        { "size",    required_argument, 0, 's' },
+        { "seed",    required_argument, 0, 'r' },
+        { "help",    no_argument,       0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "b:p:t:n:s:r:h",
+                             long_opts, NULL)) != -1) {
+        switch (ch) {
+        case 'b':
+            bench_list = optarg;
+            break;
+        case 'p':
+            pattern_list = optarg;
+            break;
+        case 't':
+            thread_list = optarg;
+            break;
+        case 'n':
+            nops = (size_t) strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            size = (size_t) strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rand_seed = (unsigned int) strtoul(optarg, NULL, 0);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return 0;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((0 == nops) || (0 == size)) {
+        fprintf(stderr, "ERROR: ops and size must be positive\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int thread_counts[MAX_THREAD_COUNTS] = { 1, 4 };
+    int n_counts = 2;
+    if (NULL != thread_list) {
+        n_counts = 0;
+        char* saveptr = NULL;
+        char* tok = strtok_r(thread_list, ",", &saveptr);
+        while ((NULL != tok) && (n_counts < MAX_THREAD_COUNTS)) {
+            int n = atoi(tok);
+            if (n <= 0) {
+                fprintf(stderr, "ERROR: invalid thread count '%s'\n", tok);
+                return EXIT_FAILURE;
+            }
+            thread_counts[n_counts++] = n;
+            tok = strtok_r(NULL, ",", &saveptr);
+        }
+    }
+
+    /* the trees use Argobots read-write locks */
+    int rc = ABT_init(0, NULL);
+    if (rc != ABT_SUCCESS) {
+        fprintf(stderr, "ERROR: ABT_init() failed (rc=%d)\n", rc);
+        return EXIT_FAILURE;
+    }
+
+    printf("benchmark,operation,pattern,threads,ops,size,"
+           "wall_ns,ops_per_sec,mean_ns,errors\n");
+    for (size_t b = 0; b < NUM_BENCHMARKS; b++) {
+        if (!in_list(bench_list, benchmarks[b].name)) {
+            continue;
+        }
+        for (int p = 0; p < PATTERN_COUNT; p++) {
+            if (!in_list(pattern_list, pattern_names[p])) {
+                continue;
+            }
+            for (int c = 0; c < n_counts; c++) {
+                run_benchmark(&benchmarks[b], (bench_pattern)p,
+                              thread_counts[c], nops, size);
+            }
+        }
+    }
+
+    ABT_finalize();
+
+    return (total_errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -46,6 +46,7 @@ int main(int argc, char** argv)
     struct seg_tree seg_tree;
     char tmp[255];
     unsigned long max, count;
+    unsigned long i;
     struct seg_tree_node* node;
 
     plan(NO_PLAN);
@@ -215,6 +216,35 @@ int main(int argc, char** argv)
        "removed a range that truncated two entries, got %s",
        print_tree(tmp, &seg_tree));
 
+    /* Append to the last range after a remove, contiguous in the log */
+    seg_tree_add(&seg_tree, 41, 50, 141, 0);
+    is("[1-10:101][20-24:20][32-50:132]", print_tree(tmp, &seg_tree),
+       "append after remove extends last range, got %s",
+       print_tree(tmp, &seg_tree));
+
+    /* Sequential appends that are contiguous in the log are merged */
+    seg_tree_clear(&seg_tree);
+    for (i = 0; i < 1000; i++) {
+        seg_tree_add(&seg_tree, i * 10, (i * 10) + 9, 500 + (i * 10), 0);
+    }
+    max = seg_tree_max(&seg_tree);
+    count = seg_tree_count(&seg_tree);
+    is("[0-9999:500]", print_tree(tmp, &seg_tree),
+       "sequential appends produce one range");
+    ok(max == 9999, "max is 9999 (got %lu)", max);
+    ok(count == 1, "count is 1 (got %lu)", count);
+
+    /* Appends that are not contiguous in the log are not merged */
+    seg_tree_add(&seg_tree, 10000, 10009, 20000, 0);
+    is("[0-9999:500][10000-10009:20000]", print_tree(tmp, &seg_tree),
+       "append from a different log position is not merged");
+
+    /* Overwriting the tail of the last range is not an append */
+    seg_tree_add(&seg_tree, 10005, 10019, 30005, 0);
+    is("[0-9999:500][10000-10004:20000][10005-10019:30005]",
+       print_tree(tmp, &seg_tree),
+       "overwrite of last range tail works");
+
     seg_tree_clear(&seg_tree);
     seg_tree_destroy(&seg_tree);
 
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "t/lib/tap.h"
@@ -12,6 +13,71 @@ struct reservation {
     size_t count;
 };
 
+static double elapsed_nsecs(struct timespec* start, struct timespec* end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+           (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/* Measure slotmap_reserve() latency as the slot map fills up. The map is
+ * filled to each target level with small random reservations, with some
+ * released again to fragment the free space, and then we time pairs of
+ * reserve/release calls of a fixed size. Returns number of failed timed
+ * reservations. */
+static size_t reserve_latency_benchmark(size_t num_slots,
+                                        size_t reserve_cnt,
+                                        size_t iters)
+{
+    size_t buf_sz = sizeof(slot_map) + (num_slots / 4) + 4096;
+    void* buf = malloc(buf_sz);
+    if (NULL == buf) {
+        BAIL_OUT("ERROR: malloc(%zu) for slot map buffer failed!\n", buf_sz);
+    }
+    slot_map* smap = slotmap_init(num_slots, buf, buf_sz);
+    if (NULL == smap) {
+        BAIL_OUT("ERROR: slotmap_init(%zu) failed!\n", num_slots);
+    }
+
+    printf("# slotmap_reserve(%zu) latency vs. fill level (%zu slots)\n",
+           reserve_cnt, num_slots);
+
+    size_t failures = 0;
+    int fill_levels[] = { 0, 25, 50, 75, 90, 95 };
+    int n_levels = sizeof(fill_levels) / sizeof(int);
+    for (int lvl = 0; lvl < n_levels; lvl++) {
+        /* fill to target level */
+        size_t target = (num_slots * (size_t)fill_levels[lvl]) / 100;
+        while (smap->used_slots < target) {
+            size_t cnt = 1 + ((size_t)rand() % 8);
+            ssize_t slot = slotmap_reserve(smap, cnt);
+            if (-1 == slot) {
+                break;
+            }
+            /* release the tail of some reservations to leave holes */
+            if ((cnt > 1) && ((rand() % 4) == 0)) {
+                slotmap_release(smap, (size_t)slot + 1, cnt - 1);
+            }
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (size_t i = 0; i < iters; i++) {
+            ssize_t slot = slotmap_reserve(smap, reserve_cnt);
+            if (-1 == slot) {
+                failures++;
+                continue;
+            }
+            slotmap_release(smap, (size_t)slot, reserve_cnt);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("#   fill=%2d%% : %10.1f ns per reserve+release\n",
+               fill_levels[lvl], elapsed_nsecs(&start, &end) / iters);
+    }
+
+    free(buf);
+    return failures;
+}
+
 int main(int argc, char** argv)
 {
     int rc;
@@ -120,6 +186,11 @@ int main(int argc, char** argv)
     rc = slotmap_clear(smap);
     ok(rc == 0, "clear the slotmap");
 
+    size_t bench_failures = reserve_latency_benchmark(1024 * 1024, 16, 1000);
+    ok(bench_failures == 0,
+       "slotmap_reserve() latency benchmark (%zu failed reservations)",
+       bench_failures);
+
     done_testing();
 }
 
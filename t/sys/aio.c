@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+ /*
+  * Test POSIX asynchronous I/O: aio_read, aio_write, aio_fsync, aio_error,
+  * aio_return, aio_suspend, and lio_listio
+  */
+#include <aio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define NCHUNKS 4
+#define CHUNK_SIZE 4096
+
+/* state for SIGEV_THREAD list completion notification */
+static pthread_mutex_t notify_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t notify_cond = PTHREAD_COND_INITIALIZER;
+static int notify_count; // = 0
+
+static void list_done(union sigval value)
+{
+    pthread_mutex_lock(&notify_mutex);
+    notify_count += value.sival_int;
+    pthread_cond_signal(&notify_cond);
+    pthread_mutex_unlock(&notify_mutex);
+}
+
+/* wait up to ten seconds for the request to complete,
+ * returns its error status */
+static int wait_for(struct aiocb* cbp)
+{
+    const struct aiocb* list[1] = { cbp };
+    struct timespec timeout = { 10, 0 };
+    while (aio_error(cbp) == EINPROGRESS) {
+        if (aio_suspend(list, 1, &timeout) != 0) {
+            break;
+        }
+    }
+    return aio_error(cbp);
+}
+
+int aio_test(char* unifyfs_root)
+{
+    diag("Starting UNIFYFS_WRAP(aio_*/lio_listio) tests");
+
+    char path[64];
+    int err, fd, rc, i;
+    ssize_t ret;
+
+    char* buf = (char*) malloc(NCHUNKS * CHUNK_SIZE);
+    char* rbuf = (char*) calloc(1, NCHUNKS * CHUNK_SIZE);
+    for (i = 0; i < (NCHUNKS * CHUNK_SIZE); i++) {
+        buf[i] = (char)('a' + (i % 26));
+    }
+
+    testutil_rand_path(path, sizeof(path), unifyfs_root);
+
+    errno = 0;
+    fd = open(path, O_RDWR | O_CREAT, 0222);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s) (fd=%d): %s",
+       __FILE__, __LINE__, path, fd, strerror(err));
+
+    /* single asynchronous write of the first chunk */
+    struct aiocb wcb;
+    memset(&wcb, 0, sizeof(wcb));
+    wcb.aio_fildes = fd;
+    wcb.aio_buf    = buf;
+    wcb.aio_nbytes = CHUNK_SIZE;
+    wcb.aio_offset = 0;
+    wcb.aio_sigevent.sigev_notify = SIGEV_NONE;
+    errno = 0;
+    rc = aio_write(&wcb);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d aio_write(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    err = wait_for(&wcb);
+    ret = aio_return(&wcb);
+    ok(err == 0 && ret == CHUNK_SIZE,
+       "%s:%d aio_write() completed (err=%d, ret=%zd)",
+       __FILE__, __LINE__, err, ret);
+
+    /* write the remaining chunks with a non-blocking list, which
+     * notifies a thread once all writes are done */
+    struct aiocb lcbs[NCHUNKS];
+    struct aiocb* list[NCHUNKS];
+    memset(lcbs, 0, sizeof(lcbs));
+    for (i = 0; i < NCHUNKS; i++) {
+        lcbs[i].aio_fildes = fd;
+        lcbs[i].aio_buf    = buf + (i * CHUNK_SIZE);
+        lcbs[i].aio_nbytes = CHUNK_SIZE;
+        lcbs[i].aio_offset = (off_t)(i * CHUNK_SIZE);
+        lcbs[i].aio_lio_opcode = (i == 0) ? LIO_NOP : LIO_WRITE;
+        list[i] = &lcbs[i];
+    }
+
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = list_done;
+    sev.sigev_value.sival_int = 1;
+    errno = 0;
+    rc = lio_listio(LIO_NOWAIT, list, NCHUNKS, &sev);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d lio_listio(LIO_NOWAIT, LIO_WRITE): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 10;
+    pthread_mutex_lock(&notify_mutex);
+    while (notify_count == 0) {
+        if (pthread_cond_timedwait(&notify_cond, &notify_mutex,
+                                   &deadline) != 0) {
+            break;
+        }
+    }
+    int notified = notify_count;
+    pthread_mutex_unlock(&notify_mutex);
+    ok(notified == 1, "%s:%d lio_listio() completion notification (%d)",
+       __FILE__, __LINE__, notified);
+
+    int all_ok = 1;
+    for (i = 1; i < NCHUNKS; i++) {
+        if ((aio_error(&lcbs[i]) != 0) ||
+            (aio_return(&lcbs[i]) != CHUNK_SIZE)) {
+            all_ok = 0;
+        }
+    }
+    ok(all_ok, "%s:%d lio_listio() writes succeeded", __FILE__, __LINE__);
+
+    /* flush the data */
+    struct aiocb scb;
+    memset(&scb, 0, sizeof(scb));
+    scb.aio_fildes = fd;
+    errno = 0;
+    rc = aio_fsync(O_SYNC, &scb);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d aio_fsync(): %s",
+       __FILE__, __LINE__, strerror(err));
+    err = wait_for(&scb);
+    ok(err == 0 && aio_return(&scb) == 0,
+       "%s:%d aio_fsync() completed (err=%d)", __FILE__, __LINE__, err);
+
+    /* read back the whole file with a blocking list of reads */
+    for (i = 0; i < NCHUNKS; i++) {
+        lcbs[i].aio_buf = rbuf + (i * CHUNK_SIZE);
+        lcbs[i].aio_lio_opcode = LIO_READ;
+    }
+    errno = 0;
+    rc = lio_listio(LIO_WAIT, list, NCHUNKS, NULL);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d lio_listio(LIO_WAIT, LIO_READ): %s",
+       __FILE__, __LINE__, strerror(err));
+    ok(memcmp(buf, rbuf, NCHUNKS * CHUNK_SIZE) == 0,
+       "%s:%d lio_listio() read data matches", __FILE__, __LINE__);
+
+    /* asynchronous read that extends past the end of file is short */
+    struct aiocb rcb;
+    memset(&rcb, 0, sizeof(rcb));
+    memset(rbuf, 0, NCHUNKS * CHUNK_SIZE);
+    rcb.aio_fildes = fd;
+    rcb.aio_buf    = rbuf;
+    rcb.aio_nbytes = 2 * CHUNK_SIZE;
+    rcb.aio_offset = (off_t)((NCHUNKS - 1) * CHUNK_SIZE);
+    errno = 0;
+    rc = aio_read(&rcb);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d aio_read(): %s",
+       __FILE__, __LINE__, strerror(err));
+    err = wait_for(&rcb);
+    ret = aio_return(&rcb);
+    ok(err == 0 && ret == CHUNK_SIZE,
+       "%s:%d aio_read() past EOF is short (err=%d, ret=%zd)",
+       __FILE__, __LINE__, err, ret);
+    ok(memcmp(rbuf, buf + ((NCHUNKS - 1) * CHUNK_SIZE), CHUNK_SIZE) == 0,
+       "%s:%d aio_read() data matches", __FILE__, __LINE__);
+
+    /* requests with a negative offset are refused */
+    rcb.aio_offset = -1;
+    errno = 0;
+    rc = aio_read(&rcb);
+    err = errno;
+    ok(rc == -1 && err == EINVAL,
+       "%s:%d aio_read(offset=-1) fails (errno=%d): %s",
+       __FILE__, __LINE__, err, strerror(err));
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    free(buf);
+    free(rbuf);
+
+    diag("Finished UNIFYFS_WRAP(aio_*/lio_listio) tests");
+
+    return 0;
+}
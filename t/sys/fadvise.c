@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+ /*
+  * Test posix_fadvise() hints, which may move file data between the
+  * shmem and spill-over storage of the write log
+  */
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+/* read back the file and check its contents match buf */
+static int check_file(int fd, char* buf, size_t bufsize)
+{
+    char* rbuf = (char*) calloc(1, bufsize);
+    ssize_t nread = pread(fd, rbuf, bufsize, 0);
+    int valid = ((nread == (ssize_t)bufsize) &&
+                 (memcmp(rbuf, buf, bufsize) == 0));
+    free(rbuf);
+    return valid;
+}
+
+int fadvise_test(char* unifyfs_root)
+{
+    diag("Starting UNIFYFS_WRAP(posix_fadvise) tests");
+
+    char path[64];
+    int err, fd, rc;
+
+    /* mix of small writes, which share log chunks, and a large write */
+    size_t small = 4096;
+    size_t bufsize = (8 * small) + (8 * 1024 * 1024);
+    char* buf = (char*) malloc(bufsize);
+    size_t i;
+    for (i = 0; i < bufsize; i++) {
+        buf[i] = (char)('A' + (i % 26));
+    }
+
+    testutil_rand_path(path, sizeof(path), unifyfs_root);
+
+    errno = 0;
+    fd = open(path, O_RDWR | O_CREAT, 0222);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s) (fd=%d): %s",
+       __FILE__, __LINE__, path, fd, strerror(err));
+
+    size_t pos = 0;
+    for (i = 0; i < 8; i++) {
+        errno = 0;
+        rc = (int) pwrite(fd, buf + pos, small, (off_t)pos);
+        err = errno;
+        ok(rc == (int)small && err == 0, "%s:%d pwrite(off=%zu): %s",
+           __FILE__, __LINE__, pos, strerror(err));
+        pos += small;
+    }
+    errno = 0;
+    rc = (int) pwrite(fd, buf + pos, bufsize - pos, (off_t)pos);
+    err = errno;
+    ok(rc == (int)(bufsize - pos) && err == 0, "%s:%d pwrite(off=%zu): %s",
+       __FILE__, __LINE__, pos, strerror(err));
+
+    /* move unsynced data out to spill-over storage */
+    rc = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ok(rc == 0, "%s:%d posix_fadvise(DONTNEED) (rc=%d)",
+       __FILE__, __LINE__, rc);
+    ok(check_file(fd, buf, bufsize),
+       "%s:%d file contents intact after DONTNEED", __FILE__, __LINE__);
+
+    /* move part of the data back into memory */
+    rc = posix_fadvise(fd, 0, (off_t)(4 * small), POSIX_FADV_WILLNEED);
+    ok(rc == 0, "%s:%d posix_fadvise(WILLNEED) (rc=%d)",
+       __FILE__, __LINE__, rc);
+    ok(check_file(fd, buf, bufsize),
+       "%s:%d file contents intact after WILLNEED", __FILE__, __LINE__);
+
+    rc = posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ok(rc == 0, "%s:%d posix_fadvise(SEQUENTIAL) (rc=%d)",
+       __FILE__, __LINE__, rc);
+
+    rc = posix_fadvise(fd, 0, 0, POSIX_FADV_NORMAL);
+    ok(rc == 0, "%s:%d posix_fadvise(NORMAL) (rc=%d)",
+       __FILE__, __LINE__, rc);
+
+    rc = posix_fadvise(fd, 0, 0, -1);
+    ok(rc == EINVAL, "%s:%d posix_fadvise(invalid advice) fails (rc=%d)",
+       __FILE__, __LINE__, rc);
+
+    /* the moved data is what gets synced to the server */
+    errno = 0;
+    rc = fsync(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d fsync(): %s",
+       __FILE__, __LINE__, strerror(err));
+    ok(check_file(fd, buf, bufsize),
+       "%s:%d file contents intact after fsync", __FILE__, __LINE__);
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    free(buf);
+
+    diag("Finished UNIFYFS_WRAP(posix_fadvise) tests");
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+ /*
+  * Test mmap(), msync(), and munmap() of laminated files
+  */
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+int mmap_test(char* unifyfs_root)
+{
+    diag("Starting UNIFYFS_WRAP(mmap/msync/munmap) tests");
+
+    char path[64];
+    int err, fd, rc;
+    void* addr;
+
+    size_t pgsz = (size_t) sysconf(_SC_PAGE_SIZE);
+    size_t bufsize = 4 * pgsz;
+    char* buf = (char*) malloc(bufsize);
+    size_t i;
+    for (i = 0; i < bufsize; i++) {
+        buf[i] = (char)('a' + (i % 26));
+    }
+
+    testutil_rand_path(path, sizeof(path), unifyfs_root);
+
+    errno = 0;
+    fd = open(path, O_RDWR | O_CREAT, 0222);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s) (fd=%d): %s",
+       __FILE__, __LINE__, path, fd, strerror(err));
+
+    errno = 0;
+    rc = (int) write(fd, buf, bufsize);
+    err = errno;
+    ok(rc == (int)bufsize && err == 0, "%s:%d write(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    errno = 0;
+    rc = fsync(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d fsync(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    /* files that are not laminated can't be mapped */
+    errno = 0;
+    addr = mmap(NULL, bufsize, PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    ok(addr == MAP_FAILED && err == ENODEV,
+       "%s:%d mmap() of non-laminated file fails (errno=%d): %s",
+       __FILE__, __LINE__, err, strerror(err));
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    /* Laminate */
+    errno = 0;
+    rc = chmod(path, 0444);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d chmod(0444): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    errno = 0;
+    fd = open(path, O_RDONLY);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s, O_RDONLY) (fd=%d): %s",
+       __FILE__, __LINE__, path, fd, strerror(err));
+
+    /* shared writable mappings are refused */
+    errno = 0;
+    addr = mmap(NULL, bufsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    err = errno;
+    ok(addr == MAP_FAILED && err == EACCES,
+       "%s:%d mmap(PROT_WRITE, MAP_SHARED) fails (errno=%d): %s",
+       __FILE__, __LINE__, err, strerror(err));
+
+    /* offset must be page aligned */
+    errno = 0;
+    addr = mmap(NULL, pgsz, PROT_READ, MAP_SHARED, fd, 1);
+    err = errno;
+    ok(addr == MAP_FAILED && err == EINVAL,
+       "%s:%d mmap() with unaligned offset fails (errno=%d): %s",
+       __FILE__, __LINE__, err, strerror(err));
+
+    /* map the whole file */
+    errno = 0;
+    addr = mmap(NULL, bufsize, PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    ok(addr != MAP_FAILED && err == 0, "%s:%d mmap(): %s",
+       __FILE__, __LINE__, strerror(err));
+    if (addr != MAP_FAILED) {
+        ok(memcmp(addr, buf, bufsize) == 0,
+           "%s:%d mapped data matches written data", __FILE__, __LINE__);
+
+        errno = 0;
+        rc = msync(addr, bufsize, MS_SYNC);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d msync(): %s",
+           __FILE__, __LINE__, strerror(err));
+
+        errno = 0;
+        rc = munmap(addr, bufsize);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d munmap(): %s",
+           __FILE__, __LINE__, strerror(err));
+    }
+
+    /* map the last page plus a page past the end of file, which should
+     * read as zeros */
+    off_t offset = (off_t)(bufsize - pgsz);
+    errno = 0;
+    addr = mmap(NULL, 2 * pgsz, PROT_READ, MAP_PRIVATE, fd, offset);
+    err = errno;
+    ok(addr != MAP_FAILED && err == 0, "%s:%d mmap(offset=%zu): %s",
+       __FILE__, __LINE__, (size_t)offset, strerror(err));
+    if (addr != MAP_FAILED) {
+        char* data = (char*) addr;
+        ok(memcmp(data, buf + offset, pgsz) == 0,
+           "%s:%d mapped data matches written data", __FILE__, __LINE__);
+
+        int zeros = 1;
+        for (i = pgsz; i < (2 * pgsz); i++) {
+            if (data[i] != 0) {
+                zeros = 0;
+                break;
+            }
+        }
+        ok(zeros, "%s:%d mapped bytes past end of file are zero",
+           __FILE__, __LINE__);
+
+        errno = 0;
+        rc = munmap(addr, 2 * pgsz);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d munmap(): %s",
+           __FILE__, __LINE__, strerror(err));
+    }
+
+    /* after a partial munmap(), the rest of the mapping is still tracked */
+    errno = 0;
+    addr = mmap(NULL, bufsize, PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    ok(addr != MAP_FAILED && err == 0, "%s:%d mmap(): %s",
+       __FILE__, __LINE__, strerror(err));
+    if (addr != MAP_FAILED) {
+        char* data = (char*) addr;
+
+        errno = 0;
+        rc = munmap(data, pgsz);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d munmap(first page): %s",
+           __FILE__, __LINE__, strerror(err));
+
+        errno = 0;
+        rc = msync(data + pgsz, bufsize - pgsz, MS_SYNC);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d msync(remaining pages): %s",
+           __FILE__, __LINE__, strerror(err));
+
+        errno = 0;
+        rc = msync(data, pgsz, MS_SYNC);
+        err = errno;
+        ok(rc == -1 && err == ENOMEM,
+           "%s:%d msync(unmapped page) fails (errno=%d): %s",
+           __FILE__, __LINE__, err, strerror(err));
+
+        ok(memcmp(data + pgsz, buf + pgsz, bufsize - pgsz) == 0,
+           "%s:%d remaining mapped data matches written data",
+           __FILE__, __LINE__);
+
+        errno = 0;
+        rc = munmap(data + pgsz, bufsize - pgsz);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d munmap(remaining pages): %s",
+           __FILE__, __LINE__, strerror(err));
+    }
+
+    /* a mapping keeps its data after the file is unlinked, even when
+     * another file is written into the space the file used */
+    errno = 0;
+    addr = mmap(NULL, bufsize, PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    ok(addr != MAP_FAILED && err == 0, "%s:%d mmap(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    errno = 0;
+    rc = unlink(path);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d unlink(%s): %s",
+       __FILE__, __LINE__, path, strerror(err));
+
+    char path2[64];
+    char* buf2 = (char*) malloc(bufsize);
+    memset(buf2, 'Z', bufsize);
+    testutil_rand_path(path2, sizeof(path2), unifyfs_root);
+
+    errno = 0;
+    fd = open(path2, O_RDWR | O_CREAT, 0222);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s) (fd=%d): %s",
+       __FILE__, __LINE__, path2, fd, strerror(err));
+
+    /* leave the last page half full */
+    size_t size2 = bufsize - (pgsz / 2);
+    errno = 0;
+    rc = (int) write(fd, buf2, size2);
+    err = errno;
+    ok(rc == (int)size2 && err == 0, "%s:%d write(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    errno = 0;
+    rc = fsync(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d fsync(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    if (addr != MAP_FAILED) {
+        ok(memcmp(addr, buf, bufsize) == 0,
+           "%s:%d mapped data of unlinked file is unchanged",
+           __FILE__, __LINE__);
+
+        errno = 0;
+        rc = munmap(addr, bufsize);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d munmap(): %s",
+           __FILE__, __LINE__, strerror(err));
+    }
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    /* Laminate */
+    errno = 0;
+    rc = chmod(path2, 0444);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d chmod(0444): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    errno = 0;
+    fd = open(path2, O_RDONLY);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s, O_RDONLY) (fd=%d): %s",
+       __FILE__, __LINE__, path2, fd, strerror(err));
+
+    /* the part of the last page past the end of file reads as zeros */
+    errno = 0;
+    addr = mmap(NULL, bufsize, PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    ok(addr != MAP_FAILED && err == 0, "%s:%d mmap(): %s",
+       __FILE__, __LINE__, strerror(err));
+    if (addr != MAP_FAILED) {
+        char* data = (char*) addr;
+        ok(memcmp(data, buf2, size2) == 0,
+           "%s:%d mapped data matches written data", __FILE__, __LINE__);
+
+        int zeros = 1;
+        for (i = size2; i < bufsize; i++) {
+            if (data[i] != 0) {
+                zeros = 0;
+                break;
+            }
+        }
+        ok(zeros, "%s:%d mapped bytes past end of file in last page are zero",
+           __FILE__, __LINE__);
+
+        errno = 0;
+        rc = munmap(addr, bufsize);
+        err = errno;
+        ok(rc == 0 && err == 0, "%s:%d munmap(): %s",
+           __FILE__, __LINE__, strerror(err));
+    }
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    free(buf2);
+    free(buf);
+
+    diag("Finished UNIFYFS_WRAP(mmap/msync/munmap) tests");
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+ /*
+  * Test vectored I/O: readv, writev, preadv, and pwritev
+  */
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+int readv_writev_test(char* unifyfs_root)
+{
+    diag("Starting UNIFYFS_WRAP(readv/writev/preadv/pwritev) tests");
+
+    char path[64];
+    int err, fd;
+    ssize_t rc;
+
+    char a[10], b[100], c[1000];
+    memset(a, 'a', sizeof(a));
+    memset(b, 'b', sizeof(b));
+    memset(c, 'c', sizeof(c));
+    size_t total = sizeof(a) + sizeof(b) + sizeof(c);
+
+    char expect[2 * 1110];
+    memcpy(expect, a, sizeof(a));
+    memcpy(expect + sizeof(a), b, sizeof(b));
+    memcpy(expect + sizeof(a) + sizeof(b), c, sizeof(c));
+
+    testutil_rand_path(path, sizeof(path), unifyfs_root);
+
+    errno = 0;
+    fd = open(path, O_RDWR | O_CREAT, 0222);
+    err = errno;
+    ok(fd != -1 && err == 0, "%s:%d open(%s) (fd=%d): %s",
+       __FILE__, __LINE__, path, fd, strerror(err));
+
+    /* write three buffers, including an empty one, at current position */
+    struct iovec wiov[4];
+    wiov[0].iov_base = a;
+    wiov[0].iov_len  = sizeof(a);
+    wiov[1].iov_base = NULL;
+    wiov[1].iov_len  = 0;
+    wiov[2].iov_base = b;
+    wiov[2].iov_len  = sizeof(b);
+    wiov[3].iov_base = c;
+    wiov[3].iov_len  = sizeof(c);
+    errno = 0;
+    rc = writev(fd, wiov, 4);
+    err = errno;
+    ok(rc == (ssize_t)total && err == 0, "%s:%d writev() (rc=%zd): %s",
+       __FILE__, __LINE__, rc, strerror(err));
+
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    ok(pos == (off_t)total, "%s:%d writev() advanced position to %zu",
+       __FILE__, __LINE__, (size_t)pos);
+
+    /* write the same data again right after, without moving position */
+    errno = 0;
+    rc = pwritev(fd, wiov, 4, (off_t)total);
+    err = errno;
+    ok(rc == (ssize_t)total && err == 0, "%s:%d pwritev() (rc=%zd): %s",
+       __FILE__, __LINE__, rc, strerror(err));
+    memcpy(expect + total, expect, total);
+
+    pos = lseek(fd, 0, SEEK_CUR);
+    ok(pos == (off_t)total, "%s:%d pwritev() did not change position",
+       __FILE__, __LINE__);
+
+    errno = 0;
+    rc = fsync(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d fsync(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    /* read back with buffer boundaries that differ from the writes */
+    char r1[500], r2[1720];
+    struct iovec riov[2];
+    riov[0].iov_base = r1;
+    riov[0].iov_len  = sizeof(r1);
+    riov[1].iov_base = r2;
+    riov[1].iov_len  = sizeof(r2);
+    errno = 0;
+    rc = preadv(fd, riov, 2, 0);
+    err = errno;
+    ok(rc == (ssize_t)(2 * total) && err == 0, "%s:%d preadv() (rc=%zd): %s",
+       __FILE__, __LINE__, rc, strerror(err));
+    ok((memcmp(r1, expect, sizeof(r1)) == 0) &&
+       (memcmp(r2, expect + sizeof(r1), sizeof(r2)) == 0),
+       "%s:%d preadv() data matches", __FILE__, __LINE__);
+
+    /* readv from current position stops short at end of file */
+    memset(r1, 0, sizeof(r1));
+    memset(r2, 0, sizeof(r2));
+    errno = 0;
+    rc = readv(fd, riov, 2);
+    err = errno;
+    ok(rc == (ssize_t)total && err == 0, "%s:%d readv() at %zu (rc=%zd): %s",
+       __FILE__, __LINE__, total, rc, strerror(err));
+    ok((memcmp(r1, expect + total, sizeof(r1)) == 0) &&
+       (memcmp(r2, expect + total + sizeof(r1), total - sizeof(r1)) == 0),
+       "%s:%d readv() data matches", __FILE__, __LINE__);
+
+    pos = lseek(fd, 0, SEEK_CUR);
+    ok(pos == (off_t)(2 * total), "%s:%d readv() advanced position to %zu",
+       __FILE__, __LINE__, (size_t)pos);
+
+    /* invalid vector count */
+    errno = 0;
+    rc = preadv(fd, riov, -1, 0);
+    err = errno;
+    ok(rc == -1 && err == EINVAL,
+       "%s:%d preadv(iovcnt=-1) fails (errno=%d): %s",
+       __FILE__, __LINE__, err, strerror(err));
+
+    errno = 0;
+    rc = close(fd);
+    err = errno;
+    ok(rc == 0 && err == 0, "%s:%d close(): %s",
+       __FILE__, __LINE__, strerror(err));
+
+    diag("Finished UNIFYFS_WRAP(readv/writev/preadv/pwritev) tests");
+
+    return 0;
+}
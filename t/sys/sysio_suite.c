@@ -91,6 +91,10 @@ int main(int argc, char* argv[])
 
     write_read_hole_test(unifyfs_root);
 
+    readv_writev_test(unifyfs_root);
+
+    aio_test(unifyfs_root);
+
     truncate_test(unifyfs_root);
     truncate_bigempty(unifyfs_root);
     truncate_eof(unifyfs_root);
@@ -109,6 +113,10 @@ int main(int argc, char* argv[])
 
     stat_test(unifyfs_root);
 
+    mmap_test(unifyfs_root);
+
+    fadvise_test(unifyfs_root);
+
     rc = unifyfs_unmount();
     ok(rc == 0, "unifyfs_unmount(%s) (rc=%d)", unifyfs_root, rc);
 
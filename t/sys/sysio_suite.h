@@ -58,6 +58,15 @@ int write_pre_existing_file_test(char* unifyfs_root);
 /* test reading from file with holes */
 int write_read_hole_test(char* unifyfs_root);
 
+/* Tests for UNIFYFS_WRAP(readv), UNIFYFS_WRAP(writev),
+ * UNIFYFS_WRAP(preadv), and UNIFYFS_WRAP(pwritev) */
+int readv_writev_test(char* unifyfs_root);
+
+/* Tests for UNIFYFS_WRAP(aio_read), UNIFYFS_WRAP(aio_write),
+ * UNIFYFS_WRAP(aio_fsync), UNIFYFS_WRAP(aio_suspend), and
+ * UNIFYFS_WRAP(lio_listio) */
+int aio_test(char* unifyfs_root);
+
 /* Tests for UNIFYFS_WRAP(ftruncate) and UNIFYFS_WRAP(truncate) */
 int truncate_test(char* unifyfs_root);
 int truncate_bigempty(char* unifyfs_root);
@@ -77,4 +86,11 @@ int chdir_test(char* unifyfs_root);
 /* Test for UNIFYFS_WRAP(stat, lstat, fstat) */
 int stat_test(char* unifyfs_root);
 
+/* Tests for UNIFYFS_WRAP(mmap), UNIFYFS_WRAP(msync), and
+ * UNIFYFS_WRAP(munmap) */
+int mmap_test(char* unifyfs_root);
+
+/* Tests for UNIFYFS_WRAP(posix_fadvise) */
+int fadvise_test(char* unifyfs_root);
+
 #endif /* SYSIO_SUITE_H */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2021, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unifyfs_api.h"
+
+static void usage(char* arg0)
+{
+    fprintf(stderr, "USAGE: %s [-r] <mountpoint>\n"
+            "  -r  reset the server statistics after reporting them\n",
+            arg0);
+    fflush(stderr);
+}
+
+int main(int argc, char** argv)
+{
+    int reset = 0;
+    int argi = 1;
+    if ((argc > 1) && (0 == strcmp(argv[1], "-r"))) {
+        reset = 1;
+        argi++;
+    }
+
+    if (argc != (argi + 1)) {
+        fprintf(stderr, "USAGE ERROR: expected a mountpoint argument!\n");
+        usage(argv[0]);
+        return -1;
+    }
+
+    char* mountpt = argv[argi];
+
+    unifyfs_handle fshdl;
+    unifyfs_rc urc = unifyfs_initialize(mountpt, NULL, 0, &fshdl);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "UNIFYFS ERROR: init failed at mountpoint %s - %s\n",
+                mountpt, unifyfs_rc_enum_description(urc));
+        return 1;
+    }
+
+    char* report = NULL;
+    urc = unifyfs_get_server_stats(fshdl, reset, &report);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "UNIFYFS ERROR: failed to get server stats - %s\n",
+                unifyfs_rc_enum_description(urc));
+        unifyfs_finalize(fshdl);
+        return 2;
+    }
+    fputs(report, stdout);
+    free(report);
+
+    urc = unifyfs_finalize(fshdl);
+    if (UNIFYFS_SUCCESS != urc) {
+        fprintf(stderr, "UNIFYFS ERROR: failed to finalize - %s\n",
+                unifyfs_rc_enum_description(urc));
+        return 3;
+    }
+
+    return 0;
+}